@@ -0,0 +1,111 @@
+#pragma once
+
+#include "BoundingVolume.h"
+#include "Library.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief A sequence of {@link BoundingVolume} instances, stored as a
+ * structure of arrays so that they can be culled in a batch.
+ *
+ * Every bounding volume is stored as a box with an additional radius: an
+ * oriented bounding box has a radius of zero, and a bounding sphere is a box
+ * with half-lengths of zero, so that the same plane and distance tests apply
+ * to both without branching on the type. Bounding regions are stored as their
+ * oriented bounding box for the plane tests. Because their distance is
+ * computed from the cartographic position of the camera, a copy of these
+ * volumes is kept as well.
+ *
+ * @see ViewState::computePlaneMasksAndDistancesSquared
+ */
+class CESIUM3DTILESSELECTION_API BoundingVolumeBatch final {
+public:
+  /**
+   * @brief Removes all bounding volumes from this batch.
+   */
+  void clear() noexcept;
+
+  /**
+   * @brief Reserves space for the given number of bounding volumes.
+   *
+   * @param count The number of bounding volumes.
+   */
+  void reserve(size_t count);
+
+  /**
+   * @brief Appends the given bounding volume to this batch.
+   *
+   * @param boundingVolume The bounding volume.
+   */
+  void add(const BoundingVolume& boundingVolume);
+
+  /**
+   * @brief Returns the number of bounding volumes in this batch.
+   */
+  size_t size() const noexcept { return this->_radii.size(); }
+
+  /**
+   * @brief Returns whether this batch is empty.
+   */
+  bool empty() const noexcept { return this->_radii.empty(); }
+
+  /**
+   * @brief Returns the x, y, and z coordinates of the centers.
+   */
+  const std::array<std::vector<double>, 3>& getCenters() const noexcept {
+    return this->_centers;
+  }
+
+  /**
+   * @brief Returns the unit-length axes of the boxes.
+   *
+   * The first index is the axis, the second index is the coordinate of the
+   * axis.
+   */
+  const std::array<std::array<std::vector<double>, 3>, 3>&
+  getAxes() const noexcept {
+    return this->_axes;
+  }
+
+  /**
+   * @brief Returns the half-lengths of the boxes along each of their
+   * {@link getAxes axes}.
+   */
+  const std::array<std::vector<double>, 3>& getHalfLengths() const noexcept {
+    return this->_halfLengths;
+  }
+
+  /**
+   * @brief Returns the radii that are added around each box.
+   */
+  const std::vector<double>& getRadii() const noexcept { return this->_radii; }
+
+  /**
+   * @brief Returns the bounding volumes, and their indices in this batch,
+   * whose distance to the camera can not be computed from the box and radius.
+   */
+  const std::vector<std::pair<size_t, BoundingVolume>>&
+  getExactDistanceVolumes() const noexcept {
+    return this->_exactDistanceVolumes;
+  }
+
+private:
+  void addBox(
+      const glm::dvec3& center,
+      const glm::dmat3& halfAxes,
+      double radius);
+
+  std::array<std::vector<double>, 3> _centers;
+  std::array<std::array<std::vector<double>, 3>, 3> _axes;
+  std::array<std::vector<double>, 3> _halfLengths;
+  std::vector<double> _radii;
+  std::vector<std::pair<size_t, BoundingVolume>> _exactDistanceVolumes;
+};
+
+} // namespace Cesium3DTilesSelection
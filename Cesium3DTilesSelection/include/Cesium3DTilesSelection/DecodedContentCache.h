@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Library.h"
+#include "TilesetOptions.h"
+
+#include <CesiumAsync/ICacheDatabase.h>
+#include <CesiumGltf/Model.h>
+
+#include <gsl/span>
+#include <spdlog/fwd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+
+/**
+ * @brief A cache of the glTF models decoded from tile content, so that a tile
+ * whose content was decoded before is loaded without parsing the glTF, and
+ * without decoding its Draco meshes and its images again.
+ *
+ * The models are stored in a {@link CesiumAsync::ICacheDatabase}, such as a
+ * {@link CesiumAsync::SqliteCache} or a {@link CesiumAsync::MappedFileCache},
+ * in a binary form that holds the buffers and the decoded image pixels as
+ * they are in memory. An entry is found by the URL of the content, a hash of
+ * the content, the {@link TilesetContentOptions} that change the decoded
+ * model, and the image decoders registered with
+ * {@link GltfContent::getGltfReader}, so an entry is never used for content
+ * that changed or that would be decoded differently now.
+ *
+ * Set {@link TilesetExternals::pDecodedContentCache} to use the cache when
+ * loading tiles. Only glTF and batched 3D model content is cached; the
+ * content of a tile that creates child tiles, such as an external tileset or
+ * a quantized-mesh tile, is always decoded. The texture coordinates for the
+ * raster overlays are generated after a model is taken from the cache, because
+ * they depend on the overlays.
+ *
+ * The methods may be called from any thread, as far as the cache database
+ * allows.
+ */
+class CESIUM3DTILESSELECTION_API DecodedContentCache final {
+public:
+  /**
+   * @brief The version of the binary form of the models.
+   *
+   * It is part of the keys, so the entries written by a different version are
+   * never read.
+   */
+  static const uint32_t FORMAT_VERSION;
+
+  /**
+   * @brief Constructs a new instance.
+   *
+   * @param pLogger The logger that receives the messages about models that
+   * cannot be stored or read.
+   * @param pCacheDatabase The database in which the models are stored. It may
+   * be shared with a {@link CesiumAsync::CachingAssetAccessor}, since the keys
+   * of the models never match the keys of responses.
+   * @param lifetime How long a stored model is kept, before it may be pruned
+   * from the database.
+   */
+  DecodedContentCache(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const std::shared_ptr<CesiumAsync::ICacheDatabase>& pCacheDatabase,
+      std::chrono::seconds lifetime = std::chrono::hours(24 * 30));
+
+  /**
+   * @brief Gets the model decoded from the given content, if it is stored.
+   *
+   * @param url The URL of the content.
+   * @param content The content, which is hashed to find the model.
+   * @param options The options with which the content is loaded.
+   * @return The model, or `std::nullopt` if it is not stored or cannot be
+   * read.
+   */
+  std::optional<CesiumGltf::Model> getModel(
+      const std::string& url,
+      const gsl::span<const std::byte>& content,
+      const TilesetContentOptions& options) const;
+
+  /**
+   * @brief Stores the model decoded from the given content.
+   *
+   * @param url The URL of the content.
+   * @param content The content, which is hashed to find the model later.
+   * @param options The options with which the content was loaded.
+   * @param model The decoded model.
+   * @return `true` if the model was stored, or `false` if it has an extension
+   * that cannot be stored, or the database failed to store it.
+   */
+  bool storeModel(
+      const std::string& url,
+      const gsl::span<const std::byte>& content,
+      const TilesetContentOptions& options,
+      const CesiumGltf::Model& model);
+
+  /**
+   * @brief Calculates the key under which the model decoded from the given
+   * content is stored.
+   *
+   * The key includes the fingerprint of the image decoders of
+   * {@link GltfContent::getGltfReader}, so models that were stored before
+   * other decoders were registered are not used.
+   *
+   * @param url The URL of the content.
+   * @param content The content.
+   * @param options The options with which the content is loaded.
+   * @return The key.
+   */
+  static std::string calculateKey(
+      const std::string& url,
+      const gsl::span<const std::byte>& content,
+      const TilesetContentOptions& options);
+
+  /**
+   * @brief Writes a model in the binary form in which it is stored.
+   *
+   * The binary form uses the byte order of this machine, so it is not meant
+   * to be exchanged between machines. Generic extensions and the
+   * `EXT_feature_metadata` extension are written. The
+   * `KHR_draco_mesh_compression` extension is left out, because the meshes
+   * are already decoded.
+   *
+   * @param model The model.
+   * @return The binary form.
+   * @throws std::runtime_error If the model has another statically-typed
+   * extension.
+   */
+  static std::vector<std::byte> writeModel(const CesiumGltf::Model& model);
+
+  /**
+   * @brief Reads a model from the binary form written by
+   * {@link writeModel}.
+   *
+   * @param data The binary form.
+   * @return The model, or `std::nullopt` if the data is not a model written
+   * by this version.
+   */
+  static std::optional<CesiumGltf::Model>
+  readModel(const gsl::span<const std::byte>& data);
+
+private:
+  std::shared_ptr<spdlog::logger> _pLogger;
+  std::shared_ptr<CesiumAsync::ICacheDatabase> _pCacheDatabase;
+  std::chrono::seconds _lifetime;
+};
+
+} // namespace Cesium3DTilesSelection
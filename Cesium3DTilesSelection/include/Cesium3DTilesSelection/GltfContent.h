@@ -33,6 +33,17 @@ public:
   CesiumAsync::Future<std::unique_ptr<TileContentLoadResult>>
   load(const TileContentLoadInput& input) override;
 
+  /**
+   * @brief Gets the reader of glTF and batched 3D model content.
+   *
+   * Image decoders, such as those of GPU compressed images, are registered
+   * with its {@link CesiumGltf::GltfReader::getImageDecoders}. That must be
+   * done before any tileset is loaded.
+   */
+  static CesiumGltf::GltfReader& getGltfReader() noexcept {
+    return GltfContent::_gltfReader;
+  }
+
   /**
    * @brief Create a {@link TileContentLoadResult} from the given data.
    *
@@ -41,12 +52,43 @@ public:
    * @param pLogger Only used for logging
    * @param url The URL, only used for logging
    * @param data The actual glTF data
+   * @param pDataOwner The object that keeps the `data` alive, such as the
+   * request that holds it. If given, the model refers to the binary chunk of
+   * a GLB instead of copying it, and keeps the owner alive.
    * @return The {@link TileContentLoadResult}
    */
   static std::unique_ptr<TileContentLoadResult> load(
       const std::shared_ptr<spdlog::logger>& pLogger,
       const std::string& url,
-      const gsl::span<const std::byte>& data);
+      const gsl::span<const std::byte>& data,
+      const std::shared_ptr<const void>& pDataOwner = nullptr);
+
+  /**
+   * @brief Create a {@link TileContentLoadResult} from the given data, and
+   * decode the images and Draco meshes of the glTF in worker threads.
+   *
+   * (Only public to be called from `Batched3DModelContent`)
+   *
+   * @param asyncSystem The async system whose worker threads decode the glTF
+   * @param pLogger Only used for logging
+   * @param url The URL, only used for logging
+   * @param data The actual glTF data, which is only used before this function
+   * returns, unless the model refers to it
+   * @param pDataOwner The object that keeps the `data` alive, such as the
+   * request that holds it. If given, and
+   * {@link TilesetContentOptions::referenceGlbBinaryChunk} is set, the model
+   * refers to the binary chunk of a GLB instead of copying it, and keeps the
+   * owner alive.
+   * @param options The options with which the content is loaded
+   * @return A future that resolves to the {@link TileContentLoadResult}
+   */
+  static CesiumAsync::Future<std::unique_ptr<TileContentLoadResult>> load(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const std::string& url,
+      const gsl::span<const std::byte>& data,
+      const std::shared_ptr<const void>& pDataOwner,
+      const TilesetContentOptions& options = TilesetContentOptions());
 
   /**
    * @brief Creates texture coordinates for mapping {@link RasterOverlay} tiles
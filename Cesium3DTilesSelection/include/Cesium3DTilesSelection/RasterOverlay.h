@@ -39,6 +39,17 @@ struct CESIUM3DTILESSELECTION_API RasterOverlayOptions {
    * maximum size of that cache.
    */
   int64_t subTileCacheBytes = 16 * 1024 * 1024;
+
+  /**
+   * @brief Whether to generate the mip levels of the overlay tile images in a
+   * worker thread, before they are passed to
+   * {@link IPrepareRendererResources::prepareRasterInLoadThread}.
+   *
+   * The levels are generated by
+   * {@link CesiumGltf::ImageManipulation::generateMipmaps}, and images that it
+   * does not support are left as they are.
+   */
+  bool generateMipmaps = false;
 };
 
 /**
@@ -112,6 +123,16 @@ public:
    */
   bool isBeingDestroyed() const noexcept { return this->_pSelf != nullptr; }
 
+  /**
+   * @brief Returns whether the tile provider of this overlay is being created.
+   *
+   * If this returns `false` but {@link getTileProvider} still returns the
+   * placeholder, the tile provider could not be created.
+   */
+  bool isLoadingTileProvider() const noexcept {
+    return this->_isLoadingTileProvider;
+  }
+
   /**
    * @brief Begins asynchronous creation of the tile provider for this overlay
    * and eventually makes it available directly from this instance.
@@ -4,6 +4,7 @@
 #include "Library.h"
 #include "RasterMappedTo3DTile.h"
 
+#include <CesiumAsync/CancellationToken.h>
 #include <CesiumAsync/IAssetAccessor.h>
 #include <CesiumGeospatial/Projection.h>
 #include <CesiumGltf/GltfReader.h>
@@ -13,6 +14,7 @@
 
 #include <cassert>
 #include <optional>
+#include <unordered_map>
 
 namespace Cesium3DTilesSelection {
 
@@ -222,6 +224,17 @@ public:
     return this->_pLogger;
   }
 
+  /**
+   * @brief Gets the reader of the images of raster overlay tiles.
+   *
+   * Image decoders, such as those of GPU compressed images, are registered
+   * with its {@link CesiumGltf::GltfReader::getImageDecoders}. That must be
+   * done before any raster overlay is loaded.
+   */
+  static CesiumGltf::GltfReader& getGltfReader() noexcept {
+    return RasterOverlayTileProvider::_gltfReader;
+  }
+
   /**
    * @brief Returns the {@link CesiumGeospatial::Projection} of this instance.
    */
@@ -321,6 +334,15 @@ public:
    */
   bool loadTileThrottled(RasterOverlayTile& tile);
 
+  /**
+   * @brief Cancels the loads of the tiles that are no longer referenced by
+   * anything but their own load, because no geometry tile needs them anymore.
+   *
+   * The canceled tiles return to the `RasterOverlayTile::LoadState::Unloaded`
+   * state and are destroyed when their load ends.
+   */
+  void cancelUnreferencedLoads();
+
 protected:
   /**
    * @brief Loads the image for a tile.
@@ -382,6 +404,8 @@ private:
   int64_t _tileDataBytes;
   int32_t _totalTilesCurrentlyLoading;
   int32_t _throttledTilesCurrentlyLoading;
+  std::unordered_map<RasterOverlayTile*, CesiumAsync::CancellationToken>
+      _cancelableLoads;
   CESIUM_TRACE_DECLARE_TRACK_SET(
       _loadingSlots,
       "Raster Overlay Tile Loading Slot");
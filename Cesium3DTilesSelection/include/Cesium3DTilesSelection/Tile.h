@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BoundingVolume.h"
+#include "BoundingVolumeBatch.h"
 #include "Library.h"
 #include "RasterMappedTo3DTile.h"
 #include "RasterOverlayTile.h"
@@ -225,6 +226,21 @@ public:
    */
   void createChildTiles(std::vector<Tile>&& children);
 
+  /**
+   * @brief Returns the bounding volumes of the children of this tile as a
+   * {@link BoundingVolumeBatch}.
+   *
+   * The batch is built when the children are assigned, and rebuilt here if
+   * the bounding volume of any child has changed since then. It must not be
+   * used concurrently with changes to the children.
+   *
+   * This function is not supposed to be called by clients.
+   *
+   * @return The bounding volumes of the children, in the order of
+   * {@link getChildren}.
+   */
+  const BoundingVolumeBatch& getChildBoundingVolumes();
+
   /**
    * @brief Returns the {@link BoundingVolume} of this tile.
    *
@@ -248,6 +264,9 @@ public:
    */
   void setBoundingVolume(const BoundingVolume& value) noexcept {
     this->_boundingVolume = value;
+    if (this->_pParent) {
+      this->_pParent->_childBoundingVolumesDirty = true;
+    }
   }
 
   /**
@@ -474,6 +493,31 @@ public:
     this->_lastSelectionState = newState;
   }
 
+  /**
+   * @brief Returns the last frame in which the tileset needed this tile.
+   *
+   * A tile is needed in a frame when the traversal reaches it or puts it in a
+   * load queue. Unlike the {@link TileSelectionState}, this includes the tiles
+   * that are only loaded, such as the children that must be loaded before
+   * their parent can be refined.
+   *
+   * This function is not supposed to be called by clients.
+   */
+  int32_t getLastNeededFrameNumber() const noexcept {
+    return this->_lastNeededFrameNumber;
+  }
+
+  /**
+   * @brief Records that the tileset needed this tile in the given frame.
+   *
+   * This function is not supposed to be called by clients.
+   *
+   * @param frameNumber The frame number.
+   */
+  void setLastNeededFrameNumber(int32_t frameNumber) noexcept {
+    this->_lastNeededFrameNumber = frameNumber;
+  }
+
   /**
    * @brief Returns the raster overlay tiles that have been mapped to this tile.
    */
@@ -543,6 +587,18 @@ public:
    */
   void update(int32_t previousFrameNumber, int32_t currentFrameNumber);
 
+  /**
+   * @brief Returns whether {@link update} may change anything about this tile.
+   *
+   * When this returns false, calling {@link update} does nothing, so a tile
+   * selection that runs in a worker thread only needs to have the main thread
+   * update the tiles for which this returns true. Unlike {@link update}, this
+   * function may be called from any thread.
+   *
+   * This function is not supposed to be called by clients.
+   */
+  bool needsUpdate() const noexcept;
+
   /**
    * @brief Marks the tile as permanently failing to load.
    *
@@ -605,6 +661,8 @@ private:
   TileContext* _pContext;
   Tile* _pParent;
   std::vector<Tile> _children;
+  BoundingVolumeBatch _childBoundingVolumes;
+  bool _childBoundingVolumesDirty;
 
   // Properties from tileset.json.
   // These are immutable after the tile leaves TileState::Unloaded.
@@ -624,6 +682,7 @@ private:
 
   // Selection state
   TileSelectionState _lastSelectionState;
+  int32_t _lastNeededFrameNumber;
 
   // Overlays
   std::vector<RasterMappedTo3DTile> _rasterTiles;
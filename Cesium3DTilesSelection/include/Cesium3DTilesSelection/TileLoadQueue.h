@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Library.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+
+class Tile;
+
+/**
+ * @brief A priority queue of the tiles that need to be loaded, which is kept
+ * from one frame to the next.
+ *
+ * The queue is an indexed binary min-heap: the position of each tile in the
+ * heap is tracked, so that when the priority of a queued tile changes, only
+ * that tile is moved, instead of sorting the whole queue again. Tiles that are
+ * no longer needed are removed with {@link removeUntouched}.
+ *
+ * Removing a tile from the middle of the heap would move others, so the tiles
+ * that were not updated stay in the heap until they reach its top, where they
+ * are dropped. They are only removed all at once when they outnumber the
+ * tiles that were updated.
+ */
+class CESIUM3DTILESSELECTION_API TileLoadQueue final {
+public:
+  /**
+   * @brief Adds a tile to the queue, or updates the priority of a tile that is
+   * already in the queue.
+   *
+   * If the tile was already updated in the same frame, it keeps the lower of
+   * the two priorities.
+   *
+   * @param tile The tile.
+   * @param priority The priority of loading the tile. Lower values load sooner.
+   * @param frameNumber The number of the current frame.
+   */
+  void update(Tile& tile, double priority, int32_t frameNumber);
+
+  /**
+   * @brief Removes all tiles that were not {@link update updated} in the given
+   * frame.
+   *
+   * The tiles are no longer returned, counted, or contained by the queue, but
+   * they stay in its heap until they reach the top or outnumber the tiles that
+   * were updated. The frame numbers given to this queue must not decrease.
+   *
+   * @param frameNumber The number of the current frame.
+   */
+  void removeUntouched(int32_t frameNumber);
+
+  /**
+   * @brief Removes the tile with the lowest priority value from the queue and
+   * returns it.
+   *
+   * @return The tile, or `nullptr` if the queue is empty.
+   */
+  Tile* pop();
+
+  /**
+   * @brief Returns the tile with the lowest priority value without removing
+   * it, or `nullptr` if the queue is empty.
+   */
+  Tile* top() const noexcept {
+    return this->empty() ? nullptr : this->_heap.front().pTile;
+  }
+
+  /**
+   * @brief Returns whether the given tile is in the queue.
+   */
+  bool contains(const Tile& tile) const;
+
+  /**
+   * @brief Returns the number of tiles in the queue.
+   */
+  size_t size() const noexcept {
+    return this->_heap.size() - this->_untouchedSize;
+  }
+
+  /**
+   * @brief Returns whether the queue is empty.
+   */
+  bool empty() const noexcept { return this->size() == 0; }
+
+  /**
+   * @brief Returns the number of removed tiles that are still in the heap.
+   */
+  size_t untouchedSize() const noexcept { return this->_untouchedSize; }
+
+  /**
+   * @brief Removes all tiles from the queue.
+   */
+  void clear() noexcept;
+
+private:
+  struct Entry {
+    Tile* pTile;
+    double priority;
+    int32_t frameNumber;
+  };
+
+  bool isUntouched(const Entry& entry) const noexcept {
+    return entry.frameNumber < this->_touchedFrameNumber;
+  }
+
+  void removeTop();
+  void removeUntouchedTop();
+  void compact();
+  void place(size_t index, const Entry& entry);
+  void siftUp(size_t index);
+  void siftDown(size_t index);
+
+  std::vector<Entry> _heap;
+  std::unordered_map<const Tile*, size_t> _indices;
+
+  // Entries updated before this frame were removed by removeUntouched.
+  int32_t _touchedFrameNumber = std::numeric_limits<int32_t>::min();
+  size_t _untouchedSize = 0;
+
+  // The number of entries updated in _lastFrameNumber, which are the ones
+  // that the next removeUntouched keeps.
+  int32_t _lastFrameNumber = std::numeric_limits<int32_t>::min();
+  size_t _lastFrameSize = 0;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -4,12 +4,14 @@
 #include "RasterOverlayCollection.h"
 #include "Tile.h"
 #include "TileContext.h"
+#include "TileLoadQueue.h"
 #include "TilesetExternals.h"
 #include "TilesetOptions.h"
 #include "ViewState.h"
 #include "ViewUpdateResult.h"
 
 #include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/CancellationToken.h>
 #include <CesiumAsync/IAssetRequest.h>
 #include <CesiumGeometry/Axis.h>
 #include <CesiumGeometry/QuadtreeTileAvailability.h>
@@ -20,6 +22,9 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -167,6 +172,38 @@ public:
    */
   const ViewUpdateResult& updateView(const std::vector<ViewState>& frustums);
 
+  /**
+   * @brief Updates this view, returning the set of tiles to render in this
+   * view, and prefetches the tiles for the views that are predicted to follow.
+   *
+   * The tiles that the predicted views would render are loaded with a lower
+   * priority than all tiles that are needed for the current views, and only
+   * when there are load slots left after loading those. The predicted views
+   * may be created by {@link ViewState::extrapolate} or from a known camera
+   * path. How many of the prefetched tiles are actually rendered is reported in
+   * the {@link ViewUpdateResult}.
+   *
+   * @param frustums The {@link ViewState}s that the view should be updated for
+   * @param predictedFrustums The {@link ViewState}s that are expected in the
+   * near future.
+   * @returns The set of tiles to render in the updated view. This value is only
+   * valid until the next call to `updateView` or until the tileset is
+   * destroyed, whichever comes first.
+   */
+  const ViewUpdateResult& updateView(
+      const std::vector<ViewState>& frustums,
+      const std::vector<ViewState>& predictedFrustums);
+
+  /**
+   * @brief Makes the next call to {@link updateView} traverse the tileset,
+   * even if {@link TilesetOptions::reuseSelectionForUnchangedViews} would
+   * allow it to reuse the previous selection.
+   *
+   * This needs to be called after changing the {@link TilesetOptions} or the
+   * excluders in a way that affects the tile selection.
+   */
+  void invalidatePreviousSelection() noexcept;
+
   /**
    * @brief Notifies the tileset that the given tile has started loading.
    * This method may be called from any thread.
@@ -211,12 +248,17 @@ public:
    * This function is not supposed to be called by clients.
    *
    * @param tile The tile for which the content is requested.
+   * @param cancellationToken The token with which the tileset cancels the
+   * load when the tile is no longer needed, see
+   * {@link TilesetOptions::enableLoadCancellation}.
    * @return A future that resolves when the content response is received, or
    * std::nullopt if this Tile has no content to load.
    */
   std::optional<
       CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>>
-  requestTileContent(Tile& tile);
+  requestTileContent(
+      Tile& tile,
+      const CesiumAsync::CancellationToken& cancellationToken);
 
   /**
    * @brief Add the given {@link TileContext} to this tile set.
@@ -240,6 +282,17 @@ public:
    */
   int64_t getTotalDataBytes() const noexcept;
 
+  /**
+   * @brief Gets the number of loads in progress, including the load of the
+   * tileset itself and the loads of tile content.
+   *
+   * Once this is zero after the tileset was constructed and
+   * {@link getRootTile} still returns `nullptr`, the tileset failed to load.
+   */
+  uint32_t getNumberOfLoadsInProgress() const noexcept {
+    return this->_loadsInProgress;
+  }
+
   /**
    * @brief Determines if this tileset supports raster overlays.
    *
@@ -407,8 +460,13 @@ private:
     int32_t currentFrameNumber;
   };
 
+  struct TraversalState;
+  struct ChildCulling;
+  class ParallelTraversalJob;
+
   TraversalDetails _renderLeaf(
       const FrameState& frameState,
+      TraversalState& state,
       Tile& tile,
       const std::vector<double>& distances,
       ViewUpdateResult& result);
@@ -423,6 +481,7 @@ private:
       bool areChildrenRenderable);
   bool _kickDescendantsAndRenderTile(
       const FrameState& frameState,
+      TraversalState& state,
       Tile& tile,
       ViewUpdateResult& result,
       TraversalDetails& traversalDetails,
@@ -431,27 +490,79 @@ private:
       size_t loadIndexMedium,
       size_t loadIndexHigh,
       bool queuedForLoad,
-      const std::vector<double>& distances);
+      const std::vector<double>& distances,
+      bool mayLoadInsteadOfDescendants);
 
   TraversalDetails _visitTile(
       const FrameState& frameState,
+      TraversalState& state,
       uint32_t depth,
       bool ancestorMeetsSse,
       Tile& tile,
       const std::vector<double>& distances,
+      const std::vector<ViewState::PlaneMask>& planeMasks,
       bool culled,
       ViewUpdateResult& result);
+
+  /**
+   * @brief Culls the given tile and visits it if it is not culled.
+   *
+   * @param pParentCulling The plane masks of, and distances to, the parent
+   * tile's children, as computed by {@link _cullChildren}, or `nullptr` to
+   * compute them for the given tile alone.
+   * @param childIndex The index of the given tile in its parent's children.
+   * Ignored if `pParentCulling` is `nullptr`.
+   */
   TraversalDetails _visitTileIfNeeded(
       const FrameState& frameState,
+      TraversalState& state,
       uint32_t depth,
       bool ancestorMeetsSse,
       Tile& tile,
+      const ChildCulling* pParentCulling,
+      size_t childIndex,
       ViewUpdateResult& result);
+
+  /**
+   * @brief Computes the plane masks of, and distances to, all children of the
+   * given tile in one batch.
+   *
+   * The children are only tested against the planes that are set in the
+   * given plane masks of the tile, unless
+   * {@link TilesetOptions::enableHierarchicalFrustumCulling} is disabled. The
+   * returned reference is valid until the traversal leaves the tile.
+   */
+  const ChildCulling& _cullChildren(
+      const FrameState& frameState,
+      TraversalState& state,
+      Tile& tile,
+      const std::vector<ViewState::PlaneMask>& planeMasks);
   TraversalDetails _visitVisibleChildrenNearToFar(
       const FrameState& frameState,
+      TraversalState& state,
       uint32_t depth,
       bool ancestorMeetsSse,
       Tile& tile,
+      const std::vector<ViewState::PlaneMask>& planeMasks,
+      ViewUpdateResult& result);
+
+  /**
+   * @brief Visits the children of the given tile concurrently, one subtree per
+   * child, and merges the results into the given state and result.
+   *
+   * This is used instead of {@link _visitVisibleChildrenNearToFar} when
+   * {@link TilesetOptions::enableParallelTraversal} is set and the traversal
+   * has reached {@link TilesetOptions::parallelTraversalDepth}. The subtrees
+   * are merged in the order of the children, so the render list and load
+   * queues are the same as if the children were visited one after another.
+   */
+  TraversalDetails _visitChildrenInParallel(
+      const FrameState& frameState,
+      TraversalState& state,
+      uint32_t depth,
+      bool ancestorMeetsSse,
+      Tile& tile,
+      const ChildCulling& childCulling,
       ViewUpdateResult& result);
 
   /**
@@ -461,6 +572,7 @@ private:
    * For replacement-refined tiles, this method does nothing and returns false.
    *
    * @param frameState The state of the current frame.
+   * @param state The state of the current traversal.
    * @param tile The tile to potentially load and render.
    * @param result The current view update result.
    * @param distance The distance to this tile, used to compute the load
@@ -471,6 +583,7 @@ private:
    */
   bool _loadAndRenderAdditiveRefinedTile(
       const FrameState& frameState,
+      TraversalState& state,
       Tile& tile,
       ViewUpdateResult& result,
       const std::vector<double>& distances);
@@ -488,6 +601,7 @@ private:
    * not-yet-renderable tiles to the load queue.
    *
    * @param frameState The state of the current frame.
+   * @param state The state of the current traversal.
    * @param tile The tile that is potentially being refined.
    * @param distance The distance to the tile.
    * @return true Some of the required children are not yet loaded, so this tile
@@ -497,6 +611,7 @@ private:
    */
   bool _queueLoadOfChildrenRequiredForRefinement(
       const FrameState& frameState,
+      TraversalState& state,
       Tile& tile,
       const std::vector<double>& distances);
   bool _meetsSse(
@@ -505,10 +620,95 @@ private:
       const std::vector<double>& distances,
       bool culled) const noexcept;
 
-  void _processLoadQueue();
+  /**
+   * @brief Returns whether a tile that is refined should be loaded, so that it
+   * can be rendered while its descendants are loading.
+   *
+   * This is always the case unless {@link TilesetOptions::skipLevelOfDetail}
+   * is true, in which case only the ancestors described there are loaded.
+   */
+  bool _shouldLoadRefinedTile(
+      const TraversalState& state,
+      uint32_t depth,
+      const Tile& tile,
+      double largestSse) const noexcept;
+
+  void _processLoadQueue(int32_t currentFrameNumber);
+
+  /**
+   * @brief Adds the tiles that would be rendered for the predicted views to
+   * the prefetch load records, and keeps them from being unloaded.
+   */
+  void _addTilesToPrefetchQueue(
+      const std::vector<ViewState>& predictedFrustums,
+      int32_t currentFrameNumber);
+
+  /**
+   * @brief Loads prefetched tiles in the load slots that are left after
+   * processing the other load queues.
+   */
+  void _processPrefetchQueue(
+      int32_t currentFrameNumber,
+      ViewUpdateResult& result);
+
+  /**
+   * @brief Counts the prefetched tiles that are rendered for the first time.
+   */
+  void _countPrefetchHits(ViewUpdateResult& result);
+
+  /**
+   * @brief Cancels the loads of the tiles that have not been needed for
+   * {@link TilesetOptions::loadCancellationFrames} frames, and of the raster
+   * overlay tiles that are no longer needed.
+   */
+  void _cancelUnneededLoads(int32_t currentFrameNumber);
+
+  /**
+   * @brief Returns the number of loads in progress that use a load slot,
+   * which excludes the canceled loads that have not ended yet.
+   */
+  uint32_t _getLoadSlotsInUse() const noexcept;
   void _unloadCachedTiles() noexcept;
   void _markTileVisited(Tile& tile) noexcept;
 
+  /**
+   * @brief Returns whether the selection of the last traversal can be reused
+   * for the given views.
+   *
+   * @see TilesetOptions::reuseSelectionForUnchangedViews
+   */
+  bool
+  _canReuseLastTraversal(const std::vector<ViewState>& frustums) const noexcept;
+
+  /**
+   * @brief Adds the credits of this tileset, its overlays, and the given
+   * rendered tiles to the current frame of the credit system.
+   */
+  void _addCreditsToFrame(const ViewUpdateResult& result);
+
+  /**
+   * @brief Marks a visited tile visited in the main thread, and counts it if
+   * it still has work to do.
+   */
+  void _markVisitedTile(
+      const FrameState& frameState,
+      TraversalState& state,
+      Tile& tile);
+
+  /**
+   * @brief Calls {@link Tile::update} for a tile that is being visited and
+   * marks it visited.
+   *
+   * Both of these need to happen in the main thread. When the given state
+   * belongs to a parallel subtree traversal, the tile is updated in the main
+   * thread by the {@link ParallelTraversalJob} if it needs it, and it is only
+   * marked visited later when the subtree is merged.
+   */
+  void _updateTileAndMarkVisited(
+      const FrameState& frameState,
+      TraversalState& state,
+      Tile& tile);
+
   std::string getResolvedContentUrl(const Tile& tile) const;
 
   std::vector<std::unique_ptr<TileContext>> _contexts;
@@ -533,6 +733,11 @@ private:
   int32_t _previousFrameNumber;
   ViewUpdateResult _updateResult;
 
+  // The views of the last traversal, and whether that traversal left nothing
+  // to do, so that its selection may be reused while the views stay the same.
+  std::vector<ViewState> _lastTraversalFrustums;
+  bool _lastTraversalSettled;
+
   struct LoadRecord {
     Tile* pTile;
 
@@ -542,17 +747,125 @@ private:
      * Lower priority values load sooner.
      */
     double priority;
+  };
+
+  /**
+   * @brief The plane masks of, and squared distances to, the children of a
+   * tile, for every frustum.
+   *
+   * Both vectors are indexed with `frustumIndex * childCount + childIndex`.
+   */
+  struct ChildCulling {
+    std::vector<ViewState::PlaneMask> planeMasks;
+    std::vector<double> distancesSquared;
+    size_t childCount = 0;
+  };
+
+  /**
+   * @brief The mutable state that is gathered while traversing the tile
+   * hierarchy.
+   *
+   * The tileset owns one instance that is used by the main thread. When
+   * {@link TilesetOptions::enableParallelTraversal} is set, each subtree that
+   * is visited in parallel gets its own instance, which is appended to the main
+   * one after the subtree has been visited.
+   */
+  struct TraversalState {
+    std::vector<LoadRecord> loadQueueHigh;
+    std::vector<LoadRecord> loadQueueMedium;
+    std::vector<LoadRecord> loadQueueLow;
+
+    // Holds computed distances, plane masks, and the culling results of the
+    // children, to avoid allocating them on the heap during tile selection.
+    // All stacks are indexed with nextDistancesVector.
+    std::vector<std::unique_ptr<std::vector<double>>> distancesStack;
+    std::vector<std::unique_ptr<std::vector<ViewState::PlaneMask>>>
+        planeMasksStack;
+    std::vector<std::unique_ptr<ChildCulling>> childCullingStack;
+    size_t nextDistancesVector = 0;
+
+    /**
+     * @brief Whether this state is used by a parallel subtree traversal.
+     *
+     * Such a traversal may be running in a worker thread, so it has its tiles
+     * updated by `pParallelTraversalJob` and records the tiles it visits in
+     * `visitedTiles` instead of marking them directly.
+     */
+    bool isWorker = false;
+
+    /**
+     * @brief The job of the parallel traversal that this state is used by,
+     * while it is running.
+     */
+    ParallelTraversalJob* pParallelTraversalJob = nullptr;
+
+    /**
+     * @brief The tiles that were visited by a parallel subtree traversal, in
+     * the order in which they were visited.
+     */
+    std::vector<Tile*> visitedTiles;
+
+    /**
+     * @brief The number of visited tiles that still have work to do in the
+     * main thread, such as attaching raster overlay tiles.
+     */
+    size_t unsettledTiles = 0;
+
+    /**
+     * @brief The largest screen-space error and the depth of the closest
+     * renderable ancestor of the tiles that are being visited, if there is
+     * one. Only tracked when {@link TilesetOptions::skipLevelOfDetail} is
+     * true.
+     */
+    std::optional<std::pair<double, uint32_t>> renderableAncestor;
+  };
 
-    bool operator<(const LoadRecord& rhs) const noexcept {
-      return this->priority < rhs.priority;
-    }
+  /**
+   * @brief The state and results of one subtree of a parallel traversal.
+   */
+  struct SubtreeTraversal {
+    TraversalState state;
+    ViewUpdateResult result;
+    TraversalDetails details;
   };
 
-  std::vector<LoadRecord> _loadQueueHigh;
-  std::vector<LoadRecord> _loadQueueMedium;
-  std::vector<LoadRecord> _loadQueueLow;
+  TraversalState _traversalState;
+
+  // The tiles to load, in the order of their priority. They are kept from
+  // frame to frame and updated from the load queues of the traversal state.
+  TileLoadQueue _loadQueueHigh;
+  TileLoadQueue _loadQueueMedium;
+  TileLoadQueue _loadQueueLow;
+
+  // The tiles for the predicted views, which are only loaded when there are
+  // load slots to spare, and the prefetched tiles that were not rendered yet.
+  std::vector<LoadRecord> _prefetchRecords;
+  TileLoadQueue _loadQueuePrefetch;
+  std::unordered_set<const Tile*> _prefetchedTiles;
+  uint64_t _prefetchedTileCount;
+  uint64_t _prefetchHitCount;
+
+  // Reused from frame to frame to avoid reallocating the per-subtree buffers.
+  std::vector<std::unique_ptr<SubtreeTraversal>> _subtreeTraversals;
+
   std::atomic<uint32_t> _loadsInProgress; // TODO: does this need to be atomic?
 
+  struct CancelableLoad {
+    CesiumAsync::CancellationToken token;
+
+    // The last frame in which the tile was needed for the predicted views.
+    int32_t lastPrefetchFrameNumber;
+  };
+
+  // The content loads in progress that may be canceled. Only tracked when
+  // TilesetOptions::enableLoadCancellation is true.
+  std::unordered_map<Tile*, CancelableLoad> _cancelableLoads;
+
+  // The canceled loads that have not ended yet. They still count as loads in
+  // progress, so that the tileset waits for them when it is destroyed, but
+  // their load slots are already free.
+  std::unordered_set<Tile*> _canceledLoads;
+
   Tile::LoadedLinkedList _loadedTiles;
 
   RasterOverlayCollection _overlays;
@@ -573,11 +886,6 @@ private:
    */
   CesiumGeometry::Axis _gltfUpAxis;
 
-  // Holds computed distances, to avoid allocating them on the heap during tile
-  // selection.
-  std::vector<std::unique_ptr<std::vector<double>>> _distancesStack;
-  size_t _nextDistancesVector;
-
   CESIUM_TRACE_DECLARE_TRACK_SET(_loadingSlots, "Tileset Loading Slot");
 
   static void addTileToLoadQueue(
@@ -586,8 +894,9 @@ private:
       Tile& tile,
       const std::vector<double>& distances);
   void processQueue(
-      std::vector<Tileset::LoadRecord>& queue,
-      const std::atomic<uint32_t>& loadsInProgress,
+      TileLoadQueue& queue,
+      const std::vector<Tileset::LoadRecord>& records,
+      int32_t currentFrameNumber,
       uint32_t maximumLoadsInProgress);
 
   Tileset(const Tileset& rhs) = delete;
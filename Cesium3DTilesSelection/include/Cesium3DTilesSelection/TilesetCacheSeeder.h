@@ -0,0 +1,228 @@
+#pragma once
+
+#include "Library.h"
+#include "TilesetExternals.h"
+
+#include <CesiumGeospatial/CartographicPolygon.h>
+#include <CesiumGeospatial/GlobeRectangle.h>
+#include <CesiumUtility/Math.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Cesium3DTilesSelection {
+class Tileset;
+
+/**
+ * @brief Options for a {@link TilesetCacheSeeder}.
+ */
+struct CESIUM3DTILESSELECTION_API TilesetCacheSeederOptions {
+  /**
+   * @brief The screen-space error, in pixels, at which tiles are no longer
+   * refined.
+   *
+   * Together with the {@link viewDistance}, {@link viewportHeight} and
+   * {@link verticalFieldOfView}, this determines the geometric error of the
+   * finest tiles that are loaded.
+   */
+  double maximumScreenSpaceError = 16.0;
+
+  /**
+   * @brief The closest distance, in meters, from which the region will be
+   * viewed.
+   */
+  double viewDistance = 1000.0;
+
+  /**
+   * @brief The height of the viewport, in pixels.
+   */
+  double viewportHeight = 1080.0;
+
+  /**
+   * @brief The vertical field of view, in radians.
+   */
+  double verticalFieldOfView = CesiumUtility::Math::degreesToRadians(60.0);
+
+  /**
+   * @brief The deepest level of the tile hierarchy to load, where the root
+   * tile is level 0.
+   *
+   * If not set, the depth is only limited by the screen-space error.
+   */
+  std::optional<int32_t> maximumDepth;
+
+  /**
+   * @brief The maximum number of tiles that are loaded at the same time.
+   *
+   * The requests for raster overlay tiles are limited separately, by
+   * {@link RasterOverlayOptions::maximumSimultaneousTileLoads}.
+   */
+  uint32_t maximumSimultaneousTileLoads = 64;
+
+  /**
+   * @brief The path of a file where completed subtrees are recorded.
+   *
+   * If the file exists, the subtrees recorded in it are skipped, so an
+   * interrupted run continues where it stopped. If empty, the progress is
+   * not recorded.
+   */
+  std::string resumeFile;
+};
+
+/**
+ * @brief The progress of a {@link TilesetCacheSeeder}.
+ */
+struct CESIUM3DTILESSELECTION_API TilesetCacheSeederProgress {
+  /**
+   * @brief The number of tiles whose content was loaded.
+   */
+  int64_t tilesLoaded = 0;
+
+  /**
+   * @brief The number of tiles whose content failed to load.
+   */
+  int64_t tilesFailed = 0;
+
+  /**
+   * @brief The number of tiles that are being loaded.
+   */
+  int64_t tilesLoading = 0;
+
+  /**
+   * @brief The number of tiles that are waiting to be loaded.
+   */
+  int64_t tilesQueued = 0;
+
+  /**
+   * @brief The number of subtrees that were skipped because they were
+   * completed by a previous run.
+   */
+  int64_t subtreesSkipped = 0;
+
+  /**
+   * @brief The number of completed requests, including those for the tileset
+   * and for raster overlays.
+   */
+  int64_t requests = 0;
+
+  /**
+   * @brief The number of bytes received in the completed requests.
+   */
+  int64_t bytesReceived = 0;
+
+  /**
+   * @brief Whether the tileset itself, or its root tile, failed to load.
+   */
+  bool tilesetFailed = false;
+};
+
+/**
+ * @brief Loads all tiles of a tileset that overlap a region, down to a target
+ * screen-space error, so that they are stored in a cache.
+ *
+ * The tiles are requested through the asset accessor of the externals, which
+ * would usually be a {@link CesiumAsync::CachingAssetAccessor}, so the
+ * responses are stored in its cache and a later visit of the region can be
+ * served from the cache. Renderer resources are never created; the
+ * {@link IPrepareRendererResources} of the externals is not used.
+ *
+ * The hierarchy is walked depth-first, and the content of a subtree is
+ * unloaded as soon as all of its tiles are loaded, so the loaded content does
+ * not grow with the size of the region. Raster overlays added to the
+ * {@link getTileset} are loaded for each tile as well.
+ *
+ * All methods must be called from the main thread. Call {@link update}
+ * repeatedly until it returns `true`.
+ */
+class CESIUM3DTILESSELECTION_API TilesetCacheSeeder final {
+public:
+  /**
+   * @brief Constructs a new instance for the tileset at the given URL.
+   *
+   * @param externals The external interfaces to use.
+   * @param url The URL of the `tileset.json` or `layer.json`.
+   * @param region The polygons defining the region to load.
+   * @param options The options for loading the region.
+   * @throws std::runtime_error If the resume file cannot be opened.
+   */
+  TilesetCacheSeeder(
+      const TilesetExternals& externals,
+      const std::string& url,
+      const std::vector<CesiumGeospatial::CartographicPolygon>& region,
+      const TilesetCacheSeederOptions& options = {});
+
+  /**
+   * @brief Constructs a new instance for the given asset on <a
+   * href="https://cesium.com/ion/">Cesium ion</a>.
+   *
+   * @param externals The external interfaces to use.
+   * @param ionAssetID The ID of the Cesium ion asset to use.
+   * @param ionAccessToken The Cesium ion access token authorizing access to
+   * the asset.
+   * @param region The polygons defining the region to load.
+   * @param options The options for loading the region.
+   * @throws std::runtime_error If the resume file cannot be opened.
+   */
+  TilesetCacheSeeder(
+      const TilesetExternals& externals,
+      uint32_t ionAssetID,
+      const std::string& ionAccessToken,
+      const std::vector<CesiumGeospatial::CartographicPolygon>& region,
+      const TilesetCacheSeederOptions& options = {});
+
+  /**
+   * @brief Waits for the loads in progress to complete, and destroys the
+   * tileset.
+   */
+  ~TilesetCacheSeeder();
+
+  /**
+   * @brief Creates a polygon covering the given rectangle, to use as a
+   * region.
+   */
+  static CesiumGeospatial::CartographicPolygon
+  createPolygon(const CesiumGeospatial::GlobeRectangle& rectangle);
+
+  /**
+   * @brief Gets the tileset being loaded.
+   *
+   * Raster overlays to load along with the tiles can be added to its
+   * {@link Tileset::getOverlays} before the first call to {@link update}.
+   */
+  Tileset& getTileset() noexcept;
+
+  /** @copydoc getTileset */
+  const Tileset& getTileset() const noexcept;
+
+  /**
+   * @brief Dispatches the main thread tasks, and starts the loads of further
+   * tiles.
+   *
+   * @return Whether all tiles in the region are loaded, or the tileset failed
+   * to load.
+   */
+  bool update();
+
+  /**
+   * @brief Returns whether all tiles in the region are loaded, or the tileset
+   * failed to load.
+   */
+  bool isDone() const noexcept;
+
+  /**
+   * @brief Gets the progress as of the last call to {@link update}.
+   */
+  const TilesetCacheSeederProgress& getProgress() const noexcept;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _pImpl;
+
+  TilesetCacheSeeder(const TilesetCacheSeeder& rhs) = delete;
+  TilesetCacheSeeder& operator=(const TilesetCacheSeeder& rhs) = delete;
+};
+
+} // namespace Cesium3DTilesSelection
@@ -14,6 +14,7 @@ class ITaskProcessor;
 
 namespace Cesium3DTilesSelection {
 class CreditSystem;
+class DecodedContentCache;
 class IPrepareRendererResources;
 
 /**
@@ -55,6 +56,14 @@ public:
    * If not specified, defaults to `spdlog::default_logger()`.
    */
   std::shared_ptr<spdlog::logger> pLogger = spdlog::default_logger();
+
+  /**
+   * @brief An optional {@link DecodedContentCache}, from which the models of
+   * tiles are taken instead of decoding their content again.
+   *
+   * If not specified, the content of every tile is decoded when it is loaded.
+   */
+  std::shared_ptr<DecodedContentCache> pDecodedContentCache;
 };
 
 } // namespace Cesium3DTilesSelection
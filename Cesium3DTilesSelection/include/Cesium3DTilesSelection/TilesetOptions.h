@@ -2,6 +2,8 @@
 
 #include "Library.h"
 
+#include <CesiumGltf/ReadImageOptions.h>
+
 #include <memory>
 #include <optional>
 #include <string>
@@ -35,6 +37,41 @@ struct CESIUM3DTILESSELECTION_API TilesetContentOptions {
    * normals.
    */
   bool generateMissingNormalsSmooth = false;
+
+  /**
+   * @brief Options for how the images of glTF and batched 3D model content
+   * are decoded.
+   *
+   * By default, the images are expanded to four channels with 8 bits each.
+   * Keeping the channels of the files reduces the memory used by the images,
+   * as long as the {@link IPrepareRendererResources} supports them.
+   */
+  CesiumGltf::ReadImageOptions imageOptions;
+
+  /**
+   * @brief Whether to generate the mip levels of the images of glTF and
+   * batched 3D model content in a worker thread.
+   *
+   * The levels are stored in the {@link CesiumGltf::ImageCesium::pixelData}
+   * and {@link CesiumGltf::ImageCesium::mipPositions} of each image that
+   * {@link CesiumGltf::ImageManipulation::generateMipmaps} supports, so the
+   * {@link IPrepareRendererResources} can upload them instead of generating
+   * them on the GPU. They take a third more memory.
+   */
+  bool generateMipmaps = false;
+
+  /**
+   * @brief Whether the models of glTF and batched 3D model content refer to
+   * the binary chunk of the response instead of copying it.
+   *
+   * The model then keeps the response alive, and the data of its first buffer
+   * is in {@link CesiumGltf::BufferCesium::externalData}, so the
+   * {@link IPrepareRendererResources} must read buffers with
+   * {@link CesiumGltf::BufferCesium::getData}.
+   *
+   * @see CesiumGltf::ReadModelOptions::referenceBinaryChunk
+   */
+  bool referenceGlbBinaryChunk = false;
 };
 
 /**
@@ -77,6 +114,26 @@ struct CESIUM3DTILESSELECTION_API TilesetOptions {
    */
   uint32_t maximumSimultaneousTileLoads = 20;
 
+  /**
+   * @brief Whether to cancel the loads of tiles that are no longer needed.
+   *
+   * After a fast camera movement, the load slots (see
+   * {@link maximumSimultaneousTileLoads}) may be taken by tiles that are no
+   * longer visible. When this is true, the load of a tile that has not been
+   * selected or refined for {@link loadCancellationFrames} frames is canceled,
+   * and the tile returns to the unloaded state. Raster overlay tiles that are
+   * loading for tiles that no longer need them are canceled as well.
+   */
+  bool enableLoadCancellation = false;
+
+  /**
+   * @brief The number of frames for which a loading tile must be unneeded
+   * before its load is canceled.
+   *
+   * Only used when {@link enableLoadCancellation} is true.
+   */
+  int32_t loadCancellationFrames = 5;
+
   /**
    * @brief Indicates whether the ancestors of rendered tiles should be
    * preloaded. Setting this to true optimizes the zoom-out experience and
@@ -118,11 +175,68 @@ struct CESIUM3DTILESSELECTION_API TilesetOptions {
    */
   bool forbidHoles = false;
 
+  /**
+   * @brief Whether to skip loading intermediate levels of detail of tiles
+   * with replacement refinement.
+   *
+   * Normally, a tile with too many loading descendants is loaded instead of
+   * them (see {@link loadingDescendantLimit}), so that a deep hierarchy is
+   * loaded one level after another. When this is true, the traversal instead
+   * keeps loading the tiles that meet the screen-space error and only loads
+   * the following ancestors, which are rendered while the descendants are
+   * not ready yet:
+   *
+   *  - Tiles with a screen-space error of at least
+   *    {@link baseScreenSpaceError}, which provide coarse coverage.
+   *  - Tiles whose screen-space error is less than that of their closest
+   *    renderable ancestor divided by {@link skipScreenSpaceErrorFactor}, and
+   *    that are more than {@link skipLevels} levels below that ancestor.
+   *
+   * This reduces the number of requests and the time until the full detail is
+   * shown on large hierarchies. Tiles are never rendered on top of each other,
+   * so parts of the view may be shown in less detail until all of the needed
+   * descendants are loaded. This has little effect when {@link forbidHoles}
+   * is true, because that already requires every level to be loaded.
+   */
+  bool skipLevelOfDetail = false;
+
+  /**
+   * @brief The screen-space error that a tile must at least have to always be
+   * loaded when {@link skipLevelOfDetail} is true.
+   */
+  double baseScreenSpaceError = 1024.0;
+
+  /**
+   * @brief The factor by which the screen-space error of a tile must be
+   * smaller than that of its closest renderable ancestor for the tile to be
+   * loaded when {@link skipLevelOfDetail} is true.
+   */
+  double skipScreenSpaceErrorFactor = 16.0;
+
+  /**
+   * @brief The number of levels below its closest renderable ancestor that a
+   * tile must at least be for it to be loaded when {@link skipLevelOfDetail}
+   * is true.
+   */
+  uint32_t skipLevels = 1;
+
   /**
    * @brief Enable culling of tiles against the frustum.
    */
   bool enableFrustumCulling = true;
 
+  /**
+   * @brief Whether frustum culling tests a tile only against the planes that
+   * its parent's bounding volume intersects.
+   *
+   * A tile whose parent is entirely inside a frustum plane is also inside that
+   * plane, as long as the parent's bounding volume encloses the child's, so
+   * the test against that plane can be skipped. This saves most plane tests
+   * in the interior of the view. Disable this for tilesets whose child
+   * bounding volumes are not contained in their parents'.
+   */
+  bool enableHierarchicalFrustumCulling = true;
+
   /**
    * @brief Enable culling of tiles that cannot be seen through atmospheric fog.
    */
@@ -192,6 +306,64 @@ struct CESIUM3DTILESSELECTION_API TilesetOptions {
    */
   bool renderTilesUnderCamera = true;
 
+  /**
+   * @brief Whether to split the tile selection traversal across worker
+   * threads.
+   *
+   * When true, the subtrees below {@link parallelTraversalDepth} are visited
+   * concurrently in the worker threads of the tileset's
+   * {@link CesiumAsync::AsyncSystem}, each with its own render list and load
+   * queues. These are merged in the order in which the serial traversal would
+   * have produced them, so the same tiles are selected.
+   *
+   * A worker thread that visits a tile that needs a {@link Tile::update} has
+   * the main thread update it and waits, so each tile is updated before it is
+   * used, as in the serial traversal. The {@link excluders} must be safe to
+   * call from multiple threads at once.
+   */
+  bool enableParallelTraversal = false;
+
+  /**
+   * @brief The number of worker threads that help the main thread with a
+   * parallel traversal.
+   *
+   * Each helper is a task of the tileset's {@link CesiumAsync::AsyncSystem},
+   * so this should not be more than the number of threads of its task
+   * processor. Only used when {@link enableParallelTraversal} is true.
+   */
+  uint32_t parallelTraversalHelperThreads = 3;
+
+  /**
+   * @brief The depth in the tile hierarchy at which the traversal is split
+   * into subtrees that are visited in parallel.
+   *
+   * The tiles above this depth are visited in the main thread. When the main
+   * thread reaches a tile that has more than one child at this depth or
+   * deeper, the subtrees of these children are visited in parallel. The root
+   * tile is at depth 0. Only used when {@link enableParallelTraversal} is
+   * true.
+   */
+  uint32_t parallelTraversalDepth = 2;
+
+  /**
+   * @brief Whether {@link Tileset::updateView} returns the tile selection of
+   * the previous frame without traversing the tileset, when the views did not
+   * change.
+   *
+   * This is meant for views that stay in place, such as those of kiosks and
+   * monitoring displays. The selection is reused when all views are exactly
+   * the same as in the last traversal and that traversal left nothing to do:
+   * no tiles were waiting to be loaded or still loading, and all raster
+   * overlay tiles were attached. The reused selection is therefore the same as
+   * the one a new traversal would return. Such frames only cost a comparison
+   * of the views. Any change to a view, and any load that is started or
+   * completes, leads to a traversal of the whole tileset.
+   *
+   * Changes to these options or to the {@link excluders} are not detected, so
+   * call {@link Tileset::invalidatePreviousSelection} after making them.
+   */
+  bool reuseSelectionForUnchangedViews = false;
+
   /**
    * @brief A list of interfaces that are given an opportunity to exclude tiles
    * from loading and rendering. If any of the excluders indicate that a tile
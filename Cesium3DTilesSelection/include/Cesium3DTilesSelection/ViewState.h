@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BoundingVolume.h"
+#include "BoundingVolumeBatch.h"
 #include "Library.h"
 
 #include <CesiumGeometry/CullingVolume.h>
@@ -10,7 +11,10 @@
 #include <glm/mat3x3.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <gsl/span>
 
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -24,6 +28,38 @@ class CESIUM3DTILESSELECTION_API ViewState final {
 
   // TODO: Add support for orthographic and off-center perspective frustums
 public:
+  /**
+   * @brief A bit mask of the planes of the culling volume of a view state that
+   * a bounding volume still needs to be tested against.
+   *
+   * Bit 0 to 5 stand for the left, right, top, bottom, near and far plane. A
+   * bit that is not set means that the bounding volume is entirely on the
+   * inside of that plane. Because the bounding volumes of child tiles are
+   * enclosed by the bounding volume of their parent, the children do not need
+   * to be tested against these planes again.
+   *
+   * @see computePlaneMask
+   */
+  using PlaneMask = uint32_t;
+
+  /**
+   * @brief The plane mask of a bounding volume that is entirely inside the
+   * culling volume.
+   */
+  static constexpr PlaneMask PLANE_MASK_INSIDE = 0x00;
+
+  /**
+   * @brief The plane mask of a bounding volume for which nothing is known
+   * yet, so that it needs to be tested against all planes.
+   */
+  static constexpr PlaneMask PLANE_MASK_INDETERMINATE = 0x3f;
+
+  /**
+   * @brief The plane mask of a bounding volume that is entirely outside the
+   * culling volume.
+   */
+  static constexpr PlaneMask PLANE_MASK_OUTSIDE = 0xffffffff;
+
   /**
    * @brief Creates a new instance of a view state.
    *
@@ -39,6 +75,10 @@ public:
    * {@link ViewState#getPositionCartographic cartographic position}
    * from the cartesian position.
    * Default value: {@link CesiumGeospatial::Ellipsoid::WGS84}.
+   * @param nearDistance The distance of the near plane from the camera
+   * position, or `std::nullopt` to not cull against a near plane.
+   * @param farDistance The distance of the far plane from the camera
+   * position, or `std::nullopt` to not cull against a far plane.
    */
   static ViewState create(
       const glm::dvec3& position,
@@ -48,7 +88,30 @@ public:
       double horizontalFieldOfView,
       double verticalFieldOfView,
       const CesiumGeospatial::Ellipsoid& ellipsoid =
-          CesiumGeospatial::Ellipsoid::WGS84);
+          CesiumGeospatial::Ellipsoid::WGS84,
+      const std::optional<double>& nearDistance = std::nullopt,
+      const std::optional<double>& farDistance = std::nullopt);
+
+  /**
+   * @brief Creates the view state that this camera is predicted to have after
+   * moving with a constant velocity for the given time.
+   *
+   * The orientation, viewport, field of view, and near and far distances stay
+   * the same. This can be used to create the predicted views that are passed
+   * to {@link Tileset::updateView} for prefetching.
+   *
+   * @param velocity The velocity of the camera, in meters per second.
+   * @param seconds The time after which to predict the view, in seconds.
+   * @param ellipsoid The ellipsoid that will be used to compute the
+   * {@link ViewState#getPositionCartographic cartographic position}
+   * from the cartesian position.
+   * @return The predicted view state.
+   */
+  ViewState extrapolate(
+      const glm::dvec3& velocity,
+      double seconds,
+      const CesiumGeospatial::Ellipsoid& ellipsoid =
+          CesiumGeospatial::Ellipsoid::WGS84) const;
 
   /**
    * @brief Gets the position of the camera in Earth-centered, Earth-fixed
@@ -100,6 +163,22 @@ public:
     return this->_verticalFieldOfView;
   }
 
+  /**
+   * @brief Gets the distance of the near plane from the camera position, if
+   * the view state has a near plane.
+   */
+  const std::optional<double>& getNearDistance() const noexcept {
+    return this->_nearDistance;
+  }
+
+  /**
+   * @brief Gets the distance of the far plane from the camera position, if
+   * the view state has a far plane.
+   */
+  const std::optional<double>& getFarDistance() const noexcept {
+    return this->_farDistance;
+  }
+
   /**
    * @brief Returns whether the given {@link BoundingVolume} is visible for this
    * camera
@@ -113,6 +192,50 @@ public:
   bool
   isBoundingVolumeVisible(const BoundingVolume& boundingVolume) const noexcept;
 
+  /**
+   * @brief Computes the {@link PlaneMask} of the given {@link BoundingVolume}.
+   *
+   * The bounding volume is only tested against the planes that are set in the
+   * given parent mask. This is usually the mask that was computed for the
+   * bounding volume of the parent tile, which encloses the given bounding
+   * volume. If the parent mask is {@link PLANE_MASK_OUTSIDE}, the bounding
+   * volume is tested against all planes.
+   *
+   * @param boundingVolume The bounding volume.
+   * @param parentPlaneMask The mask of the planes to test against.
+   * @return The mask of the planes that the bounding volume intersects, or
+   * {@link PLANE_MASK_OUTSIDE} if it is outside of any of the tested planes.
+   */
+  PlaneMask computePlaneMask(
+      const BoundingVolume& boundingVolume,
+      PlaneMask parentPlaneMask = PLANE_MASK_INDETERMINATE) const noexcept;
+
+  /**
+   * @brief Computes the {@link PlaneMask} of, and the squared distance to,
+   * each bounding volume of the given batch.
+   *
+   * This gives the same results as calling {@link computePlaneMask} and
+   * {@link computeDistanceSquaredToBoundingVolume} for each bounding volume,
+   * except that oriented bounding boxes that exactly touch a plane from the
+   * outside are considered to intersect it. The bounding volumes are
+   * processed as contiguous arrays without dispatching on their type, so that
+   * the compiler can vectorize the tests.
+   *
+   * @param boundingVolumes The bounding volumes.
+   * @param parentPlaneMask The mask of the planes to test against, which is
+   * usually the mask of the bounding volume enclosing all of the given ones.
+   * @param planeMasks Receives the plane mask of each bounding volume. Must
+   * have at least as many elements as there are bounding volumes.
+   * @param distancesSquared Receives the squared distance to each bounding
+   * volume. Must have at least as many elements as there are bounding
+   * volumes.
+   */
+  void computePlaneMasksAndDistancesSquared(
+      const BoundingVolumeBatch& boundingVolumes,
+      PlaneMask parentPlaneMask,
+      gsl::span<PlaneMask> planeMasks,
+      gsl::span<double> distancesSquared) const noexcept;
+
   /**
    * @brief Computes the squared distance to the given {@link BoundingVolume}.
    *
@@ -154,6 +277,8 @@ private:
    * angle of the camera, in radians.
    * @param verticalFieldOfView The vertical field-of-view (opening)
    * angle of the camera, in radians.
+   * @param nearDistance The distance of the near plane, if any.
+   * @param farDistance The distance of the far plane, if any.
    */
   ViewState(
       const glm::dvec3& position,
@@ -162,8 +287,9 @@ private:
       const glm::dvec2& viewportSize,
       double horizontalFieldOfView,
       double verticalFieldOfView,
-      const std::optional<CesiumGeospatial::Cartographic>&
-          positionCartographic);
+      const std::optional<CesiumGeospatial::Cartographic>& positionCartographic,
+      const std::optional<double>& nearDistance,
+      const std::optional<double>& farDistance);
 
   const glm::dvec3 _position;
   const glm::dvec3 _direction;
@@ -171,6 +297,8 @@ private:
   const glm::dvec2 _viewportSize;
   const double _horizontalFieldOfView;
   const double _verticalFieldOfView;
+  const std::optional<double> _nearDistance;
+  const std::optional<double> _farDistance;
 
   const double _sseDenominator;
   const std::optional<CesiumGeospatial::Cartographic> _positionCartographic;
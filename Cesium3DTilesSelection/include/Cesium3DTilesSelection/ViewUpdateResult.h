@@ -2,6 +2,7 @@
 
 #include "Library.h"
 
+#include <cstdint>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -31,6 +32,35 @@ public:
    */
   std::vector<Tile*> tilesToNoLongerRenderThisFrame;
 
+  /**
+   * @brief Whether the tile selection of the previous frame was reused
+   * without traversing the tileset.
+   *
+   * In this case, the remaining statistics are those of the last frame in
+   * which the tileset was traversed.
+   *
+   * @see TilesetOptions::reuseSelectionForUnchangedViews
+   */
+  bool reusedPreviousSelection = false;
+
+  /**
+   * @brief The number of tile loads that were started this frame for the
+   * predicted views passed to {@link Tileset::updateView}.
+   */
+  uint32_t tilesPrefetched = 0;
+
+  /**
+   * @brief The number of prefetched tiles that were rendered for the first
+   * time this frame.
+   */
+  uint32_t prefetchHits = 0;
+
+  /**
+   * @brief The fraction of all prefetched tiles so far that were rendered
+   * before they were unloaded, or 0.0 if no tiles were prefetched yet.
+   */
+  double prefetchHitRate = 0.0;
+
   //! @cond Doxygen_Suppress
   uint32_t tilesLoadingLowPriority = 0;
   uint32_t tilesLoadingMediumPriority = 0;
@@ -4,6 +4,7 @@
 #include "Cesium3DTilesSelection/spdlog-cesium.h"
 #include "upgradeBatchTableToFeatureMetadata.h"
 
+#include <CesiumAsync/IAssetRequest.h>
 #include <CesiumAsync/IAssetResponse.h>
 #include <CesiumGltf/ModelEXT_feature_metadata.h>
 #include <CesiumUtility/Tracing.h>
@@ -77,19 +78,14 @@ rapidjson::Document parseFeatureTableJsonData(
   return document;
 }
 
-} // namespace
-
-CesiumAsync::Future<std::unique_ptr<TileContentLoadResult>>
-Batched3DModelContent::load(const TileContentLoadInput& input) {
-  return input.asyncSystem.createResolvedFuture(load(
-      input.pLogger,
-      input.pRequest->url(),
-      input.pRequest->response()->data()));
-}
+struct B3dmLayout {
+  B3dmHeader header;
+  uint32_t headerLength;
+  gsl::span<const std::byte> glbData;
+};
 
-std::unique_ptr<TileContentLoadResult> Batched3DModelContent::load(
+B3dmLayout parseB3dmLayout(
     const std::shared_ptr<spdlog::logger>& pLogger,
-    const std::string& url,
     const gsl::span<const std::byte>& data) {
   // TODO: actually use the b3dm payload
   if (data.size() < sizeof(B3dmHeader)) {
@@ -97,7 +93,6 @@ std::unique_ptr<TileContentLoadResult> Batched3DModelContent::load(
                              "include a B3DM header.");
   }
 
-  CESIUM_TRACE("Cesium3DTilesSelection::Batched3DModelContent::load");
   const B3dmHeader* pHeader = reinterpret_cast<const B3dmHeader*>(data.data());
 
   B3dmHeader header = *pHeader;
@@ -177,14 +172,21 @@ std::unique_ptr<TileContentLoadResult> Batched3DModelContent::load(
                              "glTF model is after the end of the entire B3DM.");
   }
 
-  const gsl::span<const std::byte> glbData =
-      data.subspan(glbStart, glbEnd - glbStart);
-  std::unique_ptr<TileContentLoadResult> pResult =
-      GltfContent::load(pLogger, url, glbData);
-
-  if (pResult->model && header.featureTableJsonByteLength > 0) {
-    CesiumGltf::Model& gltf = pResult->model.value();
+  B3dmLayout layout;
+  layout.header = header;
+  layout.headerLength = headerLength;
+  layout.glbData = data.subspan(glbStart, glbEnd - glbStart);
+  return layout;
+}
 
+void addFeatureMetadata(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    CesiumGltf::Model& gltf,
+    const gsl::span<const std::byte>& data,
+    const B3dmLayout& layout) {
+  const B3dmHeader& header = layout.header;
+  const uint32_t headerLength = layout.headerLength;
+  if (header.featureTableJsonByteLength > 0) {
     const gsl::span<const std::byte> featureTableJsonData =
         data.subspan(headerLength, header.featureTableJsonByteLength);
     rapidjson::Document featureTable =
@@ -217,7 +219,7 @@ std::unique_ptr<TileContentLoadResult> Batched3DModelContent::load(
             "{}. Skip parsing metadata",
             batchTableJson.GetParseError(),
             batchTableJson.GetErrorOffset());
-        return pResult;
+        return;
       }
 
       upgradeBatchTableToFeatureMetadata(
@@ -228,6 +230,53 @@ std::unique_ptr<TileContentLoadResult> Batched3DModelContent::load(
           batchTableBinaryData);
     }
   }
+}
+
+} // namespace
+
+CesiumAsync::Future<std::unique_ptr<TileContentLoadResult>>
+Batched3DModelContent::load(const TileContentLoadInput& input) {
+  CESIUM_TRACE("Cesium3DTilesSelection::Batched3DModelContent::load");
+  const std::shared_ptr<spdlog::logger>& pLogger = input.pLogger;
+  const std::shared_ptr<CesiumAsync::IAssetRequest>& pRequest =
+      input.pRequest;
+  const B3dmLayout layout =
+      parseB3dmLayout(pLogger, pRequest->response()->data());
+
+  return GltfContent::load(
+             input.asyncSystem,
+             pLogger,
+             pRequest->url(),
+             layout.glbData,
+             pRequest,
+             input.contentOptions)
+      .thenImmediately(
+          [pLogger, pRequest, layout](
+              std::unique_ptr<TileContentLoadResult>&& pResult) {
+            if (pResult->model) {
+              addFeatureMetadata(
+                  pLogger,
+                  pResult->model.value(),
+                  pRequest->response()->data(),
+                  layout);
+            }
+            return std::move(pResult);
+          });
+}
+
+std::unique_ptr<TileContentLoadResult> Batched3DModelContent::load(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    const std::string& url,
+    const gsl::span<const std::byte>& data,
+    const std::shared_ptr<const void>& pDataOwner) {
+  CESIUM_TRACE("Cesium3DTilesSelection::Batched3DModelContent::load");
+  const B3dmLayout layout = parseB3dmLayout(pLogger, data);
+
+  std::unique_ptr<TileContentLoadResult> pResult =
+      GltfContent::load(pLogger, url, layout.glbData, pDataOwner);
+  if (pResult->model) {
+    addFeatureMetadata(pLogger, pResult->model.value(), data, layout);
+  }
 
   return pResult;
 }
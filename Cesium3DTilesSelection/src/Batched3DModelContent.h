@@ -38,6 +38,9 @@ public:
    * @param pLogger Only used for logging
    * @param url The URL, only used for logging
    * @param data The actual B3DM data
+   * @param pDataOwner The object that keeps the `data` alive, such as the
+   * request that holds it. If given, the model refers to the binary chunk of
+   * the embedded GLB instead of copying it, and keeps the owner alive.
    * @return The {@link TileContentLoadResult}, or `nullptr` if the
    * data cannot be loaded. The returned result will *only* contain
    * the `model`. All other properties will be uninitialized.
@@ -45,7 +48,8 @@ public:
   static std::unique_ptr<TileContentLoadResult> load(
       const std::shared_ptr<spdlog::logger>& pLogger,
       const std::string& url,
-      const gsl::span<const std::byte>& data);
+      const gsl::span<const std::byte>& data,
+      const std::shared_ptr<const void>& pDataOwner = nullptr);
 };
 
 } // namespace Cesium3DTilesSelection
@@ -0,0 +1,94 @@
+#include "Cesium3DTilesSelection/BoundingVolumeBatch.h"
+
+#include <glm/geometric.hpp>
+
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+
+namespace Cesium3DTilesSelection {
+
+void BoundingVolumeBatch::clear() noexcept {
+  for (size_t i = 0; i < 3; ++i) {
+    this->_centers[i].clear();
+    this->_halfLengths[i].clear();
+    for (std::vector<double>& component : this->_axes[i]) {
+      component.clear();
+    }
+  }
+  this->_radii.clear();
+  this->_exactDistanceVolumes.clear();
+}
+
+void BoundingVolumeBatch::reserve(size_t count) {
+  for (size_t i = 0; i < 3; ++i) {
+    this->_centers[i].reserve(count);
+    this->_halfLengths[i].reserve(count);
+    for (std::vector<double>& component : this->_axes[i]) {
+      component.reserve(count);
+    }
+  }
+  this->_radii.reserve(count);
+}
+
+void BoundingVolumeBatch::add(const BoundingVolume& boundingVolume) {
+  struct Operation {
+    BoundingVolumeBatch& batch;
+
+    void operator()(const OrientedBoundingBox& boundingBox) {
+      batch.addBox(boundingBox.getCenter(), boundingBox.getHalfAxes(), 0.0);
+    }
+
+    void operator()(const BoundingRegion& boundingRegion) {
+      batch._exactDistanceVolumes.emplace_back(batch.size(), boundingRegion);
+      const OrientedBoundingBox& boundingBox = boundingRegion.getBoundingBox();
+      batch.addBox(boundingBox.getCenter(), boundingBox.getHalfAxes(), 0.0);
+    }
+
+    void operator()(const BoundingSphere& boundingSphere) {
+      batch.addBox(
+          boundingSphere.getCenter(),
+          glm::dmat3(0.0),
+          boundingSphere.getRadius());
+    }
+
+    void operator()(
+        const BoundingRegionWithLooseFittingHeights& boundingRegion) {
+      batch._exactDistanceVolumes.emplace_back(batch.size(), boundingRegion);
+      const OrientedBoundingBox& boundingBox =
+          boundingRegion.getBoundingRegion().getBoundingBox();
+      batch.addBox(boundingBox.getCenter(), boundingBox.getHalfAxes(), 0.0);
+    }
+  };
+
+  std::visit(Operation{*this}, boundingVolume);
+}
+
+void BoundingVolumeBatch::addBox(
+    const glm::dvec3& center,
+    const glm::dmat3& halfAxes,
+    double radius) {
+  for (glm::length_t i = 0; i < 3; ++i) {
+    const size_t index = size_t(i);
+    this->_centers[index].push_back(center[i]);
+
+    // A degenerate axis contributes nothing to the extent of the box, so any
+    // unit vector will do. Using the coordinate axis keeps the distance
+    // computation well-defined for spheres, which have no axes at all.
+    const double halfLength = glm::length(halfAxes[i]);
+    glm::dvec3 axis(0.0);
+    if (halfLength > 0.0) {
+      axis = halfAxes[i] / halfLength;
+    } else {
+      axis[i] = 1.0;
+    }
+
+    this->_halfLengths[index].push_back(halfLength);
+    this->_axes[index][0].push_back(axis.x);
+    this->_axes[index][1].push_back(axis.y);
+    this->_axes[index][2].push_back(axis.z);
+  }
+
+  this->_radii.push_back(radius);
+}
+
+} // namespace Cesium3DTilesSelection
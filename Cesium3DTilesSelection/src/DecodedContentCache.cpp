@@ -0,0 +1,944 @@
+#include "Cesium3DTilesSelection/DecodedContentCache.h"
+
+#include "Cesium3DTilesSelection/GltfContent.h"
+#include "Cesium3DTilesSelection/spdlog-cesium.h"
+
+#include <CesiumAsync/HttpHeaders.h>
+#include <CesiumGltf/BufferEXT_meshopt_compression.h>
+#include <CesiumGltf/BufferViewEXT_meshopt_compression.h>
+#include <CesiumGltf/KHR_draco_mesh_compression.h>
+#include <CesiumGltf/MeshPrimitiveEXT_feature_metadata.h>
+#include <CesiumGltf/ModelEXT_feature_metadata.h>
+#include <CesiumUtility/JsonValue.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <any>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+
+using namespace CesiumAsync;
+using namespace CesiumGltf;
+using namespace CesiumUtility;
+
+namespace Cesium3DTilesSelection {
+
+const uint32_t DecodedContentCache::FORMAT_VERSION = 3;
+
+namespace {
+// "CNDM" in the byte order of this machine, which also makes the data written
+// on a machine with the other byte order unreadable.
+const uint32_t MAGIC = 0x4D444E43;
+
+// The data is written and read by the same `transfer` functions, which take
+// either an `OutputArchive` or an `InputArchive`. The output archive only
+// reads from the objects passed to it.
+class OutputArchive {
+public:
+  static constexpr bool isReading = false;
+
+  void bytes(const void* pData, size_t count) {
+    const std::byte* pBytes = static_cast<const std::byte*>(pData);
+    this->output.insert(this->output.end(), pBytes, pBytes + count);
+  }
+
+  size_t size(size_t value) {
+    const uint64_t encoded = value;
+    this->bytes(&encoded, sizeof(encoded));
+    return value;
+  }
+
+  std::vector<std::byte> output;
+};
+
+class InputArchive {
+public:
+  static constexpr bool isReading = true;
+
+  explicit InputArchive(const gsl::span<const std::byte>& input) noexcept
+      : _input(input), _offset(0) {}
+
+  void bytes(void* pData, size_t count) {
+    if (count > this->remaining()) {
+      throw std::runtime_error("The model data is truncated.");
+    }
+    if (count > 0) {
+      std::memcpy(pData, this->_input.data() + this->_offset, count);
+      this->_offset += count;
+    }
+  }
+
+  size_t size(size_t /*value*/) {
+    uint64_t encoded = 0;
+    this->bytes(&encoded, sizeof(encoded));
+
+    // Every element takes at least one byte, so a larger size can only be
+    // read from corrupted data.
+    if (encoded > this->remaining()) {
+      throw std::runtime_error("The model data has an invalid size.");
+    }
+    return static_cast<size_t>(encoded);
+  }
+
+  bool isAtEnd() const noexcept { return this->remaining() == 0; }
+
+private:
+  size_t remaining() const noexcept {
+    return this->_input.size() - this->_offset;
+  }
+
+  gsl::span<const std::byte> _input;
+  size_t _offset;
+};
+
+// Whether a vector of the type is transferred as one block of bytes.
+template <typename T>
+constexpr bool isRaw = (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) ||
+                       std::is_same_v<T, std::byte>;
+
+template <typename Archive, typename T>
+std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>
+transfer(Archive& archive, T& value) {
+  archive.bytes(&value, sizeof(T));
+}
+
+template <typename Archive, typename T>
+std::enable_if_t<std::is_enum_v<T>> transfer(Archive& archive, T& value) {
+  archive.bytes(&value, sizeof(T));
+}
+
+template <typename Archive> void transfer(Archive& archive, bool& value) {
+  uint8_t byte = value ? 1 : 0;
+  archive.bytes(&byte, sizeof(byte));
+  if constexpr (Archive::isReading) {
+    value = byte != 0;
+  }
+}
+
+template <typename Archive>
+void transfer(Archive& archive, std::string& value) {
+  const size_t size = archive.size(value.size());
+  if constexpr (Archive::isReading) {
+    value.resize(size);
+  }
+  archive.bytes(value.data(), size);
+}
+
+template <typename Archive, typename T>
+void transfer(Archive& archive, std::vector<T>& values) {
+  const size_t size = archive.size(values.size());
+  if constexpr (Archive::isReading) {
+    values.resize(size);
+  }
+  if constexpr (isRaw<T>) {
+    archive.bytes(values.data(), size * sizeof(T));
+  } else {
+    for (T& value : values) {
+      transfer(archive, value);
+    }
+  }
+}
+
+template <typename Archive, typename T>
+void transfer(Archive& archive, std::optional<T>& value) {
+  bool hasValue = value.has_value();
+  transfer(archive, hasValue);
+  if (hasValue) {
+    if constexpr (Archive::isReading) {
+      value.emplace();
+    }
+    transfer(archive, *value);
+  }
+}
+
+template <typename Archive, typename Map>
+void transferMap(Archive& archive, Map& map) {
+  const size_t size = archive.size(map.size());
+  if constexpr (Archive::isReading) {
+    for (size_t i = 0; i < size; ++i) {
+      std::string key;
+      transfer(archive, key);
+      transfer(archive, map[key]);
+    }
+  } else {
+    for (auto& pair : map) {
+      transfer(archive, const_cast<std::string&>(pair.first));
+      transfer(archive, pair.second);
+    }
+  }
+}
+
+template <typename Archive, typename T>
+void transfer(Archive& archive, std::map<std::string, T>& map) {
+  transferMap(archive, map);
+}
+
+template <typename Archive, typename T>
+void transfer(Archive& archive, std::unordered_map<std::string, T>& map) {
+  transferMap(archive, map);
+}
+
+template <typename Archive, typename... T>
+void transferAll(Archive& archive, T&... values) {
+  (transfer(archive, values), ...);
+}
+
+template <typename T, typename Archive>
+void transferAlternative(Archive& archive, JsonValue& value) {
+  if constexpr (Archive::isReading) {
+    value.value.emplace<T>();
+  }
+  transfer(archive, std::get<T>(value.value));
+}
+
+template <typename Archive>
+void transfer(Archive& archive, JsonValue& value) {
+  uint8_t index = static_cast<uint8_t>(value.value.index());
+  transfer(archive, index);
+  switch (index) {
+  case 0:
+    // A default-constructed value is already null.
+    break;
+  case 1:
+    transferAlternative<double>(archive, value);
+    break;
+  case 2:
+    transferAlternative<uint64_t>(archive, value);
+    break;
+  case 3:
+    transferAlternative<int64_t>(archive, value);
+    break;
+  case 4:
+    transferAlternative<JsonValue::Bool>(archive, value);
+    break;
+  case 5:
+    transferAlternative<JsonValue::String>(archive, value);
+    break;
+  case 6:
+    transferAlternative<JsonValue::Object>(archive, value);
+    break;
+  case 7:
+    transferAlternative<JsonValue::Array>(archive, value);
+    break;
+  default:
+    throw std::runtime_error("The model data has an invalid JSON value.");
+  }
+}
+
+enum class ExtensionType : uint8_t {
+  Generic = 0,
+  ModelFeatureMetadata = 1,
+  MeshPrimitiveFeatureMetadata = 2
+};
+
+template <typename T, typename Archive>
+void transferExtension(Archive& archive, std::any& extension) {
+  if constexpr (Archive::isReading) {
+    extension = T();
+  }
+  transfer(archive, *std::any_cast<T>(&extension));
+}
+
+template <typename Archive>
+void transferAnyExtension(
+    Archive& archive,
+    uint8_t type,
+    std::any& extension) {
+  switch (ExtensionType(type)) {
+  case ExtensionType::Generic:
+    transferExtension<JsonValue>(archive, extension);
+    break;
+  case ExtensionType::ModelFeatureMetadata:
+    transferExtension<ModelEXT_feature_metadata>(archive, extension);
+    break;
+  case ExtensionType::MeshPrimitiveFeatureMetadata:
+    transferExtension<MeshPrimitiveEXT_feature_metadata>(archive, extension);
+    break;
+  default:
+    throw std::runtime_error("The model data has an invalid extension.");
+  }
+}
+
+// Returns the given extension names without those of the extensions that
+// transferExtensions leaves out.
+std::vector<std::string>
+withoutDecodedExtensions(const std::vector<std::string>& names) {
+  std::vector<std::string> result;
+  for (const std::string& name : names) {
+    if (name != KHR_draco_mesh_compression::ExtensionName &&
+        name != BufferViewEXT_meshopt_compression::ExtensionName) {
+      result.push_back(name);
+    }
+  }
+  return result;
+}
+
+template <typename Archive>
+void transferExtensions(
+    Archive& archive,
+    std::unordered_map<std::string, std::any>& extensions) {
+  if constexpr (Archive::isReading) {
+    const size_t count = archive.size(0);
+    for (size_t i = 0; i < count; ++i) {
+      std::string name;
+      uint8_t type = 0;
+      transferAll(archive, name, type);
+      transferAnyExtension(archive, type, extensions[name]);
+    }
+  } else {
+    // The Draco and meshopt extensions are left out, because the meshes and
+    // buffer views are already decoded.
+    const auto isDecoded = [](const std::any& extension) {
+      return extension.type() == typeid(KHR_draco_mesh_compression) ||
+             extension.type() == typeid(BufferViewEXT_meshopt_compression) ||
+             extension.type() == typeid(BufferEXT_meshopt_compression);
+    };
+
+    size_t count = 0;
+    for (const auto& pair : extensions) {
+      if (!isDecoded(pair.second)) {
+        ++count;
+      }
+    }
+    archive.size(count);
+
+    for (auto& pair : extensions) {
+      const std::type_info& typeInfo = pair.second.type();
+      uint8_t type = 0;
+      if (isDecoded(pair.second)) {
+        continue;
+      } else if (typeInfo == typeid(JsonValue)) {
+        type = uint8_t(ExtensionType::Generic);
+      } else if (typeInfo == typeid(ModelEXT_feature_metadata)) {
+        type = uint8_t(ExtensionType::ModelFeatureMetadata);
+      } else if (typeInfo == typeid(MeshPrimitiveEXT_feature_metadata)) {
+        type = uint8_t(ExtensionType::MeshPrimitiveFeatureMetadata);
+      } else {
+        throw std::runtime_error(
+            "The extension " + pair.first + " cannot be written.");
+      }
+
+      transfer(archive, const_cast<std::string&>(pair.first));
+      transfer(archive, type);
+      transferAnyExtension(archive, type, pair.second);
+    }
+  }
+}
+
+template <typename Archive>
+void transferExtensible(Archive& archive, ExtensibleObject& object) {
+  transfer(archive, object.extras);
+  transferExtensions(archive, object.extensions);
+}
+
+template <typename Archive>
+void transferNamed(Archive& archive, NamedObject& object) {
+  transferExtensible(archive, object);
+  transfer(archive, object.name);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, AccessorSparseIndices& indices) {
+  transferExtensible(archive, indices);
+  transferAll(
+      archive,
+      indices.bufferView,
+      indices.byteOffset,
+      indices.componentType);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, AccessorSparseValues& values) {
+  transferExtensible(archive, values);
+  transferAll(archive, values.bufferView, values.byteOffset);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, AccessorSparse& sparse) {
+  transferExtensible(archive, sparse);
+  transferAll(archive, sparse.count, sparse.indices, sparse.values);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, Accessor& accessor) {
+  transferNamed(archive, accessor);
+  transferAll(
+      archive,
+      accessor.bufferView,
+      accessor.byteOffset,
+      accessor.componentType,
+      accessor.normalized,
+      accessor.count,
+      accessor.type,
+      accessor.max,
+      accessor.min,
+      accessor.sparse);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, AnimationChannelTarget& target) {
+  transferExtensible(archive, target);
+  transferAll(archive, target.node, target.path);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, AnimationChannel& channel) {
+  transferExtensible(archive, channel);
+  transferAll(archive, channel.sampler, channel.target);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, AnimationSampler& sampler) {
+  transferExtensible(archive, sampler);
+  transferAll(archive, sampler.input, sampler.interpolation, sampler.output);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, Animation& animation) {
+  transferNamed(archive, animation);
+  transferAll(archive, animation.channels, animation.samplers);
+}
+
+template <typename Archive> void transfer(Archive& archive, Asset& asset) {
+  transferExtensible(archive, asset);
+  transferAll(
+      archive,
+      asset.copyright,
+      asset.generator,
+      asset.version,
+      asset.minVersion);
+}
+
+template <typename Archive> void transfer(Archive& archive, Buffer& buffer) {
+  transferNamed(archive, buffer);
+  transferAll(archive, buffer.uri, buffer.byteLength);
+  if constexpr (Archive::isReading) {
+    transfer(archive, buffer.cesium.data);
+  } else {
+    // The data may be held by the response the model was read from.
+    const gsl::span<const std::byte> data = buffer.cesium.getData();
+    archive.bytes(data.data(), archive.size(data.size()));
+  }
+}
+
+template <typename Archive>
+void transfer(Archive& archive, BufferView& bufferView) {
+  transferNamed(archive, bufferView);
+  transferAll(
+      archive,
+      bufferView.buffer,
+      bufferView.byteOffset,
+      bufferView.byteLength,
+      bufferView.byteStride,
+      bufferView.target);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, CameraOrthographic& orthographic) {
+  transferExtensible(archive, orthographic);
+  transferAll(
+      archive,
+      orthographic.xmag,
+      orthographic.ymag,
+      orthographic.zfar,
+      orthographic.znear);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, CameraPerspective& perspective) {
+  transferExtensible(archive, perspective);
+  transferAll(
+      archive,
+      perspective.aspectRatio,
+      perspective.yfov,
+      perspective.zfar,
+      perspective.znear);
+}
+
+template <typename Archive> void transfer(Archive& archive, Camera& camera) {
+  transferNamed(archive, camera);
+  transferAll(archive, camera.orthographic, camera.perspective, camera.type);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, ImageCesiumMipPosition& mipPosition) {
+  transferAll(archive, mipPosition.byteOffset, mipPosition.byteSize);
+}
+
+template <typename Archive> void transfer(Archive& archive, Image& image) {
+  transferNamed(archive, image);
+  transferAll(
+      archive,
+      image.uri,
+      image.mimeType,
+      image.bufferView,
+      image.cesium.width,
+      image.cesium.height,
+      image.cesium.channels,
+      image.cesium.bytesPerChannel,
+      image.cesium.compressedPixelFormat,
+      image.cesium.isSrgb,
+      image.cesium.mipPositions,
+      image.cesium.pixelData);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, TextureInfo& textureInfo) {
+  transferExtensible(archive, textureInfo);
+  transferAll(archive, textureInfo.index, textureInfo.texCoord);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, MaterialNormalTextureInfo& textureInfo) {
+  transfer(archive, static_cast<TextureInfo&>(textureInfo));
+  transfer(archive, textureInfo.scale);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, MaterialOcclusionTextureInfo& textureInfo) {
+  transfer(archive, static_cast<TextureInfo&>(textureInfo));
+  transfer(archive, textureInfo.strength);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, MaterialPBRMetallicRoughness& pbr) {
+  transferExtensible(archive, pbr);
+  transferAll(
+      archive,
+      pbr.baseColorFactor,
+      pbr.baseColorTexture,
+      pbr.metallicFactor,
+      pbr.roughnessFactor,
+      pbr.metallicRoughnessTexture);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, Material& material) {
+  transferNamed(archive, material);
+  transferAll(
+      archive,
+      material.pbrMetallicRoughness,
+      material.normalTexture,
+      material.occlusionTexture,
+      material.emissiveTexture,
+      material.emissiveFactor,
+      material.alphaMode,
+      material.alphaCutoff,
+      material.doubleSided);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, MeshPrimitive& primitive) {
+  transferExtensible(archive, primitive);
+  transferAll(
+      archive,
+      primitive.attributes,
+      primitive.indices,
+      primitive.material,
+      primitive.mode,
+      primitive.targets);
+}
+
+template <typename Archive> void transfer(Archive& archive, Mesh& mesh) {
+  transferNamed(archive, mesh);
+  transferAll(archive, mesh.primitives, mesh.weights);
+}
+
+template <typename Archive> void transfer(Archive& archive, Node& node) {
+  transferNamed(archive, node);
+  transferAll(
+      archive,
+      node.camera,
+      node.children,
+      node.skin,
+      node.matrix,
+      node.mesh,
+      node.rotation,
+      node.scale,
+      node.translation,
+      node.weights);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, Sampler& sampler) {
+  transferNamed(archive, sampler);
+  transferAll(
+      archive,
+      sampler.magFilter,
+      sampler.minFilter,
+      sampler.wrapS,
+      sampler.wrapT);
+}
+
+template <typename Archive> void transfer(Archive& archive, Scene& scene) {
+  transferNamed(archive, scene);
+  transfer(archive, scene.nodes);
+}
+
+template <typename Archive> void transfer(Archive& archive, Skin& skin) {
+  transferNamed(archive, skin);
+  transferAll(archive, skin.inverseBindMatrices, skin.skeleton, skin.joints);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, Texture& texture) {
+  transferNamed(archive, texture);
+  transferAll(archive, texture.sampler, texture.source);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, EnumValue& enumValue) {
+  transferExtensible(archive, enumValue);
+  transferAll(archive, enumValue.name, enumValue.description, enumValue.value);
+}
+
+template <typename Archive> void transfer(Archive& archive, Enum& enumType) {
+  transferExtensible(archive, enumType);
+  transferAll(
+      archive,
+      enumType.name,
+      enumType.description,
+      enumType.valueType,
+      enumType.values);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, ClassProperty& property) {
+  transferExtensible(archive, property);
+  transferAll(
+      archive,
+      property.name,
+      property.description,
+      property.type,
+      property.enumType,
+      property.componentType,
+      property.componentCount,
+      property.normalized,
+      property.max,
+      property.min,
+      property.defaultProperty,
+      property.optional,
+      property.semantic);
+}
+
+template <typename Archive> void transfer(Archive& archive, Class& classType) {
+  transferExtensible(archive, classType);
+  transferAll(
+      archive,
+      classType.name,
+      classType.description,
+      classType.properties);
+}
+
+template <typename Archive> void transfer(Archive& archive, Schema& schema) {
+  transferExtensible(archive, schema);
+  transferAll(
+      archive,
+      schema.name,
+      schema.description,
+      schema.version,
+      schema.classes,
+      schema.enums);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, PropertyStatistics& statistics) {
+  transferExtensible(archive, statistics);
+  transferAll(
+      archive,
+      statistics.min,
+      statistics.max,
+      statistics.mean,
+      statistics.median,
+      statistics.standardDeviation,
+      statistics.variance,
+      statistics.sum,
+      statistics.occurrences);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, ClassStatistics& statistics) {
+  transferExtensible(archive, statistics);
+  transferAll(archive, statistics.count, statistics.properties);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, Statistics& statistics) {
+  transferExtensible(archive, statistics);
+  transfer(archive, statistics.classes);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, FeatureTableProperty& property) {
+  transferExtensible(archive, property);
+  transferAll(
+      archive,
+      property.bufferView,
+      property.offsetType,
+      property.arrayOffsetBufferView,
+      property.stringOffsetBufferView);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, FeatureTable& featureTable) {
+  transferExtensible(archive, featureTable);
+  transferAll(
+      archive,
+      featureTable.classProperty,
+      featureTable.count,
+      featureTable.properties);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, TextureAccessor& accessor) {
+  transferExtensible(archive, accessor);
+  transferAll(archive, accessor.channels, accessor.texture);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, FeatureTexture& featureTexture) {
+  transferExtensible(archive, featureTexture);
+  transferAll(archive, featureTexture.classProperty, featureTexture.properties);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, ModelEXT_feature_metadata& metadata) {
+  transferExtensible(archive, metadata);
+  transferAll(
+      archive,
+      metadata.schema,
+      metadata.schemaUri,
+      metadata.statistics,
+      metadata.featureTables,
+      metadata.featureTextures);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, FeatureIDs& featureIds) {
+  transferExtensible(archive, featureIds);
+  transferAll(
+      archive,
+      featureIds.attribute,
+      featureIds.constant,
+      featureIds.divisor);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, FeatureIDAttribute& attribute) {
+  transferExtensible(archive, attribute);
+  transferAll(archive, attribute.featureTable, attribute.featureIds);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, FeatureIDTexture& texture) {
+  transferExtensible(archive, texture);
+  transferAll(archive, texture.featureTable, texture.featureIds);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, MeshPrimitiveEXT_feature_metadata& metadata) {
+  transferExtensible(archive, metadata);
+  transferAll(
+      archive,
+      metadata.featureIdAttributes,
+      metadata.featureIdTextures,
+      metadata.featureTextures);
+}
+
+template <typename Archive> void transfer(Archive& archive, Model& model) {
+  transferExtensible(archive, model);
+  if constexpr (Archive::isReading) {
+    transferAll(archive, model.extensionsUsed, model.extensionsRequired);
+  } else {
+    // The decoded extensions are left out, so their names are, too.
+    std::vector<std::string> extensionsUsed =
+        withoutDecodedExtensions(model.extensionsUsed);
+    std::vector<std::string> extensionsRequired =
+        withoutDecodedExtensions(model.extensionsRequired);
+    transferAll(archive, extensionsUsed, extensionsRequired);
+  }
+  transferAll(
+      archive,
+      model.accessors,
+      model.animations,
+      model.asset,
+      model.buffers,
+      model.bufferViews,
+      model.cameras,
+      model.images,
+      model.materials,
+      model.meshes,
+      model.nodes,
+      model.samplers,
+      model.scene,
+      model.scenes,
+      model.skins,
+      model.textures);
+}
+
+// A 64-bit hash of the content, which reads eight bytes at a time so that
+// hashing does not take a noticeable part of the time saved by the cache.
+uint64_t hashContent(const gsl::span<const std::byte>& content) noexcept {
+  const uint64_t prime1 = 0x9E3779B185EBCA87;
+  const uint64_t prime2 = 0xC2B2AE3D27D4EB4F;
+
+  uint64_t hash = 0x27D4EB2F165667C5 ^ uint64_t(content.size());
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= content.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, content.data() + i, sizeof(word));
+    hash ^= word * prime2;
+    hash = ((hash << 31) | (hash >> 33)) * prime1;
+  }
+  for (; i < content.size(); ++i) {
+    hash ^= uint64_t(content[i]) * prime1;
+    hash = ((hash << 11) | (hash >> 53)) * prime2;
+  }
+
+  hash ^= hash >> 33;
+  hash *= prime2;
+  hash ^= hash >> 29;
+  return hash;
+}
+} // namespace
+
+DecodedContentCache::DecodedContentCache(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    const std::shared_ptr<ICacheDatabase>& pCacheDatabase,
+    std::chrono::seconds lifetime)
+    : _pLogger(pLogger), _pCacheDatabase(pCacheDatabase), _lifetime(lifetime) {
+}
+
+std::optional<Model> DecodedContentCache::getModel(
+    const std::string& url,
+    const gsl::span<const std::byte>& content,
+    const TilesetContentOptions& options) const {
+  CESIUM_TRACE("DecodedContentCache::getModel");
+
+  std::optional<CacheItem> cacheItem =
+      this->_pCacheDatabase->getEntry(calculateKey(url, content, options));
+  if (!cacheItem) {
+    return std::nullopt;
+  }
+
+  std::optional<Model> model = readModel(cacheItem->cacheResponse.getData());
+  if (!model) {
+    SPDLOG_LOGGER_WARN(
+        this->_pLogger,
+        "Could not read the cached model decoded from {}",
+        url);
+  }
+  return model;
+}
+
+bool DecodedContentCache::storeModel(
+    const std::string& url,
+    const gsl::span<const std::byte>& content,
+    const TilesetContentOptions& options,
+    const Model& model) {
+  CESIUM_TRACE("DecodedContentCache::storeModel");
+
+  std::vector<std::byte> data;
+  try {
+    data = writeModel(model);
+  } catch (const std::exception& e) {
+    SPDLOG_LOGGER_WARN(
+        this->_pLogger,
+        "The model decoded from {} is not cached: {}",
+        url,
+        e.what());
+    return false;
+  }
+
+  const std::time_t expiryTime =
+      std::time(nullptr) + static_cast<std::time_t>(this->_lifetime.count());
+  return this->_pCacheDatabase->storeEntry(
+      calculateKey(url, content, options),
+      expiryTime,
+      url,
+      "GET",
+      HttpHeaders(),
+      200,
+      HttpHeaders(),
+      data);
+}
+
+/*static*/ std::string DecodedContentCache::calculateKey(
+    const std::string& url,
+    const gsl::span<const std::byte>& content,
+    const TilesetContentOptions& options) {
+  char hash[17];
+  std::snprintf(
+      hash,
+      sizeof(hash),
+      "%016llx",
+      static_cast<unsigned long long>(hashContent(content)));
+
+  // Other image decoders create other images, for example ones that keep KTX2
+  // images compressed instead of decoding them to RGBA pixels.
+  const std::string decoders =
+      GltfContent::getGltfReader().getImageDecoders().getFingerprint();
+  char decodersHash[17];
+  std::snprintf(
+      decodersHash,
+      sizeof(decodersHash),
+      "%016llx",
+      static_cast<unsigned long long>(hashContent(gsl::span<const std::byte>(
+          reinterpret_cast<const std::byte*>(decoders.data()),
+          decoders.size()))));
+
+  const std::string flags =
+      std::string(options.generateMissingNormalsSmooth ? "1" : "0") +
+      (options.imageOptions.preserveChannels ? "1" : "0") +
+      (options.imageOptions.preserve16Bit ? "1" : "0") +
+      (options.generateMipmaps ? "1" : "0");
+
+  // The prefix keeps the keys apart from the URLs of cached responses.
+  return "decoded-model:" + std::to_string(FORMAT_VERSION) + ":" + flags +
+         ":" + decodersHash + ":" + std::to_string(content.size()) + ":" +
+         hash + ":" + url;
+}
+
+/*static*/ std::vector<std::byte>
+DecodedContentCache::writeModel(const Model& model) {
+  CESIUM_TRACE("DecodedContentCache::writeModel");
+
+  OutputArchive archive;
+  uint32_t magic = MAGIC;
+  uint32_t version = FORMAT_VERSION;
+  transferAll(archive, magic, version);
+  transfer(archive, const_cast<Model&>(model));
+  return std::move(archive.output);
+}
+
+/*static*/ std::optional<Model>
+DecodedContentCache::readModel(const gsl::span<const std::byte>& data) {
+  CESIUM_TRACE("DecodedContentCache::readModel");
+
+  try {
+    InputArchive archive(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    transferAll(archive, magic, version);
+    if (magic != MAGIC || version != FORMAT_VERSION) {
+      return std::nullopt;
+    }
+
+    Model model;
+    transfer(archive, model);
+    if (!archive.isAtEnd()) {
+      return std::nullopt;
+    }
+    return model;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+} // namespace Cesium3DTilesSelection
@@ -16,26 +16,14 @@
 
 namespace Cesium3DTilesSelection {
 
-/*static*/ CesiumGltf::GltfReader GltfContent::_gltfReader{};
-
-CesiumAsync::Future<std::unique_ptr<TileContentLoadResult>>
-GltfContent::load(const TileContentLoadInput& input) {
-  return input.asyncSystem.createResolvedFuture(load(
-      input.pLogger,
-      input.pRequest->url(),
-      input.pRequest->response()->data()));
-}
-
-/*static*/ std::unique_ptr<TileContentLoadResult> GltfContent::load(
+namespace {
+std::unique_ptr<TileContentLoadResult> createLoadResult(
     const std::shared_ptr<spdlog::logger>& pLogger,
     const std::string& url,
-    const gsl::span<const std::byte>& data) {
-  CESIUM_TRACE("Cesium3DTilesSelection::GltfContent::load");
+    CesiumGltf::ModelReaderResult&& loadedModel) {
   std::unique_ptr<TileContentLoadResult> pResult =
       std::make_unique<TileContentLoadResult>();
 
-  CesiumGltf::ModelReaderResult loadedModel =
-      GltfContent::_gltfReader.readModel(data);
   if (!loadedModel.errors.empty()) {
     SPDLOG_LOGGER_ERROR(
         pLogger,
@@ -58,6 +46,54 @@ GltfContent::load(const TileContentLoadInput& input) {
   pResult->model = std::move(loadedModel.model);
   return pResult;
 }
+} // namespace
+
+/*static*/ CesiumGltf::GltfReader GltfContent::_gltfReader{};
+
+CesiumAsync::Future<std::unique_ptr<TileContentLoadResult>>
+GltfContent::load(const TileContentLoadInput& input) {
+  return load(
+      input.asyncSystem,
+      input.pLogger,
+      input.pRequest->url(),
+      input.pRequest->response()->data(),
+      input.pRequest,
+      input.contentOptions);
+}
+
+/*static*/ std::unique_ptr<TileContentLoadResult> GltfContent::load(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    const std::string& url,
+    const gsl::span<const std::byte>& data,
+    const std::shared_ptr<const void>& pDataOwner) {
+  CESIUM_TRACE("Cesium3DTilesSelection::GltfContent::load");
+  CesiumGltf::ReadModelOptions readOptions;
+  readOptions.referenceBinaryChunk = pDataOwner != nullptr;
+  return createLoadResult(
+      pLogger,
+      url,
+      GltfContent::_gltfReader.readModel(data, pDataOwner, readOptions));
+}
+
+/*static*/ CesiumAsync::Future<std::unique_ptr<TileContentLoadResult>>
+GltfContent::load(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    const std::string& url,
+    const gsl::span<const std::byte>& data,
+    const std::shared_ptr<const void>& pDataOwner,
+    const TilesetContentOptions& options) {
+  CESIUM_TRACE("Cesium3DTilesSelection::GltfContent::load");
+  CesiumGltf::ReadModelOptions readOptions;
+  readOptions.imageOptions = options.imageOptions;
+  readOptions.referenceBinaryChunk = options.referenceGlbBinaryChunk;
+  return GltfContent::_gltfReader
+      .readModelAsync(asyncSystem, data, pDataOwner, readOptions)
+      .thenImmediately([pLogger, url](
+                           CesiumGltf::ModelReaderResult&& loadedModel) {
+        return createLoadResult(pLogger, url, std::move(loadedModel));
+      });
+}
 
 static int generateOverlayTextureCoordinates(
     CesiumGltf::Model& gltf,
@@ -1,6 +1,7 @@
 #include "Cesium3DTilesSelection/QuadtreeRasterOverlayTileProvider.h"
 
 #include "Cesium3DTilesSelection/RasterOverlay.h"
+#include "Cesium3DTilesSelection/spdlog-cesium.h"
 
 #include <CesiumGeometry/QuadtreeTilingScheme.h>
 #include <CesiumGltf/ImageManipulation.h>
@@ -311,8 +312,26 @@ QuadtreeRasterOverlayTileProvider::getQuadtreeTile(
                             currentLevel = tileID.level,
                             minimumLevel = this->getMinimumLevel(),
                             asyncSystem = this->getAsyncSystem(),
+                            pLogger = this->getLogger(),
+                            tileID,
                             loadParentTile = std::move(loadParentTile)](
                                LoadedRasterOverlayImage&& loaded) {
+            // The tiles are combined into the image of each geometry tile on
+            // the CPU, which a GPU compressed image does not allow.
+            if (loaded.image && loaded.image->compressedPixelFormat !=
+                                    GpuCompressedPixelFormat::NONE) {
+              SPDLOG_LOGGER_ERROR(
+                  pLogger,
+                  "The image of quadtree tile {}/{}/{} is GPU compressed, "
+                  "which quadtree raster overlays do not support.",
+                  tileID.level,
+                  tileID.x,
+                  tileID.y);
+              loaded.image.reset();
+              loaded.errors.emplace_back(
+                  "GPU compressed images cannot be combined.");
+            }
+
             if (loaded.image && loaded.errors.empty() &&
                 loaded.image->width > 0 && loaded.image->height > 0) {
               // Successfully loaded, continue.
@@ -40,6 +40,8 @@ void RasterOverlayCollection::add(std::unique_ptr<RasterOverlay>&& pOverlay) {
           pOverlayRaw->getPlaceholder()->getTile(Rectangle(), 0.0)));
     }
   });
+
+  this->_pTileset->invalidatePreviousSelection();
 }
 
 void RasterOverlayCollection::remove(RasterOverlay* pOverlay) noexcept {
@@ -67,6 +69,8 @@ void RasterOverlayCollection::remove(RasterOverlay* pOverlay) noexcept {
     mapped.erase(firstToRemove, mapped.end());
   });
 
+  this->_pTileset->invalidatePreviousSelection();
+
   auto it = std::find_if(
       this->_overlays.begin(),
       this->_overlays.end(),
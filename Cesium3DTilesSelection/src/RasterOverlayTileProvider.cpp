@@ -9,6 +9,7 @@
 
 #include <CesiumAsync/IAssetResponse.h>
 #include <CesiumGltf/GltfReader.h>
+#include <CesiumGltf/ImageManipulation.h>
 #include <CesiumUtility/Tracing.h>
 #include <CesiumUtility/joinToString.h>
 
@@ -36,7 +37,8 @@ RasterOverlayTileProvider::RasterOverlayTileProvider(
       _pPlaceholder(std::make_unique<RasterOverlayTile>(owner)),
       _tileDataBytes(0),
       _totalTilesCurrentlyLoading(0),
-      _throttledTilesCurrentlyLoading(0) {
+      _throttledTilesCurrentlyLoading(0),
+      _cancelableLoads() {
   // Placeholders should never be removed.
   this->_pPlaceholder->addReference();
 }
@@ -59,7 +61,8 @@ RasterOverlayTileProvider::RasterOverlayTileProvider(
       _pPlaceholder(nullptr),
       _tileDataBytes(0),
       _totalTilesCurrentlyLoading(0),
-      _throttledTilesCurrentlyLoading(0) {}
+      _throttledTilesCurrentlyLoading(0),
+      _cancelableLoads() {}
 
 CesiumUtility::IntrusivePointer<RasterOverlayTile>
 RasterOverlayTileProvider::getTile(
@@ -110,6 +113,21 @@ bool RasterOverlayTileProvider::loadTileThrottled(RasterOverlayTile& tile) {
   return true;
 }
 
+void RasterOverlayTileProvider::cancelUnreferencedLoads() {
+  // Canceling a load may finish it right away, which removes it from
+  // _cancelableLoads, so the tokens are only canceled after collecting them.
+  std::vector<CancellationToken> unreferencedLoads;
+  for (const auto& load : this->_cancelableLoads) {
+    if (load.first->getReferenceCount() <= 1) {
+      unreferencedLoads.push_back(load.second);
+    }
+  }
+
+  for (const CancellationToken& token : unreferencedLoads) {
+    token.cancel();
+  }
+}
+
 CesiumAsync::Future<LoadedRasterOverlayImage>
 RasterOverlayTileProvider::loadTileImageFromUrl(
     const std::string& url,
@@ -169,7 +187,10 @@ RasterOverlayTileProvider::loadTileImageFromUrl(
             const gsl::span<const std::byte> data = pResponse->data();
 
             CesiumGltf::ImageReaderResult loadedImage =
-                RasterOverlayTileProvider::_gltfReader.readImage(data);
+                RasterOverlayTileProvider::_gltfReader.readImage(
+                    data,
+                    CesiumGltf::ReadImageOptions(),
+                    pResponse->contentType());
 
             if (!loadedImage.errors.empty()) {
               loadedImage.errors.push_back("Image url: " + pRequest->url());
@@ -208,7 +229,8 @@ struct LoadResult {
  * `LoadResult` with the state `RasterOverlayTile::LoadState::Failed` will be
  * returned.
  *
- * Otherwise, the image data will be passed to
+ * Otherwise, the mip levels of the image are generated if `generateMipmaps`
+ * is true, and the image data will be passed to
  * `IPrepareRendererResources::prepareRasterInLoadThread`, and the function
  * will return a `LoadResult` with the image, the prepared renderer resources,
  * and the state `RasterOverlayTile::LoadState::Loaded`.
@@ -217,12 +239,14 @@ struct LoadResult {
  * @param pPrepareRendererResources The `IPrepareRendererResources`
  * @param pLogger The logger
  * @param loadedImage The `LoadedRasterOverlayImage`
+ * @param generateMipmaps Whether to generate the mip levels of the image
  * @return The `LoadResult`
  */
 static LoadResult createLoadResultFromLoadedImage(
     const std::shared_ptr<IPrepareRendererResources>& pPrepareRendererResources,
     const std::shared_ptr<spdlog::logger>& pLogger,
-    LoadedRasterOverlayImage&& loadedImage) {
+    LoadedRasterOverlayImage&& loadedImage,
+    bool generateMipmaps) {
   if (!loadedImage.image.has_value()) {
     SPDLOG_LOGGER_ERROR(
         pLogger,
@@ -246,9 +270,12 @@ static LoadResult createLoadResultFromLoadedImage(
 
   CesiumGltf::ImageCesium& image = loadedImage.image.value();
 
+  // A GPU compressed image was checked by its decoder.
   const int32_t bytesPerPixel = image.channels * image.bytesPerChannel;
   const int64_t requiredBytes =
-      static_cast<int64_t>(image.width) * image.height * bytesPerPixel;
+      image.compressedPixelFormat == CesiumGltf::GpuCompressedPixelFormat::NONE
+          ? static_cast<int64_t>(image.width) * image.height * bytesPerPixel
+          : 1;
   if (image.width > 0 && image.height > 0 &&
       image.pixelData.size() >= static_cast<size_t>(requiredBytes)) {
     CESIUM_TRACE(
@@ -256,6 +283,11 @@ static LoadResult createLoadResultFromLoadedImage(
         std::to_string(image.height) + "x" + std::to_string(image.channels) +
         "x" + std::to_string(image.bytesPerChannel));
 
+    if (generateMipmaps) {
+      CESIUM_TRACE("generateMipmaps");
+      CesiumGltf::ImageManipulation::generateMipmaps(image);
+    }
+
     void* pRendererResources = nullptr;
     if (pPrepareRendererResources) {
       pRendererResources =
@@ -293,15 +325,22 @@ void RasterOverlayTileProvider::doLoad(
 
   this->beginTileLoad(tile, isThrottledLoad);
 
+  CancellationToken cancellationToken;
+  this->_cancelableLoads.emplace(&tile, cancellationToken);
+
   this->loadTileImage(tile)
+      .withCancellation(cancellationToken)
       .thenInWorkerThread(
           [pPrepareRendererResources = this->getPrepareRendererResources(),
-           pLogger =
-               this->getLogger()](LoadedRasterOverlayImage&& loadedImage) {
+           pLogger = this->getLogger(),
+           generateMipmaps = this->getOwner().getOptions().generateMipmaps,
+           cancellationToken](LoadedRasterOverlayImage&& loadedImage) {
+            cancellationToken.throwIfCanceled();
             return createLoadResultFromLoadedImage(
                 pPrepareRendererResources,
                 pLogger,
-                std::move(loadedImage));
+                std::move(loadedImage),
+                generateMipmaps);
           })
       .thenInMainThread(
           [this, &tile, isThrottledLoad](LoadResult&& result) noexcept {
@@ -320,12 +359,15 @@ void RasterOverlayTileProvider::doLoad(
             this->finalizeTileLoad(tile, isThrottledLoad);
           })
       .catchInMainThread([this, &tile, isThrottledLoad](
-                             const std::exception& /*e*/) {
+                             const std::exception& e) {
         tile._pRendererResources = nullptr;
         tile._image = {};
         tile._tileCredits = {};
         tile._moreDetailAvailable = RasterOverlayTile::MoreDetailAvailable::No;
-        tile.setState(RasterOverlayTile::LoadState::Failed);
+        tile.setState(
+            dynamic_cast<const CancellationException*>(&e)
+                ? RasterOverlayTile::LoadState::Unloaded
+                : RasterOverlayTile::LoadState::Failed);
 
         this->finalizeTileLoad(tile, isThrottledLoad);
       });
@@ -346,6 +388,8 @@ void RasterOverlayTileProvider::beginTileLoad(
 void RasterOverlayTileProvider::finalizeTileLoad(
     RasterOverlayTile& tile,
     bool isThrottledLoad) noexcept {
+  this->_cancelableLoads.erase(&tile);
+
   --this->_totalTilesCurrentlyLoading;
   if (isThrottledLoad) {
     --this->_throttledTilesCurrentlyLoading;
@@ -1,5 +1,6 @@
 #include "Cesium3DTilesSelection/Tile.h"
 
+#include "Cesium3DTilesSelection/DecodedContentCache.h"
 #include "Cesium3DTilesSelection/GltfContent.h"
 #include "Cesium3DTilesSelection/IPrepareRendererResources.h"
 #include "Cesium3DTilesSelection/TileContentFactory.h"
@@ -8,6 +9,7 @@
 #include "upsampleGltfForRasterOverlays.h"
 
 #include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/CancellationToken.h>
 #include <CesiumAsync/IAssetAccessor.h>
 #include <CesiumAsync/IAssetResponse.h>
 #include <CesiumAsync/ITaskProcessor.h>
@@ -15,6 +17,7 @@
 #include <CesiumGeometry/AxisTransforms.h>
 #include <CesiumGeometry/Rectangle.h>
 #include <CesiumGeospatial/Transforms.h>
+#include <CesiumGltf/ImageManipulation.h>
 #include <CesiumGltf/Model.h>
 #include <CesiumUtility/Tracing.h>
 
@@ -32,6 +35,8 @@ Tile::Tile() noexcept
     : _pContext(nullptr),
       _pParent(nullptr),
       _children(),
+      _childBoundingVolumes(),
+      _childBoundingVolumesDirty(false),
       _boundingVolume(OrientedBoundingBox(glm::dvec3(), glm::dmat4())),
       _viewerRequestVolume(),
       _geometricError(0.0),
@@ -43,6 +48,7 @@ Tile::Tile() noexcept
       _pContent(nullptr),
       _pRendererResources(nullptr),
       _lastSelectionState(),
+      _lastNeededFrameNumber(0),
       _loadedTilesLinks() {}
 
 Tile::~Tile() { this->unloadContent(); }
@@ -51,6 +57,8 @@ Tile::Tile(Tile&& rhs) noexcept
     : _pContext(rhs._pContext),
       _pParent(rhs._pParent),
       _children(std::move(rhs._children)),
+      _childBoundingVolumes(std::move(rhs._childBoundingVolumes)),
+      _childBoundingVolumesDirty(rhs._childBoundingVolumesDirty),
       _boundingVolume(rhs._boundingVolume),
       _viewerRequestVolume(rhs._viewerRequestVolume),
       _geometricError(rhs._geometricError),
@@ -62,6 +70,7 @@ Tile::Tile(Tile&& rhs) noexcept
       _pContent(std::move(rhs._pContent)),
       _pRendererResources(rhs._pRendererResources),
       _lastSelectionState(rhs._lastSelectionState),
+      _lastNeededFrameNumber(rhs._lastNeededFrameNumber),
       _loadedTilesLinks() {}
 
 Tile& Tile::operator=(Tile&& rhs) noexcept {
@@ -70,6 +79,8 @@ Tile& Tile::operator=(Tile&& rhs) noexcept {
     this->_pContext = rhs._pContext;
     this->_pParent = rhs._pParent;
     this->_children = std::move(rhs._children);
+    this->_childBoundingVolumes = std::move(rhs._childBoundingVolumes);
+    this->_childBoundingVolumesDirty = rhs._childBoundingVolumesDirty;
     this->_boundingVolume = rhs._boundingVolume;
     this->_viewerRequestVolume = rhs._viewerRequestVolume;
     this->_geometricError = rhs._geometricError;
@@ -81,6 +92,7 @@ Tile& Tile::operator=(Tile&& rhs) noexcept {
     this->_pContent = std::move(rhs._pContent);
     this->_pRendererResources = rhs._pRendererResources;
     this->_lastSelectionState = rhs._lastSelectionState;
+    this->_lastNeededFrameNumber = rhs._lastNeededFrameNumber;
   }
 
   return *this;
@@ -91,6 +103,9 @@ void Tile::createChildTiles(size_t count) {
     throw std::runtime_error("Children already created.");
   }
   this->_children.resize(count);
+
+  // The bounding volumes of the new children are not known yet.
+  this->_childBoundingVolumesDirty = true;
 }
 
 void Tile::createChildTiles(std::vector<Tile>&& children) {
@@ -98,6 +113,21 @@ void Tile::createChildTiles(std::vector<Tile>&& children) {
     throw std::runtime_error("Children already created.");
   }
   this->_children = std::move(children);
+  this->_childBoundingVolumesDirty = true;
+  this->getChildBoundingVolumes();
+}
+
+const BoundingVolumeBatch& Tile::getChildBoundingVolumes() {
+  if (this->_childBoundingVolumesDirty) {
+    this->_childBoundingVolumes.clear();
+    this->_childBoundingVolumes.reserve(this->_children.size());
+    for (const Tile& child : this->_children) {
+      this->_childBoundingVolumes.add(child.getBoundingVolume());
+    }
+    this->_childBoundingVolumesDirty = false;
+  }
+
+  return this->_childBoundingVolumes;
 }
 
 void Tile::setTileID(const TileID& id) noexcept { this->_id = id; }
@@ -199,6 +229,14 @@ void mapRasterOverlaysToTile(
         CesiumGeospatial::GeographicProjection());
   }
 }
+
+// Whether the content is described completely by its model, so that the model
+// can be stored in a DecodedContentCache.
+bool isDecodedContentCacheable(const TileContentLoadResult& content) {
+  return content.model && !content.pNewTileContext && !content.childTiles &&
+         !content.updatedBoundingVolume &&
+         content.availableTileRectangles.empty();
+}
 } // namespace
 
 void Tile::loadContent() {
@@ -232,8 +270,9 @@ void Tile::loadContent() {
 
   std::vector<CesiumGeospatial::Projection> projections;
 
+  CancellationToken cancellationToken;
   std::optional<Future<std::shared_ptr<IAssetRequest>>> maybeRequestFuture =
-      tileset.requestTileContent(*this);
+      tileset.requestTileContent(*this, cancellationToken);
 
   if (!maybeRequestFuture) {
     // There is no content to load. But we may need to upsample.
@@ -279,12 +318,14 @@ void Tile::loadContent() {
            pAssetAccessor = tileset.getExternals().pAssetAccessor,
            gltfUpAxis,
            projections = std::move(projections),
-           generateMissingNormalsSmooth =
-               tileset.getOptions().contentOptions.generateMissingNormalsSmooth,
+           contentOptions = tileset.getOptions().contentOptions,
            pPrepareRendererResources =
-               tileset.getExternals().pPrepareRendererResources](
+               tileset.getExternals().pPrepareRendererResources,
+           pDecodedContentCache = tileset.getExternals().pDecodedContentCache,
+           cancellationToken](
               std::shared_ptr<IAssetRequest>&& pRequest) mutable {
             CESIUM_TRACE("loadContent worker thread");
+            cancellationToken.throwIfCanceled();
 
             const IAssetResponse* pResponse = pRequest->response();
             if (!pResponse) {
@@ -316,22 +357,52 @@ void Tile::loadContent() {
                   nullptr});
             }
 
+            // A model decoded from the same content before is used as is,
+            // without decoding the content again.
+            std::unique_ptr<TileContentLoadResult> pCachedContent;
+            if (pDecodedContentCache) {
+              std::optional<CesiumGltf::Model> cachedModel =
+                  pDecodedContentCache->getModel(
+                      pRequest->url(),
+                      pResponse->data(),
+                      contentOptions);
+              if (cachedModel) {
+                pCachedContent = std::make_unique<TileContentLoadResult>();
+                pCachedContent->model = std::move(cachedModel);
+              }
+            }
+            const bool isCached = pCachedContent != nullptr;
+
             loadInput.asyncSystem = std::move(asyncSystem);
             loadInput.pLogger = std::move(pLogger);
             loadInput.pAssetAccessor = std::move(pAssetAccessor);
             loadInput.pRequest = std::move(pRequest);
 
-            return TileContentFactory::createContent(loadInput)
+            Future<std::unique_ptr<TileContentLoadResult>> futureContent =
+                isCached ? loadInput.asyncSystem.createResolvedFuture(
+                               std::move(pCachedContent))
+                         : TileContentFactory::createContent(loadInput);
+
+            return std::move(futureContent)
                 // Forward status code to the load result.
                 .thenInWorkerThread([statusCode = pResponse->statusCode(),
                                      loadInput = std::move(loadInput),
                                      gltfUpAxis,
                                      projections = std::move(projections),
-                                     generateMissingNormalsSmooth,
+                                     contentOptions,
                                      pPrepareRendererResources =
-                                         std::move(pPrepareRendererResources)](
+                                         std::move(pPrepareRendererResources),
+                                     pDecodedContentCache =
+                                         std::move(pDecodedContentCache),
+                                     isCached,
+                                     cancellationToken =
+                                         std::move(cancellationToken)](
                                         std::unique_ptr<TileContentLoadResult>&&
                                             pContent) mutable {
+                  // Stop before the content is prepared for rendering if the
+                  // tile is no longer needed.
+                  cancellationToken.throwIfCanceled();
+
                   void* pRendererResources = nullptr;
 
                   if (pContent) {
@@ -348,6 +419,31 @@ void Tile::loadContent() {
 
                       CesiumGltf::Model& model = pContent->model.value();
 
+                      if (!isCached) {
+                        if (contentOptions.generateMissingNormalsSmooth) {
+                          model.generateMissingNormalsSmooth();
+                        }
+
+                        if (contentOptions.generateMipmaps) {
+                          CESIUM_TRACE("generateMipmaps");
+                          for (CesiumGltf::Image& image : model.images) {
+                            CesiumGltf::ImageManipulation::generateMipmaps(
+                                image.cesium);
+                          }
+                        }
+
+                        // The texture coordinates for the raster overlays are
+                        // not stored, because they depend on the overlays.
+                        if (pDecodedContentCache &&
+                            isDecodedContentCacheable(*pContent)) {
+                          pDecodedContentCache->storeModel(
+                              loadInput.pRequest->url(),
+                              loadInput.pRequest->response()->data(),
+                              contentOptions,
+                              model);
+                        }
+                      }
+
                       // TODO The `extras` are currently the only way to
                       // pass arbitrary information to the consumer, so the
                       // up-axis is stored here:
@@ -367,10 +463,6 @@ void Tile::loadContent() {
                       pContent->rasterOverlayProjections =
                           std::move(projections);
 
-                      if (generateMissingNormalsSmooth) {
-                        pContent->model->generateMissingNormalsSmooth();
-                      }
-
                       if (pPrepareRendererResources) {
                         CESIUM_TRACE("prepareInLoadThread");
                         pRendererResources =
@@ -397,6 +489,14 @@ void Tile::loadContent() {
         this->_pContent.reset();
         this->_pRendererResources = nullptr;
         this->getTileset()->notifyTileDoneLoading(this);
+
+        if (dynamic_cast<const CancellationException*>(&e)) {
+          // The tile is no longer needed, so it may be loaded again later.
+          this->_rasterTiles.clear();
+          this->setState(LoadState::Unloaded);
+          return;
+        }
+
         this->setState(LoadState::Failed);
 
         SPDLOG_LOGGER_ERROR(
@@ -719,6 +819,7 @@ void Tile::update(
       // of implicit tiling currently. But we may need to re-evaluate it if
       // we're using implicit tiling for buildings (for example) in the future.
       this->_children.resize(4);
+      this->_childBoundingVolumesDirty = true;
 
       createImplicitTile(implicitContext, *this, this->_children[0], swID, sw);
       createImplicitTile(implicitContext, *this, this->_children[1], seID, se);
@@ -799,6 +900,23 @@ void Tile::update(
   }
 }
 
+bool Tile::needsUpdate() const noexcept {
+  // Keep this in sync with the cases handled by update.
+  const LoadState state = this->getState();
+  if (state == LoadState::FailedTemporarily ||
+      state == LoadState::ContentLoaded) {
+    return true;
+  }
+
+  if (this->getContext()->implicitContext && this->getChildren().empty() &&
+      std::get_if<QuadtreeTileID>(&this->_id)) {
+    return true;
+  }
+
+  return state == LoadState::Done && !this->_rasterTiles.empty() &&
+         this->getTileset()->supportsRasterOverlays();
+}
+
 void Tile::markPermanentlyFailed() noexcept {
   if (this->getState() == LoadState::FailedTemporarily) {
     this->setState(LoadState::Failed);
@@ -814,7 +932,7 @@ int64_t Tile::computeByteSize() const noexcept {
 
     // Add up the glTF buffers
     for (const CesiumGltf::Buffer& buffer : model.buffers) {
-      bytes += int64_t(buffer.cesium.data.size());
+      bytes += int64_t(buffer.cesium.getData().size());
     }
 
     // For images loaded from buffers, subtract the buffer size and add
@@ -0,0 +1,186 @@
+#include "Cesium3DTilesSelection/TileLoadQueue.h"
+
+namespace Cesium3DTilesSelection {
+
+void TileLoadQueue::update(Tile& tile, double priority, int32_t frameNumber) {
+  if (frameNumber != this->_lastFrameNumber) {
+    this->_lastFrameNumber = frameNumber;
+    this->_lastFrameSize = 0;
+  }
+
+  auto it = this->_indices.find(&tile);
+  if (it == this->_indices.end()) {
+    const size_t index = this->_heap.size();
+    this->_heap.push_back({&tile, priority, frameNumber});
+    this->_indices.emplace(&tile, index);
+    ++this->_lastFrameSize;
+    this->siftUp(index);
+    return;
+  }
+
+  const size_t index = it->second;
+  Entry& entry = this->_heap[index];
+  if (entry.frameNumber == frameNumber && entry.priority <= priority) {
+    return;
+  }
+
+  // A removed tile that is still in the heap is simply added again.
+  if (this->isUntouched(entry)) {
+    --this->_untouchedSize;
+  }
+  if (entry.frameNumber != frameNumber) {
+    ++this->_lastFrameSize;
+  }
+
+  const double previousPriority = entry.priority;
+  entry.priority = priority;
+  entry.frameNumber = frameNumber;
+
+  if (priority < previousPriority) {
+    this->siftUp(index);
+  } else if (priority > previousPriority) {
+    this->siftDown(index);
+
+    // Moving the top down may have brought a removed tile up to it.
+    this->removeUntouchedTop();
+  }
+}
+
+void TileLoadQueue::removeUntouched(int32_t frameNumber) {
+  this->_touchedFrameNumber = frameNumber;
+
+  const size_t touchedSize =
+      frameNumber == this->_lastFrameNumber ? this->_lastFrameSize : 0;
+  this->_untouchedSize = this->_heap.size() - touchedSize;
+
+  // Only the tiles that reach the top are dropped, unless the removed tiles
+  // take most of the heap.
+  if (this->_untouchedSize > touchedSize) {
+    this->compact();
+  } else {
+    this->removeUntouchedTop();
+  }
+}
+
+Tile* TileLoadQueue::pop() {
+  if (this->empty()) {
+    return nullptr;
+  }
+
+  Tile* pTile = this->_heap.front().pTile;
+  this->removeTop();
+  this->removeUntouchedTop();
+  return pTile;
+}
+
+bool TileLoadQueue::contains(const Tile& tile) const {
+  auto it = this->_indices.find(&tile);
+  return it != this->_indices.end() &&
+         !this->isUntouched(this->_heap[it->second]);
+}
+
+void TileLoadQueue::clear() noexcept {
+  this->_heap.clear();
+  this->_indices.clear();
+  this->_untouchedSize = 0;
+  this->_lastFrameSize = 0;
+}
+
+void TileLoadQueue::removeTop() {
+  const Entry& top = this->_heap.front();
+  if (top.frameNumber == this->_lastFrameNumber) {
+    --this->_lastFrameSize;
+  }
+  if (this->isUntouched(top)) {
+    --this->_untouchedSize;
+  }
+  this->_indices.erase(top.pTile);
+
+  const Entry last = this->_heap.back();
+  this->_heap.pop_back();
+  if (!this->_heap.empty()) {
+    this->place(0, last);
+    this->siftDown(0);
+  }
+}
+
+void TileLoadQueue::removeUntouchedTop() {
+  while (this->_untouchedSize > 0 && this->isUntouched(this->_heap.front())) {
+    this->removeTop();
+  }
+}
+
+void TileLoadQueue::compact() {
+  size_t kept = 0;
+  for (size_t i = 0; i < this->_heap.size(); ++i) {
+    const Entry& entry = this->_heap[i];
+    if (!this->isUntouched(entry)) {
+      this->_heap[kept++] = entry;
+    } else {
+      if (entry.frameNumber == this->_lastFrameNumber) {
+        --this->_lastFrameSize;
+      }
+      this->_indices.erase(entry.pTile);
+    }
+  }
+
+  this->_heap.resize(kept);
+  this->_untouchedSize = 0;
+
+  // The remaining entries were moved, so update their indices and restore the
+  // heap order.
+  for (size_t i = 0; i < kept; ++i) {
+    this->_indices[this->_heap[i].pTile] = i;
+  }
+
+  for (size_t i = kept / 2; i-- > 0;) {
+    this->siftDown(i);
+  }
+}
+
+void TileLoadQueue::place(size_t index, const Entry& entry) {
+  this->_heap[index] = entry;
+  this->_indices[entry.pTile] = index;
+}
+
+void TileLoadQueue::siftUp(size_t index) {
+  const Entry entry = this->_heap[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (!(entry.priority < this->_heap[parent].priority)) {
+      break;
+    }
+
+    this->place(index, this->_heap[parent]);
+    index = parent;
+  }
+
+  this->place(index, entry);
+}
+
+void TileLoadQueue::siftDown(size_t index) {
+  const Entry entry = this->_heap[index];
+  const size_t size = this->_heap.size();
+  while (true) {
+    size_t child = 2 * index + 1;
+    if (child >= size) {
+      break;
+    }
+
+    if (child + 1 < size &&
+        this->_heap[child + 1].priority < this->_heap[child].priority) {
+      ++child;
+    }
+
+    if (!(this->_heap[child].priority < entry.priority)) {
+      break;
+    }
+
+    this->place(index, this->_heap[child]);
+    index = child;
+  }
+
+  this->place(index, entry);
+}
+
+} // namespace Cesium3DTilesSelection
@@ -2,7 +2,13 @@
 
 #include <CesiumGeospatial/BoundingRegion.h>
 #include <CesiumGeospatial/BoundingRegionWithLooseFittingHeights.h>
+#include <CesiumGeospatial/Ellipsoid.h>
 #include <CesiumGeospatial/GlobeRectangle.h>
+#include <CesiumUtility/Math.h>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
 
 #include <variant>
 
@@ -10,6 +16,161 @@ using namespace CesiumGeospatial;
 
 namespace Cesium3DTilesSelection {
 namespace Impl {
+namespace {
+struct RectangleOutline {
+  explicit RectangleOutline(const GlobeRectangle& rectangle) noexcept
+      : corners{
+            glm::dvec2(rectangle.getWest(), rectangle.getSouth()),
+            glm::dvec2(rectangle.getWest(), rectangle.getNorth()),
+            glm::dvec2(rectangle.getEast(), rectangle.getNorth()),
+            glm::dvec2(rectangle.getEast(), rectangle.getSouth())},
+        edges{
+            corners[1] - corners[0],
+            corners[2] - corners[1],
+            corners[3] - corners[2],
+            corners[0] - corners[3]} {}
+
+  glm::dvec2 corners[4];
+  glm::dvec2 edges[4];
+};
+
+bool isInsidePolygon(
+    const glm::dvec2& point,
+    const CartographicPolygon& polygon) noexcept {
+  const std::vector<glm::dvec2>& vertices = polygon.getVertices();
+  const std::vector<uint32_t>& indices = polygon.getIndices();
+
+  for (size_t j = 2; j < indices.size(); j += 3) {
+    const glm::dvec2& a = vertices[indices[j - 2]];
+    const glm::dvec2& b = vertices[indices[j - 1]];
+    const glm::dvec2& c = vertices[indices[j]];
+
+    const glm::dvec2 ab = b - a;
+    const glm::dvec2 ab_perp(-ab.y, ab.x);
+    const glm::dvec2 bc = c - b;
+    const glm::dvec2 bc_perp(-bc.y, bc.x);
+    const glm::dvec2 ca = a - c;
+    const glm::dvec2 ca_perp(-ca.y, ca.x);
+
+    const glm::dvec2 av = point - a;
+    const glm::dvec2 cv = point - c;
+
+    const double v_proj_ab_perp = glm::dot(av, ab_perp);
+    const double v_proj_bc_perp = glm::dot(cv, bc_perp);
+    const double v_proj_ca_perp = glm::dot(cv, ca_perp);
+
+    // This will determine in or out, irrespective of winding.
+    if ((v_proj_ab_perp >= 0.0 && v_proj_ca_perp >= 0.0 &&
+         v_proj_bc_perp >= 0.0) ||
+        (v_proj_ab_perp <= 0.0 && v_proj_ca_perp <= 0.0 &&
+         v_proj_bc_perp <= 0.0)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool perimeterCrossesRectangle(
+    const CartographicPolygon& polygon,
+    const RectangleOutline& outline) noexcept {
+  const std::vector<glm::dvec2>& vertices = polygon.getVertices();
+  for (size_t j = 0; j < vertices.size(); ++j) {
+    const glm::dvec2& a = vertices[j];
+    const glm::dvec2& b = vertices[(j + 1) % vertices.size()];
+
+    const glm::dvec2 ba = a - b;
+
+    // Check each rectangle edge.
+    for (size_t k = 0; k < 4; ++k) {
+      const glm::dvec2& cd = outline.edges[k];
+      const glm::dmat2 lineSegmentMatrix(cd, ba);
+      const glm::dvec2 ca = a - outline.corners[k];
+
+      // s and t are calculated such that:
+      // line_intersection = a + t * ab = c + s * cd
+      const glm::dvec2 st = glm::inverse(lineSegmentMatrix) * ca;
+
+      // check that the intersection is within the line segments
+      if (st.x <= 1.0 && st.x >= 0.0 && st.y <= 1.0 && st.y >= 0.0) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Returns the geodetic latitude of the points at the given geocentric latitude
+// and distance from the center of the Earth.
+std::optional<double>
+computeGeodeticLatitude(double geocentricLatitude, double distance) noexcept {
+  const std::optional<Cartographic> cartographic =
+      Ellipsoid::WGS84.cartesianToCartographic(glm::dvec3(
+          distance * glm::cos(geocentricLatitude),
+          0.0,
+          distance * glm::sin(geocentricLatitude)));
+  if (!cartographic) {
+    return std::nullopt;
+  }
+  return cartographic->latitude;
+}
+
+std::optional<GlobeRectangle>
+estimateSphereRectangle(const glm::dvec3& center, double radius) noexcept {
+  const double distance = glm::length(center);
+  if (radius >= distance) {
+    return std::nullopt;
+  }
+
+  // The directions from the center of the Earth to the sphere form a cone,
+  // which meets the unit sphere in a circle of this angular radius.
+  const double angularRadius = glm::asin(radius / distance);
+  const double centerLatitude = glm::asin(center.z / distance);
+  const double centerLongitude = glm::atan(center.y, center.x);
+
+  double west = -CesiumUtility::Math::ONE_PI;
+  double east = CesiumUtility::Math::ONE_PI;
+  const double south = centerLatitude - angularRadius;
+  const double north = centerLatitude + angularRadius;
+  if (south > -CesiumUtility::Math::PI_OVER_TWO &&
+      north < CesiumUtility::Math::PI_OVER_TWO) {
+    // The circle does not contain a pole, so it spans a limited range of
+    // longitudes. A range across the antimeridian keeps all longitudes.
+    const double halfWidth =
+        glm::asin(glm::sin(angularRadius) / glm::cos(centerLatitude));
+    if (centerLongitude - halfWidth > west &&
+        centerLongitude + halfWidth < east) {
+      west = centerLongitude - halfWidth;
+      east = centerLongitude + halfWidth;
+    }
+  }
+
+  // The geodetic latitude of a point differs from its geocentric latitude by
+  // an amount that depends on its distance from the center of the Earth.
+  const std::optional<double> southNear =
+      computeGeodeticLatitude(south, distance - radius);
+  const std::optional<double> southFar =
+      computeGeodeticLatitude(south, distance + radius);
+  const std::optional<double> northNear =
+      computeGeodeticLatitude(north, distance - radius);
+  const std::optional<double> northFar =
+      computeGeodeticLatitude(north, distance + radius);
+  if (!southNear || !southFar || !northNear || !northFar) {
+    return std::nullopt;
+  }
+
+  return GlobeRectangle(
+      west,
+      glm::max(
+          glm::min(*southNear, *southFar),
+          -CesiumUtility::Math::PI_OVER_TWO),
+      east,
+      glm::min(
+          glm::max(*northNear, *northFar),
+          CesiumUtility::Math::PI_OVER_TWO));
+}
+} // namespace
 
 const CesiumGeospatial::GlobeRectangle* obtainGlobeRectangle(
     const Cesium3DTilesSelection::BoundingVolume* pBoundingVolume) noexcept {
@@ -27,6 +188,37 @@ const CesiumGeospatial::GlobeRectangle* obtainGlobeRectangle(
   return nullptr;
 }
 
+std::optional<GlobeRectangle>
+estimateGlobeRectangle(const BoundingVolume& boundingVolume) noexcept {
+  const GlobeRectangle* pRectangle = obtainGlobeRectangle(&boundingVolume);
+  if (pRectangle) {
+    return *pRectangle;
+  }
+
+  const CesiumGeometry::BoundingSphere* pSphere =
+      std::get_if<CesiumGeometry::BoundingSphere>(&boundingVolume);
+  if (pSphere) {
+    return estimateSphereRectangle(pSphere->getCenter(), pSphere->getRadius());
+  }
+
+  const CesiumGeometry::OrientedBoundingBox* pBox =
+      std::get_if<CesiumGeometry::OrientedBoundingBox>(&boundingVolume);
+  if (pBox) {
+    // The half axes may not be orthogonal, so find the farthest corner.
+    const glm::dmat3& halfAxes = pBox->getHalfAxes();
+    const double radius = glm::max(
+        glm::max(
+            glm::length(halfAxes[0] + halfAxes[1] + halfAxes[2]),
+            glm::length(halfAxes[0] + halfAxes[1] - halfAxes[2])),
+        glm::max(
+            glm::length(halfAxes[0] - halfAxes[1] + halfAxes[2]),
+            glm::length(halfAxes[0] - halfAxes[1] - halfAxes[2])));
+    return estimateSphereRectangle(pBox->getCenter(), radius);
+  }
+
+  return std::nullopt;
+}
+
 bool withinPolygons(
     const BoundingVolume& boundingVolume,
     const std::vector<CartographicPolygon>& cartographicPolygons) noexcept {
@@ -44,17 +236,7 @@ bool withinPolygons(
     const CesiumGeospatial::GlobeRectangle& rectangle,
     const std::vector<CartographicPolygon>& cartographicPolygons) noexcept {
 
-  glm::dvec2 rectangleCorners[] = {
-      glm::dvec2(rectangle.getWest(), rectangle.getSouth()),
-      glm::dvec2(rectangle.getWest(), rectangle.getNorth()),
-      glm::dvec2(rectangle.getEast(), rectangle.getNorth()),
-      glm::dvec2(rectangle.getEast(), rectangle.getSouth())};
-
-  glm::dvec2 rectangleEdges[] = {
-      rectangleCorners[1] - rectangleCorners[0],
-      rectangleCorners[2] - rectangleCorners[1],
-      rectangleCorners[3] - rectangleCorners[2],
-      rectangleCorners[0] - rectangleCorners[3]};
+  const RectangleOutline outline(rectangle);
 
   // Iterate through all polygons.
   for (size_t i = 0; i < cartographicPolygons.size(); ++i) {
@@ -67,81 +249,43 @@ bool withinPolygons(
       continue;
     }
 
-    const std::vector<glm::dvec2>& vertices = selection.getVertices();
-    const std::vector<uint32_t>& indices = selection.getIndices();
-
     // First check if an arbitrary point on the bounding globe rectangle is
-    // inside the polygon.
-    bool inside = false;
-    for (size_t j = 2; j < indices.size(); j += 3) {
-      const glm::dvec2& a = vertices[indices[j - 2]];
-      const glm::dvec2& b = vertices[indices[j - 1]];
-      const glm::dvec2& c = vertices[indices[j]];
-
-      const glm::dvec2 ab = b - a;
-      const glm::dvec2 ab_perp(-ab.y, ab.x);
-      const glm::dvec2 bc = c - b;
-      const glm::dvec2 bc_perp(-bc.y, bc.x);
-      const glm::dvec2 ca = a - c;
-      const glm::dvec2 ca_perp(-ca.y, ca.x);
-
-      const glm::dvec2 av = rectangleCorners[0] - a;
-      const glm::dvec2 cv = rectangleCorners[0] - c;
-
-      const double v_proj_ab_perp = glm::dot(av, ab_perp);
-      const double v_proj_bc_perp = glm::dot(cv, bc_perp);
-      const double v_proj_ca_perp = glm::dot(cv, ca_perp);
-
-      // This will determine in or out, irrespective of winding.
-      if ((v_proj_ab_perp >= 0.0 && v_proj_ca_perp >= 0.0 &&
-           v_proj_bc_perp >= 0.0) ||
-          (v_proj_ab_perp <= 0.0 && v_proj_ca_perp <= 0.0 &&
-           v_proj_bc_perp <= 0.0)) {
-        inside = true;
-        break;
-      }
+    // inside the polygon. If it is outside, then this polygon does not
+    // entirely cull the tile.
+    if (!isInsidePolygon(outline.corners[0], selection)) {
+      continue;
     }
 
-    // If the arbitrary point was outside, then this polygon does not entirely
-    // cull the tile.
-    if (!inside) {
-      continue;
+    // There is no intersection with the perimeter and at least one point is
+    // inside the polygon so the tile is completely inside this polygon.
+    if (!perimeterCrossesRectangle(selection, outline)) {
+      return true;
     }
+  }
 
-    // Check if the polygon perimeter intersects the bounding globe rectangle
-    // edges.
-    bool intersectionFound = false;
-    for (size_t j = 0; j < vertices.size(); ++j) {
-      const glm::dvec2& a = vertices[j];
-      const glm::dvec2& b = vertices[(j + 1) % vertices.size()];
-
-      const glm::dvec2 ba = a - b;
-
-      // Check each rectangle edge.
-      for (size_t k = 0; k < 4; ++k) {
-        const glm::dvec2& cd = rectangleEdges[k];
-        const glm::dmat2 lineSegmentMatrix(cd, ba);
-        const glm::dvec2 ca = a - rectangleCorners[k];
-
-        // s and t are calculated such that:
-        // line_intersection = a + t * ab = c + s * cd
-        const glm::dvec2 st = glm::inverse(lineSegmentMatrix) * ca;
-
-        // check that the intersection is within the line segments
-        if (st.x <= 1.0 && st.x >= 0.0 && st.y <= 1.0 && st.y >= 0.0) {
-          intersectionFound = true;
-          break;
-        }
-      }
+  return false;
+}
 
-      if (intersectionFound) {
-        break;
-      }
+bool intersectsPolygons(
+    const CesiumGeospatial::GlobeRectangle& rectangle,
+    const std::vector<CartographicPolygon>& cartographicPolygons) noexcept {
+
+  const RectangleOutline outline(rectangle);
+
+  for (const CartographicPolygon& polygon : cartographicPolygons) {
+    const std::optional<CesiumGeospatial::GlobeRectangle>&
+        polygonBoundingRectangle = polygon.getBoundingRectangle();
+    if (!polygonBoundingRectangle ||
+        !rectangle.computeIntersection(*polygonBoundingRectangle)) {
+      continue;
     }
 
-    // There is no intersection with the perimeter and at least one point is
-    // inside the polygon so the tile is completely inside this polygon.
-    if (!intersectionFound) {
+    // The polygon overlaps the rectangle if it is inside the rectangle, if
+    // the rectangle is inside the polygon, or if their outlines cross.
+    const glm::dvec2& vertex = polygon.getVertices().front();
+    if (rectangle.contains(Cartographic(vertex.x, vertex.y, 0.0)) ||
+        isInsidePolygon(outline.corners[0], polygon) ||
+        perimeterCrossesRectangle(polygon, outline)) {
       return true;
     }
   }
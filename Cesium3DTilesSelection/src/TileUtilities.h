@@ -5,6 +5,7 @@
 #include <CesiumGeospatial/CartographicPolygon.h>
 #include <CesiumGeospatial/GlobeRectangle.h>
 
+#include <optional>
 #include <vector>
 
 namespace Cesium3DTilesSelection {
@@ -33,6 +34,25 @@ namespace Impl {
 const CesiumGeospatial::GlobeRectangle* obtainGlobeRectangle(
     const Cesium3DTilesSelection::BoundingVolume* pBoundingVolume) noexcept;
 
+/**
+ * @brief Computes a {@link CesiumGeospatial::GlobeRectangle} on the WGS84
+ * ellipsoid that contains the given
+ * {@link Cesium3DTilesSelection::BoundingVolume}.
+ *
+ * Bounding regions return their own rectangle. For a
+ * {@link CesiumGeometry::BoundingSphere} or a
+ * {@link CesiumGeometry::OrientedBoundingBox}, the rectangle contains the
+ * longitudes and latitudes of all points of a sphere that encloses the
+ * volume, so it may be larger than the volume.
+ *
+ * @param boundingVolume The bounding volume, in Earth-centered, Earth-fixed
+ * coordinates.
+ * @return The rectangle, or `std::nullopt` if the volume contains the center
+ * of the Earth, so that it is not bounded by any rectangle.
+ */
+std::optional<CesiumGeospatial::GlobeRectangle>
+estimateGlobeRectangle(const BoundingVolume& boundingVolume) noexcept;
+
 /**
  * @brief Returns whether the tile is completely inside a polygon.
  *
@@ -56,5 +76,17 @@ bool withinPolygons(
     const CesiumGeospatial::GlobeRectangle& rectangle,
     const std::vector<CesiumGeospatial::CartographicPolygon>&
         cartographicPolygons) noexcept;
+
+/**
+ * @brief Returns whether the tile overlaps a polygon.
+ *
+ * @param rectangle The {@link CesiumGeospatial::GlobeRectangle} of the tile.
+ * @param cartographicPolygons The list of polygons to check.
+ * @return Whether the tile overlaps a polygon.
+ */
+bool intersectsPolygons(
+    const CesiumGeospatial::GlobeRectangle& rectangle,
+    const std::vector<CesiumGeospatial::CartographicPolygon>&
+        cartographicPolygons) noexcept;
 } // namespace Impl
 } // namespace Cesium3DTilesSelection
@@ -25,12 +25,19 @@
 #include <CesiumUtility/Uri.h>
 
 #include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <rapidjson/document.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <exception>
+#include <functional>
 #include <limits>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <unordered_set>
 
 using namespace CesiumAsync;
@@ -56,13 +63,16 @@ Tileset::Tileset(
       _options(options),
       _pRootTile(),
       _previousFrameNumber(0),
+      _lastTraversalFrustums(),
+      _lastTraversalSettled(false),
+      _prefetchedTileCount(0),
+      _prefetchHitCount(0),
       _loadsInProgress(0),
+      _cancelableLoads(),
       _overlays(*this),
       _tileDataBytes(0),
       _supportsRasterOverlays(false),
-      _gltfUpAxis(CesiumGeometry::Axis::Y),
-      _distancesStack(),
-      _nextDistancesVector(0) {
+      _gltfUpAxis(CesiumGeometry::Axis::Y) {
   CESIUM_TRACE_USE_TRACK_SET(this->_loadingSlots);
   ++this->_loadsInProgress;
   this->_loadTilesetJson(url);
@@ -86,13 +96,16 @@ Tileset::Tileset(
       _options(options),
       _pRootTile(),
       _previousFrameNumber(0),
+      _lastTraversalFrustums(),
+      _lastTraversalSettled(false),
+      _prefetchedTileCount(0),
+      _prefetchHitCount(0),
       _loadsInProgress(0),
+      _cancelableLoads(),
       _overlays(*this),
       _tileDataBytes(0),
       _supportsRasterOverlays(false),
-      _gltfUpAxis(CesiumGeometry::Axis::Y),
-      _distancesStack(),
-      _nextDistancesVector(0) {
+      _gltfUpAxis(CesiumGeometry::Axis::Y) {
   CESIUM_TRACE_USE_TRACK_SET(this->_loadingSlots);
   CESIUM_TRACE_BEGIN_IN_TRACK("Tileset from ion startup");
 
@@ -314,12 +327,38 @@ Tileset::updateViewOffline(const std::vector<ViewState>& frustums) {
 
 const ViewUpdateResult&
 Tileset::updateView(const std::vector<ViewState>& frustums) {
+  return this->updateView(frustums, {});
+}
+
+const ViewUpdateResult& Tileset::updateView(
+    const std::vector<ViewState>& frustums,
+    const std::vector<ViewState>& predictedFrustums) {
   this->_asyncSystem.dispatchMainThreadTasks();
 
   const int32_t previousFrameNumber = this->_previousFrameNumber;
   const int32_t currentFrameNumber = previousFrameNumber + 1;
 
   ViewUpdateResult& result = this->_updateResult;
+
+  // The prefetched tiles change with the predicted views even if the current
+  // views stay the same.
+  if (predictedFrustums.empty() &&
+      this->_canReuseLastTraversal(frustums)) {
+    // Keep the frame number of the last traversal, so that the selection
+    // states of the tiles still refer to the previous frame when the tileset
+    // is traversed again.
+    result.tilesToNoLongerRenderThisFrame.clear();
+    result.tilesPrefetched = 0;
+    result.prefetchHits = 0;
+    result.reusedPreviousSelection = true;
+    this->_unloadCachedTiles();
+    this->_addCreditsToFrame(result);
+    return result;
+  }
+
+  this->_lastTraversalSettled = false;
+  result.reusedPreviousSelection = false;
+
   // result.tilesLoading = 0;
   result.tilesToRenderThisFrame.clear();
   // result.newTilesToRenderThisFrame.clear();
@@ -328,6 +367,8 @@ Tileset::updateView(const std::vector<ViewState>& frustums) {
   result.culledTilesVisited = 0;
   result.tilesCulled = 0;
   result.maxDepthVisited = 0;
+  result.tilesPrefetched = 0;
+  result.prefetchHits = 0;
 
   Tile* pRootTile = this->getRootTile();
   if (!pRootTile) {
@@ -339,9 +380,11 @@ Tileset::updateView(const std::vector<ViewState>& frustums) {
         "Only quantized-mesh terrain tilesets currently support overlays.");
   }
 
-  this->_loadQueueHigh.clear();
-  this->_loadQueueMedium.clear();
-  this->_loadQueueLow.clear();
+  TraversalState& traversalState = this->_traversalState;
+  traversalState.loadQueueHigh.clear();
+  traversalState.loadQueueMedium.clear();
+  traversalState.loadQueueLow.clear();
+  traversalState.unsettledTiles = 0;
 
   std::vector<double> fogDensities(frustums.size());
   std::transform(
@@ -360,22 +403,114 @@ Tileset::updateView(const std::vector<ViewState>& frustums) {
       currentFrameNumber};
 
   if (!frustums.empty()) {
-    this->_visitTileIfNeeded(frameState, 0, false, *pRootTile, result);
+    this->_visitTileIfNeeded(
+        frameState,
+        traversalState,
+        0,
+        false,
+        *pRootTile,
+        nullptr,
+        0,
+        result);
   } else {
     result = ViewUpdateResult();
   }
 
   result.tilesLoadingLowPriority =
-      static_cast<uint32_t>(this->_loadQueueLow.size());
+      static_cast<uint32_t>(traversalState.loadQueueLow.size());
   result.tilesLoadingMediumPriority =
-      static_cast<uint32_t>(this->_loadQueueMedium.size());
+      static_cast<uint32_t>(traversalState.loadQueueMedium.size());
   result.tilesLoadingHighPriority =
-      static_cast<uint32_t>(this->_loadQueueHigh.size());
+      static_cast<uint32_t>(traversalState.loadQueueHigh.size());
+
+  // The selection stays the same for as long as the views do, unless this
+  // traversal left something to do that will change the tiles.
+  this->_lastTraversalSettled =
+      this->_options.reuseSelectionForUnchangedViews &&
+      traversalState.unsettledTiles == 0 &&
+      traversalState.loadQueueHigh.empty() &&
+      traversalState.loadQueueMedium.empty() &&
+      traversalState.loadQueueLow.empty();
+  if (this->_lastTraversalSettled) {
+    this->_lastTraversalFrustums.clear();
+    for (const ViewState& frustum : frustums) {
+      this->_lastTraversalFrustums.push_back(frustum);
+    }
+  }
+
+  this->_addTilesToPrefetchQueue(predictedFrustums, currentFrameNumber);
+  this->_countPrefetchHits(result);
 
   this->_unloadCachedTiles();
-  this->_processLoadQueue();
+  this->_cancelUnneededLoads(currentFrameNumber);
+  this->_processLoadQueue(currentFrameNumber);
+  this->_processPrefetchQueue(currentFrameNumber, result);
+  this->_addCreditsToFrame(result);
+
+  this->_previousFrameNumber = currentFrameNumber;
+
+  return result;
+}
 
-  // aggregate all the credits needed from this tileset for the current frame
+void Tileset::invalidatePreviousSelection() noexcept {
+  this->_lastTraversalSettled = false;
+}
+
+namespace {
+bool isViewEqual(const ViewState& view, const ViewState& lastView) noexcept {
+  return view.getPosition() == lastView.getPosition() &&
+         view.getDirection() == lastView.getDirection() &&
+         view.getUp() == lastView.getUp() &&
+         view.getViewportSize() == lastView.getViewportSize() &&
+         view.getHorizontalFieldOfView() ==
+             lastView.getHorizontalFieldOfView() &&
+         view.getVerticalFieldOfView() == lastView.getVerticalFieldOfView() &&
+         view.getNearDistance() == lastView.getNearDistance() &&
+         view.getFarDistance() == lastView.getFarDistance();
+}
+
+/**
+ * @brief Returns whether the given tile needs to be updated in the main thread
+ * again, even if nothing else changes.
+ */
+bool isTileSettled(const Tile& tile) noexcept {
+  switch (tile.getState()) {
+  case Tile::LoadState::Unloaded:
+  case Tile::LoadState::Failed:
+    // Unloaded tiles that are needed end up in the load queues.
+    return true;
+  case Tile::LoadState::Done:
+    return std::all_of(
+        tile.getMappedRasterTiles().begin(),
+        tile.getMappedRasterTiles().end(),
+        [](const RasterMappedTo3DTile& mapped) noexcept {
+          return mapped.getState() ==
+                 RasterMappedTo3DTile::AttachmentState::Attached;
+        });
+  default:
+    return false;
+  }
+}
+} // namespace
+
+bool Tileset::_canReuseLastTraversal(
+    const std::vector<ViewState>& frustums) const noexcept {
+  if (!this->_options.reuseSelectionForUnchangedViews ||
+      !this->_lastTraversalSettled || this->_loadsInProgress > 0 ||
+      frustums.size() != this->_lastTraversalFrustums.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < frustums.size(); ++i) {
+    if (!isViewEqual(frustums[i], this->_lastTraversalFrustums[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Tileset::_addCreditsToFrame(const ViewUpdateResult& result) {
   const std::shared_ptr<CreditSystem>& pCreditSystem =
       this->_externals.pCreditSystem;
   if (pCreditSystem && !result.tilesToRenderThisFrame.empty()) {
@@ -413,10 +548,6 @@ Tileset::updateView(const std::vector<ViewState>& frustums) {
       }
     }
   }
-
-  this->_previousFrameNumber = currentFrameNumber;
-
-  return result;
 }
 
 void Tileset::notifyTileStartLoading(Tile* pTile) noexcept {
@@ -433,6 +564,8 @@ void Tileset::notifyTileDoneLoading(Tile* pTile) noexcept {
   --this->_loadsInProgress;
 
   if (pTile) {
+    this->_cancelableLoads.erase(pTile);
+    this->_canceledLoads.erase(pTile);
     this->_tileDataBytes += pTile->computeByteSize();
 
     CESIUM_TRACE_END_IN_TRACK(
@@ -463,7 +596,9 @@ void Tileset::loadTilesFromJson(
 }
 
 std::optional<CesiumAsync::Future<std::shared_ptr<CesiumAsync::IAssetRequest>>>
-Tileset::requestTileContent(Tile& tile) {
+Tileset::requestTileContent(
+    Tile& tile,
+    const CesiumAsync::CancellationToken& cancellationToken) {
   std::string url = this->getResolvedContentUrl(tile);
   if (url.empty()) {
     return std::nullopt;
@@ -471,10 +606,22 @@ Tileset::requestTileContent(Tile& tile) {
 
   this->notifyTileStartLoading(&tile);
 
-  return this->getExternals().pAssetAccessor->requestAsset(
+  if (!this->_options.enableLoadCancellation) {
+    return this->getExternals().pAssetAccessor->requestAsset(
+        this->getAsyncSystem(),
+        url,
+        tile.getContext()->requestHeaders);
+  }
+
+  this->_cancelableLoads.insert_or_assign(
+      &tile,
+      CancelableLoad{cancellationToken, -1});
+
+  return this->getExternals().pAssetAccessor->requestAssetWithCancellation(
       this->getAsyncSystem(),
       url,
-      tile.getContext()->requestHeaders);
+      tile.getContext()->requestHeaders,
+      cancellationToken);
 }
 
 void Tileset::addContext(std::unique_ptr<TileContext>&& pNewContext) {
@@ -1199,6 +1346,8 @@ static void markTileAndChildrenNonRendered(
  * the camera.
  *
  * @param viewState The {@link ViewState}
+ * @param planeMask The plane mask of the bounding volume, as computed by
+ * {@link ViewState::computePlaneMask}
  * @param boundingVolume The bounding volume of the tile
  * @param forceRenderTilesUnderCamera Whether tiles under the camera should
  * always be rendered (see {@link Cesium3DTilesSelection::TilesetOptions})
@@ -1207,9 +1356,10 @@ static void markTileAndChildrenNonRendered(
  */
 static bool isVisibleFromCamera(
     const ViewState& viewState,
+    ViewState::PlaneMask planeMask,
     const BoundingVolume& boundingVolume,
     bool forceRenderTilesUnderCamera) {
-  if (viewState.isBoundingVolumeVisible(boundingVolume)) {
+  if (planeMask != ViewState::PLANE_MASK_OUTSIDE) {
     return true;
   }
   if (!forceRenderTilesUnderCamera) {
@@ -1254,12 +1404,21 @@ static bool isVisibleInFog(double distance, double fogDensity) noexcept {
 //   * The tile has not yet been added to a load queue.
 Tileset::TraversalDetails Tileset::_visitTileIfNeeded(
     const FrameState& frameState,
+    TraversalState& state,
     uint32_t depth,
     bool ancestorMeetsSse,
     Tile& tile,
+    const ChildCulling* pParentCulling,
+    size_t childIndex,
     ViewUpdateResult& result) {
-  tile.update(frameState.lastFrameNumber, frameState.currentFrameNumber);
-  this->_markTileVisited(tile);
+  // The update applies the bounding volume that came with the content of a
+  // tile that just finished loading, so the plane masks and distances that
+  // were computed together with its siblings from the old one are stale.
+  if (tile.getState() == Tile::LoadState::ContentLoaded) {
+    pParentCulling = nullptr;
+  }
+
+  this->_updateTileAndMarkVisited(frameState, state, tile);
 
   const Tileset* pTileset = tile.getTileset();
   if (!pTileset) {
@@ -1283,57 +1442,75 @@ Tileset::TraversalDetails Tileset::_visitTileIfNeeded(
   const std::vector<ViewState>& frustums = frameState.frustums;
   const std::vector<double>& fogDensities = frameState.fogDensities;
 
-  const BoundingVolume& boundingVolume = tile.getBoundingVolume();
-  if (std::none_of(
-          frustums.begin(),
-          frustums.end(),
-          [boundingVolume,
-           renderTilesUnderCamera = this->_options.renderTilesUnderCamera](
-              const ViewState& frustum) {
-            return isVisibleFromCamera(
-                frustum,
-                boundingVolume,
-                renderTilesUnderCamera);
-          })) {
-    // this tile is off-screen so it is a culled tile
-    culled = true;
-    if (this->_options.enableFrustumCulling) {
-      // frustum culling is enabled so we shouldn't visit this off-screen tile
-      shouldVisit = false;
-    }
-  }
-
-  if (this->_nextDistancesVector >= this->_distancesStack.size()) {
-    this->_distancesStack.resize(this->_nextDistancesVector + 1);
+  if (state.nextDistancesVector >= state.distancesStack.size()) {
+    state.distancesStack.resize(state.nextDistancesVector + 1);
+    state.planeMasksStack.resize(state.nextDistancesVector + 1);
+    state.childCullingStack.resize(state.nextDistancesVector + 1);
   }
 
   std::unique_ptr<std::vector<double>>& pDistances =
-      this->_distancesStack[this->_nextDistancesVector];
+      state.distancesStack[state.nextDistancesVector];
   if (!pDistances) {
     pDistances = std::make_unique<std::vector<double>>();
   }
 
+  std::unique_ptr<std::vector<ViewState::PlaneMask>>& pPlaneMasks =
+      state.planeMasksStack[state.nextDistancesVector];
+  if (!pPlaneMasks) {
+    pPlaneMasks = std::make_unique<std::vector<ViewState::PlaneMask>>();
+  }
+
   std::vector<double>& distances = *pDistances;
   distances.resize(frustums.size());
-  ++this->_nextDistancesVector;
+  std::vector<ViewState::PlaneMask>& planeMasks = *pPlaneMasks;
+  planeMasks.resize(frustums.size());
+  ++state.nextDistancesVector;
 
-  // Use a unique_ptr to ensure the _nextDistancesVector gets decrements when we
+  // Use a unique_ptr to ensure the nextDistancesVector gets decrements when we
   // leave this scope.
-  const auto decrementNextDistancesVector = [this](std::vector<double>*) {
-    --this->_nextDistancesVector;
+  const auto decrementNextDistancesVector = [&state](std::vector<double>*) {
+    --state.nextDistancesVector;
   };
   std::unique_ptr<std::vector<double>, decltype(decrementNextDistancesVector)>
       autoDecrement(&distances, decrementNextDistancesVector);
 
-  std::transform(
-      frustums.begin(),
-      frustums.end(),
-      distances.begin(),
-      [boundingVolume](const ViewState& frustum) -> double {
-        return glm::sqrt(glm::max(
-            frustum.computeDistanceSquaredToBoundingVolume(boundingVolume),
-            0.0));
-      });
+  // Use the plane masks and distances that were computed together with the
+  // siblings of this tile, if there are any. Otherwise, test all planes.
+  const BoundingVolume& boundingVolume = tile.getBoundingVolume();
+  for (size_t i = 0; i < frustums.size(); ++i) {
+    double distanceSquared;
+    if (pParentCulling) {
+      const size_t index = i * pParentCulling->childCount + childIndex;
+      planeMasks[i] = pParentCulling->planeMasks[index];
+      distanceSquared = pParentCulling->distancesSquared[index];
+    } else {
+      planeMasks[i] = frustums[i].computePlaneMask(boundingVolume);
+      distanceSquared =
+          frustums[i].computeDistanceSquaredToBoundingVolume(boundingVolume);
+    }
+    distances[i] = glm::sqrt(glm::max(distanceSquared, 0.0));
+  }
+
+  bool isVisible = false;
+  for (size_t i = 0; i < frustums.size(); ++i) {
+    if (isVisibleFromCamera(
+            frustums[i],
+            planeMasks[i],
+            boundingVolume,
+            this->_options.renderTilesUnderCamera)) {
+      isVisible = true;
+      break;
+    }
+  }
+
+  if (!isVisible) {
+    // this tile is off-screen so it is a culled tile
+    culled = true;
+    if (this->_options.enableFrustumCulling) {
+      // frustum culling is enabled so we shouldn't visit this off-screen tile
+      shouldVisit = false;
+    }
+  }
 
   // if we are still considering visiting this tile, check for fog occlusion
   if (shouldVisit) {
@@ -1367,7 +1544,7 @@ Tileset::TraversalDetails Tileset::_visitTileIfNeeded(
 
     // Preload this culled sibling if requested.
     if (this->_options.preloadSiblings) {
-      addTileToLoadQueue(this->_loadQueueLow, frustums, tile, distances);
+      addTileToLoadQueue(state.loadQueueLow, frustums, tile, distances);
     }
 
     ++result.tilesCulled;
@@ -1377,10 +1554,12 @@ Tileset::TraversalDetails Tileset::_visitTileIfNeeded(
 
   return this->_visitTile(
       frameState,
+      state,
       depth,
       ancestorMeetsSse,
       tile,
       distances,
+      planeMasks,
       culled,
       result);
 }
@@ -1391,6 +1570,7 @@ static bool isLeaf(const Tile& tile) noexcept {
 
 Tileset::TraversalDetails Tileset::_renderLeaf(
     const FrameState& frameState,
+    TraversalState& state,
     Tile& tile,
     const std::vector<double>& distances,
     ViewUpdateResult& result) {
@@ -1403,7 +1583,7 @@ Tileset::TraversalDetails Tileset::_renderLeaf(
       TileSelectionState::Result::Rendered));
   result.tilesToRenderThisFrame.push_back(&tile);
   addTileToLoadQueue(
-      this->_loadQueueMedium,
+      state.loadQueueMedium,
       frameState.frustums,
       tile,
       distances);
@@ -1420,6 +1600,7 @@ Tileset::TraversalDetails Tileset::_renderLeaf(
 
 bool Tileset::_queueLoadOfChildrenRequiredForRefinement(
     const FrameState& frameState,
+    TraversalState& state,
     Tile& tile,
     const std::vector<double>& distances) {
   if (!this->_options.forbidHoles) {
@@ -1434,14 +1615,13 @@ bool Tileset::_queueLoadOfChildrenRequiredForRefinement(
 
       // While we are waiting for the child to load, we need to push along the
       // tile and raster loading by continuing to update it.
-      child.update(frameState.lastFrameNumber, frameState.currentFrameNumber);
-      this->_markTileVisited(child);
+      this->_updateTileAndMarkVisited(frameState, state, child);
 
       // We're using the distance to the parent tile to compute the load
       // priority. This is fine because the relative priority of the children is
       // irrelevant; we can't display any of them until all are loaded, anyway.
       addTileToLoadQueue(
-          this->_loadQueueMedium,
+          state.loadQueueMedium,
           frameState.frustums,
           child,
           distances);
@@ -1450,19 +1630,16 @@ bool Tileset::_queueLoadOfChildrenRequiredForRefinement(
   return waitingForChildren;
 }
 
-bool Tileset::_meetsSse(
+static double computeLargestSse(
     const std::vector<ViewState>& frustums,
     const Tile& tile,
-    const std::vector<double>& distances,
-    bool culled) const noexcept {
-
+    const std::vector<double>& distances) noexcept {
   double largestSse = 0.0;
 
   for (size_t i = 0; i < frustums.size() && i < distances.size(); ++i) {
     const ViewState& frustum = frustums[i];
     const double distance = distances[i];
 
-    // Does this tile meet the screen-space error?
     const double sse =
         frustum.computeScreenSpaceError(tile.getGeometricError(), distance);
     if (sse > largestSse) {
@@ -1470,11 +1647,47 @@ bool Tileset::_meetsSse(
     }
   }
 
+  return largestSse;
+}
+
+bool Tileset::_meetsSse(
+    const std::vector<ViewState>& frustums,
+    const Tile& tile,
+    const std::vector<double>& distances,
+    bool culled) const noexcept {
+  // Does this tile meet the screen-space error?
+  const double largestSse = computeLargestSse(frustums, tile, distances);
+
   return culled ? !this->_options.enforceCulledScreenSpaceError ||
                       largestSse < this->_options.culledScreenSpaceError
                 : largestSse < this->_options.maximumScreenSpaceError;
 }
 
+bool Tileset::_shouldLoadRefinedTile(
+    const TraversalState& state,
+    uint32_t depth,
+    const Tile& tile,
+    double largestSse) const noexcept {
+  if (!this->_options.skipLevelOfDetail ||
+      tile.getRefine() != TileRefine::Replace) {
+    return true;
+  }
+
+  if (largestSse >= this->_options.baseScreenSpaceError) {
+    return true;
+  }
+
+  if (!state.renderableAncestor) {
+    return false;
+  }
+
+  const double ancestorSse = state.renderableAncestor->first;
+  const uint32_t ancestorDepth = state.renderableAncestor->second;
+  return largestSse <
+             ancestorSse / this->_options.skipScreenSpaceErrorFactor &&
+         depth > ancestorDepth + this->_options.skipLevels;
+}
+
 /**
  * We can render it if _any_ of the following are true:
  *  1. We rendered it (or kicked it) last frame.
@@ -1561,6 +1774,7 @@ Tileset::TraversalDetails Tileset::_refineToNothing(
 
 bool Tileset::_loadAndRenderAdditiveRefinedTile(
     const FrameState& frameState,
+    TraversalState& state,
     Tile& tile,
     ViewUpdateResult& result,
     const std::vector<double>& distances) {
@@ -1569,7 +1783,7 @@ bool Tileset::_loadAndRenderAdditiveRefinedTile(
   if (tile.getRefine() == TileRefine::Add) {
     result.tilesToRenderThisFrame.push_back(&tile);
     addTileToLoadQueue(
-        this->_loadQueueMedium,
+        state.loadQueueMedium,
         frameState.frustums,
         tile,
         distances);
@@ -1583,6 +1797,7 @@ bool Tileset::_loadAndRenderAdditiveRefinedTile(
 // used, in order to deal with the queue elements, should be reviewed...
 bool Tileset::_kickDescendantsAndRenderTile(
     const FrameState& frameState,
+    TraversalState& state,
     Tile& tile,
     ViewUpdateResult& result,
     TraversalDetails& traversalDetails,
@@ -1591,7 +1806,8 @@ bool Tileset::_kickDescendantsAndRenderTile(
     size_t loadIndexMedium,
     size_t loadIndexHigh,
     bool queuedForLoad,
-    const std::vector<double>& distances) {
+    const std::vector<double>& distances,
+    bool mayLoadInsteadOfDescendants) {
   const TileSelectionState lastFrameSelectionState =
       tile.getLastSelectionState();
 
@@ -1635,29 +1851,29 @@ bool Tileset::_kickDescendantsAndRenderTile(
   const bool wasReallyRenderedLastFrame =
       wasRenderedLastFrame && tile.isRenderable();
 
-  if (!wasReallyRenderedLastFrame &&
+  if (mayLoadInsteadOfDescendants && !wasReallyRenderedLastFrame &&
       traversalDetails.notYetRenderableCount >
           this->_options.loadingDescendantLimit) {
     // Remove all descendants from the load queues.
-    this->_loadQueueLow.erase(
-        this->_loadQueueLow.begin() +
+    state.loadQueueLow.erase(
+        state.loadQueueLow.begin() +
             static_cast<std::vector<LoadRecord>::iterator::difference_type>(
                 loadIndexLow),
-        this->_loadQueueLow.end());
-    this->_loadQueueMedium.erase(
-        this->_loadQueueMedium.begin() +
+        state.loadQueueLow.end());
+    state.loadQueueMedium.erase(
+        state.loadQueueMedium.begin() +
             static_cast<std::vector<LoadRecord>::iterator::difference_type>(
                 loadIndexMedium),
-        this->_loadQueueMedium.end());
-    this->_loadQueueHigh.erase(
-        this->_loadQueueHigh.begin() +
+        state.loadQueueMedium.end());
+    state.loadQueueHigh.erase(
+        state.loadQueueHigh.begin() +
             static_cast<std::vector<LoadRecord>::iterator::difference_type>(
                 loadIndexHigh),
-        this->_loadQueueHigh.end());
+        state.loadQueueHigh.end());
 
     if (!queuedForLoad) {
       addTileToLoadQueue(
-          this->_loadQueueMedium,
+          state.loadQueueMedium,
           frameState.frustums,
           tile,
           distances);
@@ -1681,11 +1897,13 @@ bool Tileset::_kickDescendantsAndRenderTile(
 //   * The tile has not yet been added to a load queue.
 Tileset::TraversalDetails Tileset::_visitTile(
     const FrameState& frameState,
+    TraversalState& state,
     uint32_t depth,
     bool ancestorMeetsSse, // Careful: May be modified before being passed to
                            // children!
     Tile& tile,
     const std::vector<double>& distances,
+    const std::vector<ViewState::PlaneMask>& planeMasks,
     bool culled,
     ViewUpdateResult& result) {
   ++result.tilesVisited;
@@ -1697,13 +1915,16 @@ Tileset::TraversalDetails Tileset::_visitTile(
 
   // If this is a leaf tile, just render it (it's already been deemed visible).
   if (isLeaf(tile)) {
-    return _renderLeaf(frameState, tile, distances, result);
+    return _renderLeaf(frameState, state, tile, distances, result);
   }
 
   const bool unconditionallyRefine = tile.getUnconditionallyRefine();
   const bool meetsSse = _meetsSse(frameState.frustums, tile, distances, culled);
-  const bool waitingForChildren =
-      _queueLoadOfChildrenRequiredForRefinement(frameState, tile, distances);
+  const bool waitingForChildren = _queueLoadOfChildrenRequiredForRefinement(
+      frameState,
+      state,
+      tile,
+      distances);
 
   if (!unconditionallyRefine &&
       (meetsSse || ancestorMeetsSse || waitingForChildren)) {
@@ -1729,7 +1950,7 @@ Tileset::TraversalDetails Tileset::_visitTile(
       // Only load this tile if it (not just an ancestor) meets the SSE.
       if (meetsSse && !ancestorMeetsSse) {
         addTileToLoadQueue(
-            this->_loadQueueMedium,
+            state.loadQueueMedium,
             frameState.frustums,
             tile,
             distances);
@@ -1752,7 +1973,7 @@ Tileset::TraversalDetails Tileset::_visitTile(
     // just an ancestor) meets the SSE.
     if (meetsSse) {
       addTileToLoadQueue(
-          this->_loadQueueHigh,
+          state.loadQueueHigh,
           frameState.frustums,
           tile,
           distances);
@@ -1761,22 +1982,55 @@ Tileset::TraversalDetails Tileset::_visitTile(
 
   // Refine!
 
-  bool queuedForLoad =
-      _loadAndRenderAdditiveRefinedTile(frameState, tile, result, distances);
+  bool queuedForLoad = _loadAndRenderAdditiveRefinedTile(
+      frameState,
+      state,
+      tile,
+      result,
+      distances);
+
+  // When skipping levels of detail, only some of the refined tiles are loaded
+  // to be rendered in place of their descendants. The rest are skipped, even
+  // if many of their descendants are still loading.
+  bool mayLoadInsteadOfDescendants = true;
+  const std::optional<std::pair<double, uint32_t>> renderableAncestor =
+      state.renderableAncestor;
+  if (this->_options.skipLevelOfDetail) {
+    const double largestSse =
+        computeLargestSse(frameState.frustums, tile, distances);
+    mayLoadInsteadOfDescendants =
+        this->_shouldLoadRefinedTile(state, depth, tile, largestSse);
+    if (mayLoadInsteadOfDescendants && !queuedForLoad &&
+        !tile.isRenderable()) {
+      addTileToLoadQueue(
+          state.loadQueueMedium,
+          frameState.frustums,
+          tile,
+          distances);
+      queuedForLoad = true;
+    }
+    if (tile.isRenderable()) {
+      state.renderableAncestor = std::make_pair(largestSse, depth);
+    }
+  }
 
   const size_t firstRenderedDescendantIndex =
       result.tilesToRenderThisFrame.size();
-  const size_t loadIndexLow = this->_loadQueueLow.size();
-  const size_t loadIndexMedium = this->_loadQueueMedium.size();
-  const size_t loadIndexHigh = this->_loadQueueHigh.size();
+  const size_t loadIndexLow = state.loadQueueLow.size();
+  const size_t loadIndexMedium = state.loadQueueMedium.size();
+  const size_t loadIndexHigh = state.loadQueueHigh.size();
 
   TraversalDetails traversalDetails = this->_visitVisibleChildrenNearToFar(
       frameState,
+      state,
       depth,
       ancestorMeetsSse,
       tile,
+      planeMasks,
       result);
 
+  state.renderableAncestor = renderableAncestor;
+
   const bool descendantTilesAdded =
       firstRenderedDescendantIndex != result.tilesToRenderThisFrame.size();
   if (!descendantTilesAdded) {
@@ -1799,6 +2053,7 @@ Tileset::TraversalDetails Tileset::_visitTile(
     // this tile instead. Continue to load them though!
     queuedForLoad = _kickDescendantsAndRenderTile(
         frameState,
+        state,
         tile,
         result,
         traversalDetails,
@@ -1807,7 +2062,8 @@ Tileset::TraversalDetails Tileset::_visitTile(
         loadIndexMedium,
         loadIndexHigh,
         queuedForLoad,
-        distances);
+        distances,
+        mayLoadInsteadOfDescendants);
   } else {
     if (tile.getRefine() != TileRefine::Add) {
       markTileNonRendered(frameState.lastFrameNumber, tile, result);
@@ -1819,7 +2075,7 @@ Tileset::TraversalDetails Tileset::_visitTile(
 
   if (this->_options.preloadAncestors && !queuedForLoad) {
     addTileToLoadQueue(
-        this->_loadQueueLow,
+        state.loadQueueLow,
         frameState.frustums,
         tile,
         distances);
@@ -1830,21 +2086,46 @@ Tileset::TraversalDetails Tileset::_visitTile(
 
 Tileset::TraversalDetails Tileset::_visitVisibleChildrenNearToFar(
     const FrameState& frameState,
+    TraversalState& state,
     uint32_t depth,
     bool ancestorMeetsSse,
     Tile& tile,
+    const std::vector<ViewState::PlaneMask>& planeMasks,
     ViewUpdateResult& result) {
-  TraversalDetails traversalDetails;
-
   // TODO: actually visit near-to-far, rather than in order of occurrence.
   gsl::span<Tile> children = tile.getChildren();
+  const ChildCulling& childCulling =
+      this->_cullChildren(frameState, state, tile, planeMasks);
+
+  // Subtrees are only split off by the main traversal, so a subtree that is
+  // already being visited in parallel is never split again.
+  if (this->_options.enableParallelTraversal && !state.isWorker &&
+      depth + 1 >= this->_options.parallelTraversalDepth &&
+      children.size() > 1) {
+    return this->_visitChildrenInParallel(
+        frameState,
+        state,
+        depth,
+        ancestorMeetsSse,
+        tile,
+        childCulling,
+        result);
+  }
+
+  TraversalDetails traversalDetails;
+
+  size_t childIndex = 0;
   for (Tile& child : children) {
     const TraversalDetails childTraversal = this->_visitTileIfNeeded(
         frameState,
+        state,
         depth + 1,
         ancestorMeetsSse,
         child,
+        &childCulling,
+        childIndex,
         result);
+    ++childIndex;
 
     traversalDetails.allAreRenderable &= childTraversal.allAreRenderable;
     traversalDetails.anyWereRenderedLastFrame |=
@@ -1856,21 +2137,517 @@ Tileset::TraversalDetails Tileset::_visitVisibleChildrenNearToFar(
   return traversalDetails;
 }
 
-void Tileset::_processLoadQueue() {
+const Tileset::ChildCulling& Tileset::_cullChildren(
+    const FrameState& frameState,
+    TraversalState& state,
+    Tile& tile,
+    const std::vector<ViewState::PlaneMask>& planeMasks) {
+  // The slot of the tile whose children are culled is the one below the next
+  // free slot, and it stays reserved until the traversal leaves the tile.
+  assert(state.nextDistancesVector > 0);
+  std::unique_ptr<ChildCulling>& pChildCulling =
+      state.childCullingStack[state.nextDistancesVector - 1];
+  if (!pChildCulling) {
+    pChildCulling = std::make_unique<ChildCulling>();
+  }
+
+  const BoundingVolumeBatch& boundingVolumes = tile.getChildBoundingVolumes();
+  const std::vector<ViewState>& frustums = frameState.frustums;
+  const size_t childCount = boundingVolumes.size();
+
+  ChildCulling& childCulling = *pChildCulling;
+  childCulling.childCount = childCount;
+  childCulling.planeMasks.resize(frustums.size() * childCount);
+  childCulling.distancesSquared.resize(frustums.size() * childCount);
+
+  for (size_t i = 0; i < frustums.size(); ++i) {
+    const ViewState::PlaneMask parentPlaneMask =
+        this->_options.enableHierarchicalFrustumCulling
+            ? planeMasks[i]
+            : ViewState::PLANE_MASK_INDETERMINATE;
+    frustums[i].computePlaneMasksAndDistancesSquared(
+        boundingVolumes,
+        parentPlaneMask,
+        gsl::span<ViewState::PlaneMask>(
+            childCulling.planeMasks.data() + i * childCount,
+            childCount),
+        gsl::span<double>(
+            childCulling.distancesSquared.data() + i * childCount,
+            childCount));
+  }
+
+  return childCulling;
+}
+
+/**
+ * @brief Hands out the subtrees of a parallel traversal to the threads that
+ * take part in it, and lets the main thread wait until all of them are done.
+ *
+ * Helper tasks that only start running after all subtrees have been claimed
+ * return without touching anything but this object, so the main thread only
+ * has to wait for the claimed subtrees, not for the helper tasks themselves.
+ *
+ * A helper that visits a tile that needs a {@link Tile::update} hands it to
+ * the main thread and waits until it is updated. The main thread runs these
+ * updates whenever it visits a tile of its own subtrees, and while it waits
+ * for the other subtrees. So every tile is updated before it is used, as in
+ * the serial traversal.
+ */
+class Tileset::ParallelTraversalJob {
+public:
+  ParallelTraversalJob(size_t count, std::function<void(Tile&)> updateTile)
+      : _count(count),
+        _next(0),
+        _completed(0),
+        _pException(),
+        _mainThreadId(std::this_thread::get_id()),
+        _updateTile(std::move(updateTile)),
+        _pendingUpdates(),
+        _pendingUpdateCount(0),
+        _requestedUpdates(0),
+        _completedUpdates(0) {}
+
+  template <typename Func> void run(const Func& visitSubtree) {
+    for (size_t i = this->_next.fetch_add(1); i < this->_count;
+         i = this->_next.fetch_add(1)) {
+      std::exception_ptr pException;
+      try {
+        visitSubtree(i);
+      } catch (...) {
+        pException = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      if (pException && !this->_pException) {
+        this->_pException = pException;
+      }
+      if (++this->_completed == this->_count) {
+        this->_changed.notify_all();
+      }
+    }
+  }
+
+  /**
+   * @brief Updates a tile that is being visited in the main thread, if it
+   * needs it.
+   */
+  void visit(Tile& tile) {
+    const bool needsUpdate = tile.needsUpdate();
+    if (std::this_thread::get_id() == this->_mainThreadId) {
+      this->runPendingUpdates();
+      if (needsUpdate) {
+        this->_updateTile(tile);
+      }
+      return;
+    }
+
+    if (!needsUpdate) {
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(this->_mutex);
+    this->_pendingUpdates.push_back(&tile);
+    this->_pendingUpdateCount.store(
+        this->_pendingUpdates.size(),
+        std::memory_order_release);
+    const size_t ticket = ++this->_requestedUpdates;
+    this->_changed.notify_all();
+    this->_changed.wait(lock, [this, ticket]() {
+      return this->_completedUpdates >= ticket;
+    });
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(this->_mutex);
+    while (true) {
+      this->_changed.wait(lock, [this]() {
+        return this->_completed == this->_count ||
+               !this->_pendingUpdates.empty();
+      });
+      if (this->_pendingUpdates.empty()) {
+        break;
+      }
+      this->runPendingUpdates(lock);
+    }
+
+    if (this->_pException) {
+      std::rethrow_exception(this->_pException);
+    }
+  }
+
+private:
+  void runPendingUpdates() {
+    if (this->_pendingUpdateCount.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock(this->_mutex);
+    this->runPendingUpdates(lock);
+  }
+
+  // Runs the updates that the helpers are waiting for, in the order in which
+  // they were requested, with the mutex unlocked.
+  void runPendingUpdates(std::unique_lock<std::mutex>& lock) {
+    std::vector<Tile*> updates;
+    std::swap(updates, this->_pendingUpdates);
+    this->_pendingUpdateCount.store(0, std::memory_order_relaxed);
+    lock.unlock();
+
+    std::exception_ptr pException;
+    for (Tile* pTile : updates) {
+      try {
+        this->_updateTile(*pTile);
+      } catch (...) {
+        if (!pException) {
+          pException = std::current_exception();
+        }
+      }
+    }
+
+    lock.lock();
+    if (pException && !this->_pException) {
+      this->_pException = pException;
+    }
+    this->_completedUpdates += updates.size();
+    this->_changed.notify_all();
+  }
+
+  const size_t _count;
+  std::atomic<size_t> _next;
+  size_t _completed;
+  std::exception_ptr _pException;
+  const std::thread::id _mainThreadId;
+  const std::function<void(Tile&)> _updateTile;
+  std::vector<Tile*> _pendingUpdates;
+  std::atomic<size_t> _pendingUpdateCount;
+  size_t _requestedUpdates;
+  size_t _completedUpdates;
+  std::mutex _mutex;
+  std::condition_variable _changed;
+};
+
+namespace {
+void resetViewUpdateResult(ViewUpdateResult& result) noexcept {
+  result.tilesToRenderThisFrame.clear();
+  result.tilesToNoLongerRenderThisFrame.clear();
+  result.tilesLoadingLowPriority = 0;
+  result.tilesLoadingMediumPriority = 0;
+  result.tilesLoadingHighPriority = 0;
+  result.tilesVisited = 0;
+  result.culledTilesVisited = 0;
+  result.tilesCulled = 0;
+  result.maxDepthVisited = 0;
+}
+
+template <typename T>
+void appendTo(std::vector<T>& target, const std::vector<T>& source) {
+  target.insert(target.end(), source.begin(), source.end());
+}
+} // namespace
+
+Tileset::TraversalDetails Tileset::_visitChildrenInParallel(
+    const FrameState& frameState,
+    TraversalState& state,
+    uint32_t depth,
+    bool ancestorMeetsSse,
+    Tile& tile,
+    const ChildCulling& childCulling,
+    ViewUpdateResult& result) {
+  CESIUM_TRACE("Tileset::_visitChildrenInParallel");
+
+  const gsl::span<Tile> children = tile.getChildren();
+  const size_t childCount = children.size();
+
+  while (this->_subtreeTraversals.size() < childCount) {
+    std::unique_ptr<SubtreeTraversal>& pSubtree =
+        this->_subtreeTraversals.emplace_back(
+            std::make_unique<SubtreeTraversal>());
+    pSubtree->state.isWorker = true;
+  }
+
+  for (size_t i = 0; i < childCount; ++i) {
+    SubtreeTraversal& subtree = *this->_subtreeTraversals[i];
+    subtree.state.loadQueueHigh.clear();
+    subtree.state.loadQueueMedium.clear();
+    subtree.state.loadQueueLow.clear();
+    subtree.state.visitedTiles.clear();
+    subtree.state.renderableAncestor = state.renderableAncestor;
+    resetViewUpdateResult(subtree.result);
+    subtree.details = TraversalDetails();
+  }
+
+  // Note that _subtreeTraversals is not resized while the job is running.
+  Tile* pChildren = children.data();
+  const auto visitSubtree = [this,
+                             &frameState,
+                             depth,
+                             ancestorMeetsSse,
+                             pChildren,
+                             &childCulling](size_t i) {
+    SubtreeTraversal& subtree = *this->_subtreeTraversals[i];
+    subtree.details = this->_visitTileIfNeeded(
+        frameState,
+        subtree.state,
+        depth + 1,
+        ancestorMeetsSse,
+        pChildren[i],
+        &childCulling,
+        i,
+        subtree.result);
+  };
+
+  // The main thread takes part in the traversal, too, so it needs at most
+  // childCount - 1 helpers.
+  const size_t helperCount = std::min(
+      childCount - 1,
+      size_t(this->_options.parallelTraversalHelperThreads));
+
+  std::shared_ptr<ParallelTraversalJob> pJob =
+      std::make_shared<ParallelTraversalJob>(
+          childCount,
+          [&frameState](Tile& tileToUpdate) {
+            tileToUpdate.update(
+                frameState.lastFrameNumber,
+                frameState.currentFrameNumber);
+          });
+  for (size_t i = 0; i < childCount; ++i) {
+    this->_subtreeTraversals[i]->state.pParallelTraversalJob = pJob.get();
+  }
+  for (size_t i = 0; i < helperCount; ++i) {
+    this->_asyncSystem.runInWorkerThread(
+        [pJob, visitSubtree]() { pJob->run(visitSubtree); });
+  }
+
+  pJob->run(visitSubtree);
+  pJob->wait();
+
+  for (size_t i = 0; i < childCount; ++i) {
+    this->_subtreeTraversals[i]->state.pParallelTraversalJob = nullptr;
+  }
+
+  // Merge the subtrees in the order of the children, which is the order in
+  // which the serial traversal would have visited them.
+  TraversalDetails traversalDetails;
+
+  for (size_t i = 0; i < childCount; ++i) {
+    SubtreeTraversal& subtree = *this->_subtreeTraversals[i];
+
+    for (Tile* pVisited : subtree.state.visitedTiles) {
+      this->_markVisitedTile(frameState, state, *pVisited);
+    }
+
+    appendTo(state.loadQueueHigh, subtree.state.loadQueueHigh);
+    appendTo(state.loadQueueMedium, subtree.state.loadQueueMedium);
+    appendTo(state.loadQueueLow, subtree.state.loadQueueLow);
+
+    const ViewUpdateResult& subtreeResult = subtree.result;
+    appendTo(
+        result.tilesToRenderThisFrame,
+        subtreeResult.tilesToRenderThisFrame);
+    appendTo(
+        result.tilesToNoLongerRenderThisFrame,
+        subtreeResult.tilesToNoLongerRenderThisFrame);
+    result.tilesVisited += subtreeResult.tilesVisited;
+    result.culledTilesVisited += subtreeResult.culledTilesVisited;
+    result.tilesCulled += subtreeResult.tilesCulled;
+    result.maxDepthVisited =
+        glm::max(result.maxDepthVisited, subtreeResult.maxDepthVisited);
+
+    const TraversalDetails& childTraversal = subtree.details;
+    traversalDetails.allAreRenderable &= childTraversal.allAreRenderable;
+    traversalDetails.anyWereRenderedLastFrame |=
+        childTraversal.anyWereRenderedLastFrame;
+    traversalDetails.notYetRenderableCount +=
+        childTraversal.notYetRenderableCount;
+  }
+
+  return traversalDetails;
+}
+
+void Tileset::_processLoadQueue(int32_t currentFrameNumber) {
   this->processQueue(
       this->_loadQueueHigh,
-      this->_loadsInProgress,
+      this->_traversalState.loadQueueHigh,
+      currentFrameNumber,
       this->_options.maximumSimultaneousTileLoads);
   this->processQueue(
       this->_loadQueueMedium,
-      this->_loadsInProgress,
+      this->_traversalState.loadQueueMedium,
+      currentFrameNumber,
       this->_options.maximumSimultaneousTileLoads);
   this->processQueue(
       this->_loadQueueLow,
-      this->_loadsInProgress,
+      this->_traversalState.loadQueueLow,
+      currentFrameNumber,
       this->_options.maximumSimultaneousTileLoads);
 }
 
+void Tileset::_addTilesToPrefetchQueue(
+    const std::vector<ViewState>& predictedFrustums,
+    int32_t currentFrameNumber) {
+  this->_prefetchRecords.clear();
+
+  Tile* pRootTile = this->getRootTile();
+  if (predictedFrustums.empty() || !pRootTile) {
+    return;
+  }
+
+  // A simplified traversal that finds the tiles that meet the screen-space
+  // error in the predicted views, without any of the state of the main
+  // traversal.
+  std::vector<double> distances(predictedFrustums.size());
+  std::vector<Tile*> tilesToVisit{pRootTile};
+  while (!tilesToVisit.empty()) {
+    Tile& tile = *tilesToVisit.back();
+    tilesToVisit.pop_back();
+
+    const bool isExcluded = std::any_of(
+        this->_options.excluders.begin(),
+        this->_options.excluders.end(),
+        [&tile](const std::shared_ptr<ITileExcluder>& pExcluder) {
+          return pExcluder->shouldExclude(tile);
+        });
+    if (isExcluded) {
+      continue;
+    }
+
+    const BoundingVolume& boundingVolume = tile.getBoundingVolume();
+    bool isVisible = !this->_options.enableFrustumCulling;
+    for (size_t i = 0; i < predictedFrustums.size(); ++i) {
+      const ViewState& frustum = predictedFrustums[i];
+      distances[i] = glm::sqrt(glm::max(
+          frustum.computeDistanceSquaredToBoundingVolume(boundingVolume),
+          0.0));
+      isVisible = isVisible || frustum.isBoundingVolumeVisible(boundingVolume);
+    }
+
+    if (!isVisible) {
+      continue;
+    }
+
+    const bool isRendered =
+        isLeaf(tile) ||
+        this->_meetsSse(predictedFrustums, tile, distances, false);
+    if (!isRendered && tile.getRefine() != TileRefine::Add) {
+      for (Tile& child : tile.getChildren()) {
+        tilesToVisit.push_back(&child);
+      }
+      continue;
+    }
+
+    addTileToLoadQueue(
+        this->_prefetchRecords,
+        predictedFrustums,
+        tile,
+        distances);
+
+    // Keep the tile from being unloaded or canceled before it is needed.
+    this->_markTileVisited(tile);
+    auto loadIt = this->_cancelableLoads.find(&tile);
+    if (loadIt != this->_cancelableLoads.end()) {
+      loadIt->second.lastPrefetchFrameNumber = currentFrameNumber;
+    }
+
+    if (!isRendered) {
+      for (Tile& child : tile.getChildren()) {
+        tilesToVisit.push_back(&child);
+      }
+    }
+  }
+}
+
+void Tileset::_processPrefetchQueue(
+    int32_t currentFrameNumber,
+    ViewUpdateResult& result) {
+  TileLoadQueue& queue = this->_loadQueuePrefetch;
+  for (const LoadRecord& record : this->_prefetchRecords) {
+    record.pTile->setLastNeededFrameNumber(currentFrameNumber);
+    queue.update(*record.pTile, record.priority, currentFrameNumber);
+  }
+  queue.removeUntouched(currentFrameNumber);
+
+  // The other queues were processed first, so only the load slots that they
+  // did not need are left.
+  const uint32_t maximumLoadsInProgress =
+      this->_options.maximumSimultaneousTileLoads;
+  while (this->_getLoadSlotsInUse() < maximumLoadsInProgress &&
+         !queue.empty()) {
+    Tile* pTile = queue.pop();
+    const bool wasUnloaded = pTile->getState() == Tile::LoadState::Unloaded;
+
+    CESIUM_TRACE_USE_TRACK_SET(this->_loadingSlots);
+    pTile->loadContent();
+
+    if (wasUnloaded && pTile->getState() != Tile::LoadState::Unloaded) {
+      this->_prefetchedTiles.insert(pTile);
+      ++this->_prefetchedTileCount;
+      ++result.tilesPrefetched;
+    }
+  }
+
+  result.prefetchHitRate =
+      this->_prefetchedTileCount == 0
+          ? 0.0
+          : double(this->_prefetchHitCount) /
+                double(this->_prefetchedTileCount);
+}
+
+void Tileset::_countPrefetchHits(ViewUpdateResult& result) {
+  if (this->_prefetchedTiles.empty()) {
+    return;
+  }
+
+  for (const Tile* pTile : result.tilesToRenderThisFrame) {
+    if (pTile->isRenderable() && this->_prefetchedTiles.erase(pTile) > 0) {
+      ++this->_prefetchHitCount;
+      ++result.prefetchHits;
+    }
+  }
+}
+
+void Tileset::_cancelUnneededLoads(int32_t currentFrameNumber) {
+  if (!this->_options.enableLoadCancellation) {
+    return;
+  }
+
+  // A tile is needed while the traversal keeps reaching it or putting it in a
+  // load queue, or while it is prefetched. Culled tiles are only needed when
+  // siblings are preloaded. A tile that was only queued, like a child that
+  // must load before its parent is refined, has no selection result for the
+  // frame in which it was needed, so it is not taken for a culled one.
+  const int32_t frames = this->_options.loadCancellationFrames;
+  std::vector<std::pair<Tile*, CesiumAsync::CancellationToken>> unneededLoads;
+  for (const auto& load : this->_cancelableLoads) {
+    const Tile& tile = *load.first;
+    const int32_t frameNumber = tile.getLastNeededFrameNumber();
+    const bool isNeeded =
+        (currentFrameNumber - frameNumber < frames &&
+         (this->_options.preloadSiblings ||
+          tile.getLastSelectionState().getResult(frameNumber) !=
+              TileSelectionState::Result::Culled)) ||
+        currentFrameNumber - load.second.lastPrefetchFrameNumber < frames;
+    if (!isNeeded) {
+      unneededLoads.emplace_back(load.first, load.second.token);
+    }
+  }
+
+  // The slot of a canceled load is free for another load right away, even
+  // though the load only ends in a later main thread dispatch.
+  for (const auto& load : unneededLoads) {
+    this->_cancelableLoads.erase(load.first);
+    this->_canceledLoads.insert(load.first);
+    this->_prefetchedTiles.erase(load.first);
+    load.second.cancel();
+  }
+
+  for (auto& pOverlay : this->_overlays) {
+    RasterOverlayTileProvider* pProvider = pOverlay->getTileProvider();
+    if (pProvider) {
+      pProvider->cancelUnreferencedLoads();
+    }
+  }
+}
+
 void Tileset::_unloadCachedTiles() noexcept {
   const int64_t maxBytes = this->getOptions().maximumCachedBytes;
 
@@ -1889,16 +2666,48 @@ void Tileset::_unloadCachedTiles() noexcept {
     const bool removed = pTile->unloadContent();
     if (removed) {
       this->_loadedTiles.remove(*pTile);
+      this->_prefetchedTiles.erase(pTile);
     }
 
     pTile = pNext;
   }
 }
 
+uint32_t Tileset::_getLoadSlotsInUse() const noexcept {
+  return this->_loadsInProgress.load(std::memory_order_acquire) -
+         static_cast<uint32_t>(this->_canceledLoads.size());
+}
+
 void Tileset::_markTileVisited(Tile& tile) noexcept {
   this->_loadedTiles.insertAtTail(tile);
 }
 
+void Tileset::_updateTileAndMarkVisited(
+    const FrameState& frameState,
+    TraversalState& state,
+    Tile& tile) {
+  if (state.pParallelTraversalJob) {
+    state.pParallelTraversalJob->visit(tile);
+    state.visitedTiles.push_back(&tile);
+    return;
+  }
+
+  tile.update(frameState.lastFrameNumber, frameState.currentFrameNumber);
+  this->_markVisitedTile(frameState, state, tile);
+}
+
+void Tileset::_markVisitedTile(
+    const FrameState& frameState,
+    TraversalState& state,
+    Tile& tile) {
+  tile.setLastNeededFrameNumber(frameState.currentFrameNumber);
+  this->_markTileVisited(tile);
+
+  if (!isTileSettled(tile)) {
+    ++state.unsettledTiles;
+  }
+}
+
 std::string Tileset::getResolvedContentUrl(const Tile& tile) const {
   struct Operation {
     const TileContext& context;
@@ -2024,21 +2833,23 @@ static bool anyRasterOverlaysNeedLoading(const Tile& tile) noexcept {
 }
 
 void Tileset::processQueue(
-    std::vector<Tileset::LoadRecord>& queue,
-    const std::atomic<uint32_t>& loadsInProgress,
+    TileLoadQueue& queue,
+    const std::vector<Tileset::LoadRecord>& records,
+    int32_t currentFrameNumber,
     uint32_t maximumLoadsInProgress) {
-  if (loadsInProgress >= maximumLoadsInProgress) {
-    return;
+  // Only the tiles that are still needed this frame stay in the queue. The
+  // others keep their place in the heap, and are only moved if their
+  // priority changed.
+  for (const LoadRecord& record : records) {
+    record.pTile->setLastNeededFrameNumber(currentFrameNumber);
+    queue.update(*record.pTile, record.priority, currentFrameNumber);
   }
+  queue.removeUntouched(currentFrameNumber);
 
-  std::sort(queue.begin(), queue.end());
-
-  for (LoadRecord& record : queue) {
+  while (this->_getLoadSlotsInUse() < maximumLoadsInProgress &&
+         !queue.empty()) {
     CESIUM_TRACE_USE_TRACK_SET(this->_loadingSlots);
-    record.pTile->loadContent();
-    if (loadsInProgress >= maximumLoadsInProgress) {
-      break;
-    }
+    queue.pop()->loadContent();
   }
 }
 } // namespace Cesium3DTilesSelection
@@ -0,0 +1,473 @@
+#include "Cesium3DTilesSelection/TilesetCacheSeeder.h"
+
+#include "Cesium3DTilesSelection/IPrepareRendererResources.h"
+#include "Cesium3DTilesSelection/RasterMappedTo3DTile.h"
+#include "Cesium3DTilesSelection/RasterOverlay.h"
+#include "Cesium3DTilesSelection/RasterOverlayTile.h"
+#include "Cesium3DTilesSelection/Tile.h"
+#include "Cesium3DTilesSelection/Tileset.h"
+#include "TileUtilities.h"
+
+#include <CesiumAsync/IAssetAccessor.h>
+#include <CesiumAsync/IAssetRequest.h>
+#include <CesiumAsync/IAssetResponse.h>
+
+#include <glm/trigonometric.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace CesiumAsync;
+using namespace CesiumGeospatial;
+
+namespace Cesium3DTilesSelection {
+
+namespace {
+struct RequestCounters {
+  std::atomic<int64_t> requests = 0;
+  std::atomic<int64_t> bytesReceived = 0;
+};
+
+// Counts the completed requests and the bytes received through the accessor
+// of the externals.
+class CountingAssetAccessor : public IAssetAccessor {
+public:
+  CountingAssetAccessor(
+      const std::shared_ptr<IAssetAccessor>& pAccessor,
+      const std::shared_ptr<RequestCounters>& pCounters)
+      : _pAccessor(pAccessor), _pCounters(pCounters) {}
+
+  virtual Future<std::shared_ptr<IAssetRequest>> requestAsset(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers = {}) override {
+    return this->count(
+        this->_pAccessor->requestAsset(asyncSystem, url, headers));
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>> requestAssetWithCancellation(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const CancellationToken& cancellationToken) override {
+    return this->count(this->_pAccessor->requestAssetWithCancellation(
+        asyncSystem,
+        url,
+        headers,
+        cancellationToken));
+  }
+
+  virtual Future<std::shared_ptr<IAssetRequest>> post(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers = std::vector<THeader>(),
+      const gsl::span<const std::byte>& contentPayload = {}) override {
+    return this->count(
+        this->_pAccessor->post(asyncSystem, url, headers, contentPayload));
+  }
+
+  virtual void tick() noexcept override { this->_pAccessor->tick(); }
+
+private:
+  Future<std::shared_ptr<IAssetRequest>>
+  count(Future<std::shared_ptr<IAssetRequest>>&& future) {
+    return std::move(future).thenImmediately(
+        [pCounters = this->_pCounters](
+            std::shared_ptr<IAssetRequest>&& pRequest) {
+          ++pCounters->requests;
+          const IAssetResponse* pResponse =
+              pRequest ? pRequest->response() : nullptr;
+          if (pResponse) {
+            pCounters->bytesReceived += int64_t(pResponse->data().size());
+          }
+          return std::move(pRequest);
+        });
+  }
+
+  std::shared_ptr<IAssetAccessor> _pAccessor;
+  std::shared_ptr<RequestCounters> _pCounters;
+};
+
+// The tiles are only loaded to fill the cache, so no renderer resources are
+// created for them.
+class NoRendererResources : public IPrepareRendererResources {
+public:
+  virtual void* prepareInLoadThread(
+      const CesiumGltf::Model& /*model*/,
+      const glm::dmat4& /*transform*/) override {
+    return nullptr;
+  }
+
+  virtual void*
+  prepareInMainThread(Tile& /*tile*/, void* /*pLoadThreadResult*/) override {
+    return nullptr;
+  }
+
+  virtual void free(
+      Tile& /*tile*/,
+      void* /*pLoadThreadResult*/,
+      void* /*pMainThreadResult*/) noexcept override {}
+
+  virtual void* prepareRasterInLoadThread(
+      const CesiumGltf::ImageCesium& /*image*/) override {
+    return nullptr;
+  }
+
+  virtual void* prepareRasterInMainThread(
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pLoadThreadResult*/) override {
+    return nullptr;
+  }
+
+  virtual void freeRaster(
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pLoadThreadResult*/,
+      void* /*pMainThreadResult*/) noexcept override {}
+
+  virtual void attachRasterInMainThread(
+      const Tile& /*tile*/,
+      int32_t /*overlayTextureCoordinateID*/,
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pMainThreadRendererResources*/,
+      const glm::dvec2& /*translation*/,
+      const glm::dvec2& /*scale*/) override {}
+
+  virtual void detachRasterInMainThread(
+      const Tile& /*tile*/,
+      int32_t /*overlayTextureCoordinateID*/,
+      const RasterOverlayTile& /*rasterTile*/,
+      void* /*pMainThreadRendererResources*/) noexcept override {}
+};
+
+TilesetExternals createExternals(
+    const TilesetExternals& externals,
+    const std::shared_ptr<RequestCounters>& pCounters) {
+  TilesetExternals result = externals;
+  result.pAssetAccessor = std::make_shared<CountingAssetAccessor>(
+      externals.pAssetAccessor,
+      pCounters);
+  result.pPrepareRendererResources = std::make_shared<NoRendererResources>();
+  return result;
+}
+
+// Whether the raster overlay tiles of a loaded tile are loaded, or failed.
+bool areRasterTilesSettled(Tile& tile) noexcept {
+  for (RasterMappedTo3DTile& mapped : tile.getMappedRasterTiles()) {
+    const RasterOverlayTile* pLoading = mapped.getLoadingTile();
+    if (!pLoading) {
+      continue;
+    }
+
+    switch (pLoading->getState()) {
+    case RasterOverlayTile::LoadState::Failed:
+      break;
+    case RasterOverlayTile::LoadState::Placeholder:
+      // The placeholder is only replaced once the tile provider is created,
+      // which will never happen if its creation failed.
+      if (pLoading->getOverlay().isLoadingTileProvider()) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// The key of a tile in the resume file, which is the path of child indices
+// from the root tile.
+std::string createChildKey(const std::string& parentKey, size_t index) {
+  return parentKey + "/" + std::to_string(index);
+}
+
+const std::string ROOT_KEY = "0";
+
+struct TileProgress {
+  std::string key;
+  int32_t depth;
+  size_t incompleteChildren;
+  bool contentDone;
+};
+} // namespace
+
+struct TilesetCacheSeeder::Impl {
+  Impl(
+      const std::vector<CartographicPolygon>& region_,
+      const TilesetCacheSeederOptions& options_)
+      : pCounters(std::make_shared<RequestCounters>()),
+        region(region_),
+        options(options_),
+        maximumGeometricError(
+            options_.maximumScreenSpaceError * options_.viewDistance * 2.0 *
+            glm::tan(options_.verticalFieldOfView * 0.5) /
+            options_.viewportHeight) {
+    if (options_.resumeFile.empty()) {
+      return;
+    }
+
+    std::ifstream completed(options_.resumeFile);
+    std::string key;
+    while (std::getline(completed, key)) {
+      if (!key.empty()) {
+        this->completedSubtrees.insert(key);
+      }
+    }
+
+    this->resumeStream.open(options_.resumeFile, std::ios::app);
+    if (!this->resumeStream) {
+      throw std::runtime_error(
+          "Could not open the resume file " + options_.resumeFile);
+    }
+  }
+
+  bool update() {
+    if (this->done) {
+      return true;
+    }
+
+    this->pTileset->getExternals().pAssetAccessor->tick();
+    this->pTileset->getAsyncSystem().dispatchMainThreadTasks();
+
+    if (!this->started) {
+      Tile* pRoot = this->pTileset->getRootTile();
+      if (!pRoot) {
+        if (this->pTileset->getNumberOfLoadsInProgress() == 0) {
+          this->progress.tilesetFailed = true;
+          this->done = true;
+        }
+        return this->done;
+      }
+
+      this->started = true;
+      this->tiles.emplace(pRoot, TileProgress{ROOT_KEY, 0, 0, false});
+      this->queue.push_back(pRoot);
+    }
+
+    for (size_t i = 0; i < this->loading.size();) {
+      Tile* pTile = this->loading[i];
+      if (this->advance(*pTile)) {
+        this->loading[i] = this->loading.back();
+        this->loading.pop_back();
+        this->onContentDone(*pTile);
+      } else {
+        ++i;
+      }
+    }
+
+    while (!this->queue.empty() &&
+           this->loading.size() < this->options.maximumSimultaneousTileLoads) {
+      Tile* pTile = this->queue.back();
+      this->queue.pop_back();
+      this->start(*pTile);
+    }
+
+    this->resumeStream.flush();
+
+    this->progress.tilesLoading = int64_t(this->loading.size());
+    this->progress.tilesQueued = int64_t(this->queue.size());
+    this->progress.requests = this->pCounters->requests;
+    this->progress.bytesReceived = this->pCounters->bytesReceived;
+
+    if (this->tiles.empty()) {
+      this->done = true;
+    }
+
+    return this->done;
+  }
+
+  void start(Tile& tile) {
+    const TileProgress& tileProgress = this->tiles.at(&tile);
+    if (this->completedSubtrees.count(tileProgress.key)) {
+      ++this->progress.subtreesSkipped;
+      this->complete(tile, false);
+      return;
+    }
+
+    const std::optional<GlobeRectangle> rectangle =
+        Cesium3DTilesSelection::Impl::estimateGlobeRectangle(
+            tile.getBoundingVolume());
+    if (rectangle && !Cesium3DTilesSelection::Impl::intersectsPolygons(
+                         *rectangle,
+                         this->region)) {
+      this->complete(tile, false);
+      return;
+    }
+
+    tile.loadContent();
+    this->loading.push_back(&tile);
+  }
+
+  // Moves the tile along, and returns whether its content and raster overlay
+  // tiles are loaded or failed.
+  bool advance(Tile& tile) {
+    switch (tile.getState()) {
+    case Tile::LoadState::Unloaded:
+      // The tile is loaded again after a failure that is retried, such as an
+      // expired Cesium ion token.
+      tile.loadContent();
+      return false;
+    case Tile::LoadState::ContentLoading:
+      return false;
+    default:
+      break;
+    }
+
+    tile.update(0, 0);
+
+    if (tile.getState() == Tile::LoadState::Failed) {
+      return true;
+    }
+    if (tile.getState() != Tile::LoadState::Done) {
+      return false;
+    }
+
+    // Start the loads of throttled raster overlay tiles.
+    tile.loadContent();
+    return areRasterTilesSettled(tile);
+  }
+
+  void onContentDone(Tile& tile) {
+    TileProgress& tileProgress = this->tiles.at(&tile);
+    tileProgress.contentDone = true;
+
+    if (tile.getState() == Tile::LoadState::Failed) {
+      ++this->progress.tilesFailed;
+      if (tileProgress.key == ROOT_KEY) {
+        this->progress.tilesetFailed = true;
+      }
+      this->complete(tile, true);
+      return;
+    }
+
+    ++this->progress.tilesLoaded;
+
+    const bool refine =
+        (!this->options.maximumDepth ||
+         tileProgress.depth < *this->options.maximumDepth) &&
+        (tile.getUnconditionallyRefine() ||
+         tile.getGeometricError() > this->maximumGeometricError);
+    const gsl::span<Tile> children = tile.getChildren();
+    if (!refine || children.empty()) {
+      this->complete(tile, true);
+      return;
+    }
+
+    tileProgress.incompleteChildren = children.size();
+
+    // The children are pushed in reverse, so that the first child is loaded
+    // first.
+    for (size_t i = children.size(); i > 0; --i) {
+      Tile& child = children[i - 1];
+      this->tiles.emplace(
+          &child,
+          TileProgress{
+              createChildKey(tileProgress.key, i - 1),
+              tileProgress.depth + 1,
+              0,
+              false});
+      this->queue.push_back(&child);
+    }
+  }
+
+  // Unloads a tile whose subtree is complete, and completes its parent if it
+  // was the last incomplete child.
+  void complete(Tile& tile, bool record) {
+    auto it = this->tiles.find(&tile);
+    if (record && this->resumeStream.is_open()) {
+      this->resumeStream << it->second.key << '\n';
+    }
+    this->tiles.erase(it);
+
+    tile.unloadContent();
+
+    auto parentIt = this->tiles.find(tile.getParent());
+    if (parentIt == this->tiles.end()) {
+      return;
+    }
+
+    TileProgress& parentProgress = parentIt->second;
+    --parentProgress.incompleteChildren;
+    if (parentProgress.incompleteChildren == 0 && parentProgress.contentDone) {
+      this->complete(*tile.getParent(), true);
+    }
+  }
+
+  std::shared_ptr<RequestCounters> pCounters;
+  std::vector<CartographicPolygon> region;
+  TilesetCacheSeederOptions options;
+  double maximumGeometricError;
+  std::unique_ptr<Tileset> pTileset;
+
+  // The tiles that are queued, loading, or have incomplete children.
+  std::unordered_map<const Tile*, TileProgress> tiles;
+  std::vector<Tile*> queue;
+  std::vector<Tile*> loading;
+
+  std::unordered_set<std::string> completedSubtrees;
+  std::ofstream resumeStream;
+
+  bool started = false;
+  bool done = false;
+  TilesetCacheSeederProgress progress;
+};
+
+TilesetCacheSeeder::TilesetCacheSeeder(
+    const TilesetExternals& externals,
+    const std::string& url,
+    const std::vector<CartographicPolygon>& region,
+    const TilesetCacheSeederOptions& options)
+    : _pImpl(std::make_unique<Impl>(region, options)) {
+  this->_pImpl->pTileset = std::make_unique<Tileset>(
+      createExternals(externals, this->_pImpl->pCounters),
+      url);
+}
+
+TilesetCacheSeeder::TilesetCacheSeeder(
+    const TilesetExternals& externals,
+    uint32_t ionAssetID,
+    const std::string& ionAccessToken,
+    const std::vector<CartographicPolygon>& region,
+    const TilesetCacheSeederOptions& options)
+    : _pImpl(std::make_unique<Impl>(region, options)) {
+  this->_pImpl->pTileset = std::make_unique<Tileset>(
+      createExternals(externals, this->_pImpl->pCounters),
+      ionAssetID,
+      ionAccessToken);
+}
+
+TilesetCacheSeeder::~TilesetCacheSeeder() = default;
+
+CartographicPolygon
+TilesetCacheSeeder::createPolygon(const GlobeRectangle& rectangle) {
+  return CartographicPolygon(std::vector<glm::dvec2>{
+      glm::dvec2(rectangle.getWest(), rectangle.getSouth()),
+      glm::dvec2(rectangle.getEast(), rectangle.getSouth()),
+      glm::dvec2(rectangle.getEast(), rectangle.getNorth()),
+      glm::dvec2(rectangle.getWest(), rectangle.getNorth())});
+}
+
+Tileset& TilesetCacheSeeder::getTileset() noexcept {
+  return *this->_pImpl->pTileset;
+}
+
+const Tileset& TilesetCacheSeeder::getTileset() const noexcept {
+  return *this->_pImpl->pTileset;
+}
+
+bool TilesetCacheSeeder::update() { return this->_pImpl->update(); }
+
+bool TilesetCacheSeeder::isDone() const noexcept {
+  return this->_pImpl->done;
+}
+
+const TilesetCacheSeederProgress&
+TilesetCacheSeeder::getProgress() const noexcept {
+  return this->_pImpl->progress;
+}
+
+} // namespace Cesium3DTilesSelection
@@ -2,8 +2,13 @@
 
 #include <CesiumGeometry/CullingVolume.h>
 
+#include <glm/common.hpp>
 #include <glm/trigonometric.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+
 using namespace CesiumGeometry;
 using namespace CesiumGeospatial;
 
@@ -16,7 +21,9 @@ namespace Cesium3DTilesSelection {
     const glm::dvec2& viewportSize,
     double horizontalFieldOfView,
     double verticalFieldOfView,
-    const CesiumGeospatial::Ellipsoid& ellipsoid) {
+    const CesiumGeospatial::Ellipsoid& ellipsoid,
+    const std::optional<double>& nearDistance,
+    const std::optional<double>& farDistance) {
   return ViewState(
       position,
       direction,
@@ -24,7 +31,25 @@ namespace Cesium3DTilesSelection {
       viewportSize,
       horizontalFieldOfView,
       verticalFieldOfView,
-      ellipsoid.cartesianToCartographic(position));
+      ellipsoid.cartesianToCartographic(position),
+      nearDistance,
+      farDistance);
+}
+
+ViewState ViewState::extrapolate(
+    const glm::dvec3& velocity,
+    double seconds,
+    const CesiumGeospatial::Ellipsoid& ellipsoid) const {
+  return ViewState::create(
+      this->_position + velocity * seconds,
+      this->_direction,
+      this->_up,
+      this->_viewportSize,
+      this->_horizontalFieldOfView,
+      this->_verticalFieldOfView,
+      ellipsoid,
+      this->_nearDistance,
+      this->_farDistance);
 }
 
 ViewState::ViewState(
@@ -34,13 +59,17 @@ ViewState::ViewState(
     const glm::dvec2& viewportSize,
     double horizontalFieldOfView,
     double verticalFieldOfView,
-    const std::optional<CesiumGeospatial::Cartographic>& positionCartographic)
+    const std::optional<CesiumGeospatial::Cartographic>& positionCartographic,
+    const std::optional<double>& nearDistance,
+    const std::optional<double>& farDistance)
     : _position(position),
       _direction(direction),
       _up(up),
       _viewportSize(viewportSize),
       _horizontalFieldOfView(horizontalFieldOfView),
       _verticalFieldOfView(verticalFieldOfView),
+      _nearDistance(nearDistance),
+      _farDistance(farDistance),
       _sseDenominator(2.0 * glm::tan(0.5 * verticalFieldOfView)),
       _positionCartographic(positionCartographic),
       _cullingVolume(createCullingVolume(
@@ -48,72 +77,214 @@ ViewState::ViewState(
           direction,
           up,
           horizontalFieldOfView,
-          verticalFieldOfView)) {}
+          verticalFieldOfView,
+          nearDistance,
+          farDistance)) {}
+
+/**
+ * @brief Returns the planes of the culling volume in the order of the bits of
+ * a {@link ViewState::PlaneMask}, with `nullptr` for a missing near or far
+ * plane.
+ */
+static std::array<const Plane*, 6>
+getPlanes(const CullingVolume& cullingVolume) noexcept {
+  return {
+      &cullingVolume.leftPlane,
+      &cullingVolume.rightPlane,
+      &cullingVolume.topPlane,
+      &cullingVolume.bottomPlane,
+      cullingVolume.nearPlane ? &cullingVolume.nearPlane.value() : nullptr,
+      cullingVolume.farPlane ? &cullingVolume.farPlane.value() : nullptr};
+}
 
 template <class T>
-static bool isBoundingVolumeVisible(
+static ViewState::PlaneMask computePlaneMask(
     const T& boundingVolume,
-    const CullingVolume& cullingVolume) noexcept {
-  const CullingResult left =
-      boundingVolume.intersectPlane(cullingVolume.leftPlane);
-  if (left == CullingResult::Outside) {
-    return false;
+    const CullingVolume& cullingVolume,
+    ViewState::PlaneMask parentPlaneMask) noexcept {
+  // An ancestor that is outside of the culling volume tells us nothing about
+  // this bounding volume, so test all planes in that case.
+  if (parentPlaneMask == ViewState::PLANE_MASK_OUTSIDE) {
+    parentPlaneMask = ViewState::PLANE_MASK_INDETERMINATE;
   }
 
-  const CullingResult right =
-      boundingVolume.intersectPlane(cullingVolume.rightPlane);
-  if (right == CullingResult::Outside) {
-    return false;
-  }
+  const std::array<const Plane*, 6> planes = getPlanes(cullingVolume);
 
-  const CullingResult top =
-      boundingVolume.intersectPlane(cullingVolume.topPlane);
-  if (top == CullingResult::Outside) {
-    return false;
-  }
+  ViewState::PlaneMask planeMask = ViewState::PLANE_MASK_INSIDE;
+  for (size_t i = 0; i < planes.size(); ++i) {
+    const ViewState::PlaneMask planeBit = ViewState::PlaneMask(1) << i;
+    if ((parentPlaneMask & planeBit) == 0 || planes[i] == nullptr) {
+      // The parent is entirely inside this plane, or there is no such plane.
+      continue;
+    }
 
-  const CullingResult bottom =
-      boundingVolume.intersectPlane(cullingVolume.bottomPlane);
-  if (bottom == CullingResult::Outside) {
-    return false;
+    const CullingResult result = boundingVolume.intersectPlane(*planes[i]);
+    if (result == CullingResult::Outside) {
+      return ViewState::PLANE_MASK_OUTSIDE;
+    }
+    if (result == CullingResult::Intersecting) {
+      planeMask |= planeBit;
+    }
   }
 
-  return true;
+  return planeMask;
 }
 
 bool ViewState::isBoundingVolumeVisible(
     const BoundingVolume& boundingVolume) const noexcept {
-  // TODO: use plane masks
+  return this->computePlaneMask(boundingVolume, PLANE_MASK_INDETERMINATE) !=
+         PLANE_MASK_OUTSIDE;
+}
+
+ViewState::PlaneMask ViewState::computePlaneMask(
+    const BoundingVolume& boundingVolume,
+    PlaneMask parentPlaneMask) const noexcept {
   struct Operation {
     const ViewState& viewState;
+    PlaneMask parentMask;
 
-    bool operator()(const OrientedBoundingBox& boundingBox) noexcept {
-      return Cesium3DTilesSelection::isBoundingVolumeVisible(
+    PlaneMask operator()(const OrientedBoundingBox& boundingBox) noexcept {
+      return Cesium3DTilesSelection::computePlaneMask(
           boundingBox,
-          viewState._cullingVolume);
+          viewState._cullingVolume,
+          parentMask);
     }
 
-    bool operator()(const BoundingRegion& boundingRegion) noexcept {
-      return Cesium3DTilesSelection::isBoundingVolumeVisible(
+    PlaneMask operator()(const BoundingRegion& boundingRegion) noexcept {
+      return Cesium3DTilesSelection::computePlaneMask(
           boundingRegion,
-          viewState._cullingVolume);
+          viewState._cullingVolume,
+          parentMask);
     }
 
-    bool operator()(const BoundingSphere& boundingSphere) noexcept {
-      return Cesium3DTilesSelection::isBoundingVolumeVisible(
+    PlaneMask operator()(const BoundingSphere& boundingSphere) noexcept {
+      return Cesium3DTilesSelection::computePlaneMask(
           boundingSphere,
-          viewState._cullingVolume);
+          viewState._cullingVolume,
+          parentMask);
     }
 
-    bool operator()(
+    PlaneMask operator()(
         const BoundingRegionWithLooseFittingHeights& boundingRegion) noexcept {
-      return Cesium3DTilesSelection::isBoundingVolumeVisible(
+      return Cesium3DTilesSelection::computePlaneMask(
           boundingRegion.getBoundingRegion(),
-          viewState._cullingVolume);
+          viewState._cullingVolume,
+          parentMask);
     }
   };
 
-  return std::visit(Operation{*this}, boundingVolume);
+  return std::visit(Operation{*this, parentPlaneMask}, boundingVolume);
+}
+
+void ViewState::computePlaneMasksAndDistancesSquared(
+    const BoundingVolumeBatch& boundingVolumes,
+    PlaneMask parentPlaneMask,
+    gsl::span<PlaneMask> planeMasks,
+    gsl::span<double> distancesSquared) const noexcept {
+  const size_t count = boundingVolumes.size();
+  assert(planeMasks.size() >= count);
+  assert(distancesSquared.size() >= count);
+
+  const std::array<std::vector<double>, 3>& centers =
+      boundingVolumes.getCenters();
+  const std::array<std::array<std::vector<double>, 3>, 3>& axes =
+      boundingVolumes.getAxes();
+  const std::array<std::vector<double>, 3>& halfLengths =
+      boundingVolumes.getHalfLengths();
+
+  const double* pCenterX = centers[0].data();
+  const double* pCenterY = centers[1].data();
+  const double* pCenterZ = centers[2].data();
+  const double* pAxis0X = axes[0][0].data();
+  const double* pAxis0Y = axes[0][1].data();
+  const double* pAxis0Z = axes[0][2].data();
+  const double* pAxis1X = axes[1][0].data();
+  const double* pAxis1Y = axes[1][1].data();
+  const double* pAxis1Z = axes[1][2].data();
+  const double* pAxis2X = axes[2][0].data();
+  const double* pAxis2Y = axes[2][1].data();
+  const double* pAxis2Z = axes[2][2].data();
+  const double* pHalfLength0 = halfLengths[0].data();
+  const double* pHalfLength1 = halfLengths[1].data();
+  const double* pHalfLength2 = halfLengths[2].data();
+  const double* pRadius = boundingVolumes.getRadii().data();
+  PlaneMask* pPlaneMasks = planeMasks.data();
+  double* pDistancesSquared = distancesSquared.data();
+
+  if (parentPlaneMask == PLANE_MASK_OUTSIDE) {
+    parentPlaneMask = PLANE_MASK_INDETERMINATE;
+  }
+
+  std::fill_n(pPlaneMasks, count, PLANE_MASK_INSIDE);
+
+  // Test one plane at a time against all volumes. A volume outside of any
+  // plane gets all bits set, which later planes can not clear again.
+  const std::array<const Plane*, 6> planes = getPlanes(this->_cullingVolume);
+  for (size_t i = 0; i < planes.size(); ++i) {
+    const PlaneMask planeBit = PlaneMask(1) << i;
+    if ((parentPlaneMask & planeBit) == 0 || planes[i] == nullptr) {
+      continue;
+    }
+
+    const glm::dvec3& normal = planes[i]->getNormal();
+    const double distance = planes[i]->getDistance();
+
+    for (size_t j = 0; j < count; ++j) {
+      const double distanceToPlane = normal.x * pCenterX[j] +
+                                     normal.y * pCenterY[j] +
+                                     normal.z * pCenterZ[j] + distance;
+      const double radEffective =
+          pRadius[j] +
+          pHalfLength0[j] * glm::abs(
+                                normal.x * pAxis0X[j] + normal.y * pAxis0Y[j] +
+                                normal.z * pAxis0Z[j]) +
+          pHalfLength1[j] * glm::abs(
+                                normal.x * pAxis1X[j] + normal.y * pAxis1Y[j] +
+                                normal.z * pAxis1Z[j]) +
+          pHalfLength2[j] * glm::abs(
+                                normal.x * pAxis2X[j] + normal.y * pAxis2Y[j] +
+                                normal.z * pAxis2Z[j]);
+
+      const PlaneMask intersecting =
+          distanceToPlane < radEffective ? planeBit : PLANE_MASK_INSIDE;
+      pPlaneMasks[j] |= distanceToPlane < -radEffective ? PLANE_MASK_OUTSIDE
+                                                         : intersecting;
+    }
+  }
+
+  // The distance to a box is the length of the part of the offset to its
+  // center that sticks out along each axis. A sphere is a box without extent,
+  // and its radius is subtracted the same way as in
+  // BoundingSphere::computeDistanceSquaredToPosition.
+  const glm::dvec3& position = this->_position;
+
+  for (size_t j = 0; j < count; ++j) {
+    const double offsetX = position.x - pCenterX[j];
+    const double offsetY = position.y - pCenterY[j];
+    const double offsetZ = position.z - pCenterZ[j];
+
+    const double along0 =
+        offsetX * pAxis0X[j] + offsetY * pAxis0Y[j] + offsetZ * pAxis0Z[j];
+    const double along1 =
+        offsetX * pAxis1X[j] + offsetY * pAxis1Y[j] + offsetZ * pAxis1Z[j];
+    const double along2 =
+        offsetX * pAxis2X[j] + offsetY * pAxis2Y[j] + offsetZ * pAxis2Z[j];
+
+    const double excess0 = glm::max(glm::abs(along0) - pHalfLength0[j], 0.0);
+    const double excess1 = glm::max(glm::abs(along1) - pHalfLength1[j], 0.0);
+    const double excess2 = glm::max(glm::abs(along2) - pHalfLength2[j], 0.0);
+
+    pDistancesSquared[j] = excess0 * excess0 + excess1 * excess1 +
+                           excess2 * excess2 - pRadius[j] * pRadius[j];
+  }
+
+  // Regions measure their distance from the cartographic position instead.
+  for (const auto& exactDistanceVolume :
+       boundingVolumes.getExactDistanceVolumes()) {
+    pDistancesSquared[exactDistanceVolume.first] =
+        this->computeDistanceSquaredToBoundingVolume(
+            exactDistanceVolume.second);
+  }
 }
 
 double ViewState::computeDistanceSquaredToBoundingVolume(
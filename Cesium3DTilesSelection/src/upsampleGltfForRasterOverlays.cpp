@@ -35,7 +35,7 @@ static void upsamplePrimitiveForRasterOverlays(
     CesiumGeometry::UpsampledQuadtreeNode childID);
 
 struct FloatVertexAttribute {
-  const std::vector<std::byte>& buffer;
+  gsl::span<const std::byte> buffer;
   int64_t offset;
   int64_t stride;
   int64_t numberOfFloatsPerVertex;
@@ -455,7 +455,7 @@ static void upsamplePrimitiveForRasterOverlays(
     vertexSizeFloats += accessorComponentElements;
 
     attributes.push_back(FloatVertexAttribute{
-        buffer.cesium.data,
+        buffer.cesium.getData(),
         accessor.byteOffset,
         accessorByteStride,
         accessorComponentElements,
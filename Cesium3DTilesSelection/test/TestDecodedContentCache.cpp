@@ -0,0 +1,496 @@
+#include "Cesium3DTilesSelection/DecodedContentCache.h"
+#include "Cesium3DTilesSelection/GltfContent.h"
+
+#include <CesiumGltf/GltfReader.h>
+#include <CesiumGltf/ImageDecoder.h>
+#include <CesiumGltf/KHR_draco_mesh_compression.h>
+#include <CesiumGltf/MeshPrimitiveEXT_feature_metadata.h>
+#include <CesiumGltf/ModelEXT_feature_metadata.h>
+#include <CesiumUtility/JsonValue.h>
+
+#include <catch2/catch.hpp>
+#include <glm/vec3.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4127 4018 4804)
+#endif
+
+#include <draco/compression/encode.h>
+#include <draco/mesh/mesh.h>
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+using namespace CesiumAsync;
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGltf;
+using namespace CesiumUtility;
+
+namespace {
+class InMemoryCacheDatabase : public ICacheDatabase {
+public:
+  virtual std::optional<CacheItem>
+  getEntry(const std::string& key) const override {
+    auto it = this->entries.find(key);
+    if (it == this->entries.end()) {
+      return std::nullopt;
+    }
+    return CacheItem(
+        0,
+        CacheRequest(HttpHeaders(), "GET", std::string(key)),
+        CacheResponse(200, HttpHeaders(), std::vector<std::byte>(it->second)));
+  }
+
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t /*expiryTime*/,
+      const std::string& /*url*/,
+      const std::string& /*requestMethod*/,
+      const HttpHeaders& /*requestHeaders*/,
+      uint16_t /*statusCode*/,
+      const HttpHeaders& /*responseHeaders*/,
+      const gsl::span<const std::byte>& responseData) override {
+    this->entries[key] =
+        std::vector<std::byte>(responseData.begin(), responseData.end());
+    return true;
+  }
+
+  virtual bool prune() override { return true; }
+
+  virtual bool clearAll() override {
+    this->entries.clear();
+    return true;
+  }
+
+  std::map<std::string, std::vector<std::byte>> entries;
+};
+
+class TestImageDecoder final : public ImageDecoder {
+public:
+  ImageReaderResult decode(
+      const gsl::span<const std::byte>& /*data*/,
+      const ReadImageOptions& /*options*/) const override {
+    return ImageReaderResult();
+  }
+};
+
+std::vector<std::byte> createBytes(size_t size) {
+  std::vector<std::byte> bytes(size);
+  for (size_t i = 0; i < size; ++i) {
+    bytes[i] = std::byte(i * 7);
+  }
+  return bytes;
+}
+
+Model createModel() {
+  Model model;
+  model.asset.version = "2.0";
+  model.extensionsUsed = {"EXT_feature_metadata", "KHR_draco_mesh_compression"};
+  model.extensionsRequired = {"KHR_draco_mesh_compression"};
+  model.extras["RTC_CENTER"] = JsonValue::Array{1.5, -2.0, 3.0};
+  model.extras["object"] = JsonValue::Object{
+      {"null", JsonValue()},
+      {"bool", true},
+      {"int", int64_t(-3)},
+      {"uint", uint64_t(4)},
+      {"string", "value"}};
+
+  Buffer& buffer = model.buffers.emplace_back();
+  buffer.byteLength = 100;
+  buffer.cesium.data = createBytes(100);
+
+  BufferView& bufferView = model.bufferViews.emplace_back();
+  bufferView.buffer = 0;
+  bufferView.byteLength = 96;
+  bufferView.byteStride = 12;
+
+  Accessor& accessor = model.accessors.emplace_back();
+  accessor.bufferView = 0;
+  accessor.componentType = Accessor::ComponentType::FLOAT;
+  accessor.count = 8;
+  accessor.type = Accessor::Type::VEC3;
+  accessor.min = {-1.0, -1.0, -1.0};
+  accessor.max = {1.0, 1.0, 1.0};
+  accessor.sparse.emplace().count = 2;
+
+  Image& image = model.images.emplace_back();
+  image.name = "image";
+  image.mimeType = "image/png";
+  image.cesium.width = 2;
+  image.cesium.height = 3;
+  image.cesium.channels = 4;
+  image.cesium.pixelData = createBytes(24);
+
+  Image& compressedImage = model.images.emplace_back();
+  compressedImage.mimeType = "image/ktx2";
+  compressedImage.cesium.width = 8;
+  compressedImage.cesium.height = 4;
+  compressedImage.cesium.compressedPixelFormat =
+      GpuCompressedPixelFormat::BC1_RGBA;
+  compressedImage.cesium.isSrgb = true;
+  compressedImage.cesium.mipPositions = {{0, 16}, {16, 8}, {24, 8}, {32, 8}};
+  compressedImage.cesium.pixelData = createBytes(40);
+
+  Material& material = model.materials.emplace_back();
+  material.pbrMetallicRoughness.emplace().baseColorTexture.emplace().index = 0;
+  material.normalTexture.emplace().scale = 0.5;
+  material.doubleSided = true;
+
+  MeshPrimitive& primitive =
+      model.meshes.emplace_back().primitives.emplace_back();
+  primitive.attributes["POSITION"] = 0;
+  primitive.material = 0;
+  primitive.addExtension<KHR_draco_mesh_compression>().bufferView = 0;
+  primitive.addExtension<MeshPrimitiveEXT_feature_metadata>()
+      .featureIdAttributes.emplace_back()
+      .featureTable = "table";
+  primitive.extensions["UNKNOWN_extension"] =
+      JsonValue(JsonValue::Object{{"value", 1.0}});
+
+  ModelEXT_feature_metadata& metadata =
+      model.addExtension<ModelEXT_feature_metadata>();
+  ClassProperty& property =
+      metadata.schema.emplace().classes["class"].properties["property"];
+  property.type = "ARRAY";
+  property.componentType = "UINT8";
+  property.componentCount = 3;
+  FeatureTable& featureTable = metadata.featureTables["table"];
+  featureTable.classProperty = "class";
+  featureTable.count = 8;
+  featureTable.properties["property"].bufferView = 0;
+
+  Node& node = model.nodes.emplace_back();
+  node.mesh = 0;
+  node.translation = {1.0, 2.0, 3.0};
+  model.scenes.emplace_back().nodes = {0};
+  model.scene = 0;
+
+  return model;
+}
+
+void checkModel(const Model& model) {
+  REQUIRE(model.asset.version == "2.0");
+  REQUIRE(
+      model.extensionsUsed == std::vector<std::string>{"EXT_feature_metadata"});
+  REQUIRE(model.extensionsRequired.empty());
+  REQUIRE(model.extras.at("RTC_CENTER").getArray().size() == 3);
+  REQUIRE(model.extras.at("RTC_CENTER").getArray()[1].getDouble() == -2.0);
+  const JsonValue& object = model.extras.at("object");
+  REQUIRE(object.getValuePtrForKey("null")->isNull());
+  REQUIRE(object.getValuePtrForKey("bool")->getBool());
+  REQUIRE(*object.getValuePtrForKey<int64_t>("int") == -3);
+  REQUIRE(*object.getValuePtrForKey<uint64_t>("uint") == 4);
+  REQUIRE(object.getValuePtrForKey("string")->getString() == "value");
+
+  REQUIRE(model.buffers.size() == 1);
+  REQUIRE(model.buffers[0].cesium.data == createBytes(100));
+  REQUIRE(model.bufferViews[0].byteStride == 12);
+  REQUIRE(!model.bufferViews[0].target);
+
+  const Accessor& accessor = model.accessors[0];
+  REQUIRE(accessor.componentType == Accessor::ComponentType::FLOAT);
+  REQUIRE(accessor.count == 8);
+  REQUIRE(accessor.type == Accessor::Type::VEC3);
+  REQUIRE(accessor.max == std::vector<double>{1.0, 1.0, 1.0});
+  REQUIRE(accessor.sparse);
+  REQUIRE(accessor.sparse->count == 2);
+
+  const Image& image = model.images[0];
+  REQUIRE(image.name == "image");
+  REQUIRE(image.mimeType == "image/png");
+  REQUIRE(!image.uri);
+  REQUIRE(image.cesium.width == 2);
+  REQUIRE(image.cesium.height == 3);
+  REQUIRE(image.cesium.pixelData == createBytes(24));
+  REQUIRE(
+      image.cesium.compressedPixelFormat == GpuCompressedPixelFormat::NONE);
+  REQUIRE(!image.cesium.isSrgb);
+  REQUIRE(image.cesium.mipPositions.empty());
+
+  const ImageCesium& compressedImage = model.images[1].cesium;
+  REQUIRE(
+      compressedImage.compressedPixelFormat ==
+      GpuCompressedPixelFormat::BC1_RGBA);
+  REQUIRE(compressedImage.isSrgb);
+  REQUIRE(compressedImage.mipPositions.size() == 4);
+  REQUIRE(compressedImage.mipPositions[1].byteOffset == 16);
+  REQUIRE(compressedImage.mipPositions[3].byteSize == 8);
+  REQUIRE(compressedImage.pixelData == createBytes(40));
+
+  const Material& material = model.materials[0];
+  REQUIRE(material.pbrMetallicRoughness->baseColorTexture->index == 0);
+  REQUIRE(!material.pbrMetallicRoughness->metallicRoughnessTexture);
+  REQUIRE(material.normalTexture->scale == 0.5);
+  REQUIRE(!material.occlusionTexture);
+  REQUIRE(material.doubleSided);
+
+  const MeshPrimitive& primitive = model.meshes[0].primitives[0];
+  REQUIRE(primitive.attributes.at("POSITION") == 0);
+  REQUIRE(primitive.material == 0);
+  REQUIRE(!primitive.getExtension<KHR_draco_mesh_compression>());
+  const MeshPrimitiveEXT_feature_metadata* pPrimitiveMetadata =
+      primitive.getExtension<MeshPrimitiveEXT_feature_metadata>();
+  REQUIRE(pPrimitiveMetadata);
+  REQUIRE(pPrimitiveMetadata->featureIdAttributes[0].featureTable == "table");
+  const JsonValue* pUnknown =
+      primitive.getGenericExtension("UNKNOWN_extension");
+  REQUIRE(pUnknown);
+  REQUIRE(*pUnknown->getValuePtrForKey<double>("value") == 1.0);
+
+  const ModelEXT_feature_metadata* pMetadata =
+      model.getExtension<ModelEXT_feature_metadata>();
+  REQUIRE(pMetadata);
+  const ClassProperty& property =
+      pMetadata->schema->classes.at("class").properties.at("property");
+  REQUIRE(property.type == "ARRAY");
+  REQUIRE(property.componentType.getString() == "UINT8");
+  REQUIRE(property.componentCount == 3);
+  const FeatureTable& featureTable = pMetadata->featureTables.at("table");
+  REQUIRE(featureTable.classProperty == "class");
+  REQUIRE(featureTable.count == 8);
+  REQUIRE(featureTable.properties.at("property").bufferView == 0);
+
+  REQUIRE(model.nodes[0].mesh == 0);
+  REQUIRE(model.nodes[0].translation == std::vector<double>{1.0, 2.0, 3.0});
+  REQUIRE(model.scenes[0].nodes == std::vector<int32_t>{0});
+  REQUIRE(model.scene == 0);
+}
+
+struct UnsupportedExtension {};
+
+// Creates a GLB with one triangle compressed with KHR_draco_mesh_compression.
+std::vector<std::byte> createDracoGlb() {
+  const std::vector<glm::vec3> positions{
+      {0.0f, 0.0f, 0.0f},
+      {1.0f, 0.0f, 0.0f},
+      {0.0f, 1.0f, 0.0f}};
+
+  draco::Mesh dracoMesh;
+  dracoMesh.set_num_points(3);
+  draco::GeometryAttribute attribute;
+  attribute.Init(
+      draco::GeometryAttribute::POSITION,
+      nullptr,
+      3,
+      draco::DT_FLOAT32,
+      false,
+      sizeof(glm::vec3),
+      0);
+  draco::PointAttribute* pAttribute =
+      dracoMesh.attribute(dracoMesh.AddAttribute(attribute, true, 3));
+  for (uint32_t i = 0; i < 3; ++i) {
+    pAttribute->SetAttributeValue(
+        draco::AttributeValueIndex(i),
+        &positions[i]);
+  }
+  dracoMesh.AddFace(
+      {draco::PointIndex(0), draco::PointIndex(1), draco::PointIndex(2)});
+
+  draco::Encoder encoder;
+  draco::EncoderBuffer buffer;
+  REQUIRE(encoder.EncodeMeshToBuffer(dracoMesh, &buffer).ok());
+
+  std::vector<std::byte> binary(
+      reinterpret_cast<const std::byte*>(buffer.data()),
+      reinterpret_cast<const std::byte*>(buffer.data()) + buffer.size());
+  const std::string byteLength = std::to_string(binary.size());
+  std::string json =
+      R"({ "asset": { "version": "2.0" }, )"
+      R"("extensionsUsed": [ "KHR_draco_mesh_compression" ], )"
+      R"("extensionsRequired": [ "KHR_draco_mesh_compression" ], )"
+      R"("buffers": [ { "byteLength": )" +
+      byteLength + R"( } ], "bufferViews": [ { "buffer": 0, "byteLength": )" +
+      byteLength +
+      R"( } ], "accessors": [ { "componentType": 5126, "count": 3, )"
+      R"("type": "VEC3", "min": [ 0, 0, 0 ], "max": [ 1, 1, 0 ] }, )"
+      R"({ "componentType": 5125, "count": 3, "type": "SCALAR" } ], )"
+      R"("meshes": [ { "primitives": [ { "attributes": { "POSITION": 0 }, )"
+      R"("indices": 1, "extensions": { "KHR_draco_mesh_compression": )"
+      R"({ "bufferView": 0, "attributes": { "POSITION": )" +
+      std::to_string(pAttribute->unique_id()) + " } } } } ] } ] }";
+  json.resize((json.size() + 3) & ~size_t(3), ' ');
+  binary.resize((binary.size() + 3) & ~size_t(3), std::byte(0));
+
+  std::vector<std::byte> glb;
+  const auto append = [&glb](const void* pData, size_t size) {
+    const std::byte* pBytes = static_cast<const std::byte*>(pData);
+    glb.insert(glb.end(), pBytes, pBytes + size);
+  };
+  const uint32_t header[] = {
+      0x46546C67,
+      2,
+      uint32_t(12 + 8 + json.size() + 8 + binary.size()),
+      uint32_t(json.size()),
+      0x4E4F534A};
+  append(header, sizeof(header));
+  append(json.data(), json.size());
+  const uint32_t binaryHeader[] = {uint32_t(binary.size()), 0x004E4942};
+  append(binaryHeader, sizeof(binaryHeader));
+  append(binary.data(), binary.size());
+  return glb;
+}
+} // namespace
+
+TEST_CASE("Test the decoded content cache") {
+  SECTION("Writes and reads a model") {
+    const std::vector<std::byte> data =
+        DecodedContentCache::writeModel(createModel());
+    const std::optional<Model> model = DecodedContentCache::readModel(data);
+    REQUIRE(model);
+    checkModel(*model);
+  }
+
+  SECTION("Writes the data of a buffer that does not own it") {
+    const std::shared_ptr<std::vector<std::byte>> pData =
+        std::make_shared<std::vector<std::byte>>(createBytes(100));
+    Model original = createModel();
+    BufferCesium& buffer = original.buffers[0].cesium;
+    buffer.data.clear();
+    buffer.externalData = *pData;
+    buffer.pExternalDataOwner = pData;
+
+    const std::vector<std::byte> data =
+        DecodedContentCache::writeModel(original);
+    const std::optional<Model> model = DecodedContentCache::readModel(data);
+    REQUIRE(model);
+    checkModel(*model);
+  }
+
+  SECTION("Writes and reads a model that was compressed with Draco") {
+    GltfReader reader;
+    const ModelReaderResult result = reader.readModel(createDracoGlb());
+    REQUIRE(result.model);
+    REQUIRE(result.errors.empty());
+    const Model& decoded = *result.model;
+
+    const std::vector<std::byte> data =
+        DecodedContentCache::writeModel(decoded);
+    const std::optional<Model> model = DecodedContentCache::readModel(data);
+    REQUIRE(model);
+
+    // The mesh is already decoded, so the model no longer uses Draco.
+    REQUIRE(model->extensionsUsed.empty());
+    REQUIRE(model->extensionsRequired.empty());
+    const MeshPrimitive& primitive = model->meshes[0].primitives[0];
+    REQUIRE(!primitive.getExtension<KHR_draco_mesh_compression>());
+
+    REQUIRE(model->accessors.size() == decoded.accessors.size());
+    for (size_t i = 0; i < decoded.accessors.size(); ++i) {
+      REQUIRE(
+          model->accessors[i].bufferView == decoded.accessors[i].bufferView);
+      REQUIRE(model->accessors[i].count == decoded.accessors[i].count);
+    }
+    REQUIRE(model->bufferViews.size() == decoded.bufferViews.size());
+    REQUIRE(model->buffers.size() == decoded.buffers.size());
+    for (size_t i = 0; i < decoded.buffers.size(); ++i) {
+      const gsl::span<const std::byte> expected =
+          decoded.buffers[i].cesium.getData();
+      const gsl::span<const std::byte> actual =
+          model->buffers[i].cesium.getData();
+      REQUIRE(
+          std::vector<std::byte>(actual.begin(), actual.end()) ==
+          std::vector<std::byte>(expected.begin(), expected.end()));
+    }
+  }
+
+  SECTION("Does not read invalid data") {
+    std::vector<std::byte> data =
+        DecodedContentCache::writeModel(createModel());
+
+    std::vector<std::byte> truncated(data.begin(), data.end() - 1);
+    REQUIRE(!DecodedContentCache::readModel(truncated));
+
+    std::vector<std::byte> extended(data);
+    extended.push_back(std::byte(0));
+    REQUIRE(!DecodedContentCache::readModel(extended));
+
+    // The version follows the magic number.
+    data[4] = std::byte(uint8_t(data[4]) + 1);
+    REQUIRE(!DecodedContentCache::readModel(data));
+
+    REQUIRE(!DecodedContentCache::readModel(gsl::span<const std::byte>()));
+  }
+
+  SECTION("Does not write a model with an unsupported extension") {
+    Model model = createModel();
+    model.extensions["UNSUPPORTED_extension"] = UnsupportedExtension();
+    REQUIRE_THROWS(DecodedContentCache::writeModel(model));
+
+    const std::shared_ptr<InMemoryCacheDatabase> pDatabase =
+        std::make_shared<InMemoryCacheDatabase>();
+    DecodedContentCache cache(spdlog::default_logger(), pDatabase);
+    REQUIRE(!cache.storeModel("tile.glb", createBytes(10), {}, model));
+    REQUIRE(pDatabase->entries.empty());
+  }
+
+  SECTION("Stores models by URL, content, and options") {
+    const std::shared_ptr<InMemoryCacheDatabase> pDatabase =
+        std::make_shared<InMemoryCacheDatabase>();
+    DecodedContentCache cache(spdlog::default_logger(), pDatabase);
+
+    const std::vector<std::byte> content = createBytes(1001);
+    TilesetContentOptions options;
+    REQUIRE(!cache.getModel("tile.glb", content, options));
+    REQUIRE(cache.storeModel("tile.glb", content, options, createModel()));
+
+    const std::optional<Model> model =
+        cache.getModel("tile.glb", content, options);
+    REQUIRE(model);
+    checkModel(*model);
+
+    std::vector<std::byte> changedContent = content;
+    changedContent[1000] = std::byte(1);
+    REQUIRE(!cache.getModel("tile.glb", changedContent, options));
+    REQUIRE(!cache.getModel("other.glb", content, options));
+
+    TilesetContentOptions smoothNormals;
+    smoothNormals.generateMissingNormalsSmooth = true;
+    REQUIRE(!cache.getModel("tile.glb", content, smoothNormals));
+
+    TilesetContentOptions nativeChannels;
+    nativeChannels.imageOptions.preserveChannels = true;
+    REQUIRE(!cache.getModel("tile.glb", content, nativeChannels));
+
+    TilesetContentOptions mipmaps;
+    mipmaps.generateMipmaps = true;
+    REQUIRE(!cache.getModel("tile.glb", content, mipmaps));
+
+    REQUIRE(
+        DecodedContentCache::calculateKey("tile.glb", content, options) !=
+        DecodedContentCache::calculateKey("tile.glb", changedContent, options));
+  }
+
+  SECTION("Does not return models decoded with other image decoders") {
+    const std::shared_ptr<InMemoryCacheDatabase> pDatabase =
+        std::make_shared<InMemoryCacheDatabase>();
+    DecodedContentCache cache(spdlog::default_logger(), pDatabase);
+
+    const std::vector<std::byte> content = createBytes(1001);
+    TilesetContentOptions options;
+    REQUIRE(cache.storeModel("tile.glb", content, options, createModel()));
+    const std::string key =
+        DecodedContentCache::calculateKey("tile.glb", content, options);
+
+    // A MIME type that no tile uses, so that the decoder that stays registered
+    // does not change the other tests.
+    GltfContent::getGltfReader().getImageDecoders().registerMimeType(
+        "image/x-decoded-content-cache-test",
+        std::make_shared<TestImageDecoder>());
+
+    REQUIRE(
+        DecodedContentCache::calculateKey("tile.glb", content, options) !=
+        key);
+    REQUIRE(!cache.getModel("tile.glb", content, options));
+  }
+}
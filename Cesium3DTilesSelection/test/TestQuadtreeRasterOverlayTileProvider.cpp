@@ -50,6 +50,10 @@ public:
   // The tiles that will return an error from loadQuadtreeTileImage.
   std::vector<QuadtreeTileID> errorTiles;
 
+  // The tiles that will return a GPU compressed image from
+  // loadQuadtreeTileImage.
+  std::vector<QuadtreeTileID> compressedTiles;
+
   virtual CesiumAsync::Future<LoadedRasterOverlayImage>
   loadQuadtreeTileImage(const QuadtreeTileID& tileID) const {
     LoadedRasterOverlayImage result;
@@ -69,6 +73,12 @@ public:
       result.image->pixelData.resize(
           this->getWidth() * this->getHeight() * 4,
           std::byte(tileID.level));
+
+      if (std::find(compressedTiles.begin(), compressedTiles.end(), tileID) !=
+          compressedTiles.end()) {
+        result.image->compressedPixelFormat =
+            GpuCompressedPixelFormat::BC3_RGBA;
+      }
     }
 
     return this->getAsyncSystem().createResolvedFuture(std::move(result));
@@ -169,7 +179,17 @@ TEST_CASE("QuadtreeRasterOverlayTileProvider getTile") {
         [](std::byte b) { return b == std::byte(0); }));
   }
 
-  SECTION("uses a mix of levels when a tile returns an error") {
+  SECTION("uses a mix of levels when a tile cannot be used") {
+    bool isCompressed = false;
+
+    SECTION("because it returns an error") {}
+
+    SECTION("because it is GPU compressed") {
+      // A GPU compressed image cannot be combined with the other tiles, so it
+      // is replaced like a tile that failed to load.
+      isCompressed = true;
+    }
+
     glm::dvec2 center(0.1, 0.2);
     double geometricError = 4000.0;
 
@@ -198,14 +218,18 @@ TEST_CASE("QuadtreeRasterOverlayTileProvider getTile") {
         centerRectangle.maximumX + centerRectangle.computeWidth() * 0.5,
         centerRectangle.maximumY + centerRectangle.computeHeight() * 0.5);
 
-    // The tile in the southeast corner will fail to load.
+    // The tile in the southeast corner cannot be used.
     std::optional<QuadtreeTileID> southeastID =
         pTestProvider->getTilingScheme().positionToTile(
             tileRectangle.getLowerRight(),
             expectedLevel);
     REQUIRE(southeastID);
 
-    pTestProvider->errorTiles.emplace_back(*southeastID);
+    if (isCompressed) {
+      pTestProvider->compressedTiles.emplace_back(*southeastID);
+    } else {
+      pTestProvider->errorTiles.emplace_back(*southeastID);
+    }
 
     IntrusivePointer<RasterOverlayTile> pTile =
         pProvider->getTile(tileRectangle, geometricError);
@@ -0,0 +1,225 @@
+#include "Cesium3DTilesSelection/Tile.h"
+#include "Cesium3DTilesSelection/TileLoadQueue.h"
+
+#include <catch2/catch.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+
+namespace {
+struct Record {
+  Tile* pTile;
+  double priority;
+
+  bool operator<(const Record& rhs) const noexcept {
+    return this->priority < rhs.priority;
+  }
+};
+
+std::vector<Tile*> popAll(TileLoadQueue& queue) {
+  std::vector<Tile*> result;
+  while (!queue.empty()) {
+    result.push_back(queue.pop());
+  }
+  return result;
+}
+
+std::vector<Tile*> sortedTiles(std::vector<Record> records) {
+  std::stable_sort(records.begin(), records.end());
+  std::vector<Tile*> result;
+  for (const Record& record : records) {
+    result.push_back(record.pTile);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("TileLoadQueue") {
+  std::vector<Tile> tiles(100);
+
+  std::mt19937 random(42);
+  std::uniform_real_distribution<double> distribution(0.0, 1000.0);
+
+  std::vector<Record> records;
+  for (Tile& tile : tiles) {
+    records.push_back({&tile, distribution(random)});
+  }
+
+  TileLoadQueue queue;
+
+  SECTION("pops the tiles in the order of their priority") {
+    for (const Record& record : records) {
+      queue.update(*record.pTile, record.priority, 1);
+    }
+    CHECK(queue.size() == tiles.size());
+    CHECK(queue.top() == sortedTiles(records).front());
+    CHECK(popAll(queue) == sortedTiles(records));
+    CHECK(queue.pop() == nullptr);
+  }
+
+  SECTION("moves the tiles whose priority changed") {
+    for (const Record& record : records) {
+      queue.update(*record.pTile, record.priority, 1);
+    }
+
+    for (Record& record : records) {
+      record.priority = distribution(random);
+      queue.update(*record.pTile, record.priority, 2);
+    }
+    queue.removeUntouched(2);
+
+    CHECK(queue.size() == tiles.size());
+    CHECK(popAll(queue) == sortedTiles(records));
+  }
+
+  SECTION("keeps the lowest priority of a tile within a frame") {
+    queue.update(tiles[0], 10.0, 1);
+    queue.update(tiles[1], 20.0, 1);
+    queue.update(tiles[1], 5.0, 1);
+    queue.update(tiles[1], 30.0, 1);
+    CHECK(queue.pop() == &tiles[1]);
+
+    // A new frame replaces the priority.
+    queue.update(tiles[0], 40.0, 2);
+    queue.update(tiles[2], 30.0, 2);
+    CHECK(queue.pop() == &tiles[2]);
+  }
+
+  SECTION("removes the tiles that were not updated in a frame") {
+    for (const Record& record : records) {
+      queue.update(*record.pTile, record.priority, 1);
+    }
+
+    std::vector<Record> touched;
+    for (size_t i = 0; i < records.size(); i += 3) {
+      touched.push_back(records[i]);
+      queue.update(*records[i].pTile, records[i].priority, 2);
+    }
+    queue.removeUntouched(2);
+
+    // Most tiles were not updated, so they were removed all at once.
+    CHECK(queue.size() == touched.size());
+    CHECK(queue.untouchedSize() == 0);
+    CHECK(queue.contains(*touched.front().pTile));
+    CHECK(!queue.contains(*records[1].pTile));
+    CHECK(popAll(queue) == sortedTiles(touched));
+  }
+
+  SECTION("leaves a few untouched tiles in the heap until they reach its top") {
+    for (const Record& record : records) {
+      queue.update(*record.pTile, record.priority, 1);
+    }
+
+    // The tiles with the highest priority values are not updated, so they
+    // are at the bottom of the heap.
+    std::vector<Record> sorted = records;
+    std::stable_sort(sorted.begin(), sorted.end());
+    const std::vector<Record> touched(sorted.begin(), sorted.end() - 10);
+    const Record untouched = sorted.back();
+    for (const Record& record : touched) {
+      queue.update(*record.pTile, record.priority, 2);
+    }
+    queue.removeUntouched(2);
+
+    CHECK(queue.size() == touched.size());
+    CHECK(queue.untouchedSize() == 10);
+    CHECK(!queue.contains(*untouched.pTile));
+
+    SECTION("and drops them when they are reached") {
+      CHECK(popAll(queue) == sortedTiles(touched));
+      CHECK(queue.untouchedSize() == 0);
+      CHECK(queue.pop() == nullptr);
+    }
+
+    SECTION("and adds them again when they are updated") {
+      queue.update(*untouched.pTile, -1.0, 3);
+      CHECK(queue.untouchedSize() == 9);
+      CHECK(queue.contains(*untouched.pTile));
+      CHECK(queue.pop() == untouched.pTile);
+    }
+  }
+
+  SECTION("is empty after being cleared") {
+    queue.update(tiles[0], 1.0, 1);
+    queue.clear();
+    CHECK(queue.empty());
+    CHECK(queue.top() == nullptr);
+    CHECK(!queue.contains(tiles[0]));
+  }
+}
+
+// Compares the persistent queue with sorting all load records every frame, for
+// the leaves of a large synthetic quadtree and a camera that moves slowly over
+// it. Run with `cesium-native-tests "[benchmark]"`.
+TEST_CASE("TileLoadQueue compared to sorting every frame", "[.][benchmark]") {
+  const uint32_t levels = 9;
+  const uint32_t tilesPerSide = 1U << (levels - 1);
+  const size_t frames = 16;
+  const size_t maximumSimultaneousTileLoads = 20;
+
+  std::vector<Tile> tiles(size_t(tilesPerSide) * tilesPerSide);
+  std::vector<glm::dvec2> positions;
+  positions.reserve(tiles.size());
+  for (uint32_t y = 0; y < tilesPerSide; ++y) {
+    for (uint32_t x = 0; x < tilesPerSide; ++x) {
+      positions.emplace_back(double(x), double(y));
+    }
+  }
+
+  // The load records of each frame, computed up front so that only the
+  // ordering is measured.
+  std::vector<std::vector<Record>> recordsPerFrame(frames);
+  for (size_t frame = 0; frame < frames; ++frame) {
+    const glm::dvec2 camera(
+        0.5 * double(tilesPerSide) + 0.25 * double(frame),
+        0.5 * double(tilesPerSide));
+    std::vector<Record>& records = recordsPerFrame[frame];
+    records.reserve(tiles.size());
+    for (size_t i = 0; i < tiles.size(); ++i) {
+      records.push_back({&tiles[i], glm::distance(positions[i], camera)});
+    }
+  }
+
+  size_t sortFrame = 0;
+  std::vector<Record> sortedRecords;
+  BENCHMARK("std::sort") {
+    const std::vector<Record>& records =
+        recordsPerFrame[sortFrame++ % frames];
+    sortedRecords.assign(records.begin(), records.end());
+    std::sort(sortedRecords.begin(), sortedRecords.end());
+
+    size_t dispatched = 0;
+    for (const Record& record : sortedRecords) {
+      if (++dispatched >= maximumSimultaneousTileLoads) {
+        return record.pTile;
+      }
+    }
+    return static_cast<Tile*>(nullptr);
+  };
+
+  int32_t queueFrame = 0;
+  TileLoadQueue queue;
+  BENCHMARK("TileLoadQueue") {
+    const int32_t frameNumber = ++queueFrame;
+    const std::vector<Record>& records =
+        recordsPerFrame[size_t(frameNumber) % frames];
+    for (const Record& record : records) {
+      queue.update(*record.pTile, record.priority, frameNumber);
+    }
+    queue.removeUntouched(frameNumber);
+
+    Tile* pLast = nullptr;
+    for (size_t i = 0; i < maximumSimultaneousTileLoads && !queue.empty();
+         ++i) {
+      pLast = queue.pop();
+    }
+    return pLast;
+  };
+}
@@ -0,0 +1,235 @@
+#include "Cesium3DTilesSelection/TilesetCacheSeeder.h"
+#include "Cesium3DTilesSelection/registerAllTileContentTypes.h"
+#include "SimpleAssetAccessor.h"
+#include "SimpleAssetRequest.h"
+#include "SimpleAssetResponse.h"
+#include "SimpleTaskProcessor.h"
+#include "readFile.h"
+
+#include <CesiumGeospatial/GlobeRectangle.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CesiumAsync;
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeospatial;
+
+namespace {
+const std::string RESUME_FILE = "tileset-cache-seeder-test.txt";
+
+std::shared_ptr<SimpleAssetAccessor> createAssetAccessor() {
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "AddTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "tilesetBox.json",
+      "tileset2.json",
+      "parent.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "tileset3/tileset3.json",
+      "tileset3/ll.b3dm"};
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  return std::make_shared<SimpleAssetAccessor>(
+      std::move(mockCompletedRequests));
+}
+
+void runSeeder(TilesetCacheSeeder& seeder) {
+  for (int i = 0; i < 1000 && !seeder.update(); ++i) {
+  }
+  REQUIRE(seeder.isDone());
+}
+} // namespace
+
+TEST_CASE("Test the tileset cache seeder") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      createAssetAccessor();
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      nullptr,
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  // The region of the whole tileset.
+  const std::vector<CartographicPolygon> region{
+      TilesetCacheSeeder::createPolygon(GlobeRectangle(
+          -1.3197209591796106,
+          0.6988424218,
+          -1.3196390408203893,
+          0.6989055782))};
+
+  SECTION("Loads all tiles in the region") {
+    TilesetCacheSeederOptions options;
+    options.viewDistance = 1.0;
+    TilesetCacheSeeder seeder(
+        tilesetExternals,
+        "tileset.json",
+        region,
+        options);
+    runSeeder(seeder);
+
+    const TilesetCacheSeederProgress& progress = seeder.getProgress();
+    REQUIRE(!progress.tilesetFailed);
+    REQUIRE(progress.tilesLoaded == 7);
+    REQUIRE(progress.tilesFailed == 0);
+    REQUIRE(progress.tilesLoading == 0);
+    REQUIRE(progress.tilesQueued == 0);
+    REQUIRE(progress.requests == 8);
+    REQUIRE(progress.bytesReceived > 0);
+  }
+
+  SECTION("Skips tiles outside of the region") {
+    // A part of the lower right tile.
+    const std::vector<CartographicPolygon> lowerRight{
+        TilesetCacheSeeder::createPolygon(
+            GlobeRectangle(-1.31967, 0.69885, -1.31965, 0.69886))};
+
+    TilesetCacheSeederOptions options;
+    options.viewDistance = 1.0;
+    TilesetCacheSeeder seeder(
+        tilesetExternals,
+        "tileset.json",
+        lowerRight,
+        options);
+    runSeeder(seeder);
+
+    // The external tileset, its root, and the lower right tile.
+    REQUIRE(seeder.getProgress().tilesLoaded == 3);
+    REQUIRE(seeder.getProgress().requests == 4);
+  }
+
+  SECTION("Skips tiles with boxes and spheres outside of the region") {
+    // The same tiles as tileset2.json, bounded by boxes and, for the lower
+    // left tile, by a sphere.
+    const std::vector<CartographicPolygon> lowerRight{
+        TilesetCacheSeeder::createPolygon(
+            GlobeRectangle(-1.31967, 0.69885, -1.31965, 0.69886))};
+
+    TilesetCacheSeederOptions options;
+    options.viewDistance = 1.0;
+    TilesetCacheSeeder seeder(
+        tilesetExternals,
+        "tilesetBox.json",
+        lowerRight,
+        options);
+    runSeeder(seeder);
+
+    // The root and the lower right tile.
+    REQUIRE(seeder.getProgress().tilesLoaded == 2);
+    REQUIRE(seeder.getProgress().requests == 3);
+
+    TilesetCacheSeeder wholeSeeder(
+        tilesetExternals,
+        "tilesetBox.json",
+        region,
+        options);
+    runSeeder(wholeSeeder);
+    REQUIRE(wholeSeeder.getProgress().tilesLoaded == 5);
+  }
+
+  SECTION("Stops at the target screen-space error") {
+    // The external tileset is refined unconditionally, but the geometric error
+    // of its root is small enough when viewed from far away.
+    TilesetCacheSeederOptions options;
+    options.viewDistance = 10000000.0;
+    TilesetCacheSeeder seeder(
+        tilesetExternals,
+        "tileset.json",
+        region,
+        options);
+    runSeeder(seeder);
+    REQUIRE(seeder.getProgress().tilesLoaded == 2);
+    REQUIRE(seeder.getProgress().requests == 3);
+
+    options.viewDistance = 1.0;
+    options.maximumDepth = 1;
+    TilesetCacheSeeder shallowSeeder(
+        tilesetExternals,
+        "tileset.json",
+        region,
+        options);
+    runSeeder(shallowSeeder);
+    REQUIRE(shallowSeeder.getProgress().tilesLoaded == 2);
+  }
+
+  SECTION("Resumes from the completed subtrees") {
+    // The subtree of the external tileset in the first child of the root of
+    // tileset2.json was completed by an interrupted run.
+    std::ofstream(RESUME_FILE, std::ios::trunc) << "0/0/0\n";
+
+    TilesetCacheSeederOptions options;
+    options.viewDistance = 1.0;
+    options.resumeFile = RESUME_FILE;
+    {
+      TilesetCacheSeeder seeder(
+          tilesetExternals,
+          "tileset.json",
+          region,
+          options);
+      runSeeder(seeder);
+      REQUIRE(seeder.getProgress().subtreesSkipped == 1);
+      REQUIRE(seeder.getProgress().tilesLoaded == 5);
+      REQUIRE(seeder.getProgress().requests == 6);
+    }
+
+    // Now the whole tileset is complete, and only the tileset.json is loaded.
+    TilesetCacheSeeder seeder(
+        tilesetExternals,
+        "tileset.json",
+        region,
+        options);
+    runSeeder(seeder);
+    REQUIRE(seeder.getProgress().subtreesSkipped == 1);
+    REQUIRE(seeder.getProgress().tilesLoaded == 0);
+    REQUIRE(seeder.getProgress().requests == 1);
+
+    std::remove(RESUME_FILE.c_str());
+  }
+
+  SECTION("Reports a tileset that fails to load") {
+    mockAssetAccessor->mockCompletedRequests["tileset.json"] =
+        std::make_shared<SimpleAssetRequest>(
+            "GET",
+            "tileset.json",
+            CesiumAsync::HttpHeaders{},
+            std::make_unique<SimpleAssetResponse>(
+                static_cast<uint16_t>(404),
+                "doesn't matter",
+                CesiumAsync::HttpHeaders{},
+                std::vector<std::byte>()));
+
+    TilesetCacheSeeder seeder(tilesetExternals, "tileset.json", region);
+    runSeeder(seeder);
+    REQUIRE(seeder.getProgress().tilesetFailed);
+    REQUIRE(seeder.getProgress().tilesLoaded == 0);
+  }
+}
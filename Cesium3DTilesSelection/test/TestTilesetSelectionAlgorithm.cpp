@@ -14,9 +14,14 @@
 #include <glm/mat4x4.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <set>
+#include <thread>
+#include <utility>
 
 using namespace CesiumAsync;
 using namespace Cesium3DTilesSelection;
@@ -115,6 +120,43 @@ static ViewState zoomToTileset(const Tileset& tileset) {
   return zoomToTile(*root);
 }
 
+namespace {
+// Holds back the responses for the given files until they are released, so
+// that the loads of their tiles stay in progress over several frames.
+class DeferringAssetAccessor : public SimpleAssetAccessor {
+public:
+  using SimpleAssetAccessor::SimpleAssetAccessor;
+
+  virtual Future<std::shared_ptr<IAssetRequest>> requestAsset(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers) override {
+    ++this->requestCounts[url];
+    if (this->deferredFiles.count(url) == 0) {
+      return SimpleAssetAccessor::requestAsset(asyncSystem, url, headers);
+    }
+
+    Promise<std::shared_ptr<IAssetRequest>> promise =
+        asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>();
+    this->pendingRequests.emplace_back(url, promise);
+    return promise.getFuture();
+  }
+
+  void releaseDeferredRequests() {
+    for (const auto& pendingRequest : this->pendingRequests) {
+      pendingRequest.second.resolve(std::shared_ptr<IAssetRequest>(
+          this->mockCompletedRequests[pendingRequest.first]));
+    }
+    this->pendingRequests.clear();
+  }
+
+  std::set<std::string> deferredFiles;
+  std::map<std::string, int> requestCounts;
+  std::vector<std::pair<std::string, Promise<std::shared_ptr<IAssetRequest>>>>
+      pendingRequests;
+};
+} // namespace
+
 TEST_CASE("Test replace refinement for render") {
   Cesium3DTilesSelection::registerAllTileContentTypes();
 
@@ -940,3 +982,561 @@ TEST_CASE("Test multiple frustums") {
     }
   }
 }
+
+TEST_CASE("Parallel traversal selects the same tiles as the serial traversal") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  TilesetOptions parallelOptions;
+  parallelOptions.enableParallelTraversal = true;
+  parallelOptions.parallelTraversalDepth = 1;
+
+  Tileset serialTileset(tilesetExternals, "tileset.json");
+  Tileset parallelTileset(tilesetExternals, "tileset.json", parallelOptions);
+  initializeTileset(serialTileset);
+  initializeTileset(parallelTileset);
+
+  const Tile* root = serialTileset.getRootTile();
+  REQUIRE(root != nullptr);
+  REQUIRE(root->getChildren().size() == 4);
+  ViewState zoomToTileViewState = zoomToTile(root->getChildren()[0]);
+  ViewState viewState = ViewState::create(
+      zoomToTileViewState.getPosition() +
+          zoomToTileViewState.getDirection() * 250.0,
+      zoomToTileViewState.getDirection(),
+      zoomToTileViewState.getUp(),
+      zoomToTileViewState.getViewportSize(),
+      0.5 * zoomToTileViewState.getHorizontalFieldOfView(),
+      0.5 * zoomToTileViewState.getVerticalFieldOfView());
+
+  const auto getRenderedUrls = [](const ViewUpdateResult& result) {
+    std::vector<std::string> urls;
+    for (const Tile* pTile : result.tilesToRenderThisFrame) {
+      urls.emplace_back(std::get<std::string>(pTile->getTileID()));
+    }
+    return urls;
+  };
+
+  // Give both tilesets a few frames to load everything they need.
+  for (int frame = 0; frame < 4; ++frame) {
+    serialTileset.updateView({viewState});
+    parallelTileset.updateView({viewState});
+  }
+
+  ViewUpdateResult serialResult = serialTileset.updateView({viewState});
+  ViewUpdateResult parallelResult = parallelTileset.updateView({viewState});
+
+  REQUIRE(!serialResult.tilesToRenderThisFrame.empty());
+  REQUIRE(getRenderedUrls(parallelResult) == getRenderedUrls(serialResult));
+  REQUIRE(parallelResult.tilesVisited == serialResult.tilesVisited);
+  REQUIRE(parallelResult.tilesCulled == serialResult.tilesCulled);
+  REQUIRE(parallelResult.maxDepthVisited == serialResult.maxDepthVisited);
+  REQUIRE(
+      parallelResult.tilesLoadingMediumPriority ==
+      serialResult.tilesLoadingMediumPriority);
+}
+
+namespace {
+class ThreadTaskProcessor : public ITaskProcessor {
+public:
+  virtual void startTask(std::function<void()> f) override {
+    std::thread(f).detach();
+  }
+};
+
+// Waits until the tileset has its root tile and none of its tiles is loading,
+// so that a tileset starts each frame in the same state, regardless of how
+// long its loads took.
+void waitForLoads(AsyncSystem& asyncSystem, Tileset& tileset) {
+  bool loading = true;
+  while (loading) {
+    asyncSystem.dispatchMainThreadTasks();
+
+    loading = tileset.getRootTile() == nullptr;
+    tileset.forEachLoadedTile([&loading](Tile& tile) {
+      loading |= tile.getState() == Tile::LoadState::ContentLoading;
+    });
+
+    if (loading) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Parallel traversal in worker threads matches the serial traversal "
+          "in every frame") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  AsyncSystem asyncSystem(std::make_shared<ThreadTaskProcessor>());
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      asyncSystem,
+      nullptr};
+
+  TilesetOptions parallelOptions;
+  parallelOptions.enableParallelTraversal = true;
+  parallelOptions.parallelTraversalDepth = 1;
+
+  Tileset serialTileset(tilesetExternals, "tileset.json");
+  Tileset parallelTileset(tilesetExternals, "tileset.json", parallelOptions);
+  waitForLoads(asyncSystem, serialTileset);
+  waitForLoads(asyncSystem, parallelTileset);
+
+  const Tile* root = serialTileset.getRootTile();
+  REQUIRE(root != nullptr);
+  REQUIRE(root->getChildren().size() == 4);
+  ViewState zoomToTileViewState = zoomToTile(root->getChildren()[0]);
+  ViewState viewState = ViewState::create(
+      zoomToTileViewState.getPosition() +
+          zoomToTileViewState.getDirection() * 250.0,
+      zoomToTileViewState.getDirection(),
+      zoomToTileViewState.getUp(),
+      zoomToTileViewState.getViewportSize(),
+      0.5 * zoomToTileViewState.getHorizontalFieldOfView(),
+      0.5 * zoomToTileViewState.getVerticalFieldOfView());
+
+  const auto getRenderedUrls = [](const ViewUpdateResult& result) {
+    std::vector<std::string> urls;
+    for (const Tile* pTile : result.tilesToRenderThisFrame) {
+      urls.emplace_back(std::get<std::string>(pTile->getTileID()));
+    }
+    return urls;
+  };
+
+  // The tiles that finished loading since the last frame are updated during
+  // the traversal, so both tilesets must refine in the same frames.
+  for (int frame = 0; frame < 6; ++frame) {
+    ViewUpdateResult serialResult = serialTileset.updateView({viewState});
+    ViewUpdateResult parallelResult = parallelTileset.updateView({viewState});
+
+    CHECK(getRenderedUrls(parallelResult) == getRenderedUrls(serialResult));
+    CHECK(parallelResult.tilesVisited == serialResult.tilesVisited);
+    CHECK(parallelResult.tilesCulled == serialResult.tilesCulled);
+    CHECK(parallelResult.maxDepthVisited == serialResult.maxDepthVisited);
+    CHECK(
+        parallelResult.tilesLoadingMediumPriority ==
+        serialResult.tilesLoadingMediumPriority);
+
+    waitForLoads(asyncSystem, serialTileset);
+    waitForLoads(asyncSystem, parallelTileset);
+  }
+
+  ViewUpdateResult result = parallelTileset.updateView({viewState});
+  CHECK(!result.tilesToRenderThisFrame.empty());
+}
+
+TEST_CASE("Reuses the tile selection of an unchanged view") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  TilesetOptions options;
+  options.reuseSelectionForUnchangedViews = true;
+
+  Tileset tileset(tilesetExternals, "tileset.json", options);
+  initializeTileset(tileset);
+
+  const Tile* root = tileset.getRootTile();
+  REQUIRE(root != nullptr);
+  ViewState viewState = zoomToTile(root->getChildren()[0]);
+
+  // Load everything that the view needs.
+  ViewUpdateResult result;
+  for (int frame = 0; frame < 10 && !result.reusedPreviousSelection;
+       ++frame) {
+    result = tileset.updateView({viewState});
+  }
+  REQUIRE(result.reusedPreviousSelection);
+  REQUIRE(!result.tilesToRenderThisFrame.empty());
+  REQUIRE(result.tilesToNoLongerRenderThisFrame.empty());
+
+  SECTION("An unchanged view reuses the selection") {
+    ViewUpdateResult sameResult = tileset.updateView({viewState});
+    REQUIRE(sameResult.reusedPreviousSelection);
+    REQUIRE(sameResult.tilesToRenderThisFrame == result.tilesToRenderThisFrame);
+  }
+
+  SECTION("A view that moves slightly traverses the tileset again") {
+    ViewState movedViewState = ViewState::create(
+        viewState.getPosition() + glm::dvec3(0.01, 0.0, 0.0),
+        viewState.getDirection(),
+        viewState.getUp(),
+        viewState.getViewportSize(),
+        viewState.getHorizontalFieldOfView(),
+        viewState.getVerticalFieldOfView());
+    ViewUpdateResult movedResult = tileset.updateView({movedViewState});
+    REQUIRE(!movedResult.reusedPreviousSelection);
+    REQUIRE(movedResult.tilesVisited > 0);
+  }
+
+  SECTION("Invalidating traverses the tileset again") {
+    tileset.invalidatePreviousSelection();
+    ViewUpdateResult newResult = tileset.updateView({viewState});
+    REQUIRE(!newResult.reusedPreviousSelection);
+    REQUIRE(newResult.tilesToRenderThisFrame == result.tilesToRenderThisFrame);
+  }
+}
+
+TEST_CASE("Skipping levels of detail does not load intermediate tiles") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  // Without skipping, a tile with any loading descendants is loaded instead
+  // of them.
+  TilesetOptions options;
+  options.loadingDescendantLimit = 0;
+  TilesetOptions skipOptions = options;
+  skipOptions.skipLevelOfDetail = true;
+  skipOptions.baseScreenSpaceError = std::numeric_limits<double>::max();
+
+  Tileset tileset(tilesetExternals, "tileset.json", options);
+  Tileset skipTileset(tilesetExternals, "tileset.json", skipOptions);
+  initializeTileset(tileset);
+  initializeTileset(skipTileset);
+
+  const Tile* root = tileset.getRootTile();
+  const Tile* skipRoot = skipTileset.getRootTile();
+  REQUIRE(root != nullptr);
+  REQUIRE(skipRoot != nullptr);
+
+  const Tile& ll = root->getChildren()[0];
+  const Tile& skipLL = skipRoot->getChildren()[0];
+  ViewState zoomToTileViewState = zoomToTile(ll);
+  ViewState viewState = ViewState::create(
+      zoomToTileViewState.getPosition() +
+          zoomToTileViewState.getDirection() * 250.0,
+      zoomToTileViewState.getDirection(),
+      zoomToTileViewState.getUp(),
+      zoomToTileViewState.getViewportSize(),
+      0.5 * zoomToTileViewState.getHorizontalFieldOfView(),
+      0.5 * zoomToTileViewState.getVerticalFieldOfView());
+  REQUIRE(!doesTileMeetSSE(viewState, ll, tileset));
+
+  const auto getRenderedUrls = [](const ViewUpdateResult& result) {
+    std::vector<std::string> urls;
+    for (const Tile* pTile : result.tilesToRenderThisFrame) {
+      urls.emplace_back(std::get<std::string>(pTile->getTileID()));
+    }
+    return urls;
+  };
+
+  for (int frame = 0; frame < 6; ++frame) {
+    tileset.updateView({viewState});
+    skipTileset.updateView({viewState});
+  }
+
+  ViewUpdateResult result = tileset.updateView({viewState});
+  ViewUpdateResult skipResult = skipTileset.updateView({viewState});
+
+  // Both end up with the same tiles, but only the tileset that does not skip
+  // levels of detail loaded the intermediate tile.
+  REQUIRE(!result.tilesToRenderThisFrame.empty());
+  REQUIRE(getRenderedUrls(skipResult) == getRenderedUrls(result));
+  REQUIRE(ll.getState() == Tile::LoadState::Done);
+  REQUIRE(skipLL.getState() == Tile::LoadState::Unloaded);
+}
+
+TEST_CASE("Predicted views prefetch the tiles that they will render") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<SimpleAssetAccessor> mockAssetAccessor =
+      std::make_shared<SimpleAssetAccessor>(std::move(mockCompletedRequests));
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  Tileset tileset(tilesetExternals, "tileset.json");
+  initializeTileset(tileset);
+
+  const Tile* root = tileset.getRootTile();
+  REQUIRE(root != nullptr);
+
+  // The root meets the screen-space error in the current view, but its
+  // children are rendered in the predicted view.
+  ViewState viewState = zoomToTileset(tileset);
+  ViewState zoomOutViewState = viewState.extrapolate(
+      -viewState.getDirection() * 250.0,
+      10.0);
+  REQUIRE(doesTileMeetSSE(zoomOutViewState, *root, tileset));
+  REQUIRE(!doesTileMeetSSE(viewState, *root, tileset));
+
+  ViewUpdateResult result = tileset.updateView({zoomOutViewState}, {viewState});
+  REQUIRE(result.tilesToRenderThisFrame.size() == 1);
+  REQUIRE(result.tilesToRenderThisFrame.front() == root);
+  REQUIRE(result.tilesPrefetched == root->getChildren().size());
+  for (const Tile& child : root->getChildren()) {
+    REQUIRE(child.getState() != Tile::LoadState::Unloaded);
+  }
+
+  // Once the camera arrives, the prefetched tiles are rendered.
+  uint32_t prefetchHits = 0;
+  for (int frame = 0; frame < 4; ++frame) {
+    result = tileset.updateView({viewState});
+    prefetchHits += result.prefetchHits;
+  }
+
+  REQUIRE(result.tilesToRenderThisFrame.size() == root->getChildren().size());
+  REQUIRE(prefetchHits == root->getChildren().size());
+  REQUIRE(result.prefetchHitRate == Approx(1.0));
+}
+
+TEST_CASE("Load cancellation keeps the children that a refinement waits for") {
+  Cesium3DTilesSelection::registerAllTileContentTypes();
+
+  std::filesystem::path testDataPath = Cesium3DTilesSelection_TEST_DATA_DIR;
+  testDataPath = testDataPath / "ReplaceTileset";
+  std::vector<std::string> files{
+      "tileset.json",
+      "parent.b3dm",
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm",
+      "ll_ll.b3dm",
+  };
+
+  std::map<std::string, std::shared_ptr<SimpleAssetRequest>>
+      mockCompletedRequests;
+  for (const auto& file : files) {
+    std::unique_ptr<SimpleAssetResponse> mockCompletedResponse =
+        std::make_unique<SimpleAssetResponse>(
+            static_cast<uint16_t>(200),
+            "doesn't matter",
+            CesiumAsync::HttpHeaders{},
+            readFile(testDataPath / file));
+    mockCompletedRequests.insert(
+        {file,
+         std::make_shared<SimpleAssetRequest>(
+             "GET",
+             file,
+             CesiumAsync::HttpHeaders{},
+             std::move(mockCompletedResponse))});
+  }
+
+  std::shared_ptr<DeferringAssetAccessor> mockAssetAccessor =
+      std::make_shared<DeferringAssetAccessor>(
+          std::move(mockCompletedRequests));
+  const std::vector<std::string> childFiles{
+      "ll.b3dm",
+      "lr.b3dm",
+      "ul.b3dm",
+      "ur.b3dm"};
+  mockAssetAccessor->deferredFiles.insert(childFiles.begin(), childFiles.end());
+  TilesetExternals tilesetExternals{
+      mockAssetAccessor,
+      std::make_shared<SimplePrepareRendererResource>(),
+      AsyncSystem(std::make_shared<SimpleTaskProcessor>()),
+      nullptr};
+
+  TilesetOptions options;
+  options.forbidHoles = true;
+  options.enableLoadCancellation = true;
+  options.loadCancellationFrames = 2;
+
+  Tileset tileset(tilesetExternals, "tileset.json", options);
+  initializeTileset(tileset);
+
+  const Tile* root = tileset.getRootTile();
+  REQUIRE(root != nullptr);
+  ViewState viewState = zoomToTileset(tileset);
+
+  // The root does not meet the screen-space error, so its children are
+  // loaded, but never selected while the root waits for all of them. They are
+  // still needed for longer than the cancellation delay.
+  for (int frame = 0; frame < 6; ++frame) {
+    ViewUpdateResult result = tileset.updateView({viewState});
+    CHECK(result.tilesToRenderThisFrame.size() == 1);
+  }
+
+  for (const Tile& child : root->getChildren()) {
+    CHECK(child.getState() == Tile::LoadState::ContentLoading);
+  }
+  for (const std::string& file : childFiles) {
+    CHECK(mockAssetAccessor->requestCounts[file] == 1);
+  }
+
+  // Once the children arrive, the root is refined.
+  mockAssetAccessor->releaseDeferredRequests();
+  ViewUpdateResult result;
+  for (int frame = 0; frame < 2; ++frame) {
+    result = tileset.updateView({viewState});
+  }
+
+  CHECK(result.tilesToRenderThisFrame.size() == root->getChildren().size());
+}
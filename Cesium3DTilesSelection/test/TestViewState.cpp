@@ -0,0 +1,148 @@
+#include "Cesium3DTilesSelection/BoundingVolumeBatch.h"
+#include "Cesium3DTilesSelection/ViewState.h"
+
+#include <CesiumGeometry/BoundingSphere.h>
+#include <CesiumGeometry/OrientedBoundingBox.h>
+#include <CesiumGeospatial/BoundingRegion.h>
+#include <CesiumUtility/Math.h>
+
+#include <catch2/catch.hpp>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumGeometry;
+using namespace CesiumGeospatial;
+using namespace CesiumUtility;
+
+namespace {
+ViewState createViewState(
+    const std::optional<double>& nearDistance,
+    const std::optional<double>& farDistance) {
+  return ViewState::create(
+      glm::dvec3(0.0),
+      glm::dvec3(1.0, 0.0, 0.0),
+      glm::dvec3(0.0, 0.0, 1.0),
+      glm::dvec2(500.0, 500.0),
+      Math::degreesToRadians(90.0),
+      Math::degreesToRadians(90.0),
+      CesiumGeospatial::Ellipsoid::WGS84,
+      nearDistance,
+      farDistance);
+}
+} // namespace
+
+TEST_CASE("ViewState::computePlaneMask") {
+  const ViewState viewState = createViewState(1.0, 100.0);
+
+  SECTION("returns an empty mask for a volume inside all planes") {
+    CHECK(
+        viewState.computePlaneMask(
+            BoundingSphere(glm::dvec3(50.0, 0.0, 0.0), 1.0)) ==
+        ViewState::PLANE_MASK_INSIDE);
+  }
+
+  SECTION("culls against the near and far planes") {
+    CHECK(
+        viewState.computePlaneMask(
+            BoundingSphere(glm::dvec3(0.5, 0.0, 0.0), 0.1)) ==
+        ViewState::PLANE_MASK_OUTSIDE);
+    CHECK(
+        viewState.computePlaneMask(
+            BoundingSphere(glm::dvec3(200.0, 0.0, 0.0), 1.0)) ==
+        ViewState::PLANE_MASK_OUTSIDE);
+    CHECK(!viewState.isBoundingVolumeVisible(
+        BoundingSphere(glm::dvec3(200.0, 0.0, 0.0), 1.0)));
+  }
+
+  SECTION("sets the bit of an intersected plane") {
+    CHECK(
+        viewState.computePlaneMask(
+            BoundingSphere(glm::dvec3(100.0, 0.0, 0.0), 1.0)) ==
+        ViewState::PlaneMask(1 << 5));
+  }
+
+  SECTION("skips the planes that are not set in the parent mask") {
+    const BoundingSphere outside(glm::dvec3(200.0, 0.0, 0.0), 1.0);
+    CHECK(
+        viewState.computePlaneMask(outside, ViewState::PLANE_MASK_INSIDE) ==
+        ViewState::PLANE_MASK_INSIDE);
+    CHECK(
+        viewState.computePlaneMask(outside, ViewState::PLANE_MASK_OUTSIDE) ==
+        ViewState::PLANE_MASK_OUTSIDE);
+  }
+
+  SECTION("does not cull without near and far planes") {
+    const ViewState unbounded = createViewState(std::nullopt, std::nullopt);
+    CHECK(
+        unbounded.computePlaneMask(
+            BoundingSphere(glm::dvec3(0.5, 0.0, 0.0), 0.1)) ==
+        ViewState::PLANE_MASK_INSIDE);
+    CHECK(
+        unbounded.computePlaneMask(
+            BoundingSphere(glm::dvec3(200.0, 0.0, 0.0), 1.0)) ==
+        ViewState::PLANE_MASK_INSIDE);
+  }
+}
+
+TEST_CASE("ViewState::computePlaneMasksAndDistancesSquared matches the "
+          "individual tests") {
+  const ViewState viewState = createViewState(1.0, 100.0);
+
+  const std::vector<BoundingVolume> boundingVolumes{
+      BoundingSphere(glm::dvec3(50.0, 0.0, 0.0), 1.0),
+      BoundingSphere(glm::dvec3(50.0, 60.0, 0.0), 5.0),
+      OrientedBoundingBox(
+          glm::dvec3(30.0, 10.0, 5.0),
+          glm::dmat3(
+              glm::dvec3(3.0, 1.0, 0.0),
+              glm::dvec3(-1.0, 2.0, 0.0),
+              glm::dvec3(0.0, 0.0, 4.0))),
+      OrientedBoundingBox(glm::dvec3(100.0, 0.0, 0.0), glm::dmat3(2.0)),
+      BoundingRegion(GlobeRectangle(0.0, 0.0, 0.1, 0.1), 0.0, 100.0)};
+
+  BoundingVolumeBatch batch;
+  for (const BoundingVolume& boundingVolume : boundingVolumes) {
+    batch.add(boundingVolume);
+  }
+  REQUIRE(batch.size() == boundingVolumes.size());
+
+  for (const ViewState::PlaneMask parentPlaneMask :
+       {ViewState::PLANE_MASK_INDETERMINATE,
+        ViewState::PlaneMask(1 << 5),
+        ViewState::PLANE_MASK_INSIDE}) {
+    std::vector<ViewState::PlaneMask> planeMasks(batch.size());
+    std::vector<double> distancesSquared(batch.size());
+    viewState.computePlaneMasksAndDistancesSquared(
+        batch,
+        parentPlaneMask,
+        planeMasks,
+        distancesSquared);
+
+    for (size_t i = 0; i < boundingVolumes.size(); ++i) {
+      CHECK(
+          planeMasks[i] ==
+          viewState.computePlaneMask(boundingVolumes[i], parentPlaneMask));
+      CHECK(
+          distancesSquared[i] ==
+          Approx(viewState.computeDistanceSquaredToBoundingVolume(
+              boundingVolumes[i])));
+    }
+  }
+}
+
+TEST_CASE("ViewState::extrapolate moves the view along the velocity") {
+  const ViewState viewState = createViewState(1.0, 100.0);
+  const ViewState extrapolated =
+      viewState.extrapolate(glm::dvec3(2.0, 0.0, 0.0), 5.0);
+
+  CHECK(extrapolated.getPosition() == glm::dvec3(10.0, 0.0, 0.0));
+  CHECK(extrapolated.getDirection() == viewState.getDirection());
+  CHECK(extrapolated.getUp() == viewState.getUp());
+  CHECK(
+      extrapolated.getHorizontalFieldOfView() ==
+      viewState.getHorizontalFieldOfView());
+
+  // The frustum moves with the view.
+  const BoundingSphere sphere(glm::dvec3(105.0, 0.0, 0.0), 1.0);
+  CHECK(!viewState.isBoundingVolumeVisible(sphere));
+  CHECK(extrapolated.isBoundingVolumeVisible(sphere));
+}
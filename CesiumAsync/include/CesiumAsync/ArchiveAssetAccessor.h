@@ -0,0 +1,81 @@
+#pragma once
+
+#include "IAssetAccessor.h"
+#include "Library.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CesiumAsync {
+
+/**
+ * @brief An {@link IAssetAccessor} that serves assets from a zip archive on
+ * disk, such as a 3D Tiles archive (`.3tz`), instead of downloading them.
+ *
+ * The archive is mapped into memory when this instance is constructed, and
+ * its central directory is read into an index of the entries. A request for
+ * a URL that starts with the base URL is answered with the entry whose name
+ * is the rest of the URL, without its query and fragment. The data of a
+ * response refers to the mapped archive, which stays mapped while the
+ * response is alive, so it is not copied.
+ *
+ * A request for a URL that is not in the archive is answered with status
+ * code 404. The entries must be stored uncompressed; a request for a
+ * compressed entry is rejected. Only GET requests are supported.
+ *
+ * To load a tileset or a raster overlay from an archive, use this accessor
+ * in its externals, and the URL of its root file in the archive, for example
+ * `archive:///tileset.json` when the base URL is `archive:///`.
+ */
+class CESIUMASYNC_API ArchiveAssetAccessor : public IAssetAccessor {
+public:
+  /**
+   * @brief Opens the archive at the given path.
+   *
+   * @param archivePath The path of the zip archive.
+   * @param baseUrl The URL of the root of the archive.
+   * @throws std::runtime_error If the archive cannot be opened, or if it is
+   * not a zip archive.
+   */
+  ArchiveAssetAccessor(
+      const std::string& archivePath,
+      const std::string& baseUrl = "archive:///");
+
+  /**
+   * @brief Closes the archive once the responses from it are destroyed.
+   */
+  virtual ~ArchiveAssetAccessor() noexcept override;
+
+  /**
+   * @brief Gets the number of files in the archive.
+   */
+  size_t getEntryCount() const noexcept;
+
+  /** @copydoc IAssetAccessor::requestAsset */
+  virtual Future<std::shared_ptr<IAssetRequest>> requestAsset(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers = {}) override;
+
+  /**
+   * @copydoc IAssetAccessor::post
+   *
+   * The archive is read-only, so the request is answered with status code
+   * 405.
+   */
+  virtual Future<std::shared_ptr<IAssetRequest>> post(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers = std::vector<THeader>(),
+      const gsl::span<const std::byte>& contentPayload = {}) override;
+
+  /** @copydoc IAssetAccessor::tick */
+  virtual void tick() noexcept override;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _pImpl;
+};
+} // namespace CesiumAsync
@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <ctime>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace CesiumAsync {
@@ -29,7 +30,40 @@ public:
       std::vector<std::byte>&& cacheData)
       : statusCode(cacheStatusCode),
         headers(std::move(cacheHeaders)),
-        data(std::move(cacheData)) {}
+        data(std::move(cacheData)),
+        externalData(),
+        pExternalDataOwner() {}
+
+  /**
+   * @brief Constructor for a response whose body is not owned by the
+   * response, such as a body in a memory-mapped file.
+   *
+   * @param cacheStatusCode the status code of the response
+   * @param cacheHeaders the headers of the response
+   * @param cacheExternalData the body of the response
+   * @param pCacheExternalDataOwner the object that keeps the body alive
+   */
+  CacheResponse(
+      uint16_t cacheStatusCode,
+      HttpHeaders&& cacheHeaders,
+      const gsl::span<const std::byte>& cacheExternalData,
+      std::shared_ptr<const void>&& pCacheExternalDataOwner)
+      : statusCode(cacheStatusCode),
+        headers(std::move(cacheHeaders)),
+        data(),
+        externalData(cacheExternalData),
+        pExternalDataOwner(std::move(pCacheExternalDataOwner)) {}
+
+  /**
+   * @brief Gets the body data of the response, whether it is owned by this
+   * response or not.
+   */
+  gsl::span<const std::byte> getData() const noexcept {
+    if (this->pExternalDataOwner) {
+      return this->externalData;
+    }
+    return gsl::span<const std::byte>(this->data.data(), this->data.size());
+  }
 
   /**
    * @brief The status code of the response.
@@ -42,9 +76,21 @@ public:
   HttpHeaders headers;
 
   /**
-   * @brief The body data of the response.
+   * @brief The body data of the response, if it is owned by this response.
    */
   std::vector<std::byte> data;
+
+  /**
+   * @brief The body data of the response, if it is not owned by this
+   * response. It remains valid while {@link pExternalDataOwner} is alive.
+   */
+  gsl::span<const std::byte> externalData;
+
+  /**
+   * @brief The object that keeps {@link externalData} alive, or `nullptr` if
+   * the body is in {@link data}.
+   */
+  std::shared_ptr<const void> pExternalDataOwner;
 };
 
 /**
@@ -9,21 +9,108 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace CesiumAsync {
 class AsyncSystem;
 
+/**
+ * @brief Statistics about the lookups of a {@link CachingAssetAccessor} in its
+ * in-memory cache and in its cache database.
+ */
+struct CESIUMASYNC_API CachingAssetAccessorStatistics {
+  /**
+   * @brief The number of lookups in the in-memory cache.
+   */
+  int64_t memoryCacheLookups = 0;
+
+  /**
+   * @brief The number of lookups that were found in the in-memory cache.
+   */
+  int64_t memoryCacheHits = 0;
+
+  /**
+   * @brief The number of lookups in the cache database, which are the lookups
+   * that were not found in the in-memory cache.
+   */
+  int64_t databaseLookups = 0;
+
+  /**
+   * @brief The number of lookups that were found in the cache database.
+   */
+  int64_t databaseHits = 0;
+
+  /**
+   * @brief Returns the fraction of the lookups in the in-memory cache that
+   * were found, or 0 if there were none.
+   */
+  double memoryCacheHitRate() const noexcept {
+    return this->memoryCacheLookups == 0
+               ? 0.0
+               : double(this->memoryCacheHits) /
+                     double(this->memoryCacheLookups);
+  }
+
+  /**
+   * @brief Returns the fraction of the lookups in the cache database that were
+   * found, or 0 if there were none.
+   */
+  double databaseHitRate() const noexcept {
+    return this->databaseLookups == 0
+               ? 0.0
+               : double(this->databaseHits) / double(this->databaseLookups);
+  }
+};
+
 /**
  * @brief A decorator for an {@link IAssetAccessor} that caches requests and
  * responses in an {@link ICacheDatabase}.
  *
  * This can be used to improve asset loading performance by caching assets
  * across runs.
+ *
+ * Concurrent requests for the same URL with the same headers are coalesced:
+ * they share one lookup in the cache, one request to the underlying asset
+ * accessor, and one write to the cache. The shared request is only canceled
+ * when all of the requests that share it were canceled.
+ *
+ * Optionally, the most recently used responses are also kept in memory, in
+ * front of the cache database. A response that is found in memory is shared
+ * with the request instead of being read from the database again.
+ *
+ * Responses are cached by a key computed from the URL, which by default omits
+ * the `access_token` query parameter, so that cached responses are still used
+ * after the token is refreshed. See {@link calculateDefaultCacheKey}.
  */
 class CachingAssetAccessor : public IAssetAccessor {
 public:
+  /**
+   * @brief A function that computes the key under which the response for a
+   * URL is cached.
+   *
+   * URLs that only differ in parameters that do not change the response, such
+   * as access tokens, should have the same key.
+   */
+  using CacheKeyFunction = std::function<std::string(const std::string& url)>;
+
+  /**
+   * @brief Computes the default cache key of a URL.
+   *
+   * This is the URL without the `access_token` query parameter, which
+   * authenticates a request but does not change the response. All other query
+   * parameters are kept, because some servers use parameters such as `key` to
+   * select the content. A {@link CacheKeyFunction} that calls
+   * {@link CesiumUtility::Uri::removeQueryParameters} can omit more of them.
+   *
+   * @param url The URL.
+   * @return The cache key.
+   */
+  static std::string calculateDefaultCacheKey(const std::string& url);
+
   /**
    * @brief Constructs a new instance.
    *
@@ -35,12 +122,25 @@ public:
    * responses.
    * @param requestsPerCachePrune The number of requests to handle before each
    * {@link ICacheDatabase::prune} of old cached results from the database.
+   * @param numberOfCacheThreads The number of threads that look up and store
+   * entries in the cache database. The default of 1 uses the database from
+   * one thread at a time. Larger values require a database that may be used
+   * from many threads at once, such as {@link SqliteCache}.
+   * @param maximumMemoryCacheBytes The maximum total size of the response data
+   * that is kept in memory. When it is exceeded, the least recently used
+   * responses are removed from memory. They remain in the cache database. A
+   * value of 0 disables the in-memory cache.
+   * @param cacheKeyFunction The function that computes the key under which the
+   * response for a URL is cached.
    */
   CachingAssetAccessor(
       const std::shared_ptr<spdlog::logger>& pLogger,
       const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
       const std::shared_ptr<ICacheDatabase>& pCacheDatabase,
-      int32_t requestsPerCachePrune = 10000);
+      int32_t requestsPerCachePrune = 10000,
+      int32_t numberOfCacheThreads = 1,
+      size_t maximumMemoryCacheBytes = 0,
+      const CacheKeyFunction& cacheKeyFunction = calculateDefaultCacheKey);
 
   virtual ~CachingAssetAccessor() noexcept override;
 
@@ -50,6 +150,13 @@ public:
       const std::string& url,
       const std::vector<THeader>& headers) override;
 
+  /** @copydoc IAssetAccessor::requestAssetWithCancellation */
+  virtual Future<std::shared_ptr<IAssetRequest>> requestAssetWithCancellation(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const CancellationToken& cancellationToken) override;
+
   virtual Future<std::shared_ptr<IAssetRequest>> post(
       const AsyncSystem& asyncSystem,
       const std::string& url,
@@ -59,13 +166,42 @@ public:
   /** @copydoc IAssetAccessor::tick */
   virtual void tick() noexcept override;
 
+  /**
+   * @brief Gets the statistics about the lookups in the in-memory cache and in
+   * the cache database since this instance was created.
+   */
+  CachingAssetAccessorStatistics getStatistics() const noexcept;
+
 private:
+  struct InFlightRequests;
+  struct ResponseCache;
+
+  Future<std::shared_ptr<IAssetRequest>> joinOrStartRequest(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const std::optional<CancellationToken>& cancellationToken);
+
+  Future<std::shared_ptr<IAssetRequest>> requestAssetFromCacheOrServer(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const CancellationToken& cancellationToken);
+
   int32_t _requestsPerCachePrune;
   std::atomic<int32_t> _requestSinceLastPrune;
   std::shared_ptr<spdlog::logger> _pLogger;
   std::shared_ptr<IAssetAccessor> _pAssetAccessor;
   std::shared_ptr<ICacheDatabase> _pCacheDatabase;
   ThreadPool _cacheThreadPool;
+  CacheKeyFunction _calculateCacheKey;
+
+  // Shared with the continuations of the requests, which remove themselves
+  // when they complete.
+  std::shared_ptr<InFlightRequests> _pInFlightRequests;
+
+  // The in-memory cache, and the lookup counts of both caches.
+  std::shared_ptr<ResponseCache> _pResponseCache;
   CESIUM_TRACE_DECLARE_TRACK_SET(_pruneSlots, "Prune cache database");
 };
 } // namespace CesiumAsync
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Library.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace CesiumAsync {
+
+/**
+ * @brief The exception with which a {@link Future} is rejected when the work
+ * it represents was canceled with a {@link CancellationToken}.
+ */
+class CESIUMASYNC_API CancellationException : public std::runtime_error {
+public:
+  /**
+   * @brief Creates a new instance.
+   */
+  CancellationException() : std::runtime_error("The operation was canceled.") {}
+};
+
+/**
+ * @brief A token for cooperatively canceling asynchronous work.
+ *
+ * Copies of a token share the same state, so a token may be handed to the
+ * work that is to be canceled, and a copy kept to {@link cancel} it later.
+ * Cancellation is cooperative: the work checks {@link isCanceled} or calls
+ * {@link throwIfCanceled} where it is safe to stop, and code that can abort
+ * early, such as a network request, registers a callback with
+ * {@link onCancel}. {@link Future::withCancellation} rejects a future as soon
+ * as its token is canceled.
+ *
+ * The methods of this class may be called from any thread.
+ */
+class CESIUMASYNC_API CancellationToken final {
+public:
+  /**
+   * @brief Creates a new token that is not canceled.
+   */
+  CancellationToken();
+
+  /**
+   * @brief Cancels this token and all of its copies.
+   *
+   * The callbacks that were registered with {@link onCancel} are invoked in the
+   * calling thread before this method returns. Canceling a token more than once
+   * has no further effect.
+   */
+  void cancel() const;
+
+  /**
+   * @brief Returns whether this token was canceled.
+   */
+  bool isCanceled() const noexcept {
+    return this->_pState->canceled.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Throws a {@link CancellationException} if this token was canceled.
+   */
+  void throwIfCanceled() const;
+
+  /**
+   * @brief Registers a function to invoke when this token is canceled.
+   *
+   * If the token is already canceled, the function is invoked immediately in
+   * the calling thread. The function is released once it was invoked, or when
+   * the last copy of this token is destroyed.
+   *
+   * @param callback The function to invoke.
+   */
+  void onCancel(std::function<void()>&& callback) const;
+
+private:
+  struct State {
+    std::atomic<bool> canceled{false};
+    std::mutex mutex;
+    std::vector<std::function<void()>> callbacks;
+  };
+
+  std::shared_ptr<State> _pState;
+};
+
+} // namespace CesiumAsync
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "CancellationToken.h"
 #include "Impl/AsyncSystemSchedulers.h"
 #include "Impl/CatchFunction.h"
 #include "Impl/ContinuationFutureType.h"
@@ -9,6 +10,9 @@
 
 #include <CesiumUtility/Tracing.h>
 
+#include <exception>
+#include <memory>
+#include <type_traits>
 #include <variant>
 
 namespace CesiumAsync {
@@ -194,6 +198,57 @@ public:
         std::forward<Func>(f));
   }
 
+  /**
+   * @brief Creates a version of this future that rejects with a
+   * {@link CancellationException} as soon as the given token is canceled, and
+   * invalidates this Future.
+   *
+   * If this Future resolves or rejects before the token is canceled, the
+   * returned Future does the same. Canceling the token does not stop the work
+   * that this Future waits for, it only stops waiting for it. Continuations
+   * that are attached to the returned Future can tell a cancellation from other
+   * errors by the type of the exception.
+   *
+   * @param token The cancellation token.
+   * @return The Future that resolves with this Future, or rejects when the
+   * token is canceled.
+   */
+  Future<T> withCancellation(const CancellationToken& token) && {
+    std::shared_ptr<async::event_task<T>> pEvent =
+        std::make_shared<async::event_task<T>>();
+    async::task<T> eventTask = pEvent->get_task();
+
+    // Whichever happens first settles the event, the other one is ignored.
+    // The token only refers to the event weakly, and the continuation lets go
+    // of it once this Future settles, so a token that outlives the work does
+    // not keep its result alive.
+    std::weak_ptr<async::event_task<T>> pWeakEvent = pEvent;
+    token.onCancel([pWeakEvent]() {
+      std::shared_ptr<async::event_task<T>> pPendingEvent = pWeakEvent.lock();
+      if (pPendingEvent) {
+        pPendingEvent->set_exception(
+            std::make_exception_ptr(CancellationException()));
+      }
+    });
+    this->_task.then(
+        async::inline_scheduler(),
+        [pEvent](async::task<T>&& task) mutable {
+          try {
+            if constexpr (std::is_void_v<T>) {
+              task.get();
+              pEvent->set();
+            } else {
+              pEvent->set(task.get());
+            }
+          } catch (...) {
+            pEvent->set_exception(std::current_exception());
+          }
+          pEvent.reset();
+        });
+
+    return Future<T>(this->_pSchedulers, std::move(eventTask));
+  }
+
   /**
    * @brief Waits for the future to resolve or reject and returns the result.
    *
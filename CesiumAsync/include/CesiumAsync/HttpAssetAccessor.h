@@ -0,0 +1,116 @@
+#pragma once
+
+#include "IAssetAccessor.h"
+#include "Library.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CesiumAsync {
+
+/**
+ * @brief Options for a {@link HttpAssetAccessor}.
+ */
+struct CESIUMASYNC_API HttpAssetAccessorOptions {
+  /**
+   * @brief The number of threads that send requests and receive responses.
+   *
+   * This is the maximum number of requests in progress across all hosts.
+   */
+  size_t numberOfThreads = 8;
+
+  /**
+   * @brief The maximum number of requests in progress, and of open
+   * connections, for each host.
+   */
+  size_t maximumConnectionsPerHost = 6;
+
+  /**
+   * @brief The time to wait for a connection to be established, in
+   * milliseconds.
+   */
+  int64_t connectionTimeoutMilliseconds = 10000;
+
+  /**
+   * @brief The time to wait for data to be received from a connection, in
+   * milliseconds.
+   */
+  int64_t readTimeoutMilliseconds = 30000;
+
+  /**
+   * @brief The headers that are sent with every request, unless the request
+   * has a header with the same name.
+   */
+  std::vector<IAssetAccessor::THeader> defaultHeaders;
+};
+
+/**
+ * @brief An {@link IAssetAccessor} that sends HTTP requests with
+ * cpp-httplib.
+ *
+ * The requests are queued and sent by a fixed set of threads. Connections are
+ * kept alive and reused for later requests to the same host, and no more than
+ * {@link HttpAssetAccessorOptions::maximumConnectionsPerHost} requests to a
+ * host are in progress at once. A queued request waits while its host is at
+ * that limit, but requests to other hosts are sent in the meantime.
+ *
+ * The futures are resolved in the thread that received the response, and
+ * their continuations are scheduled by the {@link AsyncSystem} that was
+ * passed to the request. Redirects are followed.
+ *
+ * Only `http` URLs are supported, unless cpp-httplib is built with OpenSSL.
+ * Requests for other URLs are rejected.
+ */
+class CESIUMASYNC_API HttpAssetAccessor : public IAssetAccessor {
+public:
+  /**
+   * @brief Constructs a new instance and starts its threads.
+   *
+   * @param options The options.
+   */
+  HttpAssetAccessor(
+      const HttpAssetAccessorOptions& options = HttpAssetAccessorOptions());
+
+  /**
+   * @brief Destroys this instance, after the requests in progress completed.
+   *
+   * The requests that are still queued are rejected.
+   */
+  virtual ~HttpAssetAccessor() noexcept override;
+
+  /** @copydoc IAssetAccessor::requestAsset */
+  virtual Future<std::shared_ptr<IAssetRequest>> requestAsset(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers = {}) override;
+
+  /**
+   * @copydoc IAssetAccessor::requestAssetWithCancellation
+   *
+   * A request that is canceled while it is queued is never sent, and one that
+   * is canceled while its response is received is aborted.
+   */
+  virtual Future<std::shared_ptr<IAssetRequest>> requestAssetWithCancellation(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const CancellationToken& cancellationToken) override;
+
+  /** @copydoc IAssetAccessor::post */
+  virtual Future<std::shared_ptr<IAssetRequest>> post(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers = std::vector<THeader>(),
+      const gsl::span<const std::byte>& contentPayload = {}) override;
+
+  /** @copydoc IAssetAccessor::tick */
+  virtual void tick() noexcept override;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _pImpl;
+};
+} // namespace CesiumAsync
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AsyncSystem.h"
+#include "CancellationToken.h"
 #include "IAssetRequest.h"
 #include "Library.h"
 
@@ -41,6 +42,33 @@ public:
       const std::string& url,
       const std::vector<THeader>& headers = {}) = 0;
 
+  /**
+   * @brief Starts a new request for the asset with the given URL, which is
+   * abandoned when the given token is canceled.
+   *
+   * When the token is canceled before the request completes, the returned
+   * future rejects with a {@link CancellationException}. The default
+   * implementation only stops waiting for the request started by
+   * {@link requestAsset}, which still completes in the background. Asset
+   * accessors that are able to abort a request in progress should override
+   * this method to do so.
+   *
+   * @param asyncSystem The async system used to do work in threads.
+   * @param url The URL of the asset.
+   * @param headers The headers to include in the request.
+   * @param cancellationToken The token that cancels the request.
+   * @return The in-progress asset request.
+   */
+  virtual CesiumAsync::Future<std::shared_ptr<IAssetRequest>>
+  requestAssetWithCancellation(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const CancellationToken& cancellationToken) {
+    return this->requestAsset(asyncSystem, url, headers)
+        .withCancellation(cancellationToken);
+  }
+
   /**
    * @brief Starts a new POST request to the given URL.
    *
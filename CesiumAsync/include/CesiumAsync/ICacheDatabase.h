@@ -10,6 +10,10 @@
 namespace CesiumAsync {
 /**
  * @brief Provides database storage interface to cache completed request.
+ *
+ * Implementations need not be thread safe. A {@link CachingAssetAccessor}
+ * with more than one cache thread calls the database from several threads at
+ * once, which an implementation must then allow.
  */
 class CESIUMASYNC_API ICacheDatabase {
 public:
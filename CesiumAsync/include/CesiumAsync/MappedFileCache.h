@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ICacheDatabase.h"
+
+#include <spdlog/fwd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace CesiumAsync {
+
+/**
+ * @brief Cache storage that appends completed responses to memory-mapped
+ * files.
+ *
+ * The entries are stored in segment files in a directory. Each entry is
+ * appended to the newest segment, and a new segment is started when it is
+ * full. The location of each entry is kept in a hash index in memory, which
+ * is rebuilt from the segments when the cache is opened.
+ *
+ * The response data returned by {@link getEntry} is not copied: it refers to
+ * the mapped segment, which stays mapped while the response is alive. See
+ * {@link CacheResponse::getData}.
+ *
+ * Deleted and replaced entries are only marked as deleted in their segment.
+ * After {@link prune}, a background thread compacts the segments in which
+ * more than half of the space is taken by deleted entries, by copying their
+ * remaining entries to the newest segment and removing them.
+ *
+ * The segments are written to disk by the operating system. If the operating
+ * system stops before that, for example due to a power loss, the most
+ * recently stored entries may be lost or incomplete.
+ */
+class CESIUMASYNC_API MappedFileCache : public ICacheDatabase {
+public:
+  /**
+   * @brief Constructs a new instance that stores its segments in the given
+   * directory.
+   *
+   * The directory is created if it does not exist, and the segments that are
+   * already in it are opened.
+   *
+   * @param pLogger The logger that receives error messages.
+   * @param directory The path of the directory of the segments.
+   * @param maxItems The maximum number of items that should be kept after
+   * pruning.
+   * @param maxBytes The maximum total size of the response data that should be
+   * kept after pruning, in bytes, or 0 for no limit.
+   * @param segmentBytes The size of each segment file, in bytes. A larger
+   * entry is stored in a segment of its own.
+   * @throws std::runtime_error If the directory cannot be created.
+   */
+  MappedFileCache(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const std::string& directory,
+      uint64_t maxItems = 4096,
+      uint64_t maxBytes = 0,
+      size_t segmentBytes = 64 * 1024 * 1024);
+
+  /**
+   * @brief Destroys this instance, after the compaction that is in progress
+   * finished.
+   */
+  ~MappedFileCache();
+
+  /** @copydoc ICacheDatabase::getEntry*/
+  virtual std::optional<CacheItem>
+  getEntry(const std::string& key) const override;
+
+  /** @copydoc ICacheDatabase::storeEntry*/
+  virtual bool storeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData) override;
+
+  /**
+   * @copydoc ICacheDatabase::prune
+   *
+   * The segments that are mostly taken by deleted entries are compacted
+   * afterwards in the background.
+   */
+  virtual bool prune() override;
+
+  /** @copydoc ICacheDatabase::clearAll*/
+  virtual bool clearAll() override;
+
+  /**
+   * @brief Compacts the segments that are mostly taken by deleted entries,
+   * and waits until they are compacted.
+   */
+  void compact();
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> _pImpl;
+};
+} // namespace CesiumAsync
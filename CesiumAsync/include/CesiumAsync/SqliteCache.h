@@ -5,14 +5,62 @@
 #include <spdlog/fwd.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 
 namespace CesiumAsync {
 
+/**
+ * @brief Options for writing the entries stored in a {@link SqliteCache} to
+ * the database in the background.
+ */
+struct CESIUMASYNC_API SqliteCacheWriteBehindOptions {
+  /**
+   * @brief Whether stored entries are queued in memory and written to the
+   * database in batches by a background thread.
+   *
+   * If this is false, each entry is written in its own transaction before
+   * {@link SqliteCache::storeEntry} returns.
+   */
+  bool enabled = false;
+
+  /**
+   * @brief The maximum number of entries that are queued. Storing an entry
+   * while the queue is full waits until the queue is written.
+   */
+  size_t maximumPendingEntries = 1024;
+
+  /**
+   * @brief The number of queued entries at which they are written, without
+   * waiting for {@link flushIntervalMilliseconds}.
+   */
+  size_t entriesPerTransaction = 64;
+
+  /**
+   * @brief The longest time that an entry is queued before it is written.
+   */
+  uint32_t flushIntervalMilliseconds = 100;
+};
+
 /**
  * @brief Cache storage using SQLITE to store completed response.
+ *
+ * The database is used in WAL mode, which allows entries to be looked up with
+ * a pool of read-only connections concurrently with each other and with the
+ * one connection that stores and prunes entries. The last accessed times of
+ * the entries that were looked up are written before the next store or prune.
+ *
+ * The total number of items and the total size of their response data are
+ * kept up to date in the database as items are stored and deleted, so that
+ * {@link prune} does not need to count the items. It removes the least
+ * recently used items until both are within their limits.
+ *
+ * With {@link SqliteCacheWriteBehindOptions::enabled}, stored entries are
+ * written in batches, each in one transaction, by a background thread.
+ * Entries that are not written yet are still returned by {@link getEntry},
+ * and all of them are written before the cache is destroyed.
  */
 class CESIUMASYNC_API SqliteCache : public ICacheDatabase {
 public:
@@ -27,18 +75,39 @@ public:
    * @param databaseName the database path.
    * @param maxItems the maximum number of items should be kept in the database
    * after prunning.
+   * @param maxBytes The maximum total size of the response data that should be
+   * kept in the database after pruning, in bytes, or 0 for no limit.
+   * @param numberOfReadConnections The number of connections used to look up
+   * entries, which is the number of lookups that can run at the same time. If
+   * it is 0, or the database is in memory, entries are looked up with the
+   * connection that stores them, one at a time.
+   * @param writeBehindOptions The options for writing stored entries in the
+   * background.
    */
   SqliteCache(
       const std::shared_ptr<spdlog::logger>& pLogger,
       const std::string& databaseName,
-      uint64_t maxItems = 4096);
+      uint64_t maxItems = 4096,
+      uint64_t maxBytes = 0,
+      uint32_t numberOfReadConnections = 4,
+      const SqliteCacheWriteBehindOptions& writeBehindOptions = {});
+
+  /**
+   * @brief Destroys this instance, after writing all entries that are queued
+   * for writing.
+   */
   ~SqliteCache();
 
   /** @copydoc ICacheDatabase::getEntry*/
   virtual std::optional<CacheItem>
   getEntry(const std::string& key) const override;
 
-  /** @copydoc ICacheDatabase::storeEntry*/
+  /**
+   * @copydoc ICacheDatabase::storeEntry
+   *
+   * If {@link SqliteCacheWriteBehindOptions::enabled} is true, the entry is
+   * only queued for writing, and errors while writing it are logged instead.
+   */
   virtual bool storeEntry(
       const std::string& key,
       std::time_t expiryTime,
@@ -55,6 +124,15 @@ public:
   /** @copydoc ICacheDatabase::clearAll*/
   virtual bool clearAll() override;
 
+  /**
+   * @brief Writes all entries that are queued for writing to the database,
+   * and waits until they are written.
+   *
+   * This does nothing if {@link SqliteCacheWriteBehindOptions::enabled} is
+   * false.
+   */
+  void flush();
+
 private:
   struct Impl;
   std::unique_ptr<Impl> _pImpl;
@@ -0,0 +1,475 @@
+#include "CesiumAsync/ArchiveAssetAccessor.h"
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetResponse.h"
+#include "MemoryMappedFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace CesiumAsync {
+
+namespace {
+class ArchiveAssetResponse : public IAssetResponse {
+public:
+  ArchiveAssetResponse(
+      uint16_t statusCode,
+      std::string&& contentType,
+      const gsl::span<const std::byte>& data,
+      const std::shared_ptr<const MemoryMappedFile>& pArchive) noexcept
+      : _statusCode(statusCode),
+        _contentType(std::move(contentType)),
+        _headers(),
+        _data(data),
+        _pArchive(pArchive) {
+    if (!this->_contentType.empty()) {
+      this->_headers.emplace("Content-Type", this->_contentType);
+    }
+  }
+
+  virtual uint16_t statusCode() const noexcept override {
+    return this->_statusCode;
+  }
+
+  virtual std::string contentType() const override {
+    return this->_contentType;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const noexcept override {
+    return this->_data;
+  }
+
+private:
+  uint16_t _statusCode;
+  std::string _contentType;
+  HttpHeaders _headers;
+  gsl::span<const std::byte> _data;
+
+  // Keeps the data mapped.
+  std::shared_ptr<const MemoryMappedFile> _pArchive;
+};
+
+class ArchiveAssetRequest : public IAssetRequest {
+public:
+  ArchiveAssetRequest(
+      const std::string& method,
+      const std::string& url,
+      const std::vector<IAssetAccessor::THeader>& headers,
+      std::unique_ptr<ArchiveAssetResponse>&& pResponse)
+      : _method(method),
+        _url(url),
+        _headers(headers.begin(), headers.end()),
+        _pResponse(std::move(pResponse)) {}
+
+  virtual const std::string& method() const noexcept override {
+    return this->_method;
+  }
+
+  virtual const std::string& url() const noexcept override {
+    return this->_url;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual const IAssetResponse* response() const noexcept override {
+    return this->_pResponse.get();
+  }
+
+private:
+  std::string _method;
+  std::string _url;
+  HttpHeaders _headers;
+  std::unique_ptr<ArchiveAssetResponse> _pResponse;
+};
+
+// The signatures and sizes of the zip records that are read. All numbers in a
+// zip archive are little-endian.
+const uint32_t LOCAL_FILE_HEADER_SIGNATURE = 0x04034b50;
+const uint32_t CENTRAL_DIRECTORY_HEADER_SIGNATURE = 0x02014b50;
+const uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+const uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06064b50;
+const uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE = 0x07064b50;
+const uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001;
+
+const size_t LOCAL_FILE_HEADER_SIZE = 30;
+const size_t CENTRAL_DIRECTORY_HEADER_SIZE = 46;
+const size_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+const size_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE = 56;
+const size_t ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE = 20;
+const size_t MAXIMUM_COMMENT_SIZE = 0xFFFF;
+
+const uint16_t STORED_COMPRESSION_METHOD = 0;
+const uint16_t ENCRYPTED_FLAG = 0x0001;
+
+uint16_t read16(const std::byte* p) noexcept {
+  return uint16_t(uint16_t(p[0]) | uint16_t(p[1]) << 8);
+}
+
+uint32_t read32(const std::byte* p) noexcept {
+  return uint32_t(read16(p)) | uint32_t(read16(p + 2)) << 16;
+}
+
+uint64_t read64(const std::byte* p) noexcept {
+  return uint64_t(read32(p)) | uint64_t(read32(p + 4)) << 32;
+}
+
+// Decodes the percent-encoded characters of a URL path, such as `%20`.
+std::string decodePath(std::string_view path) {
+  const auto hexValue = [](char c) -> int {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  };
+
+  std::string result;
+  result.reserve(path.size());
+  for (size_t i = 0; i < path.size(); ++i) {
+    if (path[i] == '%' && i + 2 < path.size() &&
+        hexValue(path[i + 1]) >= 0 && hexValue(path[i + 2]) >= 0) {
+      result += char(hexValue(path[i + 1]) * 16 + hexValue(path[i + 2]));
+      i += 2;
+    } else {
+      result += path[i];
+    }
+  }
+  return result;
+}
+
+std::string getContentType(std::string_view name) {
+  const size_t extensionStart = name.rfind('.');
+  if (extensionStart == std::string_view::npos) {
+    return "application/octet-stream";
+  }
+
+  std::string extension(name.substr(extensionStart + 1));
+  std::transform(
+      extension.begin(),
+      extension.end(),
+      extension.begin(),
+      [](char c) { return char(std::tolower(static_cast<unsigned char>(c))); });
+
+  if (extension == "json") {
+    return "application/json";
+  }
+  if (extension == "png") {
+    return "image/png";
+  }
+  if (extension == "jpg" || extension == "jpeg") {
+    return "image/jpeg";
+  }
+  if (extension == "ktx2") {
+    return "image/ktx2";
+  }
+  if (extension == "glb") {
+    return "model/gltf-binary";
+  }
+  if (extension == "gltf") {
+    return "model/gltf+json";
+  }
+  if (extension == "xml") {
+    return "application/xml";
+  }
+  return "application/octet-stream";
+}
+} // namespace
+
+struct ArchiveAssetAccessor::Impl {
+  struct Entry {
+    // Refers to the central directory in the mapped archive.
+    std::string_view name;
+    uint64_t localHeaderOffset;
+    uint64_t compressedSize;
+    uint16_t compressionMethod;
+    uint16_t flags;
+  };
+
+  Impl(const std::string& archivePath, const std::string& baseUrl_)
+      : pArchive(std::make_shared<MemoryMappedFile>(archivePath)),
+        baseUrl(baseUrl_),
+        entries() {
+    this->readCentralDirectory();
+  }
+
+  void readCentralDirectory();
+
+  const Entry* findEntry(std::string_view name) const noexcept;
+
+  gsl::span<const std::byte> getData(const Entry& entry) const;
+
+  [[noreturn]] void throwInvalidArchive() const {
+    throw std::runtime_error(
+        "The file " + this->pArchive->getPath() +
+        " is not a valid zip archive.");
+  }
+
+  std::shared_ptr<const MemoryMappedFile> pArchive;
+  std::string baseUrl;
+
+  // Sorted by name.
+  std::vector<Entry> entries;
+};
+
+ArchiveAssetAccessor::ArchiveAssetAccessor(
+    const std::string& archivePath,
+    const std::string& baseUrl)
+    : _pImpl(std::make_unique<Impl>(archivePath, baseUrl)) {}
+
+ArchiveAssetAccessor::~ArchiveAssetAccessor() noexcept = default;
+
+size_t ArchiveAssetAccessor::getEntryCount() const noexcept {
+  return this->_pImpl->entries.size();
+}
+
+Future<std::shared_ptr<IAssetRequest>> ArchiveAssetAccessor::requestAsset(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers) {
+  const Impl& impl = *this->_pImpl;
+
+  const Impl::Entry* pEntry = nullptr;
+  std::string name;
+  if (url.compare(0, impl.baseUrl.size(), impl.baseUrl) == 0) {
+    std::string_view path(url);
+    path.remove_prefix(impl.baseUrl.size());
+    path = path.substr(0, path.find_first_of("?#"));
+    name = decodePath(path);
+    pEntry = impl.findEntry(name);
+  }
+
+  std::unique_ptr<ArchiveAssetResponse> pResponse;
+  if (!pEntry) {
+    pResponse = std::make_unique<ArchiveAssetResponse>(
+        uint16_t(404),
+        std::string(),
+        gsl::span<const std::byte>(),
+        nullptr);
+  } else {
+    try {
+      pResponse = std::make_unique<ArchiveAssetResponse>(
+          uint16_t(200),
+          getContentType(name),
+          impl.getData(*pEntry),
+          impl.pArchive);
+    } catch (...) {
+      Promise<std::shared_ptr<IAssetRequest>> promise =
+          asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>();
+      promise.reject(std::current_exception());
+      return promise.getFuture();
+    }
+  }
+
+  return asyncSystem.createResolvedFuture<std::shared_ptr<IAssetRequest>>(
+      std::make_shared<ArchiveAssetRequest>(
+          "GET",
+          url,
+          headers,
+          std::move(pResponse)));
+}
+
+Future<std::shared_ptr<IAssetRequest>> ArchiveAssetAccessor::post(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const gsl::span<const std::byte>& /*contentPayload*/) {
+  return asyncSystem.createResolvedFuture<std::shared_ptr<IAssetRequest>>(
+      std::make_shared<ArchiveAssetRequest>(
+          "POST",
+          url,
+          headers,
+          std::make_unique<ArchiveAssetResponse>(
+              uint16_t(405),
+              std::string(),
+              gsl::span<const std::byte>(),
+              nullptr)));
+}
+
+void ArchiveAssetAccessor::tick() noexcept {}
+
+void ArchiveAssetAccessor::Impl::readCentralDirectory() {
+  const std::byte* pData = this->pArchive->data();
+  const size_t size = this->pArchive->size();
+  if (size < END_OF_CENTRAL_DIRECTORY_SIZE) {
+    this->throwInvalidArchive();
+  }
+
+  // The end of central directory record is followed by a comment of up to
+  // 64 KiB, so search backwards for its signature.
+  const size_t searchEnd =
+      size - std::min(size, END_OF_CENTRAL_DIRECTORY_SIZE +
+                                MAXIMUM_COMMENT_SIZE);
+  size_t endOffset = size - END_OF_CENTRAL_DIRECTORY_SIZE;
+  while (read32(pData + endOffset) != END_OF_CENTRAL_DIRECTORY_SIGNATURE) {
+    if (endOffset == searchEnd) {
+      this->throwInvalidArchive();
+    }
+    --endOffset;
+  }
+
+  const std::byte* pEnd = pData + endOffset;
+  uint64_t entryCount = read16(pEnd + 10);
+  uint64_t directorySize = read32(pEnd + 12);
+  uint64_t directoryOffset = read32(pEnd + 16);
+
+  // An archive that is too large for these fields has a ZIP64 end of central
+  // directory record, which is found through the locator before this record.
+  if (endOffset >= ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE &&
+      read32(pEnd - ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE) ==
+          ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE) {
+    const uint64_t zip64EndOffset =
+        read64(pEnd - ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE + 8);
+    if (size < ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE ||
+        zip64EndOffset > size - ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE ||
+        read32(pData + size_t(zip64EndOffset)) !=
+            ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE) {
+      this->throwInvalidArchive();
+    }
+
+    const std::byte* pZip64End = pData + size_t(zip64EndOffset);
+    entryCount = read64(pZip64End + 32);
+    directorySize = read64(pZip64End + 40);
+    directoryOffset = read64(pZip64End + 48);
+  }
+
+  if (directoryOffset > size || directorySize > size - directoryOffset) {
+    this->throwInvalidArchive();
+  }
+
+  this->entries.reserve(size_t(std::min(
+      entryCount,
+      uint64_t(directorySize / CENTRAL_DIRECTORY_HEADER_SIZE))));
+
+  const std::byte* pHeader = pData + size_t(directoryOffset);
+  const std::byte* pDirectoryEnd = pHeader + size_t(directorySize);
+  for (uint64_t i = 0; i < entryCount; ++i) {
+    if (size_t(pDirectoryEnd - pHeader) < CENTRAL_DIRECTORY_HEADER_SIZE ||
+        read32(pHeader) != CENTRAL_DIRECTORY_HEADER_SIGNATURE) {
+      this->throwInvalidArchive();
+    }
+
+    const uint16_t nameSize = read16(pHeader + 28);
+    const uint16_t extraSize = read16(pHeader + 30);
+    const uint16_t commentSize = read16(pHeader + 32);
+    const size_t headerSize =
+        CENTRAL_DIRECTORY_HEADER_SIZE + nameSize + extraSize + commentSize;
+    if (size_t(pDirectoryEnd - pHeader) < headerSize) {
+      this->throwInvalidArchive();
+    }
+
+    Entry entry;
+    entry.name = std::string_view(
+        reinterpret_cast<const char*>(pHeader + CENTRAL_DIRECTORY_HEADER_SIZE),
+        nameSize);
+    entry.flags = read16(pHeader + 8);
+    entry.compressionMethod = read16(pHeader + 10);
+    entry.compressedSize = read32(pHeader + 20);
+    uint64_t uncompressedSize = read32(pHeader + 24);
+    entry.localHeaderOffset = read32(pHeader + 42);
+
+    // The sizes and offset that do not fit are in the ZIP64 extra field, in
+    // this order.
+    const std::byte* pExtra =
+        pHeader + CENTRAL_DIRECTORY_HEADER_SIZE + nameSize;
+    const std::byte* pExtraEnd = pExtra + extraSize;
+    while (pExtraEnd - pExtra >= 4) {
+      const uint16_t id = read16(pExtra);
+      const uint16_t fieldSize = read16(pExtra + 2);
+      const std::byte* pField = pExtra + 4;
+      if (pExtraEnd - pField < fieldSize) {
+        break;
+      }
+
+      if (id == ZIP64_EXTRA_FIELD_ID) {
+        const std::byte* pFieldEnd = pField + fieldSize;
+        const auto readZip64 = [&pField, pFieldEnd](uint64_t& value) {
+          if (value == 0xFFFFFFFF && pFieldEnd - pField >= 8) {
+            value = read64(pField);
+            pField += 8;
+          }
+        };
+        readZip64(uncompressedSize);
+        readZip64(entry.compressedSize);
+        readZip64(entry.localHeaderOffset);
+        break;
+      }
+
+      pExtra = pField + fieldSize;
+    }
+
+    // Directories have no data.
+    if (!entry.name.empty() && entry.name.back() != '/') {
+      this->entries.emplace_back(entry);
+    }
+
+    pHeader += headerSize;
+  }
+
+  std::sort(
+      this->entries.begin(),
+      this->entries.end(),
+      [](const Entry& a, const Entry& b) { return a.name < b.name; });
+}
+
+const ArchiveAssetAccessor::Impl::Entry*
+ArchiveAssetAccessor::Impl::findEntry(std::string_view name) const noexcept {
+  auto it = std::lower_bound(
+      this->entries.begin(),
+      this->entries.end(),
+      name,
+      [](const Entry& entry, std::string_view value) {
+        return entry.name < value;
+      });
+  if (it == this->entries.end() || it->name != name) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+gsl::span<const std::byte>
+ArchiveAssetAccessor::Impl::getData(const Entry& entry) const {
+  if (entry.compressionMethod != STORED_COMPRESSION_METHOD ||
+      (entry.flags & ENCRYPTED_FLAG) != 0) {
+    throw std::runtime_error(
+        "The file " + std::string(entry.name) + " in the archive " +
+        this->pArchive->getPath() +
+        " is compressed or encrypted, which is not supported.");
+  }
+
+  // The data follows the local file header, whose name and extra field may
+  // differ in size from those in the central directory.
+  const std::byte* pData = this->pArchive->data();
+  const uint64_t size = this->pArchive->size();
+  const uint64_t offset = entry.localHeaderOffset;
+  if (offset > size || size - offset < LOCAL_FILE_HEADER_SIZE ||
+      read32(pData + size_t(offset)) != LOCAL_FILE_HEADER_SIGNATURE) {
+    this->throwInvalidArchive();
+  }
+
+  const uint64_t dataOffset = offset + LOCAL_FILE_HEADER_SIZE +
+                              read16(pData + size_t(offset) + 26) +
+                              read16(pData + size_t(offset) + 28);
+  if (dataOffset > size || size - dataOffset < entry.compressedSize) {
+    this->throwInvalidArchive();
+  }
+
+  return gsl::span<const std::byte>(
+      pData + size_t(dataOffset),
+      size_t(entry.compressedSize));
+}
+
+} // namespace CesiumAsync
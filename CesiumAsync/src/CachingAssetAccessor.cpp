@@ -6,12 +6,19 @@
 #include "InternalTimegm.h"
 #include "ResponseCacheControl.h"
 
+#include <CesiumUtility/Uri.h>
+
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <iomanip>
+#include <list>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 namespace CesiumAsync {
 class CacheAssetResponse : public IAssetResponse {
@@ -36,9 +43,7 @@ public:
   }
 
   virtual gsl::span<const std::byte> data() const noexcept override {
-    return gsl::span<const std::byte>(
-        this->_pCacheItem->cacheResponse.data.data(),
-        this->_pCacheItem->cacheResponse.data.size());
+    return this->_pCacheItem->cacheResponse.getData();
   }
 
 private:
@@ -47,19 +52,26 @@ private:
 
 class CacheAssetRequest : public IAssetRequest {
 public:
-  CacheAssetRequest(CacheItem&& cacheItem)
-      : _cacheItem(std::move(cacheItem)), _response(&this->_cacheItem) {}
+  CacheAssetRequest(
+      const std::shared_ptr<const CacheItem>& pCacheItem,
+      std::optional<std::string>&& requestedUrl = std::nullopt)
+      : _pCacheItem(pCacheItem),
+        _requestedUrl(std::move(requestedUrl)),
+        _response(pCacheItem.get()) {}
 
   virtual const std::string& method() const noexcept override {
-    return this->_cacheItem.cacheRequest.method;
+    return this->_pCacheItem->cacheRequest.method;
   }
 
   virtual const std::string& url() const noexcept override {
-    return this->_cacheItem.cacheRequest.url;
+    if (this->_requestedUrl) {
+      return *this->_requestedUrl;
+    }
+    return this->_pCacheItem->cacheRequest.url;
   }
 
   virtual const HttpHeaders& headers() const noexcept override {
-    return this->_cacheItem.cacheRequest.headers;
+    return this->_pCacheItem->cacheRequest.headers;
   }
 
   virtual const IAssetResponse* response() const noexcept override {
@@ -67,10 +79,48 @@ public:
   }
 
 private:
-  CacheItem _cacheItem;
+  // Shared with the in-memory cache, which is why the item is immutable.
+  std::shared_ptr<const CacheItem> _pCacheItem;
+
+  // The URL that was requested, if the item was cached for another URL with
+  // the same cache key.
+  std::optional<std::string> _requestedUrl;
   CacheAssetResponse _response;
 };
 
+/**
+ * @brief A request that was shared with a request for another URL with the
+ * same cache key, such as one with another access token. It reports the URL
+ * that was requested, so that URLs relative to it get its query parameters.
+ */
+class SharedAssetRequest : public IAssetRequest {
+public:
+  SharedAssetRequest(
+      const std::shared_ptr<IAssetRequest>& pRequest,
+      const std::string& requestedUrl)
+      : _pRequest(pRequest), _requestedUrl(requestedUrl) {}
+
+  virtual const std::string& method() const override {
+    return this->_pRequest->method();
+  }
+
+  virtual const std::string& url() const override {
+    return this->_requestedUrl;
+  }
+
+  virtual const HttpHeaders& headers() const override {
+    return this->_pRequest->headers();
+  }
+
+  virtual const IAssetResponse* response() const override {
+    return this->_pRequest->response();
+  }
+
+private:
+  std::shared_ptr<IAssetRequest> _pRequest;
+  std::string _requestedUrl;
+};
+
 static std::time_t convertHttpDateToTime(const std::string& httpDate);
 
 static bool shouldRevalidateCache(const CacheItem& cacheItem);
@@ -81,8 +131,6 @@ static bool shouldCacheRequest(
     const IAssetRequest& request,
     const std::optional<ResponseCacheControl>& cacheControl);
 
-static std::string calculateCacheKey(const IAssetRequest& request);
-
 static std::time_t calculateExpiryTime(
     const IAssetRequest& request,
     const std::optional<ResponseCacheControl>& cacheControl);
@@ -90,24 +138,267 @@ static std::time_t calculateExpiryTime(
 static std::unique_ptr<IAssetRequest>
 updateCacheItem(CacheItem&& cacheItem, const IAssetRequest& request);
 
+static CacheItem
+createCacheItem(std::time_t expiryTime, const IAssetRequest& request);
+
+struct CachingAssetAccessor::InFlightRequests {
+  // The cache key of the URL and the request headers.
+  using Key = std::pair<std::string, std::vector<THeader>>;
+
+  struct Request {
+    SharedFuture<std::shared_ptr<IAssetRequest>> future;
+
+    // The URL of the request that started this one.
+    std::string url;
+
+    // Canceled once all requests that share this one were canceled.
+    CancellationToken cancellationToken;
+    int32_t interestedRequests;
+  };
+
+  std::mutex mutex;
+  std::map<Key, std::shared_ptr<Request>> requests;
+};
+
+struct CachingAssetAccessor::ResponseCache {
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const CacheItem> pItem;
+  };
+
+  explicit ResponseCache(size_t maximumBytes_) noexcept
+      : maximumBytes(maximumBytes_) {}
+
+  bool isEnabled() const noexcept { return this->maximumBytes > 0; }
+
+  std::shared_ptr<const CacheItem> get(const std::string& key) {
+    if (!this->isEnabled()) {
+      return nullptr;
+    }
+
+    ++this->memoryCacheLookups;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->index.find(key);
+    if (it == this->index.end()) {
+      return nullptr;
+    }
+
+    ++this->memoryCacheHits;
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->pItem;
+  }
+
+  void put(const std::string& key, std::shared_ptr<const CacheItem>&& pItem) {
+    const size_t bytes = pItem->cacheResponse.getData().size();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->index.find(key);
+    if (it != this->index.end()) {
+      this->totalBytes -= it->second->pItem->cacheResponse.getData().size();
+      this->entries.erase(it->second);
+      this->index.erase(it);
+    }
+
+    if (bytes > this->maximumBytes) {
+      return;
+    }
+
+    this->entries.push_front(Entry{key, std::move(pItem)});
+    this->index.emplace(key, this->entries.begin());
+    this->totalBytes += bytes;
+
+    while (this->totalBytes > this->maximumBytes) {
+      const Entry& leastRecentlyUsed = this->entries.back();
+      this->totalBytes -=
+          leastRecentlyUsed.pItem->cacheResponse.getData().size();
+      this->index.erase(leastRecentlyUsed.key);
+      this->entries.pop_back();
+    }
+  }
+
+  // Stores the response of a completed request in the cache database and in
+  // memory, if it may be cached.
+  void storeResponse(
+      ICacheDatabase& cacheDatabase,
+      const std::string& key,
+      const IAssetRequest& request);
+
+  const size_t maximumBytes;
+
+  std::mutex mutex;
+
+  // The most recently used entry is at the front.
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+  size_t totalBytes = 0;
+
+  std::atomic<int64_t> memoryCacheLookups{0};
+  std::atomic<int64_t> memoryCacheHits{0};
+  std::atomic<int64_t> databaseLookups{0};
+  std::atomic<int64_t> databaseHits{0};
+};
+
 CachingAssetAccessor::CachingAssetAccessor(
     const std::shared_ptr<spdlog::logger>& pLogger,
     const std::shared_ptr<IAssetAccessor>& pAssetAccessor,
     const std::shared_ptr<ICacheDatabase>& pCacheDatabase,
-    int32_t requestsPerCachePrune)
+    int32_t requestsPerCachePrune,
+    int32_t numberOfCacheThreads,
+    size_t maximumMemoryCacheBytes,
+    const CacheKeyFunction& cacheKeyFunction)
     : _requestsPerCachePrune(requestsPerCachePrune),
       _requestSinceLastPrune(0),
       _pLogger(pLogger),
       _pAssetAccessor(pAssetAccessor),
       _pCacheDatabase(pCacheDatabase),
-      _cacheThreadPool(1) {}
+      _cacheThreadPool(numberOfCacheThreads),
+      _calculateCacheKey(cacheKeyFunction),
+      _pInFlightRequests(std::make_shared<InFlightRequests>()),
+      _pResponseCache(
+          std::make_shared<ResponseCache>(maximumMemoryCacheBytes)) {}
 
 CachingAssetAccessor::~CachingAssetAccessor() noexcept {}
 
+std::string
+CachingAssetAccessor::calculateDefaultCacheKey(const std::string& url) {
+  return CesiumUtility::Uri::removeQueryParameters(url, {"access_token"});
+}
+
+CachingAssetAccessorStatistics
+CachingAssetAccessor::getStatistics() const noexcept {
+  const ResponseCache& responseCache = *this->_pResponseCache;
+  return CachingAssetAccessorStatistics{
+      responseCache.memoryCacheLookups.load(),
+      responseCache.memoryCacheHits.load(),
+      responseCache.databaseLookups.load(),
+      responseCache.databaseHits.load()};
+}
+
 Future<std::shared_ptr<IAssetRequest>> CachingAssetAccessor::requestAsset(
     const AsyncSystem& asyncSystem,
     const std::string& url,
     const std::vector<THeader>& headers) {
+  return this->joinOrStartRequest(asyncSystem, url, headers, std::nullopt);
+}
+
+Future<std::shared_ptr<IAssetRequest>>
+CachingAssetAccessor::requestAssetWithCancellation(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const CancellationToken& cancellationToken) {
+  // The token is also passed on, so that a request to the server is aborted
+  // if the underlying asset accessor supports it and no other request shares
+  // it.
+  return this->joinOrStartRequest(asyncSystem, url, headers, cancellationToken)
+      .withCancellation(cancellationToken);
+}
+
+Future<std::shared_ptr<IAssetRequest>> CachingAssetAccessor::joinOrStartRequest(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const std::optional<CancellationToken>& cancellationToken) {
+  using Request = InFlightRequests::Request;
+
+  // Requests for URLs that only differ in parameters that the cache key
+  // omits, such as access tokens, share one request, because they share the
+  // cache entry that it stores.
+  InFlightRequests::Key key(this->_calculateCacheKey(url), headers);
+
+  std::shared_ptr<Request> pRequest;
+  bool isNewRequest = false;
+  {
+    std::lock_guard<std::mutex> lock(this->_pInFlightRequests->mutex);
+    auto it = this->_pInFlightRequests->requests.find(key);
+    if (it != this->_pInFlightRequests->requests.end() &&
+        !it->second->cancellationToken.isCanceled()) {
+      pRequest = it->second;
+    } else {
+      // A canceled request is replaced. It still completes for the requests
+      // that already share it.
+      CancellationToken sharedCancellationToken;
+      pRequest = std::make_shared<Request>(Request{
+          this->requestAssetFromCacheOrServer(
+                  asyncSystem,
+                  url,
+                  headers,
+                  sharedCancellationToken)
+              .share(),
+          url,
+          sharedCancellationToken,
+          0});
+      this->_pInFlightRequests->requests.insert_or_assign(key, pRequest);
+      isNewRequest = true;
+    }
+
+    ++pRequest->interestedRequests;
+  }
+
+  SharedFuture<std::shared_ptr<IAssetRequest>> future = pRequest->future;
+
+  if (isNewRequest) {
+    // The continuations are attached outside of the lock, because they run
+    // right away if the request already completed.
+    const auto removeRequest = [pInFlightRequests = this->_pInFlightRequests,
+                                key,
+                                pRemovedRequest = pRequest.get()]() {
+      std::lock_guard<std::mutex> lock(pInFlightRequests->mutex);
+      auto it = pInFlightRequests->requests.find(key);
+      if (it != pInFlightRequests->requests.end() &&
+          it->second.get() == pRemovedRequest) {
+        pInFlightRequests->requests.erase(it);
+      }
+    };
+    future
+        .thenImmediately(
+            [removeRequest](const std::shared_ptr<IAssetRequest>&) {
+              removeRequest();
+            })
+        .catchImmediately([removeRequest](std::exception&&) {
+          removeRequest();
+        });
+  }
+
+  if (cancellationToken) {
+    cancellationToken->onCancel(
+        [pInFlightRequests = this->_pInFlightRequests, pRequest]() {
+          bool cancel = false;
+          {
+            std::lock_guard<std::mutex> lock(pInFlightRequests->mutex);
+            cancel = --pRequest->interestedRequests == 0;
+          }
+
+          if (cancel) {
+            pRequest->cancellationToken.cancel();
+          }
+        });
+  }
+
+  if (pRequest->url != url) {
+    return future.thenImmediately(
+        [url](const std::shared_ptr<IAssetRequest>& pCompletedRequest)
+            -> std::shared_ptr<IAssetRequest> {
+          if (!pCompletedRequest) {
+            return pCompletedRequest;
+          }
+          return std::make_shared<SharedAssetRequest>(pCompletedRequest, url);
+        });
+  }
+
+  return future.thenImmediately(
+      [](const std::shared_ptr<IAssetRequest>& pCompletedRequest) {
+        return pCompletedRequest;
+      });
+}
+
+Future<std::shared_ptr<IAssetRequest>>
+CachingAssetAccessor::requestAssetFromCacheOrServer(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const CancellationToken& cancellationToken) {
   const int32_t requestSinceLastPrune = ++this->_requestSinceLastPrune;
   if (requestSinceLastPrune == this->_requestsPerCachePrune) {
     // More requests may have started and incremented _requestSinceLastPrune
@@ -123,6 +414,7 @@ Future<std::shared_ptr<IAssetRequest>> CachingAssetAccessor::requestAsset(
   CESIUM_TRACE_BEGIN_IN_TRACK("requestAsset (cached)");
 
   const ThreadPool& threadPool = this->_cacheThreadPool;
+  std::string cacheKey = this->_calculateCacheKey(url);
 
   return asyncSystem
       .runInThreadPool(
@@ -130,50 +422,68 @@ Future<std::shared_ptr<IAssetRequest>> CachingAssetAccessor::requestAsset(
           [asyncSystem,
            pAssetAccessor = this->_pAssetAccessor,
            pCacheDatabase = this->_pCacheDatabase,
+           pResponseCache = this->_pResponseCache,
            pLogger = this->_pLogger,
+           calculateCacheKey = this->_calculateCacheKey,
            url,
+           cacheKey = std::move(cacheKey),
            headers,
-           threadPool]() -> Future<std::shared_ptr<IAssetRequest>> {
-            std::optional<CacheItem> cacheLookup =
-                pCacheDatabase->getEntry(url);
-            if (!cacheLookup) {
+           threadPool,
+           cancellationToken]() -> Future<std::shared_ptr<IAssetRequest>> {
+            cancellationToken.throwIfCanceled();
+
+            const auto requestFromServer =
+                [&](const std::vector<THeader>& requestHeaders) {
+                  return pAssetAccessor->requestAssetWithCancellation(
+                      asyncSystem,
+                      url,
+                      requestHeaders,
+                      cancellationToken);
+                };
+
+            std::shared_ptr<const CacheItem> pCacheItem =
+                pResponseCache->get(cacheKey);
+            bool isFromDatabase = false;
+            if (!pCacheItem) {
+              ++pResponseCache->databaseLookups;
+              std::optional<CacheItem> cacheLookup =
+                  pCacheDatabase->getEntry(cacheKey);
+              if (cacheLookup) {
+                ++pResponseCache->databaseHits;
+                pCacheItem =
+                    std::make_shared<const CacheItem>(std::move(*cacheLookup));
+                isFromDatabase = true;
+              }
+            }
+
+            if (!pCacheItem) {
               // No cache item found, request directly from the server
-              return pAssetAccessor->requestAsset(asyncSystem, url, headers)
+              return requestFromServer(headers)
                   .thenInThreadPool(
                       threadPool,
-                      [pCacheDatabase, pLogger](
+                      [pCacheDatabase, pResponseCache, pLogger, cacheKey](
                           std::shared_ptr<IAssetRequest>&& pCompletedRequest) {
-                        const IAssetResponse* pResponse =
-                            pCompletedRequest->response();
-                        if (!pResponse) {
-                          return std::move(pCompletedRequest);
-                        }
-
-                        const std::optional<ResponseCacheControl> cacheControl =
-                            ResponseCacheControl::parseFromResponseHeaders(
-                                pResponse->headers());
-
-                        if (pResponse && shouldCacheRequest(
-                                             *pCompletedRequest,
-                                             cacheControl)) {
-                          pCacheDatabase->storeEntry(
-                              calculateCacheKey(*pCompletedRequest),
-                              calculateExpiryTime(
-                                  *pCompletedRequest,
-                                  cacheControl),
-                              pCompletedRequest->url(),
-                              pCompletedRequest->method(),
-                              pCompletedRequest->headers(),
-                              pResponse->statusCode(),
-                              pResponse->headers(),
-                              pResponse->data());
+                        if (pCompletedRequest->response()) {
+                          pResponseCache->storeResponse(
+                              *pCacheDatabase,
+                              cacheKey,
+                              *pCompletedRequest);
                         }
 
                         return std::move(pCompletedRequest);
                       });
             }
 
-            CacheItem& cacheItem = cacheLookup.value();
+            const CacheItem& cacheItem = *pCacheItem;
+
+            // An item that was cached for another URL with the same key, such
+            // as one with an expired access token, reports the requested URL,
+            // so that URLs relative to it get the current query parameters.
+            std::optional<std::string> requestedUrl;
+            if (cacheItem.cacheRequest.url != url &&
+                calculateCacheKey(cacheItem.cacheRequest.url) == cacheKey) {
+              requestedUrl = url;
+            }
 
             if (shouldRevalidateCache(cacheItem)) {
               // Cache is stale and needs revalidation
@@ -192,58 +502,67 @@ Future<std::shared_ptr<IAssetRequest>> CachingAssetAccessor::requestAsset(
                     lastModifiedHeader->second);
               }
 
-              return pAssetAccessor->requestAsset(asyncSystem, url, newHeaders)
+              return requestFromServer(newHeaders)
                   .thenInThreadPool(
                       threadPool,
-                      [cacheItem = std::move(cacheItem),
+                      [pCacheItem,
                        pCacheDatabase,
-                       pLogger](std::shared_ptr<IAssetRequest>&&
-                                    pCompletedRequest) mutable {
-                        if (!pCompletedRequest) {
-                          return std::move(pCompletedRequest);
+                       pResponseCache,
+                       pLogger,
+                       cacheKey,
+                       requestedUrl](std::shared_ptr<IAssetRequest>&&
+                                         pCompletedRequest) {
+                        if (!pCompletedRequest ||
+                            !pCompletedRequest->response()) {
+                          // The server could not be reached, so serve the
+                          // stale response rather than nothing.
+                          SPDLOG_LOGGER_WARN(
+                              pLogger,
+                              "Revalidating the cached response for {} "
+                              "failed, using the stale response.",
+                              cacheKey);
+                          std::shared_ptr<IAssetRequest> pStaleRequest =
+                              std::make_shared<CacheAssetRequest>(
+                                  pCacheItem,
+                                  std::optional<std::string>(requestedUrl));
+                          return pStaleRequest;
                         }
 
                         std::shared_ptr<IAssetRequest> pRequestToStore;
                         if (pCompletedRequest->response()->statusCode() ==
                             304) { // status Not-Modified
+                          CacheItem updatedCacheItem(*pCacheItem);
+                          if (requestedUrl) {
+                            updatedCacheItem.cacheRequest.url = *requestedUrl;
+                          }
                           pRequestToStore = updateCacheItem(
-                              std::move(cacheItem),
+                              std::move(updatedCacheItem),
                               *pCompletedRequest);
                         } else {
                           pRequestToStore = pCompletedRequest;
                         }
 
-                        const IAssetResponse* pResponseToStore =
-                            pRequestToStore->response();
-                        const std::optional<ResponseCacheControl> cacheControl =
-                            ResponseCacheControl::parseFromResponseHeaders(
-                                pResponseToStore->headers());
-
-                        if (shouldCacheRequest(
-                                *pRequestToStore,
-                                cacheControl)) {
-
-                          pCacheDatabase->storeEntry(
-                              calculateCacheKey(*pRequestToStore),
-                              calculateExpiryTime(
-                                  *pRequestToStore,
-                                  cacheControl),
-                              pRequestToStore->url(),
-                              pRequestToStore->method(),
-                              pRequestToStore->headers(),
-                              pResponseToStore->statusCode(),
-                              pResponseToStore->headers(),
-                              pResponseToStore->data());
-                        }
+                        pResponseCache->storeResponse(
+                            *pCacheDatabase,
+                            cacheKey,
+                            *pRequestToStore);
 
                         return pRequestToStore;
                       });
             }
 
+            if (isFromDatabase && pResponseCache->isEnabled()) {
+              pResponseCache->put(
+                  cacheKey,
+                  std::shared_ptr<const CacheItem>(pCacheItem));
+            }
+
             // Good cache item that doesn't need to be revalidated, just return
             // it.
             std::shared_ptr<IAssetRequest> pRequest =
-                std::make_shared<CacheAssetRequest>(std::move(cacheItem));
+                std::make_shared<CacheAssetRequest>(
+                    pCacheItem,
+                    std::move(requestedUrl));
             return asyncSystem.createResolvedFuture(std::move(pRequest));
           })
       .thenImmediately([](std::shared_ptr<IAssetRequest>&& pRequest) noexcept {
@@ -262,6 +581,38 @@ Future<std::shared_ptr<IAssetRequest>> CachingAssetAccessor::post(
 
 void CachingAssetAccessor::tick() noexcept { _pAssetAccessor->tick(); }
 
+void CachingAssetAccessor::ResponseCache::storeResponse(
+    ICacheDatabase& cacheDatabase,
+    const std::string& key,
+    const IAssetRequest& request) {
+  const IAssetResponse* pResponse = request.response();
+  const std::optional<ResponseCacheControl> cacheControl =
+      ResponseCacheControl::parseFromResponseHeaders(pResponse->headers());
+
+  if (!shouldCacheRequest(request, cacheControl)) {
+    return;
+  }
+
+  const std::time_t expiryTime = calculateExpiryTime(request, cacheControl);
+
+  cacheDatabase.storeEntry(
+      key,
+      expiryTime,
+      request.url(),
+      request.method(),
+      request.headers(),
+      pResponse->statusCode(),
+      pResponse->headers(),
+      pResponse->data());
+
+  if (this->isEnabled()) {
+    this->put(
+        key,
+        std::make_shared<const CacheItem>(
+            createCacheItem(expiryTime, request)));
+  }
+}
+
 bool shouldRevalidateCache(const CacheItem& cacheItem) {
   std::optional<ResponseCacheControl> cacheControl =
       ResponseCacheControl::parseFromResponseHeaders(
@@ -333,11 +684,6 @@ bool shouldCacheRequest(
   return true;
 }
 
-std::string calculateCacheKey(const IAssetRequest& request) {
-  // TODO: more complete cache key
-  return request.url();
-}
-
 std::time_t calculateExpiryTime(
     const IAssetRequest& request,
     const std::optional<ResponseCacheControl>& cacheControl) {
@@ -372,7 +718,24 @@ updateCacheItem(CacheItem&& cacheItem, const IAssetRequest& request) {
     }
   }
 
-  return std::make_unique<CacheAssetRequest>(std::move(cacheItem));
+  return std::make_unique<CacheAssetRequest>(
+      std::make_shared<const CacheItem>(std::move(cacheItem)));
+}
+
+CacheItem
+createCacheItem(std::time_t expiryTime, const IAssetRequest& request) {
+  const IAssetResponse* pResponse = request.response();
+  const gsl::span<const std::byte> data = pResponse->data();
+  return CacheItem(
+      expiryTime,
+      CacheRequest(
+          HttpHeaders(request.headers()),
+          std::string(request.method()),
+          std::string(request.url())),
+      CacheResponse(
+          pResponse->statusCode(),
+          HttpHeaders(pResponse->headers()),
+          std::vector<std::byte>(data.begin(), data.end())));
 }
 
 std::time_t convertHttpDateToTime(const std::string& httpDate) {
@@ -0,0 +1,45 @@
+#include "CesiumAsync/CancellationToken.h"
+
+namespace CesiumAsync {
+
+CancellationToken::CancellationToken()
+    : _pState(std::make_shared<State>()) {}
+
+void CancellationToken::cancel() const {
+  std::vector<std::function<void()>> callbacks;
+
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    if (this->_pState->canceled.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    callbacks = std::move(this->_pState->callbacks);
+    this->_pState->callbacks.clear();
+  }
+
+  // Invoke the callbacks without holding the lock, so that they may use this
+  // token, too.
+  for (std::function<void()>& callback : callbacks) {
+    callback();
+  }
+}
+
+void CancellationToken::throwIfCanceled() const {
+  if (this->isCanceled()) {
+    throw CancellationException();
+  }
+}
+
+void CancellationToken::onCancel(std::function<void()>&& callback) const {
+  {
+    std::lock_guard<std::mutex> lock(this->_pState->mutex);
+    if (!this->_pState->canceled.load(std::memory_order_acquire)) {
+      this->_pState->callbacks.emplace_back(std::move(callback));
+      return;
+    }
+  }
+
+  callback();
+}
+
+} // namespace CesiumAsync
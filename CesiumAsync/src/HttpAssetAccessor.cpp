@@ -0,0 +1,469 @@
+#include "CesiumAsync/HttpAssetAccessor.h"
+
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetResponse.h"
+
+#include <httplib.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <ctime>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace CesiumAsync {
+
+namespace {
+class HttpAssetResponse : public IAssetResponse {
+public:
+  HttpAssetResponse(
+      uint16_t statusCode,
+      HttpHeaders&& headers,
+      std::string&& body) noexcept
+      : _statusCode(statusCode),
+        _headers(std::move(headers)),
+        _body(std::move(body)) {}
+
+  virtual uint16_t statusCode() const noexcept override {
+    return this->_statusCode;
+  }
+
+  virtual std::string contentType() const override {
+    auto it = this->_headers.find("Content-Type");
+    if (it == this->_headers.end()) {
+      return std::string();
+    }
+    return it->second;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual gsl::span<const std::byte> data() const noexcept override {
+    // The body is not copied to a vector of bytes.
+    return gsl::span<const std::byte>(
+        reinterpret_cast<const std::byte*>(this->_body.data()),
+        this->_body.size());
+  }
+
+private:
+  uint16_t _statusCode;
+  HttpHeaders _headers;
+  std::string _body;
+};
+
+class HttpAssetRequest : public IAssetRequest {
+public:
+  HttpAssetRequest(
+      const std::string& method,
+      const std::string& url,
+      HttpHeaders&& headers)
+      : _method(method), _url(url), _headers(std::move(headers)) {}
+
+  virtual const std::string& method() const noexcept override {
+    return this->_method;
+  }
+
+  virtual const std::string& url() const noexcept override {
+    return this->_url;
+  }
+
+  virtual const HttpHeaders& headers() const noexcept override {
+    return this->_headers;
+  }
+
+  virtual const IAssetResponse* response() const noexcept override {
+    return this->_pResponse.get();
+  }
+
+  void setResponse(std::unique_ptr<HttpAssetResponse>&& pResponse) noexcept {
+    this->_pResponse = std::move(pResponse);
+  }
+
+private:
+  std::string _method;
+  std::string _url;
+  HttpHeaders _headers;
+  std::unique_ptr<HttpAssetResponse> _pResponse;
+};
+
+struct Job {
+  Job(const AsyncSystem& asyncSystem,
+      std::unique_ptr<HttpAssetRequest>&& pRequest_,
+      std::vector<std::byte>&& payload_,
+      const CancellationToken& cancellationToken_)
+      : pRequest(std::move(pRequest_)),
+        payload(std::move(payload_)),
+        cancellationToken(cancellationToken_),
+        promise(asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>()) {}
+
+  // The scheme, host and port of the URL, which identify the connections
+  // that may be used for this job, and the rest of the URL.
+  std::string origin;
+  std::string path;
+
+  std::unique_ptr<HttpAssetRequest> pRequest;
+  std::vector<std::byte> payload;
+  CancellationToken cancellationToken;
+  Promise<std::shared_ptr<IAssetRequest>> promise;
+
+  // Why the request failed, once it was sent.
+  std::exception_ptr pError;
+};
+
+// Splits a URL into the origin, for example `http://example.com:8080`, and
+// the path and query, without the fragment.
+void splitUrl(const std::string& url, std::string& origin, std::string& path) {
+  const size_t authorityStart = url.find("://");
+  const size_t pathStart = authorityStart == std::string::npos
+                               ? std::string::npos
+                               : url.find_first_of("/?#", authorityStart + 3);
+  origin = url.substr(0, pathStart);
+  if (pathStart == std::string::npos) {
+    path = "/";
+    return;
+  }
+
+  const size_t fragmentStart = url.find('#', pathStart);
+  path = url.substr(pathStart, fragmentStart - pathStart);
+  if (path.empty() || path[0] != '/') {
+    path.insert(0, "/");
+  }
+}
+} // namespace
+
+struct HttpAssetAccessor::Impl {
+  struct Host {
+    size_t activeRequests = 0;
+    std::vector<std::unique_ptr<httplib::Client>> idleClients;
+  };
+
+  explicit Impl(const HttpAssetAccessorOptions& options_) : options(options_) {
+    this->options.numberOfThreads =
+        std::max<size_t>(this->options.numberOfThreads, 1);
+    this->options.maximumConnectionsPerHost =
+        std::max<size_t>(this->options.maximumConnectionsPerHost, 1);
+  }
+
+  Future<std::shared_ptr<IAssetRequest>> enqueue(
+      const AsyncSystem& asyncSystem,
+      const std::string& method,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      std::vector<std::byte>&& payload,
+      const CancellationToken& cancellationToken);
+
+  void run();
+
+  std::unique_ptr<Job>
+  takeJob(std::vector<std::unique_ptr<Job>>& canceledJobs);
+
+  void send(Job& job, std::unique_ptr<httplib::Client>& pClient) const;
+
+  std::unique_ptr<httplib::Client>
+  createClient(const std::string& origin) const;
+
+  HttpAssetAccessorOptions options;
+
+  std::mutex mutex;
+  std::condition_variable jobAvailable;
+  std::deque<std::unique_ptr<Job>> queue;
+  std::unordered_map<std::string, Host> hosts;
+  bool stopping = false;
+
+  std::vector<std::thread> threads;
+};
+
+HttpAssetAccessor::HttpAssetAccessor(const HttpAssetAccessorOptions& options)
+    : _pImpl(std::make_unique<Impl>(options)) {
+  Impl* pImpl = this->_pImpl.get();
+  for (size_t i = 0; i < pImpl->options.numberOfThreads; ++i) {
+    pImpl->threads.emplace_back([pImpl]() { pImpl->run(); });
+  }
+}
+
+HttpAssetAccessor::~HttpAssetAccessor() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(this->_pImpl->mutex);
+    this->_pImpl->stopping = true;
+  }
+  this->_pImpl->jobAvailable.notify_all();
+
+  for (std::thread& thread : this->_pImpl->threads) {
+    thread.join();
+  }
+
+  for (const std::unique_ptr<Job>& pJob : this->_pImpl->queue) {
+    pJob->promise.reject(std::runtime_error(
+        "The asset accessor was destroyed before the request for " +
+        pJob->pRequest->url() + " was sent."));
+  }
+}
+
+Future<std::shared_ptr<IAssetRequest>> HttpAssetAccessor::requestAsset(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers) {
+  return this->_pImpl->enqueue(
+      asyncSystem,
+      "GET",
+      url,
+      headers,
+      std::vector<std::byte>(),
+      CancellationToken());
+}
+
+Future<std::shared_ptr<IAssetRequest>>
+HttpAssetAccessor::requestAssetWithCancellation(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const CancellationToken& cancellationToken) {
+  // A job that is canceled while it is queued is removed by the next thread
+  // that looks for a job.
+  return this->_pImpl
+      ->enqueue(
+          asyncSystem,
+          "GET",
+          url,
+          headers,
+          std::vector<std::byte>(),
+          cancellationToken)
+      .withCancellation(cancellationToken);
+}
+
+Future<std::shared_ptr<IAssetRequest>> HttpAssetAccessor::post(
+    const AsyncSystem& asyncSystem,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    const gsl::span<const std::byte>& contentPayload) {
+  return this->_pImpl->enqueue(
+      asyncSystem,
+      "POST",
+      url,
+      headers,
+      std::vector<std::byte>(contentPayload.begin(), contentPayload.end()),
+      CancellationToken());
+}
+
+void HttpAssetAccessor::tick() noexcept {}
+
+Future<std::shared_ptr<IAssetRequest>> HttpAssetAccessor::Impl::enqueue(
+    const AsyncSystem& asyncSystem,
+    const std::string& method,
+    const std::string& url,
+    const std::vector<THeader>& headers,
+    std::vector<std::byte>&& payload,
+    const CancellationToken& cancellationToken) {
+  // The headers of the request replace the default headers with the same
+  // name.
+  HttpHeaders requestHeaders(headers.begin(), headers.end());
+  requestHeaders.insert(
+      this->options.defaultHeaders.begin(),
+      this->options.defaultHeaders.end());
+
+  std::unique_ptr<Job> pJob = std::make_unique<Job>(
+      asyncSystem,
+      std::make_unique<HttpAssetRequest>(
+          method,
+          url,
+          std::move(requestHeaders)),
+      std::move(payload),
+      cancellationToken);
+  splitUrl(url, pJob->origin, pJob->path);
+
+  Future<std::shared_ptr<IAssetRequest>> future = pJob->promise.getFuture();
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->queue.emplace_back(std::move(pJob));
+  }
+  this->jobAvailable.notify_one();
+
+  return future;
+}
+
+void HttpAssetAccessor::Impl::run() {
+  for (;;) {
+    std::unique_ptr<Job> pJob;
+    std::unique_ptr<httplib::Client> pClient;
+    std::vector<std::unique_ptr<Job>> canceledJobs;
+
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      for (;;) {
+        if (this->stopping) {
+          return;
+        }
+        pJob = this->takeJob(canceledJobs);
+        if (pJob || !canceledJobs.empty()) {
+          break;
+        }
+        this->jobAvailable.wait(lock);
+      }
+
+      if (pJob) {
+        Host& host = this->hosts[pJob->origin];
+        ++host.activeRequests;
+        if (!host.idleClients.empty()) {
+          pClient = std::move(host.idleClients.back());
+          host.idleClients.pop_back();
+        }
+      }
+    }
+
+    for (const std::unique_ptr<Job>& pCanceledJob : canceledJobs) {
+      pCanceledJob->promise.reject(CancellationException());
+    }
+
+    if (!pJob) {
+      continue;
+    }
+
+    this->send(*pJob, pClient);
+
+    // Release the connection before the promise is settled, so that the next
+    // request to the host is not held up by the continuations.
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      Host& host = this->hosts[pJob->origin];
+      --host.activeRequests;
+      if (pClient) {
+        host.idleClients.emplace_back(std::move(pClient));
+      }
+    }
+
+    if (pJob->pError) {
+      pJob->promise.reject(pJob->pError);
+    } else {
+      pJob->promise.resolve(std::move(pJob->pRequest));
+    }
+  }
+}
+
+std::unique_ptr<Job> HttpAssetAccessor::Impl::takeJob(
+    std::vector<std::unique_ptr<Job>>& canceledJobs) {
+  // Take the oldest job whose host is not at its limit of connections.
+  auto it = this->queue.begin();
+  while (it != this->queue.end()) {
+    if ((*it)->cancellationToken.isCanceled()) {
+      canceledJobs.emplace_back(std::move(*it));
+      it = this->queue.erase(it);
+      continue;
+    }
+
+    auto hostIt = this->hosts.find((*it)->origin);
+    if (hostIt == this->hosts.end() ||
+        hostIt->second.activeRequests <
+            this->options.maximumConnectionsPerHost) {
+      std::unique_ptr<Job> pJob = std::move(*it);
+      this->queue.erase(it);
+      return pJob;
+    }
+
+    ++it;
+  }
+
+  return nullptr;
+}
+
+void HttpAssetAccessor::Impl::send(
+    Job& job,
+    std::unique_ptr<httplib::Client>& pClient) const {
+  HttpAssetRequest& request = *job.pRequest;
+
+  try {
+    if (!pClient) {
+      pClient = this->createClient(job.origin);
+    }
+
+    httplib::Headers headers;
+    const bool isPost = request.method() == "POST";
+
+    // The content type of a POST is passed separately.
+    std::string contentType = "application/octet-stream";
+    auto contentTypeIt = request.headers().end();
+    if (isPost) {
+      contentTypeIt = request.headers().find("Content-Type");
+      if (contentTypeIt != request.headers().end()) {
+        contentType = contentTypeIt->second;
+      }
+    }
+
+    for (auto it = request.headers().begin(); it != request.headers().end();
+         ++it) {
+      if (it != contentTypeIt) {
+        headers.emplace(it->first, it->second);
+      }
+    }
+
+    const CancellationToken& cancellationToken = job.cancellationToken;
+    auto result =
+        isPost
+            ? pClient->Post(
+                  job.path.c_str(),
+                  headers,
+                  reinterpret_cast<const char*>(job.payload.data()),
+                  job.payload.size(),
+                  contentType.c_str())
+            : pClient->Get(
+                  job.path.c_str(),
+                  headers,
+                  [&cancellationToken](uint64_t, uint64_t) {
+                    return !cancellationToken.isCanceled();
+                  });
+
+    if (!result) {
+      cancellationToken.throwIfCanceled();
+      throw std::runtime_error(
+          "The request for " + request.url() +
+          " failed with cpp-httplib error " +
+          std::to_string(static_cast<int>(result.error())) + ".");
+    }
+
+    httplib::Response& response = *result;
+    HttpHeaders responseHeaders(
+        response.headers.begin(),
+        response.headers.end());
+    request.setResponse(std::make_unique<HttpAssetResponse>(
+        static_cast<uint16_t>(response.status),
+        std::move(responseHeaders),
+        std::move(response.body)));
+  } catch (...) {
+    job.pError = std::current_exception();
+  }
+}
+
+std::unique_ptr<httplib::Client>
+HttpAssetAccessor::Impl::createClient(const std::string& origin) const {
+  // Without OpenSSL, cpp-httplib either throws or creates an invalid client
+  // for an `https` URL.
+  std::unique_ptr<httplib::Client> pClient =
+      std::make_unique<httplib::Client>(origin);
+  if (!pClient->is_valid()) {
+    throw std::runtime_error(
+        "The asset accessor cannot connect to " + origin + ".");
+  }
+
+  pClient->set_keep_alive(true);
+  pClient->set_follow_location(true);
+
+  const int64_t connectionTimeout = this->options.connectionTimeoutMilliseconds;
+  pClient->set_connection_timeout(
+      time_t(connectionTimeout / 1000),
+      time_t((connectionTimeout % 1000) * 1000));
+  const int64_t readTimeout = this->options.readTimeoutMilliseconds;
+  pClient->set_read_timeout(
+      time_t(readTimeout / 1000),
+      time_t((readTimeout % 1000) * 1000));
+
+  return pClient;
+}
+
+} // namespace CesiumAsync
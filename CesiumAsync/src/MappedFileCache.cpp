@@ -0,0 +1,776 @@
+#include "CesiumAsync/MappedFileCache.h"
+
+#include "MemoryMappedFile.h"
+
+#include <CesiumUtility/Tracing.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+// "CESIUMC1" as a little-endian integer, at the start of each segment.
+const uint64_t SEGMENT_MAGIC = 0x31434d5549534543;
+
+// "ENTR" as a little-endian integer, at the start of each complete record.
+const uint32_t RECORD_MAGIC = 0x52544e45;
+
+const uint32_t RECORD_DELETED = 1;
+
+const size_t RECORD_ALIGNMENT = 8;
+
+const std::string SEGMENT_FILE_PREFIX = "segment-";
+const std::string SEGMENT_FILE_EXTENSION = ".bin";
+
+struct SegmentHeader {
+  uint64_t magic;
+  uint64_t reserved;
+};
+
+// A record is this header, followed by the key, URL, method, request headers
+// and response headers, and then by the response data at the next aligned
+// offset. Records are aligned, so that their headers are accessed in place.
+struct RecordHeader {
+  uint32_t magic;
+  uint32_t flags;
+  uint64_t sequenceNumber;
+  int64_t expiryTime;
+  int64_t lastAccessedTime;
+  uint64_t dataSize;
+  uint32_t keySize;
+  uint32_t urlSize;
+  uint32_t methodSize;
+  uint32_t requestHeadersSize;
+  uint32_t responseHeadersSize;
+  uint16_t statusCode;
+  uint16_t reserved;
+};
+
+size_t align(size_t offset) noexcept {
+  return (offset + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+size_t getDataOffset(const RecordHeader& header) noexcept {
+  return align(
+      sizeof(RecordHeader) + header.keySize + header.urlSize +
+      header.methodSize + header.requestHeadersSize +
+      header.responseHeadersSize);
+}
+
+size_t getRecordSize(const RecordHeader& header) noexcept {
+  return align(getDataOffset(header) + size_t(header.dataSize));
+}
+
+// Writes the header of a record whose other contents were written. The magic
+// number is written last, so that an incomplete record is not read when the
+// segment is opened again.
+void writeRecordHeader(std::byte* pRecord, const RecordHeader& header) {
+  RecordHeader incompleteHeader = header;
+  incompleteHeader.magic = 0;
+  std::memcpy(pRecord, &incompleteHeader, sizeof(RecordHeader));
+  reinterpret_cast<RecordHeader*>(pRecord)->magic = RECORD_MAGIC;
+}
+
+void appendString(std::string& result, const std::string& value) {
+  const uint32_t size = uint32_t(value.size());
+  result.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  result.append(value);
+}
+
+bool readString(
+    const std::byte* pData,
+    size_t size,
+    size_t& offset,
+    std::string& value) {
+  uint32_t valueSize;
+  if (size - offset < sizeof(valueSize)) {
+    return false;
+  }
+
+  std::memcpy(&valueSize, pData + offset, sizeof(valueSize));
+  offset += sizeof(valueSize);
+  if (size - offset < valueSize) {
+    return false;
+  }
+
+  value.assign(reinterpret_cast<const char*>(pData + offset), valueSize);
+  offset += valueSize;
+  return true;
+}
+
+std::string serializeHeaders(const HttpHeaders& headers) {
+  std::string result;
+  for (const std::pair<const std::string, std::string>& header : headers) {
+    appendString(result, header.first);
+    appendString(result, header.second);
+  }
+  return result;
+}
+
+HttpHeaders deserializeHeaders(const std::byte* pData, size_t size) {
+  HttpHeaders headers;
+  size_t offset = 0;
+  std::string name;
+  std::string value;
+  while (readString(pData, size, offset, name) &&
+         readString(pData, size, offset, value)) {
+    headers.emplace(std::move(name), std::move(value));
+  }
+  return headers;
+}
+
+void writeField(std::byte*& pDestination, const std::string& value) {
+  std::memcpy(pDestination, value.data(), value.size());
+  pDestination += value.size();
+}
+
+std::string readField(const std::byte*& pSource, uint32_t size) {
+  std::string result(reinterpret_cast<const char*>(pSource), size);
+  pSource += size;
+  return result;
+}
+} // namespace
+
+struct MappedFileCache::Impl {
+  struct Segment {
+    Segment(const std::string& path, size_t minimumSize)
+        : file(path, minimumSize),
+          writeOffset(sizeof(SegmentHeader)),
+          liveBytes(0) {}
+
+    MemoryMappedFile file;
+
+    // The end of the records, and the size of the records that are not
+    // deleted. Both are guarded by the mutex of the cache.
+    size_t writeOffset;
+    size_t liveBytes;
+  };
+
+  struct Location {
+    std::shared_ptr<Segment> pSegment;
+    size_t offset;
+  };
+
+  Impl(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      const std::string& directory,
+      uint64_t maxItems,
+      uint64_t maxBytes,
+      size_t segmentBytes)
+      : _pLogger(pLogger),
+        _directory(directory),
+        _maxItems(maxItems),
+        _maxBytes(maxBytes),
+        _segmentBytes(segmentBytes),
+        _totalBytes(0),
+        _nextSequenceNumber(0),
+        _nextSegmentNumber(0),
+        _compactionPending(false),
+        _stopCompactionThread(false) {}
+
+  RecordHeader& getHeader(const Location& location) const noexcept {
+    return *reinterpret_cast<RecordHeader*>(
+        location.pSegment->file.data() + location.offset);
+  }
+
+  std::string getSegmentPath(uint64_t number) const;
+  void openSegments();
+  void openSegment(uint64_t number, const std::string& path);
+  void addOpenedRecord(const std::shared_ptr<Segment>& pSegment, size_t offset);
+  void createSegment(size_t recordSize);
+  Location allocateRecord(size_t recordSize);
+  void markDeleted(const Location& location) noexcept;
+  bool compactSegment();
+  void runCompactionThread();
+
+  std::shared_ptr<spdlog::logger> _pLogger;
+  std::string _directory;
+  uint64_t _maxItems;
+  uint64_t _maxBytes;
+  size_t _segmentBytes;
+
+  // Guards the segments, the index and the records' headers.
+  mutable std::mutex _mutex;
+
+  // The segments by their number. New records are appended to the active
+  // segment, which is the newest one.
+  std::map<uint64_t, std::shared_ptr<Segment>> _segments;
+  std::shared_ptr<Segment> _pActiveSegment;
+  std::unordered_map<std::string, Location> _index;
+  uint64_t _totalBytes;
+  uint64_t _nextSequenceNumber;
+  uint64_t _nextSegmentNumber;
+
+  std::mutex _compactionMutex;
+  std::condition_variable _compactionRequested;
+  bool _compactionPending;
+  bool _stopCompactionThread;
+  std::thread _compactionThread;
+};
+
+std::string MappedFileCache::Impl::getSegmentPath(uint64_t number) const {
+  return (std::filesystem::path(this->_directory) /
+          (SEGMENT_FILE_PREFIX + std::to_string(number) +
+           SEGMENT_FILE_EXTENSION))
+      .string();
+}
+
+void MappedFileCache::Impl::openSegments() {
+  std::vector<std::pair<uint64_t, std::string>> files;
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(this->_directory)) {
+    const std::string name = entry.path().filename().string();
+    const size_t affixesSize =
+        SEGMENT_FILE_PREFIX.size() + SEGMENT_FILE_EXTENSION.size();
+    if (name.size() <= affixesSize ||
+        name.compare(0, SEGMENT_FILE_PREFIX.size(), SEGMENT_FILE_PREFIX) !=
+            0 ||
+        name.compare(
+            name.size() - SEGMENT_FILE_EXTENSION.size(),
+            SEGMENT_FILE_EXTENSION.size(),
+            SEGMENT_FILE_EXTENSION) != 0) {
+      continue;
+    }
+
+    const std::string number = name.substr(
+        SEGMENT_FILE_PREFIX.size(),
+        name.size() - affixesSize);
+    if (!std::all_of(number.begin(), number.end(), [](char c) {
+          return c >= '0' && c <= '9';
+        })) {
+      continue;
+    }
+
+    files.emplace_back(std::stoull(number), entry.path().string());
+  }
+
+  std::sort(files.begin(), files.end());
+
+  for (const std::pair<uint64_t, std::string>& file : files) {
+    this->_nextSegmentNumber = file.first + 1;
+    try {
+      this->openSegment(file.first, file.second);
+    } catch (const std::exception& e) {
+      SPDLOG_LOGGER_ERROR(
+          this->_pLogger,
+          "Cannot open the cache segment {}: {}",
+          file.second,
+          e.what());
+    }
+  }
+}
+
+void MappedFileCache::Impl::openSegment(
+    uint64_t number,
+    const std::string& path) {
+  if (std::filesystem::file_size(path) < sizeof(SegmentHeader)) {
+    std::filesystem::remove(path);
+    return;
+  }
+
+  std::shared_ptr<Segment> pSegment = std::make_shared<Segment>(path, 0);
+  const std::byte* pData = pSegment->file.data();
+  const size_t size = pSegment->file.size();
+
+  SegmentHeader segmentHeader;
+  std::memcpy(&segmentHeader, pData, sizeof(SegmentHeader));
+  if (segmentHeader.magic != SEGMENT_MAGIC) {
+    pSegment->file.removeWhenClosed();
+    return;
+  }
+
+  size_t offset = sizeof(SegmentHeader);
+  while (size - offset >= sizeof(RecordHeader)) {
+    const RecordHeader& header =
+        *reinterpret_cast<const RecordHeader*>(pData + offset);
+    if (header.magic != RECORD_MAGIC || header.dataSize > size ||
+        getDataOffset(header) > size) {
+      break;
+    }
+
+    const size_t recordSize = getRecordSize(header);
+    if (recordSize > size - offset) {
+      break;
+    }
+
+    if ((header.flags & RECORD_DELETED) == 0) {
+      this->addOpenedRecord(pSegment, offset);
+    }
+
+    offset += recordSize;
+  }
+
+  // New records overwrite an incomplete record at the end.
+  pSegment->writeOffset = offset;
+
+  this->_segments.emplace(number, pSegment);
+  this->_pActiveSegment = pSegment;
+}
+
+void MappedFileCache::Impl::addOpenedRecord(
+    const std::shared_ptr<Segment>& pSegment,
+    size_t offset) {
+  const Location location{pSegment, offset};
+  RecordHeader& header = this->getHeader(location);
+  const std::string key(
+      reinterpret_cast<const char*>(
+          pSegment->file.data() + offset + sizeof(RecordHeader)),
+      header.keySize);
+
+  this->_nextSequenceNumber =
+      std::max(this->_nextSequenceNumber, header.sequenceNumber + 1);
+
+  // A record that was replaced or copied during a compaction may not be
+  // marked as deleted yet. The one with the highest sequence number is kept.
+  auto it = this->_index.find(key);
+  if (it != this->_index.end()) {
+    if (this->getHeader(it->second).sequenceNumber > header.sequenceNumber) {
+      header.flags |= RECORD_DELETED;
+      return;
+    }
+
+    this->_totalBytes -= this->getHeader(it->second).dataSize;
+    this->markDeleted(it->second);
+    it->second = location;
+  } else {
+    this->_index.emplace(key, location);
+  }
+
+  pSegment->liveBytes += getRecordSize(header);
+  this->_totalBytes += header.dataSize;
+}
+
+void MappedFileCache::Impl::createSegment(size_t recordSize) {
+  const uint64_t number = this->_nextSegmentNumber++;
+  const std::string path = this->getSegmentPath(number);
+  std::shared_ptr<Segment> pSegment;
+  try {
+    pSegment = std::make_shared<Segment>(
+        path,
+        std::max(this->_segmentBytes, sizeof(SegmentHeader) + recordSize));
+  } catch (...) {
+    // Do not leave a segment without a header behind, for example when the
+    // disk is full.
+    std::error_code errorCode;
+    std::filesystem::remove(path, errorCode);
+    throw;
+  }
+
+  const SegmentHeader segmentHeader{SEGMENT_MAGIC, 0};
+  std::memcpy(pSegment->file.data(), &segmentHeader, sizeof(SegmentHeader));
+
+  this->_segments.emplace(number, pSegment);
+  this->_pActiveSegment = pSegment;
+}
+
+MappedFileCache::Impl::Location
+MappedFileCache::Impl::allocateRecord(size_t recordSize) {
+  if (!this->_pActiveSegment ||
+      this->_pActiveSegment->file.size() -
+              this->_pActiveSegment->writeOffset <
+          recordSize) {
+    this->createSegment(recordSize);
+  }
+
+  Segment& segment = *this->_pActiveSegment;
+  const Location location{this->_pActiveSegment, segment.writeOffset};
+  segment.writeOffset += recordSize;
+  segment.liveBytes += recordSize;
+  return location;
+}
+
+void MappedFileCache::Impl::markDeleted(const Location& location) noexcept {
+  RecordHeader& header = this->getHeader(location);
+  header.flags |= RECORD_DELETED;
+  location.pSegment->liveBytes -= getRecordSize(header);
+}
+
+bool MappedFileCache::Impl::compactSegment() {
+  CESIUM_TRACE("MappedFileCache::compactSegment");
+
+  // A record that is moved to the active segment.
+  struct Move {
+    std::string key;
+    size_t offset;
+    size_t recordSize;
+    Location newLocation;
+  };
+
+  uint64_t segmentNumber;
+  std::shared_ptr<Segment> pSegment;
+  std::vector<Move> moves;
+
+  {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    // Find a segment in which more than half of the records are deleted.
+    auto segmentIt = std::find_if(
+        this->_segments.begin(),
+        this->_segments.end(),
+        [this](const std::pair<const uint64_t, std::shared_ptr<Segment>>&
+                   numberAndSegment) {
+          const Segment& segment = *numberAndSegment.second;
+          return numberAndSegment.second != this->_pActiveSegment &&
+                 (segment.liveBytes == 0 ||
+                  segment.liveBytes * 2 <
+                      segment.writeOffset - sizeof(SegmentHeader));
+        });
+    if (segmentIt == this->_segments.end()) {
+      return false;
+    }
+
+    segmentNumber = segmentIt->first;
+    pSegment = segmentIt->second;
+
+    // Reserve the space of its remaining records in the active segment. The
+    // new records are marked deleted until their data has been copied, so
+    // that the segment can still be read if the copy never completes.
+    try {
+      for (const std::pair<const std::string, Location>& entry :
+           this->_index) {
+        const Location& location = entry.second;
+        if (location.pSegment != pSegment) {
+          continue;
+        }
+
+        RecordHeader header = this->getHeader(location);
+        header.flags |= RECORD_DELETED;
+        const size_t recordSize = getRecordSize(header);
+        const Location newLocation = this->allocateRecord(recordSize);
+        writeRecordHeader(
+            newLocation.pSegment->file.data() + newLocation.offset,
+            header);
+
+        moves.push_back(
+            {entry.first, location.offset, recordSize, newLocation});
+      }
+    } catch (const std::exception& e) {
+      SPDLOG_LOGGER_ERROR(
+          this->_pLogger,
+          "Cannot compact the cache segment {}: {}",
+          pSegment->file.getPath(),
+          e.what());
+      for (const Move& move : moves) {
+        move.newLocation.pSegment->liveBytes -= move.recordSize;
+      }
+      return false;
+    }
+  }
+
+  // Copy the records without holding the lock, so that the cache can be used
+  // in the meantime. Only the headers of records change after they are
+  // written, so their other fields and data can be read without the lock.
+  for (const Move& move : moves) {
+    const std::byte* pRecord = pSegment->file.data() + move.offset;
+    std::byte* pNewRecord =
+        move.newLocation.pSegment->file.data() + move.newLocation.offset;
+    std::memcpy(
+        pNewRecord + sizeof(RecordHeader),
+        pRecord + sizeof(RecordHeader),
+        move.recordSize - sizeof(RecordHeader));
+  }
+
+  std::lock_guard<std::mutex> lock(this->_mutex);
+
+  for (const Move& move : moves) {
+    auto it = this->_index.find(move.key);
+    if (it == this->_index.end() || it->second.pSegment != pSegment ||
+        it->second.offset != move.offset) {
+      // The entry was replaced or removed while it was copied, so the new
+      // record stays deleted.
+      move.newLocation.pSegment->liveBytes -= move.recordSize;
+      continue;
+    }
+
+    RecordHeader header = this->getHeader(it->second);
+    header.sequenceNumber = this->_nextSequenceNumber++;
+    writeRecordHeader(
+        move.newLocation.pSegment->file.data() + move.newLocation.offset,
+        header);
+
+    this->markDeleted(it->second);
+    it->second = move.newLocation;
+  }
+
+  // The file is removed once the responses that refer to it are destroyed.
+  pSegment->file.removeWhenClosed();
+  this->_segments.erase(segmentNumber);
+  return true;
+}
+
+void MappedFileCache::Impl::runCompactionThread() {
+  std::unique_lock<std::mutex> lock(this->_compactionMutex);
+  while (!this->_stopCompactionThread) {
+    this->_compactionRequested.wait(lock, [this]() {
+      return this->_stopCompactionThread || this->_compactionPending;
+    });
+
+    if (this->_stopCompactionThread) {
+      break;
+    }
+
+    this->_compactionPending = false;
+
+    lock.unlock();
+    while (this->compactSegment()) {
+    }
+    lock.lock();
+  }
+}
+
+MappedFileCache::MappedFileCache(
+    const std::shared_ptr<spdlog::logger>& pLogger,
+    const std::string& directory,
+    uint64_t maxItems,
+    uint64_t maxBytes,
+    size_t segmentBytes)
+    : _pImpl(std::make_unique<Impl>(
+          pLogger,
+          directory,
+          maxItems,
+          maxBytes,
+          segmentBytes)) {
+  std::filesystem::create_directories(directory);
+
+  this->_pImpl->openSegments();
+
+  Impl* pImpl = this->_pImpl.get();
+  pImpl->_compactionThread =
+      std::thread([pImpl]() { pImpl->runCompactionThread(); });
+}
+
+MappedFileCache::~MappedFileCache() {
+  {
+    std::lock_guard<std::mutex> lock(this->_pImpl->_compactionMutex);
+    this->_pImpl->_stopCompactionThread = true;
+  }
+  this->_pImpl->_compactionRequested.notify_one();
+  this->_pImpl->_compactionThread.join();
+}
+
+std::optional<CacheItem>
+MappedFileCache::getEntry(const std::string& key) const {
+  CESIUM_TRACE("MappedFileCache::getEntry");
+
+  Impl::Location location;
+  RecordHeader header;
+  {
+    std::lock_guard<std::mutex> lock(this->_pImpl->_mutex);
+    auto it = this->_pImpl->_index.find(key);
+    if (it == this->_pImpl->_index.end()) {
+      return std::nullopt;
+    }
+
+    location = it->second;
+    RecordHeader& storedHeader = this->_pImpl->getHeader(location);
+    storedHeader.lastAccessedTime = int64_t(std::time(nullptr));
+    header = storedHeader;
+  }
+
+  // Apart from its header, a record does not change once it is written, so
+  // it is read without the lock. The location keeps its segment mapped.
+  const std::byte* pRecord = location.pSegment->file.data() + location.offset;
+  const std::byte* pField = pRecord + sizeof(RecordHeader) + header.keySize;
+  std::string url = readField(pField, header.urlSize);
+  std::string method = readField(pField, header.methodSize);
+  HttpHeaders requestHeaders =
+      deserializeHeaders(pField, header.requestHeadersSize);
+  pField += header.requestHeadersSize;
+  HttpHeaders responseHeaders =
+      deserializeHeaders(pField, header.responseHeadersSize);
+
+  const gsl::span<const std::byte> responseData(
+      pRecord + getDataOffset(header),
+      size_t(header.dataSize));
+
+  return CacheItem(
+      std::time_t(header.expiryTime),
+      CacheRequest(
+          std::move(requestHeaders),
+          std::move(method),
+          std::move(url)),
+      CacheResponse(
+          header.statusCode,
+          std::move(responseHeaders),
+          responseData,
+          std::move(location.pSegment)));
+}
+
+bool MappedFileCache::storeEntry(
+    const std::string& key,
+    std::time_t expiryTime,
+    const std::string& url,
+    const std::string& requestMethod,
+    const HttpHeaders& requestHeaders,
+    uint16_t statusCode,
+    const HttpHeaders& responseHeaders,
+    const gsl::span<const std::byte>& responseData) {
+  CESIUM_TRACE("MappedFileCache::storeEntry");
+
+  const std::string serializedRequestHeaders = serializeHeaders(requestHeaders);
+  const std::string serializedResponseHeaders =
+      serializeHeaders(responseHeaders);
+
+  RecordHeader header{};
+  header.magic = RECORD_MAGIC;
+  header.expiryTime = int64_t(expiryTime);
+  header.lastAccessedTime = int64_t(std::time(nullptr));
+  header.dataSize = responseData.size();
+  header.keySize = uint32_t(key.size());
+  header.urlSize = uint32_t(url.size());
+  header.methodSize = uint32_t(requestMethod.size());
+  header.requestHeadersSize = uint32_t(serializedRequestHeaders.size());
+  header.responseHeadersSize = uint32_t(serializedResponseHeaders.size());
+  header.statusCode = statusCode;
+  const size_t recordSize = getRecordSize(header);
+
+  std::lock_guard<std::mutex> lock(this->_pImpl->_mutex);
+
+  Impl::Location location;
+  try {
+    location = this->_pImpl->allocateRecord(recordSize);
+  } catch (const std::exception& e) {
+    SPDLOG_LOGGER_ERROR(
+        this->_pImpl->_pLogger,
+        "Cannot create a cache segment: {}",
+        e.what());
+    return false;
+  }
+
+  std::byte* pRecord = location.pSegment->file.data() + location.offset;
+  std::byte* pField = pRecord + sizeof(RecordHeader);
+  writeField(pField, key);
+  writeField(pField, url);
+  writeField(pField, requestMethod);
+  writeField(pField, serializedRequestHeaders);
+  writeField(pField, serializedResponseHeaders);
+  if (!responseData.empty()) {
+    std::memcpy(
+        pRecord + getDataOffset(header),
+        responseData.data(),
+        responseData.size());
+  }
+
+  header.sequenceNumber = this->_pImpl->_nextSequenceNumber++;
+  writeRecordHeader(pRecord, header);
+
+  auto it = this->_pImpl->_index.find(key);
+  if (it != this->_pImpl->_index.end()) {
+    this->_pImpl->_totalBytes -= this->_pImpl->getHeader(it->second).dataSize;
+    this->_pImpl->markDeleted(it->second);
+    it->second = std::move(location);
+  } else {
+    this->_pImpl->_index.emplace(key, std::move(location));
+  }
+
+  this->_pImpl->_totalBytes += responseData.size();
+  return true;
+}
+
+bool MappedFileCache::prune() {
+  CESIUM_TRACE("MappedFileCache::prune");
+
+  {
+    std::lock_guard<std::mutex> lock(this->_pImpl->_mutex);
+    std::unordered_map<std::string, Impl::Location>& index =
+        this->_pImpl->_index;
+
+    const auto erase = [this, &index](
+                           std::unordered_map<std::string, Impl::Location>::
+                               iterator it) {
+      this->_pImpl->_totalBytes -= this->_pImpl->getHeader(it->second).dataSize;
+      this->_pImpl->markDeleted(it->second);
+      return index.erase(it);
+    };
+
+    // Remove the expired entries.
+    const int64_t currentTime = int64_t(std::time(nullptr));
+    for (auto it = index.begin(); it != index.end();) {
+      if (this->_pImpl->getHeader(it->second).expiryTime < currentTime) {
+        it = erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    const auto isOverQuota = [this, &index]() {
+      return index.size() > this->_pImpl->_maxItems ||
+             (this->_pImpl->_maxBytes > 0 &&
+              this->_pImpl->_totalBytes > this->_pImpl->_maxBytes);
+    };
+
+    // Remove the least recently used entries.
+    if (isOverQuota()) {
+      using Candidate = std::pair<
+          std::pair<int64_t, uint64_t>,
+          std::unordered_map<std::string, Impl::Location>::iterator>;
+      std::vector<Candidate> candidates;
+      candidates.reserve(index.size());
+      for (auto it = index.begin(); it != index.end(); ++it) {
+        const RecordHeader& header = this->_pImpl->getHeader(it->second);
+        candidates.emplace_back(
+            std::make_pair(header.lastAccessedTime, header.sequenceNumber),
+            it);
+      }
+
+      std::sort(
+          candidates.begin(),
+          candidates.end(),
+          [](const Candidate& lhs, const Candidate& rhs) {
+            return lhs.first < rhs.first;
+          });
+
+      for (const Candidate& candidate : candidates) {
+        if (!isOverQuota()) {
+          break;
+        }
+        erase(candidate.second);
+      }
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->_pImpl->_compactionMutex);
+    this->_pImpl->_compactionPending = true;
+  }
+  this->_pImpl->_compactionRequested.notify_one();
+
+  return true;
+}
+
+bool MappedFileCache::clearAll() {
+  CESIUM_TRACE("MappedFileCache::clearAll");
+
+  std::lock_guard<std::mutex> lock(this->_pImpl->_mutex);
+
+  // The files are removed once the responses that refer to them are
+  // destroyed.
+  for (std::pair<const uint64_t, std::shared_ptr<Impl::Segment>>& segment :
+       this->_pImpl->_segments) {
+    segment.second->file.removeWhenClosed();
+  }
+
+  this->_pImpl->_segments.clear();
+  this->_pImpl->_pActiveSegment.reset();
+  this->_pImpl->_index.clear();
+  this->_pImpl->_totalBytes = 0;
+  return true;
+}
+
+void MappedFileCache::compact() {
+  while (this->_pImpl->compactSegment()) {
+  }
+}
@@ -0,0 +1,224 @@
+#include "MemoryMappedFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CesiumAsync {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path, size_t minimumSize)
+    : MemoryMappedFile(path, minimumSize, false) {}
+
+MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    : MemoryMappedFile(path, 0, true) {}
+
+#ifdef _WIN32
+
+MemoryMappedFile::MemoryMappedFile(
+    const std::string& path,
+    size_t minimumSize,
+    bool readOnly)
+    : _path(path),
+      _pData(nullptr),
+      _size(0),
+      _removeWhenClosed(false),
+      _fileHandle(INVALID_HANDLE_VALUE),
+      _mappingHandle(nullptr) {
+  HANDLE fileHandle = CreateFileA(
+      path.c_str(),
+      readOnly ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+      nullptr,
+      readOnly ? OPEN_EXISTING : OPEN_ALWAYS,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Cannot open the file " + path + ".");
+  }
+  this->_fileHandle = fileHandle;
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(fileHandle, &fileSize)) {
+    CloseHandle(fileHandle);
+    throw std::runtime_error("Cannot get the size of the file " + path + ".");
+  }
+
+  this->_size = std::max(size_t(fileSize.QuadPart), minimumSize);
+  if (this->_size == 0) {
+    // An empty file cannot be mapped.
+    return;
+  }
+
+  // Mapping a file that is smaller than the mapping extends it with zeros.
+  const uint64_t mappingSize = uint64_t(this->_size);
+  HANDLE mappingHandle = CreateFileMappingA(
+      fileHandle,
+      nullptr,
+      readOnly ? PAGE_READONLY : PAGE_READWRITE,
+      DWORD(mappingSize >> 32),
+      DWORD(mappingSize & 0xFFFFFFFF),
+      nullptr);
+  if (!mappingHandle) {
+    CloseHandle(fileHandle);
+    throw std::runtime_error("Cannot map the file " + path + ".");
+  }
+  this->_mappingHandle = mappingHandle;
+
+  void* pData = MapViewOfFile(
+      mappingHandle,
+      readOnly ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS,
+      0,
+      0,
+      this->_size);
+  if (!pData) {
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    throw std::runtime_error("Cannot map the file " + path + ".");
+  }
+  this->_pData = static_cast<std::byte*>(pData);
+}
+
+MemoryMappedFile::~MemoryMappedFile() noexcept {
+  if (this->_pData) {
+    UnmapViewOfFile(this->_pData);
+    CloseHandle(this->_mappingHandle);
+  }
+  CloseHandle(this->_fileHandle);
+
+  if (this->_removeWhenClosed.load(std::memory_order_acquire)) {
+    DeleteFileA(this->_path.c_str());
+  }
+}
+
+#else
+
+namespace {
+/**
+ * @brief Allocates the disk space of a range of a file, extending the file if
+ * needed.
+ *
+ * A file that is only extended with `ftruncate` is sparse, so writing to its
+ * mapping raises SIGBUS when the disk is full. With the space allocated up
+ * front, a full disk is reported here instead.
+ *
+ * @return Whether the space was allocated.
+ */
+bool allocateFileSpace(int fileDescriptor, size_t offset, size_t length) {
+#ifndef __APPLE__
+  const int result =
+      posix_fallocate(fileDescriptor, off_t(offset), off_t(length));
+  if (result == 0) {
+    return true;
+  }
+  if (result != EINVAL && result != EOPNOTSUPP) {
+    return false;
+  }
+#endif
+
+  // The file system cannot allocate space without writing it, so write zeros.
+  const std::vector<std::byte> zeros(std::min<size_t>(length, 65536));
+  while (length > 0) {
+    const ssize_t written = pwrite(
+        fileDescriptor,
+        zeros.data(),
+        std::min(length, zeros.size()),
+        off_t(offset));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    offset += size_t(written);
+    length -= size_t(written);
+  }
+
+  return true;
+}
+} // namespace
+
+MemoryMappedFile::MemoryMappedFile(
+    const std::string& path,
+    size_t minimumSize,
+    bool readOnly)
+    : _path(path),
+      _pData(nullptr),
+      _size(0),
+      _removeWhenClosed(false),
+      _fileDescriptor(-1) {
+  const int fileDescriptor =
+      readOnly ? open(path.c_str(), O_RDONLY)
+               : open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fileDescriptor < 0) {
+    throw std::runtime_error("Cannot open the file " + path + ".");
+  }
+
+  struct stat fileStatus;
+  if (fstat(fileDescriptor, &fileStatus) != 0) {
+    close(fileDescriptor);
+    throw std::runtime_error("Cannot get the size of the file " + path + ".");
+  }
+
+  const size_t fileSize = size_t(fileStatus.st_size);
+  this->_size = fileSize < minimumSize ? minimumSize : fileSize;
+  if (fileSize < this->_size &&
+      !allocateFileSpace(fileDescriptor, fileSize, this->_size - fileSize)) {
+    close(fileDescriptor);
+    throw std::runtime_error(
+        "Cannot allocate the space of the file " + path + ".");
+  }
+
+  this->_fileDescriptor = fileDescriptor;
+  if (this->_size == 0) {
+    // An empty file cannot be mapped.
+    return;
+  }
+
+  void* pData = mmap(
+      nullptr,
+      this->_size,
+      readOnly ? PROT_READ : PROT_READ | PROT_WRITE,
+      MAP_SHARED,
+      fileDescriptor,
+      0);
+  if (pData == MAP_FAILED) {
+    close(fileDescriptor);
+    throw std::runtime_error("Cannot map the file " + path + ".");
+  }
+
+  this->_pData = static_cast<std::byte*>(pData);
+}
+
+MemoryMappedFile::~MemoryMappedFile() noexcept {
+  if (this->_pData) {
+    munmap(this->_pData, this->_size);
+  }
+  close(this->_fileDescriptor);
+
+  if (this->_removeWhenClosed.load(std::memory_order_acquire)) {
+    std::remove(this->_path.c_str());
+  }
+}
+
+#endif
+
+} // namespace CesiumAsync
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace CesiumAsync {
+
+/**
+ * @brief A file that is mapped into memory for reading and writing.
+ *
+ * Writes to the mapped memory are written to the file by the operating system.
+ */
+class MemoryMappedFile final {
+public:
+  /**
+   * @brief Opens the file at the given path, or creates it if it does not
+   * exist, and maps all of it into memory.
+   *
+   * A file that is smaller than `minimumSize` is first extended to that size
+   * with zero bytes. Their disk space is allocated right away, so that a full
+   * disk is reported here rather than when the mapping is written to.
+   *
+   * @param path The path of the file.
+   * @param minimumSize The minimum size of the file, in bytes.
+   * @throws std::runtime_error If the file cannot be opened, extended, or
+   * mapped.
+   */
+  MemoryMappedFile(const std::string& path, size_t minimumSize);
+
+  /**
+   * @brief Opens the existing file at the given path and maps all of it into
+   * memory for reading only.
+   *
+   * The mapped memory must not be written. An empty file is not mapped, and
+   * {@link data} returns nullptr.
+   *
+   * @param path The path of the file.
+   * @throws std::runtime_error If the file cannot be opened or mapped.
+   */
+  explicit MemoryMappedFile(const std::string& path);
+
+  /**
+   * @brief Unmaps and closes the file, and removes it if
+   * {@link removeWhenClosed} was called.
+   */
+  ~MemoryMappedFile() noexcept;
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  /**
+   * @brief Gets the path of the file.
+   */
+  const std::string& getPath() const noexcept { return this->_path; }
+
+  /**
+   * @brief Gets the mapped memory.
+   */
+  std::byte* data() const noexcept { return this->_pData; }
+
+  /**
+   * @brief Gets the size of the file and the mapped memory, in bytes.
+   */
+  size_t size() const noexcept { return this->_size; }
+
+  /**
+   * @brief Removes the file once it is closed.
+   *
+   * This may be called from any thread.
+   */
+  void removeWhenClosed() noexcept {
+    this->_removeWhenClosed.store(true, std::memory_order_release);
+  }
+
+private:
+  MemoryMappedFile(const std::string& path, size_t minimumSize, bool readOnly);
+
+  std::string _path;
+  std::byte* _pData;
+  size_t _size;
+  std::atomic<bool> _removeWhenClosed;
+
+#ifdef _WIN32
+  void* _fileHandle;
+  void* _mappingHandle;
+#else
+  int _fileDescriptor;
+#endif
+};
+
+} // namespace CesiumAsync
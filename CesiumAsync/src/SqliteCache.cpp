@@ -10,9 +10,17 @@
 #include <spdlog/spdlog.h>
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <ctime>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 using namespace CesiumAsync;
 
@@ -29,7 +37,13 @@ const std::string CACHE_TABLE_RESPONSE_DATA_COLUMN = "responseData";
 const std::string CACHE_TABLE_REQUEST_HEADER_COLUMN = "requestHeader";
 const std::string CACHE_TABLE_REQUEST_METHOD_COLUMN = "requestMethod";
 const std::string CACHE_TABLE_REQUEST_URL_COLUMN = "requestUrl";
-const std::string CACHE_TABLE_VIRTUAL_TOTAL_ITEMS_COLUMN = "totalItems";
+
+// Metadata table column names and keys
+const std::string METADATA_TABLE = "CacheMetadataTable";
+const std::string METADATA_TABLE_KEY_COLUMN = "key";
+const std::string METADATA_TABLE_VALUE_COLUMN = "value";
+const std::string METADATA_TOTAL_ITEMS_KEY = "totalItems";
+const std::string METADATA_TOTAL_BYTES_KEY = "totalBytes";
 
 // Sql commands for setting up database
 const std::string CREATE_CACHE_TABLE_SQL =
@@ -43,6 +57,60 @@ const std::string CREATE_CACHE_TABLE_SQL =
     CACHE_TABLE_REQUEST_METHOD_COLUMN + " TEXT NOT NULL," +
     CACHE_TABLE_REQUEST_URL_COLUMN + " TEXT NOT NULL)";
 
+// The totals of the cached items are kept up to date by triggers, in the same
+// transaction as the change to the items. Replacing an item only fires the
+// delete trigger with recursive triggers on.
+const std::string CREATE_METADATA_TABLE_SQL =
+    "CREATE TABLE IF NOT EXISTS " + METADATA_TABLE + "(" +
+    METADATA_TABLE_KEY_COLUMN + " TEXT PRIMARY KEY NOT NULL," +
+    METADATA_TABLE_VALUE_COLUMN + " INTEGER NOT NULL)";
+
+const std::string RESPONSE_DATA_SIZE_SQL =
+    "IFNULL(length(" + CACHE_TABLE_RESPONSE_DATA_COLUMN + "), 0)";
+
+// Computes the totals of a cache from before they were tracked. The existing
+// totals are kept.
+const std::string INITIALIZE_METADATA_SQL =
+    "INSERT OR IGNORE INTO " + METADATA_TABLE + " SELECT '" +
+    METADATA_TOTAL_ITEMS_KEY + "', COUNT(*) FROM " + CACHE_TABLE +
+    " UNION ALL SELECT '" + METADATA_TOTAL_BYTES_KEY + "', IFNULL(SUM(" +
+    RESPONSE_DATA_SIZE_SQL + "), 0) FROM " + CACHE_TABLE;
+
+const std::string CREATE_INSERT_TRIGGER_SQL =
+    "CREATE TRIGGER IF NOT EXISTS CacheItemInsertTrigger AFTER INSERT ON " +
+    CACHE_TABLE + " BEGIN UPDATE " + METADATA_TABLE + " SET " +
+    METADATA_TABLE_VALUE_COLUMN + " = " + METADATA_TABLE_VALUE_COLUMN +
+    " + 1 WHERE " + METADATA_TABLE_KEY_COLUMN + " = '" +
+    METADATA_TOTAL_ITEMS_KEY + "'; UPDATE " + METADATA_TABLE + " SET " +
+    METADATA_TABLE_VALUE_COLUMN + " = " + METADATA_TABLE_VALUE_COLUMN +
+    " + IFNULL(length(NEW." + CACHE_TABLE_RESPONSE_DATA_COLUMN +
+    "), 0) WHERE " + METADATA_TABLE_KEY_COLUMN + " = '" +
+    METADATA_TOTAL_BYTES_KEY + "'; END";
+
+const std::string CREATE_DELETE_TRIGGER_SQL =
+    "CREATE TRIGGER IF NOT EXISTS CacheItemDeleteTrigger AFTER DELETE ON " +
+    CACHE_TABLE + " BEGIN UPDATE " + METADATA_TABLE + " SET " +
+    METADATA_TABLE_VALUE_COLUMN + " = " + METADATA_TABLE_VALUE_COLUMN +
+    " - 1 WHERE " + METADATA_TABLE_KEY_COLUMN + " = '" +
+    METADATA_TOTAL_ITEMS_KEY + "'; UPDATE " + METADATA_TABLE + " SET " +
+    METADATA_TABLE_VALUE_COLUMN + " = " + METADATA_TABLE_VALUE_COLUMN +
+    " - IFNULL(length(OLD." + CACHE_TABLE_RESPONSE_DATA_COLUMN +
+    "), 0) WHERE " + METADATA_TABLE_KEY_COLUMN + " = '" +
+    METADATA_TOTAL_BYTES_KEY + "'; END";
+
+// Indices that let pruning find the expired and least recently used items
+// without scanning the whole table.
+const std::string CREATE_LAST_ACCESSED_TIME_INDEX_SQL =
+    "CREATE INDEX IF NOT EXISTS CacheItemLastAccessedTimeIndex ON " +
+    CACHE_TABLE + "(" + CACHE_TABLE_LAST_ACCESSED_TIME_COLUMN + ")";
+
+const std::string CREATE_EXPIRY_TIME_INDEX_SQL =
+    "CREATE INDEX IF NOT EXISTS CacheItemExpiryTimeIndex ON " + CACHE_TABLE +
+    "(" + CACHE_TABLE_EXPIRY_TIME_COLUMN + ")";
+
+const std::string PRAGMA_RECURSIVE_TRIGGERS_SQL =
+    "PRAGMA recursive_triggers=ON";
+
 const std::string PRAGMA_WAL_SQL = "PRAGMA journal_mode=WAL";
 
 const std::string PRAGMA_SYNC_SQL = "PRAGMA synchronous=OFF";
@@ -61,7 +129,7 @@ const std::string GET_ENTRY_SQL =
 
 const std::string UPDATE_LAST_ACCESSED_TIME_SQL =
     "UPDATE " + CACHE_TABLE + " SET " + CACHE_TABLE_LAST_ACCESSED_TIME_COLUMN +
-    " = strftime('%s','now') WHERE " + CACHE_TABLE_KEY_COLUMN + " =?";
+    " = ? WHERE rowid =?";
 
 // Sql commands for storing response
 const std::string STORE_RESPONSE_SQL =
@@ -74,10 +142,17 @@ const std::string STORE_RESPONSE_SQL =
     CACHE_TABLE_REQUEST_METHOD_COLUMN + ", " + CACHE_TABLE_REQUEST_URL_COLUMN +
     ", " + CACHE_TABLE_KEY_COLUMN + ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)";
 
+// Sql commands for writing queued entries in one transaction
+const std::string BEGIN_TRANSACTION_SQL = "BEGIN TRANSACTION";
+
+const std::string COMMIT_TRANSACTION_SQL = "COMMIT TRANSACTION";
+
+const std::string ROLLBACK_TRANSACTION_SQL = "ROLLBACK TRANSACTION";
+
 // Sql commands for prunning the database
-const std::string TOTAL_ITEMS_QUERY_SQL =
-    "SELECT COUNT(*) " + CACHE_TABLE_VIRTUAL_TOTAL_ITEMS_COLUMN + " FROM " +
-    CACHE_TABLE;
+const std::string TOTALS_QUERY_SQL =
+    "SELECT " + METADATA_TABLE_KEY_COLUMN + ", " + METADATA_TABLE_VALUE_COLUMN +
+    " FROM " + METADATA_TABLE;
 
 const std::string DELETE_EXPIRED_ITEMS_SQL =
     "DELETE FROM " + CACHE_TABLE + " WHERE " + CACHE_TABLE_EXPIRY_TIME_COLUMN +
@@ -140,6 +215,10 @@ using SqliteConnectionPtr =
 using SqliteStatementPtr =
     std::unique_ptr<CESIUM_SQLITE(sqlite3_stmt), DeleteSqliteStatement>;
 
+// How long a connection waits for another connection to release a lock on
+// the database.
+const int BUSY_TIMEOUT_MILLISECONDS = 5000;
+
 SqliteStatementPtr prepareStatement(
     const SqliteConnectionPtr& pConnection,
     const std::string& sql) {
@@ -157,41 +236,378 @@ SqliteStatementPtr prepareStatement(
   return SqliteStatementPtr(pStmt);
 }
 
+void executeSql(
+    const SqliteConnectionPtr& pConnection,
+    const std::string& sql) {
+  char* pError = nullptr;
+  const int status = CESIUM_SQLITE(sqlite3_exec)(
+      pConnection.get(),
+      sql.c_str(),
+      nullptr,
+      nullptr,
+      &pError);
+  if (status != SQLITE_OK) {
+    std::string errorStr(
+        pError ? pError : CESIUM_SQLITE(sqlite3_errstr)(status));
+    CESIUM_SQLITE(sqlite3_free)(pError);
+    throw std::runtime_error(errorStr);
+  }
+}
+
+bool isInMemoryDatabase(const std::string& databaseName) {
+  // Every connection to these opens a separate database.
+  return databaseName.empty() || databaseName == ":memory:" ||
+         databaseName.find("mode=memory") != std::string::npos;
+}
+
 } // namespace
 
 namespace CesiumAsync {
 
 struct SqliteCache::Impl {
-  Impl(const std::shared_ptr<spdlog::logger>& pLogger, uint64_t maxItems)
+  // A connection that only looks up entries. Each one is used by one thread
+  // at a time.
+  struct ReadConnection {
+    SqliteConnectionPtr pConnection;
+    SqliteStatementPtr pGetEntryStatement;
+  };
+
+  // Takes a read connection from the pool, waiting until one is available,
+  // and returns it when destroyed.
+  class ReadConnectionLease {
+  public:
+    ReadConnectionLease(const Impl& impl) : _impl(impl), _pReadConnection() {
+      std::unique_lock<std::mutex> lock(this->_impl._readMutex);
+      this->_impl._readConnectionReleased.wait(lock, [this]() {
+        return !this->_impl._availableReadConnections.empty();
+      });
+      this->_pReadConnection = this->_impl._availableReadConnections.back();
+      this->_impl._availableReadConnections.pop_back();
+    }
+
+    ~ReadConnectionLease() noexcept {
+      {
+        std::lock_guard<std::mutex> lock(this->_impl._readMutex);
+        this->_impl._availableReadConnections.push_back(
+            this->_pReadConnection);
+      }
+      this->_impl._readConnectionReleased.notify_one();
+    }
+
+    ReadConnectionLease(const ReadConnectionLease&) = delete;
+    ReadConnectionLease& operator=(const ReadConnectionLease&) = delete;
+
+    ReadConnection& operator*() const noexcept {
+      return *this->_pReadConnection;
+    }
+
+  private:
+    const Impl& _impl;
+    ReadConnection* _pReadConnection;
+  };
+
+  Impl(
+      const std::shared_ptr<spdlog::logger>& pLogger,
+      uint64_t maxItems,
+      uint64_t maxBytes,
+      const SqliteCacheWriteBehindOptions& writeBehindOptions)
       : _pLogger(pLogger),
         _pConnection(nullptr),
         _maxItems(maxItems),
+        _maxBytes(maxBytes),
         _getEntryStmtWrapper(),
         _updateLastAccessedTimeStmtWrapper(),
         _storeResponseStmtWrapper(),
-        _totalItemsQueryStmtWrapper(),
+        _totalsQueryStmtWrapper(),
         _deleteExpiredStmtWrapper(),
         _deleteLRUStmtWrapper(),
-        _clearAllStmtWrapper() {}
+        _clearAllStmtWrapper(),
+        _readConnections(),
+        _availableReadConnections(),
+        _accessedRows(),
+        _writeBehindOptions(writeBehindOptions),
+        _pendingEntries(),
+        _flushingEntries(),
+        _stopFlushThread(false),
+        _flushThread() {
+    this->_writeBehindOptions.maximumPendingEntries =
+        std::max(this->_writeBehindOptions.maximumPendingEntries, size_t(1));
+  }
+
+  /**
+   * @brief Looks up an entry with the given statement, which must have been
+   * prepared from GET_ENTRY_SQL.
+   */
+  std::optional<CacheItem> getEntry(
+      CESIUM_SQLITE(sqlite3_stmt*) pGetEntryStatement,
+      const std::string& key) const;
+
+  /**
+   * @brief Returns a copy of the queued entry with the given key, if any.
+   */
+  std::optional<CacheItem> getPendingEntry(const std::string& key) const;
+
+  /**
+   * @brief Writes an entry with the write connection. The write mutex must be
+   * locked.
+   */
+  bool writeEntry(
+      const std::string& key,
+      std::time_t expiryTime,
+      const std::string& url,
+      const std::string& requestMethod,
+      const HttpHeaders& requestHeaders,
+      uint16_t statusCode,
+      const HttpHeaders& responseHeaders,
+      const gsl::span<const std::byte>& responseData);
+
+  /**
+   * @brief Writes the last accessed times of the entries that were looked up
+   * since the last call. The write mutex must be locked.
+   */
+  void updateLastAccessedTimes();
+
+  /**
+   * @brief Reads the total number of items and bytes in the cache, which are
+   * kept up to date by triggers. The write mutex must be locked.
+   */
+  bool queryTotals(int64_t& totalItems, int64_t& totalBytes);
+
+  /**
+   * @brief Writes all queued entries in one transaction.
+   */
+  void flushPendingEntries();
+
+  /**
+   * @brief Flushes the queued entries whenever enough of them are queued or
+   * the flush interval passed, until the cache is destroyed.
+   */
+  void runFlushThread();
+
+  bool executeSql(const std::string& sql);
 
   std::shared_ptr<spdlog::logger> _pLogger;
+
+  // The connection that writes to the database. Entries are also looked up
+  // with it if there are no read connections.
   SqliteConnectionPtr _pConnection;
   uint64_t _maxItems;
+  uint64_t _maxBytes;
   mutable std::mutex _mutex;
   SqliteStatementPtr _getEntryStmtWrapper;
   SqliteStatementPtr _updateLastAccessedTimeStmtWrapper;
   SqliteStatementPtr _storeResponseStmtWrapper;
-  SqliteStatementPtr _totalItemsQueryStmtWrapper;
+  SqliteStatementPtr _totalsQueryStmtWrapper;
   SqliteStatementPtr _deleteExpiredStmtWrapper;
   SqliteStatementPtr _deleteLRUStmtWrapper;
   SqliteStatementPtr _clearAllStmtWrapper;
+
+  // With WAL journaling, the read connections look up entries concurrently
+  // with each other and with the write connection.
+  std::vector<std::unique_ptr<ReadConnection>> _readConnections;
+  mutable std::vector<ReadConnection*> _availableReadConnections;
+  mutable std::mutex _readMutex;
+  mutable std::condition_variable _readConnectionReleased;
+
+  // The rowids and times of the entries that were looked up. Lookups do not
+  // write to the database, so the times are written before the next store or
+  // prune.
+  mutable std::mutex _accessedRowsMutex;
+  mutable std::vector<std::pair<int64_t, std::time_t>> _accessedRows;
+
+  // The entries that are queued for writing, and the ones being written.
+  // Both are guarded by _pendingMutex, and _flushMutex is held while writing.
+  SqliteCacheWriteBehindOptions _writeBehindOptions;
+  mutable std::mutex _pendingMutex;
+  std::mutex _flushMutex;
+  std::condition_variable _flushRequested;
+  std::condition_variable _pendingSpaceAvailable;
+  std::unordered_map<std::string, CacheItem> _pendingEntries;
+  std::unordered_map<std::string, CacheItem> _flushingEntries;
+  bool _stopFlushThread;
+  std::thread _flushThread;
 };
 
+std::optional<CacheItem>
+SqliteCache::Impl::getPendingEntry(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(this->_pendingMutex);
+
+  // The queued entries are newer than the ones being written.
+  auto it = this->_pendingEntries.find(key);
+  if (it != this->_pendingEntries.end()) {
+    return it->second;
+  }
+
+  it = this->_flushingEntries.find(key);
+  if (it != this->_flushingEntries.end()) {
+    return it->second;
+  }
+
+  return std::nullopt;
+}
+
+bool SqliteCache::Impl::executeSql(const std::string& sql) {
+  char* pError = nullptr;
+  const int status = CESIUM_SQLITE(sqlite3_exec)(
+      this->_pConnection.get(),
+      sql.c_str(),
+      nullptr,
+      nullptr,
+      &pError);
+  if (status != SQLITE_OK) {
+    SPDLOG_LOGGER_ERROR(
+        this->_pLogger,
+        pError ? pError : CESIUM_SQLITE(sqlite3_errstr)(status));
+    CESIUM_SQLITE(sqlite3_free)(pError);
+    return false;
+  }
+
+  return true;
+}
+
+bool SqliteCache::Impl::queryTotals(
+    int64_t& totalItems,
+    int64_t& totalBytes) {
+  CESIUM_SQLITE(sqlite3_stmt*) pStatement = this->_totalsQueryStmtWrapper.get();
+
+  int status = CESIUM_SQLITE(sqlite3_reset)(pStatement);
+  while (status == SQLITE_OK || status == SQLITE_ROW) {
+    status = CESIUM_SQLITE(sqlite3_step)(pStatement);
+    if (status != SQLITE_ROW) {
+      break;
+    }
+
+    const std::string key = reinterpret_cast<const char*>(
+        CESIUM_SQLITE(sqlite3_column_text)(pStatement, 0));
+    const int64_t value = CESIUM_SQLITE(sqlite3_column_int64)(pStatement, 1);
+    if (key == METADATA_TOTAL_ITEMS_KEY) {
+      totalItems = value;
+    } else if (key == METADATA_TOTAL_BYTES_KEY) {
+      totalBytes = value;
+    }
+  }
+
+  CESIUM_SQLITE(sqlite3_reset)(pStatement);
+
+  if (status != SQLITE_DONE) {
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
+    return false;
+  }
+
+  return true;
+}
+
+void SqliteCache::Impl::flushPendingEntries() {
+  CESIUM_TRACE("SqliteCache::flush");
+  std::lock_guard<std::mutex> flushLock(this->_flushMutex);
+
+  {
+    std::lock_guard<std::mutex> lock(this->_pendingMutex);
+    if (this->_pendingEntries.empty()) {
+      return;
+    }
+
+    // The entries stay visible to lookups until they are written.
+    this->_flushingEntries.swap(this->_pendingEntries);
+  }
+  this->_pendingSpaceAvailable.notify_all();
+
+  {
+    std::lock_guard<std::mutex> guard(this->_mutex);
+
+    const bool inTransaction = this->executeSql(BEGIN_TRANSACTION_SQL);
+
+    this->updateLastAccessedTimes();
+
+    for (const auto& [key, cacheItem] : this->_flushingEntries) {
+      const CacheRequest& request = cacheItem.cacheRequest;
+      const CacheResponse& response = cacheItem.cacheResponse;
+      this->writeEntry(
+          key,
+          cacheItem.expiryTime,
+          request.url,
+          request.method,
+          request.headers,
+          response.statusCode,
+          response.headers,
+          gsl::span<const std::byte>(response.data));
+    }
+
+    if (inTransaction && !this->executeSql(COMMIT_TRANSACTION_SQL)) {
+      this->executeSql(ROLLBACK_TRANSACTION_SQL);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(this->_pendingMutex);
+  this->_flushingEntries.clear();
+}
+
+void SqliteCache::Impl::runFlushThread() {
+  const std::chrono::milliseconds flushInterval(
+      this->_writeBehindOptions.flushIntervalMilliseconds);
+
+  std::unique_lock<std::mutex> lock(this->_pendingMutex);
+  while (!this->_stopFlushThread) {
+    this->_flushRequested.wait_for(lock, flushInterval, [this]() {
+      return this->_stopFlushThread ||
+             this->_pendingEntries.size() >=
+                 this->_writeBehindOptions.entriesPerTransaction;
+    });
+
+    if (this->_pendingEntries.empty()) {
+      continue;
+    }
+
+    lock.unlock();
+    this->flushPendingEntries();
+    lock.lock();
+  }
+}
+
+void SqliteCache::Impl::updateLastAccessedTimes() {
+  std::vector<std::pair<int64_t, std::time_t>> accessedRows;
+  {
+    std::lock_guard<std::mutex> lock(this->_accessedRowsMutex);
+    accessedRows.swap(this->_accessedRows);
+  }
+
+  CESIUM_SQLITE(sqlite3_stmt*)
+  pStatement = this->_updateLastAccessedTimeStmtWrapper.get();
+  for (const auto& [rowid, accessedTime] : accessedRows) {
+    int status = CESIUM_SQLITE(sqlite3_reset)(pStatement);
+    if (status == SQLITE_OK) {
+      status = CESIUM_SQLITE(sqlite3_bind_int64)(
+          pStatement,
+          1,
+          static_cast<int64_t>(accessedTime));
+    }
+    if (status == SQLITE_OK) {
+      status = CESIUM_SQLITE(sqlite3_bind_int64)(pStatement, 2, rowid);
+    }
+    if (status == SQLITE_OK) {
+      status = CESIUM_SQLITE(sqlite3_step)(pStatement);
+    }
+    if (status != SQLITE_DONE) {
+      SPDLOG_LOGGER_ERROR(
+          this->_pLogger,
+          CESIUM_SQLITE(sqlite3_errstr)(status));
+      return;
+    }
+  }
+}
+
 SqliteCache::SqliteCache(
     const std::shared_ptr<spdlog::logger>& pLogger,
     const std::string& databaseName,
-    uint64_t maxItems)
-    : _pImpl(std::make_unique<Impl>(pLogger, maxItems)) {
+    uint64_t maxItems,
+    uint64_t maxBytes,
+    uint32_t numberOfReadConnections,
+    const SqliteCacheWriteBehindOptions& writeBehindOptions)
+    : _pImpl(std::make_unique<Impl>(
+          pLogger,
+          maxItems,
+          maxBytes,
+          writeBehindOptions)) {
   CESIUM_SQLITE(sqlite3*) pConnection;
   int status = CESIUM_SQLITE(sqlite3_open)(databaseName.c_str(), &pConnection);
   if (status != SQLITE_OK) {
@@ -202,6 +618,9 @@ SqliteCache::SqliteCache(
       std::unique_ptr<CESIUM_SQLITE(sqlite3), DeleteSqliteConnection>(
           pConnection);
 
+  CESIUM_SQLITE(sqlite3_busy_timeout)
+  (this->_pImpl->_pConnection.get(), BUSY_TIMEOUT_MILLISECONDS);
+
   // create cache tables if not exist. Key -> Cache table: one-to-many
   // relationship
   char* createTableError = nullptr;
@@ -259,6 +678,15 @@ SqliteCache::SqliteCache(
     throw std::runtime_error(errorStr);
   }
 
+  // keep track of the total items and bytes
+  executeSql(this->_pImpl->_pConnection, PRAGMA_RECURSIVE_TRIGGERS_SQL);
+  executeSql(this->_pImpl->_pConnection, CREATE_METADATA_TABLE_SQL);
+  executeSql(this->_pImpl->_pConnection, INITIALIZE_METADATA_SQL);
+  executeSql(this->_pImpl->_pConnection, CREATE_INSERT_TRIGGER_SQL);
+  executeSql(this->_pImpl->_pConnection, CREATE_DELETE_TRIGGER_SQL);
+  executeSql(this->_pImpl->_pConnection, CREATE_LAST_ACCESSED_TIME_INDEX_SQL);
+  executeSql(this->_pImpl->_pConnection, CREATE_EXPIRY_TIME_INDEX_SQL);
+
   // get entry based on key
   this->_pImpl->_getEntryStmtWrapper =
       prepareStatement(this->_pImpl->_pConnection, GET_ENTRY_SQL);
@@ -272,9 +700,9 @@ SqliteCache::SqliteCache(
   this->_pImpl->_storeResponseStmtWrapper =
       prepareStatement(this->_pImpl->_pConnection, STORE_RESPONSE_SQL);
 
-  // query total items
-  this->_pImpl->_totalItemsQueryStmtWrapper =
-      prepareStatement(this->_pImpl->_pConnection, TOTAL_ITEMS_QUERY_SQL);
+  // query the total items and bytes
+  this->_pImpl->_totalsQueryStmtWrapper =
+      prepareStatement(this->_pImpl->_pConnection, TOTALS_QUERY_SQL);
 
   // delete expired items
   this->_pImpl->_deleteExpiredStmtWrapper =
@@ -287,48 +715,123 @@ SqliteCache::SqliteCache(
   // clear all items
   this->_pImpl->_clearAllStmtWrapper =
       prepareStatement(this->_pImpl->_pConnection, CLEAR_ALL_SQL);
+
+  // open the read connections, now that the table exists and the database is
+  // in WAL mode
+  if (isInMemoryDatabase(databaseName)) {
+    numberOfReadConnections = 0;
+  }
+
+  for (uint32_t i = 0; i < numberOfReadConnections; ++i) {
+    CESIUM_SQLITE(sqlite3*) pReadConnection;
+    status = CESIUM_SQLITE(sqlite3_open_v2)(
+        databaseName.c_str(),
+        &pReadConnection,
+        SQLITE_OPEN_READONLY,
+        nullptr);
+    SqliteConnectionPtr pReadConnectionWrapper(pReadConnection);
+    if (status != SQLITE_OK) {
+      throw std::runtime_error(CESIUM_SQLITE(sqlite3_errstr)(status));
+    }
+
+    CESIUM_SQLITE(sqlite3_busy_timeout)
+    (pReadConnectionWrapper.get(), BUSY_TIMEOUT_MILLISECONDS);
+
+    SqliteStatementPtr pGetEntryStatement =
+        prepareStatement(pReadConnectionWrapper, GET_ENTRY_SQL);
+
+    this->_pImpl->_readConnections.emplace_back(
+        std::make_unique<Impl::ReadConnection>(Impl::ReadConnection{
+            std::move(pReadConnectionWrapper),
+            std::move(pGetEntryStatement)}));
+    this->_pImpl->_availableReadConnections.push_back(
+        this->_pImpl->_readConnections.back().get());
+  }
+
+  if (writeBehindOptions.enabled) {
+    Impl* pImpl = this->_pImpl.get();
+    pImpl->_flushThread = std::thread([pImpl]() { pImpl->runFlushThread(); });
+  }
 }
 
-SqliteCache::~SqliteCache() = default;
+SqliteCache::~SqliteCache() {
+  if (this->_pImpl->_flushThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(this->_pImpl->_pendingMutex);
+      this->_pImpl->_stopFlushThread = true;
+    }
+    this->_pImpl->_flushRequested.notify_one();
+    this->_pImpl->_flushThread.join();
+  }
+
+  // Write the entries that are still queued.
+  this->_pImpl->flushPendingEntries();
+
+  std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
+  this->_pImpl->updateLastAccessedTimes();
+}
+
+void SqliteCache::flush() { this->_pImpl->flushPendingEntries(); }
 
 std::optional<CacheItem> SqliteCache::getEntry(const std::string& key) const {
   CESIUM_TRACE("SqliteCache::getEntry");
-  std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
 
+  if (this->_pImpl->_writeBehindOptions.enabled) {
+    std::optional<CacheItem> pendingEntry = this->_pImpl->getPendingEntry(key);
+    if (pendingEntry) {
+      return pendingEntry;
+    }
+  }
+
+  std::optional<CacheItem> result;
+  if (this->_pImpl->_readConnections.empty()) {
+    std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
+    result =
+        this->_pImpl->getEntry(this->_pImpl->_getEntryStmtWrapper.get(), key);
+  } else {
+    Impl::ReadConnectionLease readConnection(*this->_pImpl);
+    result = this->_pImpl->getEntry(
+        (*readConnection).pGetEntryStatement.get(),
+        key);
+  }
+
+  return result;
+}
+
+std::optional<CacheItem> SqliteCache::Impl::getEntry(
+    CESIUM_SQLITE(sqlite3_stmt*) pGetEntryStatement,
+    const std::string& key) const {
   // get entry based on key
-  int status =
-      CESIUM_SQLITE(sqlite3_reset)(this->_pImpl->_getEntryStmtWrapper.get());
+  int status = CESIUM_SQLITE(sqlite3_reset)(pGetEntryStatement);
   if (status != SQLITE_OK) {
     SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
+        this->_pLogger,
         CESIUM_SQLITE(sqlite3_errstr)(status));
     return std::nullopt;
   }
 
-  status = CESIUM_SQLITE(sqlite3_clear_bindings)(
-      this->_pImpl->_getEntryStmtWrapper.get());
+  status = CESIUM_SQLITE(sqlite3_clear_bindings)(pGetEntryStatement);
   if (status != SQLITE_OK) {
     SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
+        this->_pLogger,
         CESIUM_SQLITE(sqlite3_errstr)(status));
     return std::nullopt;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_getEntryStmtWrapper.get(),
+      pGetEntryStatement,
       1,
       key.c_str(),
       -1,
       SQLITE_STATIC);
   if (status != SQLITE_OK) {
     SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
+        this->_pLogger,
         CESIUM_SQLITE(sqlite3_errstr)(status));
     return std::nullopt;
   }
 
-  status =
-      CESIUM_SQLITE(sqlite3_step)(this->_pImpl->_getEntryStmtWrapper.get());
+  status = CESIUM_SQLITE(sqlite3_step)(pGetEntryStatement);
   if (status == SQLITE_DONE) {
     // Cache miss
     return std::nullopt;
@@ -337,87 +840,54 @@ std::optional<CacheItem> SqliteCache::getEntry(const std::string& key) const {
   if (status != SQLITE_ROW) {
     // Something went wrong.
     SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
+        this->_pLogger,
         CESIUM_SQLITE(sqlite3_errstr)(status));
     return std::nullopt;
   }
 
   // Cache hit - unpack and return it.
-  const int64_t itemIndex = CESIUM_SQLITE(
-      sqlite3_column_int64)(this->_pImpl->_getEntryStmtWrapper.get(), 0);
+  const int64_t itemIndex =
+      CESIUM_SQLITE(sqlite3_column_int64)(pGetEntryStatement, 0);
 
   // parse cache item metadata
-  const std::time_t expiryTime = CESIUM_SQLITE(
-      sqlite3_column_int64)(this->_pImpl->_getEntryStmtWrapper.get(), 1);
+  const std::time_t expiryTime =
+      CESIUM_SQLITE(sqlite3_column_int64)(pGetEntryStatement, 1);
 
   // parse response cache
-  std::string serializedResponseHeaders =
-      reinterpret_cast<const char*>(CESIUM_SQLITE(
-          sqlite3_column_text)(this->_pImpl->_getEntryStmtWrapper.get(), 2));
+  std::string serializedResponseHeaders = reinterpret_cast<const char*>(
+      CESIUM_SQLITE(sqlite3_column_text)(pGetEntryStatement, 2));
   HttpHeaders responseHeaders =
       convertStringToHeaders(serializedResponseHeaders);
 
-  const uint16_t statusCode = static_cast<uint16_t>(CESIUM_SQLITE(
-      sqlite3_column_int)(this->_pImpl->_getEntryStmtWrapper.get(), 3));
+  const uint16_t statusCode = static_cast<uint16_t>(
+      CESIUM_SQLITE(sqlite3_column_int)(pGetEntryStatement, 3));
 
-  const std::byte* rawResponseData =
-      reinterpret_cast<const std::byte*>(CESIUM_SQLITE(
-          sqlite3_column_blob)(this->_pImpl->_getEntryStmtWrapper.get(), 4));
-  const int responseDataSize = CESIUM_SQLITE(
-      sqlite3_column_bytes)(this->_pImpl->_getEntryStmtWrapper.get(), 4);
+  const std::byte* rawResponseData = reinterpret_cast<const std::byte*>(
+      CESIUM_SQLITE(sqlite3_column_blob)(pGetEntryStatement, 4));
+  const int responseDataSize =
+      CESIUM_SQLITE(sqlite3_column_bytes)(pGetEntryStatement, 4);
   std::vector<std::byte> responseData(
       rawResponseData,
       rawResponseData + responseDataSize);
 
   // parse request
-  std::string serializedRequestHeaders =
-      reinterpret_cast<const char*>(CESIUM_SQLITE(
-          sqlite3_column_text)(this->_pImpl->_getEntryStmtWrapper.get(), 5));
+  std::string serializedRequestHeaders = reinterpret_cast<const char*>(
+      CESIUM_SQLITE(sqlite3_column_text)(pGetEntryStatement, 5));
   HttpHeaders requestHeaders = convertStringToHeaders(serializedRequestHeaders);
 
-  std::string requestMethod = reinterpret_cast<const char*>(CESIUM_SQLITE(
-      sqlite3_column_text)(this->_pImpl->_getEntryStmtWrapper.get(), 6));
+  std::string requestMethod = reinterpret_cast<const char*>(
+      CESIUM_SQLITE(sqlite3_column_text)(pGetEntryStatement, 6));
 
-  std::string requestUrl = reinterpret_cast<const char*>(CESIUM_SQLITE(
-      sqlite3_column_text)(this->_pImpl->_getEntryStmtWrapper.get(), 7));
+  std::string requestUrl = reinterpret_cast<const char*>(
+      CESIUM_SQLITE(sqlite3_column_text)(pGetEntryStatement, 7));
 
-  // update the last accessed time
-  int updateStatus = CESIUM_SQLITE(sqlite3_reset)(
-      this->_pImpl->_updateLastAccessedTimeStmtWrapper.get());
-  if (updateStatus != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(updateStatus));
-    return std::nullopt;
-  }
+  // End the read transaction, so that it does not keep the WAL from being
+  // checkpointed.
+  CESIUM_SQLITE(sqlite3_reset)(pGetEntryStatement);
 
-  updateStatus = CESIUM_SQLITE(sqlite3_clear_bindings)(
-      this->_pImpl->_updateLastAccessedTimeStmtWrapper.get());
-  if (updateStatus != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(updateStatus));
-    return std::nullopt;
-  }
-
-  updateStatus = CESIUM_SQLITE(sqlite3_bind_int64)(
-      this->_pImpl->_updateLastAccessedTimeStmtWrapper.get(),
-      1,
-      itemIndex);
-  if (updateStatus != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(updateStatus));
-    return std::nullopt;
-  }
-
-  updateStatus = CESIUM_SQLITE(sqlite3_step)(
-      this->_pImpl->_updateLastAccessedTimeStmtWrapper.get());
-  if (updateStatus != SQLITE_DONE) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(updateStatus));
-    return std::nullopt;
+  {
+    std::lock_guard<std::mutex> lock(this->_accessedRowsMutex);
+    this->_accessedRows.emplace_back(itemIndex, std::time(nullptr));
   }
 
   return CacheItem{
@@ -442,146 +912,182 @@ bool SqliteCache::storeEntry(
     const HttpHeaders& responseHeaders,
     const gsl::span<const std::byte>& responseData) {
   CESIUM_TRACE("SqliteCache::storeEntry");
-  std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
 
+  if (!this->_pImpl->_writeBehindOptions.enabled) {
+    std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
+
+    this->_pImpl->updateLastAccessedTimes();
+
+    return this->_pImpl->writeEntry(
+        key,
+        expiryTime,
+        url,
+        requestMethod,
+        requestHeaders,
+        statusCode,
+        responseHeaders,
+        responseData);
+  }
+
+  const SqliteCacheWriteBehindOptions& options =
+      this->_pImpl->_writeBehindOptions;
+  CacheItem cacheItem(
+      expiryTime,
+      CacheRequest(
+          HttpHeaders(requestHeaders),
+          std::string(requestMethod),
+          std::string(url)),
+      CacheResponse(
+          statusCode,
+          HttpHeaders(responseHeaders),
+          std::vector<std::byte>(responseData.begin(), responseData.end())));
+
+  bool shouldFlush = false;
+  {
+    std::unique_lock<std::mutex> lock(this->_pImpl->_pendingMutex);
+    this->_pImpl->_pendingSpaceAvailable.wait(lock, [this, &key, &options]() {
+      return this->_pImpl->_pendingEntries.size() <
+                 options.maximumPendingEntries ||
+             this->_pImpl->_pendingEntries.find(key) !=
+                 this->_pImpl->_pendingEntries.end();
+    });
+
+    this->_pImpl->_pendingEntries.insert_or_assign(key, std::move(cacheItem));
+
+    const size_t pendingEntries = this->_pImpl->_pendingEntries.size();
+    shouldFlush = pendingEntries >= options.entriesPerTransaction ||
+                  pendingEntries >= options.maximumPendingEntries;
+  }
+
+  if (shouldFlush) {
+    this->_pImpl->_flushRequested.notify_one();
+  }
+
+  return true;
+}
+
+bool SqliteCache::Impl::writeEntry(
+    const std::string& key,
+    std::time_t expiryTime,
+    const std::string& url,
+    const std::string& requestMethod,
+    const HttpHeaders& requestHeaders,
+    uint16_t statusCode,
+    const HttpHeaders& responseHeaders,
+    const gsl::span<const std::byte>& responseData) {
   // cache the request with the key
-  int status = CESIUM_SQLITE(sqlite3_reset)(
-      this->_pImpl->_storeResponseStmtWrapper.get());
+  int status =
+      CESIUM_SQLITE(sqlite3_reset)(this->_storeResponseStmtWrapper.get());
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_clear_bindings)(
-      this->_pImpl->_storeResponseStmtWrapper.get());
+      this->_storeResponseStmtWrapper.get());
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_int64)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       1,
       static_cast<int64_t>(expiryTime));
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_int64)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       2,
       static_cast<int64_t>(std::time(nullptr)));
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   std::string responseHeaderString = convertHeadersToString(responseHeaders);
   status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       3,
       responseHeaderString.c_str(),
       -1,
       SQLITE_STATIC);
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_int)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       4,
       static_cast<int>(statusCode));
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_blob)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       5,
       responseData.data(),
       static_cast<int>(responseData.size()),
       SQLITE_STATIC);
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   std::string requestHeaderString = convertHeadersToString(requestHeaders);
   status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       6,
       requestHeaderString.c_str(),
       -1,
       SQLITE_STATIC);
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       7,
       requestMethod.c_str(),
       -1,
       SQLITE_STATIC);
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       8,
       url.c_str(),
       -1,
       SQLITE_STATIC);
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
   status = CESIUM_SQLITE(sqlite3_bind_text)(
-      this->_pImpl->_storeResponseStmtWrapper.get(),
+      this->_storeResponseStmtWrapper.get(),
       9,
       key.c_str(),
       -1,
       SQLITE_STATIC);
   if (status != SQLITE_OK) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
-  status = CESIUM_SQLITE(sqlite3_step)(
-      this->_pImpl->_storeResponseStmtWrapper.get());
+  status = CESIUM_SQLITE(sqlite3_step)(this->_storeResponseStmtWrapper.get());
   if (status != SQLITE_DONE) {
-    SPDLOG_LOGGER_ERROR(
-        this->_pImpl->_pLogger,
-        CESIUM_SQLITE(sqlite3_errstr)(status));
+    SPDLOG_LOGGER_ERROR(this->_pLogger, CESIUM_SQLITE(sqlite3_errstr)(status));
     return false;
   }
 
@@ -590,52 +1096,30 @@ bool SqliteCache::storeEntry(
 
 bool SqliteCache::prune() {
   CESIUM_TRACE("SqliteCache::prune");
-  std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
 
-  int64_t totalItems = 0;
+  // Prune the queued entries, too.
+  this->_pImpl->flushPendingEntries();
 
-  // query total size of response's data
-  {
-    int totalItemsQueryStatus = CESIUM_SQLITE(sqlite3_reset)(
-        this->_pImpl->_totalItemsQueryStmtWrapper.get());
-    if (totalItemsQueryStatus != SQLITE_OK) {
-      SPDLOG_LOGGER_ERROR(
-          this->_pImpl->_pLogger,
-          CESIUM_SQLITE(sqlite3_errstr)(totalItemsQueryStatus));
-      return false;
-    }
-
-    totalItemsQueryStatus = CESIUM_SQLITE(sqlite3_clear_bindings)(
-        this->_pImpl->_totalItemsQueryStmtWrapper.get());
-    if (totalItemsQueryStatus != SQLITE_OK) {
-      SPDLOG_LOGGER_ERROR(
-          this->_pImpl->_pLogger,
-          CESIUM_SQLITE(sqlite3_errstr)(totalItemsQueryStatus));
-      return false;
-    }
-
-    totalItemsQueryStatus = CESIUM_SQLITE(sqlite3_step)(
-        this->_pImpl->_totalItemsQueryStmtWrapper.get());
+  std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
 
-    if (totalItemsQueryStatus == SQLITE_DONE) {
-      return true;
-    }
+  this->_pImpl->updateLastAccessedTimes();
 
-    if (totalItemsQueryStatus != SQLITE_ROW) {
-      SPDLOG_LOGGER_ERROR(
-          this->_pImpl->_pLogger,
-          CESIUM_SQLITE(sqlite3_errstr)(totalItemsQueryStatus));
-      return false;
-    }
+  const int64_t maxItems = static_cast<int64_t>(this->_pImpl->_maxItems);
+  const int64_t maxBytes = static_cast<int64_t>(this->_pImpl->_maxBytes);
+  int64_t totalItems = 0;
+  int64_t totalBytes = 0;
+  const auto isOverQuota = [&]() {
+    return totalItems > maxItems || (maxBytes > 0 && totalBytes > maxBytes);
+  };
+
+  // the totals are kept up to date as items are stored and deleted, so they
+  // don't need to be counted
+  if (!this->_pImpl->queryTotals(totalItems, totalBytes)) {
+    return false;
+  }
 
-    // prune the rows if over maximum
-    totalItems = CESIUM_SQLITE(sqlite3_column_int64)(
-        this->_pImpl->_totalItemsQueryStmtWrapper.get(),
-        0);
-    if (totalItems > 0 &&
-        totalItems <= static_cast<int64_t>(this->_pImpl->_maxItems)) {
-      return true;
-    }
+  if (!isOverQuota()) {
+    return true;
   }
 
   // delete expired rows first
@@ -668,62 +1152,84 @@ bool SqliteCache::prune() {
     }
   }
 
-  // check if we should delete more
-  const int deletedRows =
-      CESIUM_SQLITE(sqlite3_changes)(this->_pImpl->_pConnection.get());
-  if (totalItems - deletedRows < static_cast<int>(this->_pImpl->_maxItems)) {
-    return true;
-  }
-
-  totalItems -= deletedRows;
-
-  // delete rows LRU if we are still over maximum
-  {
-    int deleteLLRUStatus =
-        CESIUM_SQLITE(sqlite3_reset)(this->_pImpl->_deleteLRUStmtWrapper.get());
-    if (deleteLLRUStatus != SQLITE_OK) {
-      SPDLOG_LOGGER_ERROR(
-          this->_pImpl->_pLogger,
-          CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
+  // delete rows LRU while we are still over maximum, using the average item
+  // size to estimate how many rows to delete for the byte quota
+  while (true) {
+    if (!this->_pImpl->queryTotals(totalItems, totalBytes)) {
       return false;
     }
 
-    deleteLLRUStatus = CESIUM_SQLITE(sqlite3_clear_bindings)(
-        this->_pImpl->_deleteLRUStmtWrapper.get());
-    if (deleteLLRUStatus != SQLITE_OK) {
-      SPDLOG_LOGGER_ERROR(
-          this->_pImpl->_pLogger,
-          CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
-      return false;
+    if (!isOverQuota() || totalItems <= 0) {
+      return true;
     }
 
-    deleteLLRUStatus = CESIUM_SQLITE(sqlite3_bind_int64)(
-        this->_pImpl->_deleteLRUStmtWrapper.get(),
-        1,
-        totalItems - static_cast<int64_t>(this->_pImpl->_maxItems));
-    if (deleteLLRUStatus != SQLITE_OK) {
-      SPDLOG_LOGGER_ERROR(
-          this->_pImpl->_pLogger,
-          CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
-      return false;
+    int64_t rowsToDelete = std::max(totalItems - maxItems, int64_t(0));
+    if (maxBytes > 0 && totalBytes > maxBytes) {
+      const int64_t averageBytes =
+          std::max(totalBytes / totalItems, int64_t(1));
+      rowsToDelete = std::max(
+          rowsToDelete,
+          (totalBytes - maxBytes + averageBytes - 1) / averageBytes);
     }
 
-    deleteLLRUStatus =
-        CESIUM_SQLITE(sqlite3_step)(this->_pImpl->_deleteLRUStmtWrapper.get());
-    if (deleteLLRUStatus != SQLITE_DONE) {
-      SPDLOG_LOGGER_ERROR(
-          this->_pImpl->_pLogger,
-          CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
-      return false;
+    // delete the least recently used rows
+    {
+      int deleteLLRUStatus = CESIUM_SQLITE(sqlite3_reset)(
+          this->_pImpl->_deleteLRUStmtWrapper.get());
+      if (deleteLLRUStatus != SQLITE_OK) {
+        SPDLOG_LOGGER_ERROR(
+            this->_pImpl->_pLogger,
+            CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
+        return false;
+      }
+
+      deleteLLRUStatus = CESIUM_SQLITE(sqlite3_clear_bindings)(
+          this->_pImpl->_deleteLRUStmtWrapper.get());
+      if (deleteLLRUStatus != SQLITE_OK) {
+        SPDLOG_LOGGER_ERROR(
+            this->_pImpl->_pLogger,
+            CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
+        return false;
+      }
+
+      deleteLLRUStatus = CESIUM_SQLITE(sqlite3_bind_int64)(
+          this->_pImpl->_deleteLRUStmtWrapper.get(),
+          1,
+          rowsToDelete);
+      if (deleteLLRUStatus != SQLITE_OK) {
+        SPDLOG_LOGGER_ERROR(
+            this->_pImpl->_pLogger,
+            CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
+        return false;
+      }
+
+      deleteLLRUStatus = CESIUM_SQLITE(sqlite3_step)(
+          this->_pImpl->_deleteLRUStmtWrapper.get());
+      if (deleteLLRUStatus != SQLITE_DONE) {
+        SPDLOG_LOGGER_ERROR(
+            this->_pImpl->_pLogger,
+            CESIUM_SQLITE(sqlite3_errstr)(deleteLLRUStatus));
+        return false;
+      }
     }
-  }
 
-  return true;
+    if (CESIUM_SQLITE(sqlite3_changes)(this->_pImpl->_pConnection.get()) == 0) {
+      return true;
+    }
+  }
 }
 
 bool SqliteCache::clearAll() {
+  // Write the queued entries first, so that they are removed, too.
+  this->_pImpl->flushPendingEntries();
+
   std::lock_guard<std::mutex> guard(this->_pImpl->_mutex);
 
+  {
+    std::lock_guard<std::mutex> lock(this->_pImpl->_accessedRowsMutex);
+    this->_pImpl->_accessedRows.clear();
+  }
+
   int status =
       CESIUM_SQLITE(sqlite3_reset)(this->_pImpl->_clearAllStmtWrapper.get());
   if (status != SQLITE_OK) {
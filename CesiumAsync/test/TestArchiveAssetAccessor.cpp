@@ -0,0 +1,202 @@
+#include "CesiumAsync/ArchiveAssetAccessor.h"
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/IAssetResponse.h"
+
+#include <CesiumUtility/Uri.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CesiumAsync;
+using namespace CesiumUtility;
+
+namespace {
+const std::string TEST_ARCHIVE = "archive-asset-accessor-test.zip";
+
+class ThreadTaskProcessor : public ITaskProcessor {
+public:
+  virtual void startTask(std::function<void()> f) override {
+    std::thread(f).detach();
+  }
+};
+
+struct ArchiveFile {
+  std::string name;
+  std::string data;
+  uint16_t compressionMethod = 0;
+};
+
+void write16(std::string& output, uint16_t value) {
+  output += char(value & 0xFF);
+  output += char(value >> 8);
+}
+
+void write32(std::string& output, uint32_t value) {
+  write16(output, uint16_t(value & 0xFFFF));
+  write16(output, uint16_t(value >> 16));
+}
+
+// Writes a zip archive. The CRC-32 of the files is not written, because it is
+// not checked.
+void writeArchive(const std::vector<ArchiveFile>& files) {
+  std::string archive;
+  std::string centralDirectory;
+  for (const ArchiveFile& file : files) {
+    const uint32_t localHeaderOffset = uint32_t(archive.size());
+    const uint32_t size = uint32_t(file.data.size());
+    const uint16_t nameSize = uint16_t(file.name.size());
+
+    write32(archive, 0x04034b50);
+    write16(archive, 20);
+    write16(archive, 0);
+    write16(archive, file.compressionMethod);
+    write32(archive, 0);
+    write32(archive, 0);
+    write32(archive, size);
+    write32(archive, size);
+    write16(archive, nameSize);
+    write16(archive, 0);
+    archive += file.name;
+    archive += file.data;
+
+    write32(centralDirectory, 0x02014b50);
+    write16(centralDirectory, 20);
+    write16(centralDirectory, 20);
+    write16(centralDirectory, 0);
+    write16(centralDirectory, file.compressionMethod);
+    write32(centralDirectory, 0);
+    write32(centralDirectory, 0);
+    write32(centralDirectory, size);
+    write32(centralDirectory, size);
+    write16(centralDirectory, nameSize);
+    write16(centralDirectory, 0);
+    write16(centralDirectory, 0);
+    write16(centralDirectory, 0);
+    write16(centralDirectory, 0);
+    write32(centralDirectory, 0);
+    write32(centralDirectory, localHeaderOffset);
+    centralDirectory += file.name;
+  }
+
+  const uint32_t centralDirectoryOffset = uint32_t(archive.size());
+  archive += centralDirectory;
+
+  write32(archive, 0x06054b50);
+  write16(archive, 0);
+  write16(archive, 0);
+  write16(archive, uint16_t(files.size()));
+  write16(archive, uint16_t(files.size()));
+  write32(archive, uint32_t(centralDirectory.size()));
+  write32(archive, centralDirectoryOffset);
+  const std::string comment = "A comment";
+  write16(archive, uint16_t(comment.size()));
+  archive += comment;
+
+  std::ofstream stream(TEST_ARCHIVE, std::ios::binary | std::ios::trunc);
+  stream.write(archive.data(), std::streamsize(archive.size()));
+}
+
+std::string getData(const IAssetRequest& request) {
+  const gsl::span<const std::byte> data = request.response()->data();
+  return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+}
+} // namespace
+
+TEST_CASE("Test the archive asset accessor") {
+  AsyncSystem asyncSystem(std::make_shared<ThreadTaskProcessor>());
+  writeArchive(
+      {{"tileset.json", "{\"asset\":{\"version\":\"1.0\"}}"},
+       {"tiles/", ""},
+       {"tiles/0 0.b3dm", "b3dm"},
+       {"tiles/1.b3dm", ""},
+       {"compressed.json", "compressed", 8}});
+
+  SECTION("Serves the files in the archive") {
+    ArchiveAssetAccessor accessor(TEST_ARCHIVE);
+    REQUIRE(accessor.getEntryCount() == 4);
+
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.requestAsset(asyncSystem, "archive:///tileset.json").wait();
+    REQUIRE(pRequest->method() == "GET");
+    REQUIRE(pRequest->url() == "archive:///tileset.json");
+    REQUIRE(pRequest->response()->statusCode() == 200);
+    REQUIRE(pRequest->response()->contentType() == "application/json");
+    REQUIRE(getData(*pRequest) == "{\"asset\":{\"version\":\"1.0\"}}");
+
+    // The data refers to the mapped archive instead of a copy.
+    std::shared_ptr<IAssetRequest> pOtherRequest =
+        accessor.requestAsset(asyncSystem, "archive:///tileset.json").wait();
+    REQUIRE(
+        pRequest->response()->data().data() ==
+        pOtherRequest->response()->data().data());
+
+    pRequest =
+        accessor.requestAsset(asyncSystem, "archive:///tiles/1.b3dm").wait();
+    REQUIRE(pRequest->response()->statusCode() == 200);
+    REQUIRE(pRequest->response()->data().empty());
+  }
+
+  SECTION("Serves files at relative URLs") {
+    ArchiveAssetAccessor accessor(TEST_ARCHIVE, "archive://tileset/");
+    const std::string url =
+        Uri::resolve("archive://tileset/tileset.json", "tiles/0%200.b3dm?v=1");
+
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.requestAsset(asyncSystem, url).wait();
+    REQUIRE(pRequest->response()->statusCode() == 200);
+    REQUIRE(getData(*pRequest) == "b3dm");
+  }
+
+  SECTION("Answers with status code 404 for other URLs") {
+    ArchiveAssetAccessor accessor(TEST_ARCHIVE);
+    REQUIRE(
+        accessor.requestAsset(asyncSystem, "archive:///missing.json")
+            .wait()
+            ->response()
+            ->statusCode() == 404);
+    REQUIRE(
+        accessor.requestAsset(asyncSystem, "archive:///tiles/")
+            .wait()
+            ->response()
+            ->statusCode() == 404);
+    REQUIRE(
+        accessor.requestAsset(asyncSystem, "http://example.com/tileset.json")
+            .wait()
+            ->response()
+            ->statusCode() == 404);
+  }
+
+  SECTION("Rejects requests for compressed files") {
+    ArchiveAssetAccessor accessor(TEST_ARCHIVE);
+    REQUIRE_THROWS(
+        accessor.requestAsset(asyncSystem, "archive:///compressed.json")
+            .wait());
+  }
+
+  SECTION("Keeps the archive open while a response is alive") {
+    std::shared_ptr<IAssetRequest> pRequest;
+    {
+      ArchiveAssetAccessor accessor(TEST_ARCHIVE);
+      pRequest =
+          accessor.requestAsset(asyncSystem, "archive:///tiles/0%200.b3dm")
+              .wait();
+    }
+    REQUIRE(getData(*pRequest) == "b3dm");
+  }
+
+  SECTION("Throws for a file that is not a zip archive") {
+    std::ofstream(TEST_ARCHIVE, std::ios::binary | std::ios::trunc)
+        << "This is not a zip archive.";
+    REQUIRE_THROWS(ArchiveAssetAccessor(TEST_ARCHIVE));
+    REQUIRE_THROWS(ArchiveAssetAccessor("missing.zip"));
+  }
+
+  std::remove(TEST_ARCHIVE.c_str());
+}
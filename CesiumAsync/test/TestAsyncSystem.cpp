@@ -525,4 +525,57 @@ TEST_CASE("AsyncSystem") {
     promise.resolve(4);
     CHECK(future.isReady());
   }
+
+  SECTION("withCancellation resolves when the token is not canceled") {
+    auto promise = asyncSystem.createPromise<int>();
+    CancellationToken token;
+    auto future = promise.getFuture().withCancellation(token);
+
+    promise.resolve(4);
+    CHECK(future.wait() == 4);
+
+    // Canceling after the future resolved has no effect.
+    token.cancel();
+    CHECK(token.isCanceled());
+  }
+
+  SECTION("withCancellation rejects as soon as the token is canceled") {
+    auto promise = asyncSystem.createPromise<int>();
+    CancellationToken token;
+    auto future = promise.getFuture().withCancellation(token);
+
+    CHECK(!future.isReady());
+    token.cancel();
+    CHECK(future.isReady());
+    CHECK_THROWS_AS(future.wait(), CancellationException);
+
+    // The original promise may still be resolved.
+    promise.resolve(4);
+  }
+
+  SECTION("withCancellation rejects if the token was already canceled") {
+    CancellationToken token;
+    token.cancel();
+
+    auto future = asyncSystem.createResolvedFuture(4).withCancellation(token);
+    CHECK_THROWS_AS(future.wait(), CancellationException);
+  }
+
+  SECTION("copies of a cancellation token share their state") {
+    CancellationToken token;
+    CancellationToken copy = token;
+    int32_t callbacks = 0;
+    token.onCancel([&callbacks]() { ++callbacks; });
+
+    CHECK_NOTHROW(token.throwIfCanceled());
+    copy.cancel();
+    copy.cancel();
+    CHECK(token.isCanceled());
+    CHECK_THROWS_AS(token.throwIfCanceled(), CancellationException);
+    CHECK(callbacks == 1);
+
+    // Callbacks registered after the cancellation are invoked right away.
+    token.onCancel([&callbacks]() { ++callbacks; });
+    CHECK(callbacks == 2);
+  }
 }
@@ -6,9 +6,11 @@
 #include "MockAssetResponse.h"
 #include "ResponseCacheControl.h"
 
+#include <CesiumUtility/Uri.h>
 #include <catch2/catch.hpp>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <cstddef>
 #include <optional>
 
@@ -34,8 +36,9 @@ public:
         clearAllCall{false} {}
 
   virtual std::optional<CacheItem>
-  getEntry(const std::string& /*key*/) const override {
+  getEntry(const std::string& key) const override {
     this->getEntryCall = true;
+    this->getEntryKey = key;
     return this->cacheItem;
   }
 
@@ -72,6 +75,7 @@ public:
   }
 
   mutable bool getEntryCall;
+  mutable std::string getEntryKey;
   bool storeResponseCall;
   bool pruneCall;
   bool clearAllCall;
@@ -109,6 +113,39 @@ public:
   std::shared_ptr<IAssetRequest> testRequest;
 };
 
+class MockDeferredAssetAccessor : public IAssetAccessor {
+public:
+  MockDeferredAssetAccessor(
+      SharedFuture<std::shared_ptr<IAssetRequest>>&& serverResponse)
+      : future{std::move(serverResponse)}, requestCount{0} {}
+
+  virtual CesiumAsync::Future<std::shared_ptr<IAssetRequest>> requestAsset(
+      const AsyncSystem& /* asyncSystem */,
+      const std::string& /* url */,
+      const std::vector<THeader>& /* headers */
+      ) override {
+    ++this->requestCount;
+    return this->future.thenImmediately(
+        [](const std::shared_ptr<IAssetRequest>& pRequest) {
+          return pRequest;
+        });
+  }
+
+  virtual CesiumAsync::Future<std::shared_ptr<IAssetRequest>> post(
+      const AsyncSystem& asyncSystem,
+      const std::string& url,
+      const std::vector<THeader>& headers,
+      const gsl::span<const std::byte>& /* contentPayload */
+      ) override {
+    return this->requestAsset(asyncSystem, url, headers);
+  }
+
+  virtual void tick() noexcept override {}
+
+  SharedFuture<std::shared_ptr<IAssetRequest>> future;
+  std::atomic<int32_t> requestCount;
+};
+
 class MockTaskProcessor : public ITaskProcessor {
 public:
   virtual void startTask(std::function<void()> f) override { f(); }
@@ -838,4 +875,421 @@ TEST_CASE("Test serving cache item") {
             })
         .wait();
   }
+
+  SECTION("Cache should serve the stale response if the revalidation request "
+          "has no response") {
+    std::shared_ptr<IAssetRequest> mockRequest =
+        std::make_shared<MockAssetRequest>(
+            "GET",
+            "test.com",
+            HttpHeaders{},
+            nullptr);
+
+    // mock cache item
+    std::unique_ptr<MockStoreCacheDatabase> mockCacheDatabase =
+        std::make_unique<MockStoreCacheDatabase>();
+    MockStoreCacheDatabase* pMockCacheDatabase = mockCacheDatabase.get();
+    std::time_t currentTime = std::time(nullptr);
+    CacheRequest cacheRequest(HttpHeaders{}, "GET", "test.com");
+    CacheResponse cacheResponse(
+        static_cast<uint16_t>(200),
+        HttpHeaders{
+            {"Content-Type", "app/json"},
+            {"Cache-Response-Header", "Cache-Response-Value"},
+            {"Cache-Control", "max-age=100, private"},
+            {"Etag", "deadbeef"}},
+        std::vector<std::byte>());
+    CacheItem cacheItem(
+        currentTime - 100,
+        std::move(cacheRequest),
+        std::move(cacheResponse));
+    mockCacheDatabase->cacheItem = cacheItem;
+
+    std::shared_ptr<CachingAssetAccessor> cacheAssetAccessor =
+        std::make_shared<CachingAssetAccessor>(
+            spdlog::default_logger(),
+            std::make_unique<MockAssetAccessor>(mockRequest),
+            std::move(mockCacheDatabase));
+    std::shared_ptr<MockTaskProcessor> mockTaskProcessor =
+        std::make_shared<MockTaskProcessor>();
+
+    AsyncSystem asyncSystem(mockTaskProcessor);
+    cacheAssetAccessor
+        ->requestAsset(
+            asyncSystem,
+            "test.com",
+            std::vector<IAssetAccessor::THeader>{})
+        .thenImmediately(
+            [](const std::shared_ptr<IAssetRequest>& completedRequest) {
+              REQUIRE(completedRequest != nullptr);
+              REQUIRE(completedRequest->url() == "test.com");
+              REQUIRE(completedRequest->method() == "GET");
+
+              const IAssetResponse* response = completedRequest->response();
+              REQUIRE(response != nullptr);
+              REQUIRE(
+                  response->headers().at("Cache-Response-Header") ==
+                  "Cache-Response-Value");
+              REQUIRE(response->statusCode() == 200);
+              REQUIRE(response->contentType() == "app/json");
+            })
+        .wait();
+
+    REQUIRE(!pMockCacheDatabase->storeRequestParam.has_value());
+  }
+}
+
+TEST_CASE("Test coalescing concurrent requests") {
+  std::unique_ptr<IAssetResponse> mockResponse =
+      std::make_unique<MockAssetResponse>(
+          static_cast<uint16_t>(200),
+          "app/json",
+          HttpHeaders{
+              {"Content-Type", "app/json"},
+              {"Cache-Control", "max-age=100"}},
+          std::vector<std::byte>());
+
+  std::shared_ptr<IAssetRequest> mockRequest =
+      std::make_shared<MockAssetRequest>(
+          "GET",
+          "test.com",
+          HttpHeaders{},
+          std::move(mockResponse));
+
+  std::shared_ptr<MockTaskProcessor> mockTaskProcessor =
+      std::make_shared<MockTaskProcessor>();
+  AsyncSystem asyncSystem(mockTaskProcessor);
+
+  // The server only responds once the promise is resolved, so that the
+  // requests below are all in flight at the same time.
+  Promise<std::shared_ptr<IAssetRequest>> serverResponse =
+      asyncSystem.createPromise<std::shared_ptr<IAssetRequest>>();
+  std::shared_ptr<MockDeferredAssetAccessor> mockAssetAccessor =
+      std::make_shared<MockDeferredAssetAccessor>(
+          serverResponse.getFuture().share());
+
+  std::unique_ptr<MockStoreCacheDatabase> ownedMockCacheDatabase =
+      std::make_unique<MockStoreCacheDatabase>();
+  MockStoreCacheDatabase* mockCacheDatabase = ownedMockCacheDatabase.get();
+  std::shared_ptr<CachingAssetAccessor> cacheAssetAccessor =
+      std::make_shared<CachingAssetAccessor>(
+          spdlog::default_logger(),
+          mockAssetAccessor,
+          std::move(ownedMockCacheDatabase));
+
+  SECTION("Identical requests share one request to the server") {
+    Future<std::shared_ptr<IAssetRequest>> one =
+        cacheAssetAccessor->requestAsset(asyncSystem, "test.com", {});
+    Future<std::shared_ptr<IAssetRequest>> two =
+        cacheAssetAccessor->requestAsset(asyncSystem, "test.com", {});
+    Future<std::shared_ptr<IAssetRequest>> withHeaders =
+        cacheAssetAccessor->requestAsset(
+            asyncSystem,
+            "test.com",
+            {{"Accept", "app/json"}});
+    Future<std::shared_ptr<IAssetRequest>> otherUrl =
+        cacheAssetAccessor->requestAsset(asyncSystem, "other.com", {});
+
+    serverResponse.resolve(std::shared_ptr<IAssetRequest>(mockRequest));
+
+    std::shared_ptr<IAssetRequest> pOne = one.wait();
+    std::shared_ptr<IAssetRequest> pTwo = two.wait();
+    withHeaders.wait();
+    otherUrl.wait();
+
+    REQUIRE(pOne == pTwo);
+    REQUIRE(mockAssetAccessor->requestCount == 3);
+    REQUIRE(mockCacheDatabase->storeResponseCall);
+  }
+
+  SECTION("Requests with the same cache key share one request to the "
+          "server") {
+    Future<std::shared_ptr<IAssetRequest>> one =
+        cacheAssetAccessor->requestAsset(
+            asyncSystem,
+            "test.com?access_token=one",
+            {});
+    Future<std::shared_ptr<IAssetRequest>> two =
+        cacheAssetAccessor->requestAsset(
+            asyncSystem,
+            "test.com?access_token=two",
+            {});
+
+    serverResponse.resolve(std::shared_ptr<IAssetRequest>(mockRequest));
+
+    std::shared_ptr<IAssetRequest> pOne = one.wait();
+    std::shared_ptr<IAssetRequest> pTwo = two.wait();
+
+    REQUIRE(mockAssetAccessor->requestCount == 1);
+    REQUIRE(pOne == mockRequest);
+    REQUIRE(pTwo->url() == "test.com?access_token=two");
+    REQUIRE(pTwo->response() == mockRequest->response());
+  }
+
+  SECTION("Canceling one request does not cancel the requests that share it") {
+    CancellationToken canceledToken;
+    CancellationToken token;
+    Future<std::shared_ptr<IAssetRequest>> canceled =
+        cacheAssetAccessor->requestAssetWithCancellation(
+            asyncSystem,
+            "test.com",
+            {},
+            canceledToken);
+    Future<std::shared_ptr<IAssetRequest>> notCanceled =
+        cacheAssetAccessor->requestAssetWithCancellation(
+            asyncSystem,
+            "test.com",
+            {},
+            token);
+
+    canceledToken.cancel();
+    serverResponse.resolve(std::shared_ptr<IAssetRequest>(mockRequest));
+
+    REQUIRE_THROWS_AS(canceled.wait(), CancellationException);
+    REQUIRE(notCanceled.wait() == mockRequest);
+  }
+
+  SECTION("A request after all sharing requests were canceled starts over") {
+    CancellationToken token;
+    Future<std::shared_ptr<IAssetRequest>> canceled =
+        cacheAssetAccessor->requestAssetWithCancellation(
+            asyncSystem,
+            "test.com",
+            {},
+            token);
+    token.cancel();
+
+    Future<std::shared_ptr<IAssetRequest>> next =
+        cacheAssetAccessor->requestAsset(asyncSystem, "test.com", {});
+    serverResponse.resolve(std::shared_ptr<IAssetRequest>(mockRequest));
+
+    REQUIRE_THROWS_AS(canceled.wait(), CancellationException);
+    REQUIRE(next.wait() == mockRequest);
+  }
+}
+
+TEST_CASE("Test the in-memory cache") {
+  std::unique_ptr<IAssetResponse> mockResponse =
+      std::make_unique<MockAssetResponse>(
+          static_cast<uint16_t>(200),
+          "app/json",
+          HttpHeaders{
+              {"Content-Type", "app/json"},
+              {"Cache-Control", "max-age=100"}},
+          std::vector<std::byte>());
+
+  std::shared_ptr<IAssetRequest> mockRequest =
+      std::make_shared<MockAssetRequest>(
+          "GET",
+          "test.com",
+          HttpHeaders{},
+          std::move(mockResponse));
+
+  // A fresh cache item with 10 bytes of response data.
+  std::unique_ptr<MockStoreCacheDatabase> ownedMockCacheDatabase =
+      std::make_unique<MockStoreCacheDatabase>();
+  MockStoreCacheDatabase* mockCacheDatabase = ownedMockCacheDatabase.get();
+  mockCacheDatabase->cacheItem = CacheItem(
+      std::time(nullptr) + 100,
+      CacheRequest(HttpHeaders{}, "GET", "cache.com"),
+      CacheResponse(
+          static_cast<uint16_t>(200),
+          HttpHeaders{
+              {"Content-Type", "app/json"},
+              {"Cache-Control", "max-age=100"}},
+          std::vector<std::byte>(10)));
+
+  // There is only room for one item in memory.
+  std::shared_ptr<CachingAssetAccessor> cacheAssetAccessor =
+      std::make_shared<CachingAssetAccessor>(
+          spdlog::default_logger(),
+          std::make_unique<MockAssetAccessor>(mockRequest),
+          std::move(ownedMockCacheDatabase),
+          10000,
+          4,
+          15);
+  std::shared_ptr<MockTaskProcessor> mockTaskProcessor =
+      std::make_shared<MockTaskProcessor>();
+  AsyncSystem asyncSystem(mockTaskProcessor);
+
+  std::shared_ptr<IAssetRequest> pFirst =
+      cacheAssetAccessor->requestAsset(asyncSystem, "a.com", {}).wait();
+  REQUIRE(pFirst->url() == "cache.com");
+  REQUIRE(mockCacheDatabase->getEntryCall);
+
+  SECTION("Serves a recently used item without reading the database") {
+    mockCacheDatabase->getEntryCall = false;
+
+    std::shared_ptr<IAssetRequest> pSecond =
+        cacheAssetAccessor->requestAsset(asyncSystem, "a.com", {}).wait();
+    REQUIRE(!mockCacheDatabase->getEntryCall);
+
+    // The response data is shared, not copied.
+    REQUIRE(
+        pSecond->response()->data().data() ==
+        pFirst->response()->data().data());
+
+    const CachingAssetAccessorStatistics statistics =
+        cacheAssetAccessor->getStatistics();
+    REQUIRE(statistics.memoryCacheLookups == 2);
+    REQUIRE(statistics.memoryCacheHits == 1);
+    REQUIRE(statistics.databaseLookups == 1);
+    REQUIRE(statistics.databaseHits == 1);
+    REQUIRE(statistics.memoryCacheHitRate() == 0.5);
+    REQUIRE(statistics.databaseHitRate() == 1.0);
+  }
+
+  SECTION("Removes the least recently used item when it is full") {
+    cacheAssetAccessor->requestAsset(asyncSystem, "b.com", {}).wait();
+    mockCacheDatabase->getEntryCall = false;
+
+    cacheAssetAccessor->requestAsset(asyncSystem, "b.com", {}).wait();
+    REQUIRE(!mockCacheDatabase->getEntryCall);
+
+    cacheAssetAccessor->requestAsset(asyncSystem, "a.com", {}).wait();
+    REQUIRE(mockCacheDatabase->getEntryCall);
+
+    const CachingAssetAccessorStatistics statistics =
+        cacheAssetAccessor->getStatistics();
+    REQUIRE(statistics.memoryCacheLookups == 4);
+    REQUIRE(statistics.memoryCacheHits == 1);
+    REQUIRE(statistics.databaseLookups == 3);
+  }
+
+  SECTION("Keeps the responses from the server in memory") {
+    mockCacheDatabase->cacheItem.reset();
+    mockCacheDatabase->getEntryCall = false;
+
+    std::shared_ptr<IAssetRequest> pFromServer =
+        cacheAssetAccessor->requestAsset(asyncSystem, "test.com", {}).wait();
+    REQUIRE(pFromServer == mockRequest);
+    REQUIRE(mockCacheDatabase->getEntryCall);
+    REQUIRE(mockCacheDatabase->storeResponseCall);
+
+    mockCacheDatabase->getEntryCall = false;
+    std::shared_ptr<IAssetRequest> pFromMemory =
+        cacheAssetAccessor->requestAsset(asyncSystem, "test.com", {}).wait();
+    REQUIRE(pFromMemory->url() == "test.com");
+    REQUIRE(!mockCacheDatabase->getEntryCall);
+  }
+}
+
+TEST_CASE("Test the cache key") {
+  SECTION("The default cache key omits the access token") {
+    REQUIRE(
+        CachingAssetAccessor::calculateDefaultCacheKey("test.com/a.json") ==
+        "test.com/a.json");
+    REQUIRE(
+        CachingAssetAccessor::calculateDefaultCacheKey(
+            "test.com/a.json?access_token=abc") == "test.com/a.json");
+    REQUIRE(
+        CachingAssetAccessor::calculateDefaultCacheKey(
+            "test.com/a.json?v=2&access_token=abc&extensions=octvertexnormals"
+            "&key=def&session=ghi#fragment") ==
+        "test.com/a.json?v=2&extensions=octvertexnormals&key=def&session=ghi"
+        "#fragment");
+  }
+
+  std::unique_ptr<IAssetResponse> mockResponse =
+      std::make_unique<MockAssetResponse>(
+          static_cast<uint16_t>(200),
+          "app/json",
+          HttpHeaders{
+              {"Content-Type", "app/json"},
+              {"Cache-Control", "max-age=100"}},
+          std::vector<std::byte>());
+
+  const std::string url = "test.com/a.json?v=2&access_token=new";
+  std::shared_ptr<IAssetRequest> mockRequest =
+      std::make_shared<MockAssetRequest>(
+          "GET",
+          url,
+          HttpHeaders{},
+          std::move(mockResponse));
+
+  std::shared_ptr<MockTaskProcessor> mockTaskProcessor =
+      std::make_shared<MockTaskProcessor>();
+  AsyncSystem asyncSystem(mockTaskProcessor);
+
+  std::unique_ptr<MockStoreCacheDatabase> ownedMockCacheDatabase =
+      std::make_unique<MockStoreCacheDatabase>();
+  MockStoreCacheDatabase* mockCacheDatabase = ownedMockCacheDatabase.get();
+
+  SECTION("Responses are stored and looked up by the cache key") {
+    CachingAssetAccessor cacheAssetAccessor(
+        spdlog::default_logger(),
+        std::make_unique<MockAssetAccessor>(mockRequest),
+        std::move(ownedMockCacheDatabase));
+
+    REQUIRE(
+        cacheAssetAccessor.requestAsset(asyncSystem, url, {}).wait() ==
+        mockRequest);
+    REQUIRE(mockCacheDatabase->getEntryKey == "test.com/a.json?v=2");
+    REQUIRE(mockCacheDatabase->storeRequestParam);
+    REQUIRE(mockCacheDatabase->storeRequestParam->key == "test.com/a.json?v=2");
+    REQUIRE(mockCacheDatabase->storeRequestParam->url == url);
+  }
+
+  SECTION("A response cached with another access token reports the requested "
+          "URL") {
+    mockCacheDatabase->cacheItem = CacheItem(
+        std::time(nullptr) + 100,
+        CacheRequest(
+            HttpHeaders{},
+            "GET",
+            "test.com/a.json?v=2&access_token=old"),
+        CacheResponse(
+            static_cast<uint16_t>(200),
+            HttpHeaders{
+                {"Content-Type", "app/json"},
+                {"Cache-Control", "max-age=100"}},
+            std::vector<std::byte>()));
+
+    CachingAssetAccessor cacheAssetAccessor(
+        spdlog::default_logger(),
+        std::make_unique<MockAssetAccessor>(mockRequest),
+        std::move(ownedMockCacheDatabase));
+
+    std::shared_ptr<IAssetRequest> pCompletedRequest =
+        cacheAssetAccessor.requestAsset(asyncSystem, url, {}).wait();
+    REQUIRE(pCompletedRequest != mockRequest);
+    REQUIRE(pCompletedRequest->url() == url);
+    REQUIRE(!mockCacheDatabase->storeResponseCall);
+  }
+
+  SECTION("The cache key function can be replaced") {
+    CachingAssetAccessor cacheAssetAccessor(
+        spdlog::default_logger(),
+        std::make_unique<MockAssetAccessor>(mockRequest),
+        std::move(ownedMockCacheDatabase),
+        10000,
+        4,
+        0,
+        [](const std::string& requestUrl) { return "key:" + requestUrl; });
+
+    cacheAssetAccessor.requestAsset(asyncSystem, url, {}).wait();
+    REQUIRE(mockCacheDatabase->getEntryKey == "key:" + url);
+    REQUIRE(mockCacheDatabase->storeRequestParam);
+    REQUIRE(mockCacheDatabase->storeRequestParam->key == "key:" + url);
+  }
+
+  SECTION("The cache key function can omit more query parameters") {
+    CachingAssetAccessor cacheAssetAccessor(
+        spdlog::default_logger(),
+        std::make_unique<MockAssetAccessor>(mockRequest),
+        std::move(ownedMockCacheDatabase),
+        10000,
+        4,
+        0,
+        [](const std::string& requestUrl) {
+          return CesiumUtility::Uri::removeQueryParameters(
+              CachingAssetAccessor::calculateDefaultCacheKey(requestUrl),
+              {"session"});
+        });
+
+    cacheAssetAccessor
+        .requestAsset(asyncSystem, url + "&key=abc&session=def", {})
+        .wait();
+    REQUIRE(mockCacheDatabase->getEntryKey == "test.com/a.json?v=2&key=abc");
+  }
 }
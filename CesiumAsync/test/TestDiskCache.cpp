@@ -6,10 +6,62 @@
 #include <catch2/catch.hpp>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
 #include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace CesiumAsync;
 
+namespace {
+void storeEntries(
+    SqliteCache& diskCache,
+    size_t count,
+    const std::string& keyPrefix = "TestKey") {
+  const std::vector<std::byte> responseData(1024, std::byte(42));
+  for (size_t i = 0; i < count; ++i) {
+    REQUIRE(diskCache.storeEntry(
+        keyPrefix + std::to_string(i),
+        std::time(nullptr) + 1000,
+        "test.com/" + std::to_string(i),
+        "GET",
+        HttpHeaders{},
+        200,
+        HttpHeaders{{"Content-Type", "application/octet-stream"}},
+        responseData));
+  }
+}
+
+// Looks up all entries from each of the given number of threads, and returns
+// the number of entries that were found.
+size_t lookUpEntries(
+    const SqliteCache& diskCache,
+    size_t entryCount,
+    size_t threadCount) {
+  std::atomic<size_t> found{0};
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < threadCount; ++thread) {
+    threads.emplace_back([&diskCache, &found, entryCount]() {
+      for (size_t i = 0; i < entryCount; ++i) {
+        std::optional<CacheItem> cacheItem =
+            diskCache.getEntry("TestKey" + std::to_string(i));
+        if (cacheItem &&
+            cacheItem->cacheRequest.url == "test.com/" + std::to_string(i)) {
+          ++found;
+        }
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  return found;
+}
+} // namespace
+
 TEST_CASE("Test disk cache with Sqlite") {
   SqliteCache diskCache(spdlog::default_logger(), "test.db", 3);
 
@@ -214,3 +266,182 @@ TEST_CASE("Test disk cache with Sqlite") {
     }
   }
 }
+
+TEST_CASE("Test disk cache byte quota") {
+  // storeEntries stores 1024 bytes of response data per entry.
+  SqliteCache diskCache(spdlog::default_logger(), "test.db", 4096, 10240, 0);
+  REQUIRE(diskCache.clearAll());
+
+  // Storing the entries again replaces them, which must not count their sizes
+  // twice.
+  storeEntries(diskCache, 20);
+  storeEntries(diskCache, 20);
+
+  REQUIRE(diskCache.prune());
+  for (int i = 0; i < 10; ++i) {
+    REQUIRE(diskCache.getEntry("TestKey" + std::to_string(i)) == std::nullopt);
+  }
+
+  for (int i = 10; i < 20; ++i) {
+    REQUIRE(diskCache.getEntry("TestKey" + std::to_string(i)) != std::nullopt);
+  }
+
+  // Within the quota, nothing else is removed.
+  REQUIRE(diskCache.prune());
+  REQUIRE(diskCache.getEntry("TestKey10") != std::nullopt);
+}
+
+TEST_CASE("Test concurrent lookups in the disk cache") {
+  const size_t entryCount = 100;
+  const size_t threadCount = 8;
+
+  SECTION("With a pool of read connections") {
+    SqliteCache diskCache(spdlog::default_logger(), "test.db", 4096, 0, 4);
+    REQUIRE(diskCache.clearAll());
+    storeEntries(diskCache, entryCount);
+
+    REQUIRE(
+        lookUpEntries(diskCache, entryCount, threadCount) ==
+        entryCount * threadCount);
+
+    // Prune writes the last accessed times of the entries that were looked up.
+    REQUIRE(diskCache.prune());
+    REQUIRE(diskCache.getEntry("TestKey0") != std::nullopt);
+  }
+
+  SECTION("With an in-memory database") {
+    SqliteCache diskCache(spdlog::default_logger(), ":memory:", 4096, 0, 4);
+    storeEntries(diskCache, entryCount);
+
+    REQUIRE(
+        lookUpEntries(diskCache, entryCount, threadCount) ==
+        entryCount * threadCount);
+  }
+}
+
+TEST_CASE("Test write-behind disk cache") {
+  const size_t entryCount = 100;
+
+  // Only the queue limit or destruction cause the entries to be written.
+  SqliteCacheWriteBehindOptions writeBehindOptions;
+  writeBehindOptions.enabled = true;
+  writeBehindOptions.maximumPendingEntries = entryCount;
+  writeBehindOptions.entriesPerTransaction = entryCount;
+  writeBehindOptions.flushIntervalMilliseconds = 3600000;
+
+  {
+    SqliteCache diskCache(spdlog::default_logger(), "test.db", 4096, 0, 0);
+    REQUIRE(diskCache.clearAll());
+  }
+
+  SECTION("Queued entries can be looked up before they are written") {
+    SqliteCache diskCache(
+        spdlog::default_logger(),
+        "test.db",
+        4096,
+        0,
+        4,
+        writeBehindOptions);
+    storeEntries(diskCache, entryCount / 2);
+    REQUIRE(lookUpEntries(diskCache, entryCount / 2, 4) == entryCount * 2);
+
+    diskCache.flush();
+    REQUIRE(lookUpEntries(diskCache, entryCount / 2, 4) == entryCount * 2);
+  }
+
+  SECTION("Queued entries are written before the cache is destroyed") {
+    {
+      SqliteCache diskCache(
+          spdlog::default_logger(),
+          "test.db",
+          4096,
+          0,
+          4,
+          writeBehindOptions);
+      storeEntries(diskCache, entryCount / 2);
+    }
+
+    SqliteCache diskCache(spdlog::default_logger(), "test.db", 4096, 0, 0);
+    REQUIRE(lookUpEntries(diskCache, entryCount / 2, 1) == entryCount / 2);
+  }
+
+  SECTION("Storing more entries than the queue holds waits for a flush") {
+    SqliteCache diskCache(
+        spdlog::default_logger(),
+        "test.db",
+        4096,
+        0,
+        4,
+        writeBehindOptions);
+    storeEntries(diskCache, entryCount * 3);
+    REQUIRE(lookUpEntries(diskCache, entryCount * 3, 1) == entryCount * 3);
+  }
+}
+
+// Measures the lookup throughput for an increasing number of threads, each
+// with its own read connection. Run with `cesium-native-tests "[benchmark]"`.
+TEST_CASE("Disk cache lookup throughput by thread count", "[.][benchmark]") {
+  const size_t entryCount = 1000;
+
+  for (const size_t threadCount : std::vector<size_t>{1, 2, 4, 8, 16}) {
+    SqliteCache diskCache(
+        spdlog::default_logger(),
+        "benchmark.db",
+        entryCount,
+        0,
+        uint32_t(threadCount));
+    REQUIRE(diskCache.clearAll());
+    storeEntries(diskCache, entryCount);
+
+    BENCHMARK(
+        std::to_string(threadCount) + " threads, " +
+        std::to_string(entryCount) + " lookups each") {
+      return lookUpEntries(diskCache, entryCount, threadCount);
+    };
+  }
+
+  SqliteCache singleConnection(
+      spdlog::default_logger(),
+      "benchmark.db",
+      entryCount,
+      0,
+      0);
+  BENCHMARK("8 threads sharing the write connection") {
+    return lookUpEntries(singleConnection, entryCount, 8);
+  };
+}
+
+// Compares writing each stored entry in its own transaction with queuing the
+// entries and writing them in batches. Run with
+// `cesium-native-tests "[benchmark]"`.
+TEST_CASE("Disk cache store throughput", "[.][benchmark]") {
+  const size_t entryCount = 1000;
+
+  SqliteCache immediate(spdlog::default_logger(), "benchmark.db", 100000, 0, 0);
+  REQUIRE(immediate.clearAll());
+  size_t immediateRun = 0;
+  BENCHMARK("1000 stores, one transaction each") {
+    storeEntries(
+        immediate,
+        entryCount,
+        "Immediate" + std::to_string(immediateRun++) + "_");
+  };
+
+  SqliteCacheWriteBehindOptions writeBehindOptions;
+  writeBehindOptions.enabled = true;
+  SqliteCache writeBehind(
+      spdlog::default_logger(),
+      "benchmark.db",
+      100000,
+      0,
+      0,
+      writeBehindOptions);
+  size_t writeBehindRun = 0;
+  BENCHMARK("1000 stores, write-behind, including the final flush") {
+    storeEntries(
+        writeBehind,
+        entryCount,
+        "WriteBehind" + std::to_string(writeBehindRun++) + "_");
+    writeBehind.flush();
+  };
+}
@@ -0,0 +1,277 @@
+#include "CesiumAsync/AsyncSystem.h"
+#include "CesiumAsync/HttpAssetAccessor.h"
+#include "CesiumAsync/IAssetResponse.h"
+
+#include <catch2/catch.hpp>
+#include <httplib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+class ThreadTaskProcessor : public ITaskProcessor {
+public:
+  virtual void startTask(std::function<void()> f) override {
+    std::thread(f).detach();
+  }
+};
+
+// A server on a local port that answers requests in its own threads.
+class TestServer {
+public:
+  TestServer() {
+    this->_server.set_keep_alive_max_count(100000);
+
+    this->_server.Get(
+        "/hello",
+        [this](const httplib::Request& request, httplib::Response& response) {
+          this->recordConnection(request);
+          response.set_header("X-Test", "test");
+          response.set_content(
+              "Hello " + request.get_header_value("X-Name"),
+              "text/plain");
+        });
+
+    this->_server.Get(
+        "/slow",
+        [this](const httplib::Request& request, httplib::Response& response) {
+          this->recordConnection(request);
+          ++this->slowRequests;
+          const int32_t active = ++this->activeSlowRequests;
+          int32_t maximum = this->maximumActiveSlowRequests;
+          while (active > maximum &&
+                 !this->maximumActiveSlowRequests.compare_exchange_weak(
+                     maximum,
+                     active)) {
+          }
+
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+          --this->activeSlowRequests;
+          response.set_content("slow", "text/plain");
+        });
+
+    this->_server.Post(
+        "/echo",
+        [this](const httplib::Request& request, httplib::Response& response) {
+          this->recordConnection(request);
+          response.set_content(
+              request.body,
+              request.get_header_value("Content-Type").c_str());
+        });
+
+    this->_port = this->_server.bind_to_any_port("127.0.0.1");
+    this->_thread =
+        std::thread([this]() { this->_server.listen_after_bind(); });
+    while (!this->_server.is_running()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  ~TestServer() {
+    this->_server.stop();
+    this->_thread.join();
+  }
+
+  std::string url(const std::string& path) const {
+    return "http://127.0.0.1:" + std::to_string(this->_port) + path;
+  }
+
+  size_t connectionCount() {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_remotePorts.size();
+  }
+
+  std::atomic<int32_t> slowRequests = 0;
+  std::atomic<int32_t> activeSlowRequests = 0;
+  std::atomic<int32_t> maximumActiveSlowRequests = 0;
+
+private:
+  void recordConnection(const httplib::Request& request) {
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_remotePorts.insert(request.remote_port);
+  }
+
+  httplib::Server _server;
+  int _port;
+  std::thread _thread;
+
+  std::mutex _mutex;
+  std::set<int> _remotePorts;
+};
+
+std::string getData(const IAssetRequest& request) {
+  const gsl::span<const std::byte> data = request.response()->data();
+  return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+}
+} // namespace
+
+TEST_CASE("Test the HTTP asset accessor") {
+  AsyncSystem asyncSystem(std::make_shared<ThreadTaskProcessor>());
+  TestServer server;
+
+  SECTION("Gets a response") {
+    HttpAssetAccessorOptions options;
+    options.defaultHeaders = {{"X-Name", "Default"}};
+    HttpAssetAccessor accessor(options);
+
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor.requestAsset(asyncSystem, server.url("/hello#fragment"))
+            .wait();
+    REQUIRE(pRequest->method() == "GET");
+    REQUIRE(pRequest->url() == server.url("/hello#fragment"));
+    REQUIRE(pRequest->headers().at("X-Name") == "Default");
+
+    const IAssetResponse* pResponse = pRequest->response();
+    REQUIRE(pResponse);
+    REQUIRE(pResponse->statusCode() == 200);
+    REQUIRE(pResponse->contentType() == "text/plain");
+    REQUIRE(pResponse->headers().at("x-test") == "test");
+    REQUIRE(getData(*pRequest) == "Hello Default");
+
+    // The headers of the request replace the default headers.
+    pRequest = accessor
+                   .requestAsset(
+                       asyncSystem,
+                       server.url("/hello"),
+                       {{"x-name", "Cesium"}})
+                   .wait();
+    REQUIRE(getData(*pRequest) == "Hello Cesium");
+
+    pRequest =
+        accessor.requestAsset(asyncSystem, server.url("/missing")).wait();
+    REQUIRE(pRequest->response()->statusCode() == 404);
+  }
+
+  SECTION("Posts a payload") {
+    HttpAssetAccessor accessor;
+    const std::string payload = "payload";
+    std::shared_ptr<IAssetRequest> pRequest =
+        accessor
+            .post(
+                asyncSystem,
+                server.url("/echo"),
+                {{"Content-Type", "application/test"}},
+                gsl::span<const std::byte>(
+                    reinterpret_cast<const std::byte*>(payload.data()),
+                    payload.size()))
+            .wait();
+    REQUIRE(pRequest->method() == "POST");
+    REQUIRE(pRequest->response()->contentType() == "application/test");
+    REQUIRE(getData(*pRequest) == payload);
+  }
+
+  SECTION("Keeps connections alive") {
+    HttpAssetAccessorOptions options;
+    options.maximumConnectionsPerHost = 1;
+    HttpAssetAccessor accessor(options);
+
+    for (int i = 0; i < 10; ++i) {
+      accessor.requestAsset(asyncSystem, server.url("/hello")).wait();
+    }
+    REQUIRE(server.connectionCount() == 1);
+  }
+
+  SECTION("Limits the requests in progress for each host") {
+    HttpAssetAccessorOptions options;
+    options.numberOfThreads = 8;
+    options.maximumConnectionsPerHost = 2;
+    HttpAssetAccessor accessor(options);
+
+    std::vector<Future<std::shared_ptr<IAssetRequest>>> futures;
+    for (int i = 0; i < 6; ++i) {
+      futures.emplace_back(
+          accessor.requestAsset(asyncSystem, server.url("/slow")));
+    }
+    for (Future<std::shared_ptr<IAssetRequest>>& future : futures) {
+      REQUIRE(getData(*future.wait()) == "slow");
+    }
+
+    REQUIRE(server.maximumActiveSlowRequests == 2);
+    REQUIRE(server.connectionCount() == 2);
+  }
+
+  SECTION("Does not send requests that are canceled while queued") {
+    HttpAssetAccessorOptions options;
+    options.numberOfThreads = 1;
+    HttpAssetAccessor accessor(options);
+
+    Future<std::shared_ptr<IAssetRequest>> slow =
+        accessor.requestAsset(asyncSystem, server.url("/slow"));
+
+    CancellationToken token;
+    Future<std::shared_ptr<IAssetRequest>> canceled =
+        accessor.requestAssetWithCancellation(
+            asyncSystem,
+            server.url("/slow"),
+            {},
+            token);
+    token.cancel();
+    REQUIRE_THROWS_AS(canceled.wait(), CancellationException);
+
+    // The requests are sent in order by the only thread, so the canceled one
+    // was skipped once the next one is complete.
+    slow.wait();
+    accessor.requestAsset(asyncSystem, server.url("/hello")).wait();
+    REQUIRE(server.slowRequests == 1);
+  }
+
+  SECTION("Rejects requests that cannot be sent") {
+    HttpAssetAccessor accessor;
+    REQUIRE_THROWS(
+        accessor.requestAsset(asyncSystem, "unsupported://127.0.0.1/").wait());
+  }
+}
+
+// Measures the requests per second and the 99th percentile latency of
+// requests to a local server. Run with `cesium-native-tests "[benchmark]"`.
+TEST_CASE("HTTP asset accessor throughput", "[.][benchmark]") {
+  const size_t requestCount = 2000;
+
+  AsyncSystem asyncSystem(std::make_shared<ThreadTaskProcessor>());
+  TestServer server;
+  HttpAssetAccessor accessor;
+  const std::string url = server.url("/hello");
+
+  std::vector<std::chrono::steady_clock::duration> latencies(requestCount);
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<Future<void>> futures;
+  for (size_t i = 0; i < requestCount; ++i) {
+    const auto requestStart = std::chrono::steady_clock::now();
+    futures.emplace_back(accessor.requestAsset(asyncSystem, url)
+                             .thenImmediately(
+                                 [&latencies, i, requestStart](
+                                     std::shared_ptr<IAssetRequest>&&) {
+                                   latencies[i] =
+                                       std::chrono::steady_clock::now() -
+                                       requestStart;
+                                 }));
+  }
+  for (Future<void>& future : futures) {
+    future.wait();
+  }
+
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  std::sort(latencies.begin(), latencies.end());
+  const double p99Milliseconds =
+      std::chrono::duration<double, std::milli>(
+          latencies[requestCount * 99 / 100])
+          .count();
+
+  WARN(
+      "Requests per second: " << double(requestCount) / seconds
+                              << ", p99 latency: " << p99Milliseconds
+                              << " ms");
+}
@@ -0,0 +1,267 @@
+#include "CesiumAsync/MappedFileCache.h"
+#include "CesiumAsync/SqliteCache.h"
+
+#include <catch2/catch.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace CesiumAsync;
+
+namespace {
+const std::string TEST_DIRECTORY = "mapped-file-cache-test";
+
+std::vector<std::byte> createResponseData(size_t size, size_t seed) {
+  std::vector<std::byte> result(size);
+  for (size_t i = 0; i < size; ++i) {
+    result[i] = std::byte((i + seed) % 256);
+  }
+  return result;
+}
+
+void storeEntries(
+    ICacheDatabase& cache,
+    size_t count,
+    size_t responseSize = 1024,
+    std::time_t expiryTime = std::time(nullptr) + 1000) {
+  for (size_t i = 0; i < count; ++i) {
+    REQUIRE(cache.storeEntry(
+        "TestKey" + std::to_string(i),
+        expiryTime,
+        "test.com/" + std::to_string(i),
+        "GET",
+        HttpHeaders{{"Request-Header", std::to_string(i)}},
+        200,
+        HttpHeaders{{"Content-Type", "application/octet-stream"}},
+        createResponseData(responseSize, i)));
+  }
+}
+
+size_t countEntries(const ICacheDatabase& cache, size_t count) {
+  size_t found = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (cache.getEntry("TestKey" + std::to_string(i))) {
+      ++found;
+    }
+  }
+  return found;
+}
+
+size_t countSegments() {
+  size_t segments = 0;
+  for (const std::filesystem::directory_entry& entry :
+       std::filesystem::directory_iterator(TEST_DIRECTORY)) {
+    (void)entry;
+    ++segments;
+  }
+  return segments;
+}
+} // namespace
+
+TEST_CASE("Test the memory-mapped file cache") {
+  std::filesystem::remove_all(TEST_DIRECTORY);
+
+  SECTION("Stores and retrieves entries") {
+    MappedFileCache cache(spdlog::default_logger(), TEST_DIRECTORY);
+    storeEntries(cache, 10);
+
+    std::optional<CacheItem> cacheItem = cache.getEntry("TestKey3");
+    REQUIRE(cacheItem);
+    REQUIRE(cacheItem->cacheRequest.url == "test.com/3");
+    REQUIRE(cacheItem->cacheRequest.method == "GET");
+    REQUIRE(
+        cacheItem->cacheRequest.headers ==
+        HttpHeaders{{"Request-Header", "3"}});
+    REQUIRE(cacheItem->cacheResponse.statusCode == 200);
+    REQUIRE(
+        cacheItem->cacheResponse.headers ==
+        HttpHeaders{{"Content-Type", "application/octet-stream"}});
+
+    const gsl::span<const std::byte> data = cacheItem->cacheResponse.getData();
+    const std::vector<std::byte> expected = createResponseData(1024, 3);
+    REQUIRE(std::vector<std::byte>(data.begin(), data.end()) == expected);
+
+    // The response data refers to the mapped segment instead of a copy.
+    REQUIRE(cacheItem->cacheResponse.data.empty());
+    REQUIRE(
+        cache.getEntry("TestKey3")->cacheResponse.getData().data() ==
+        data.data());
+
+    REQUIRE(!cache.getEntry("NoSuchKey"));
+  }
+
+  SECTION("Replaces entries") {
+    MappedFileCache cache(spdlog::default_logger(), TEST_DIRECTORY);
+    storeEntries(cache, 10);
+    REQUIRE(cache.storeEntry(
+        "TestKey3",
+        std::time(nullptr) + 1000,
+        "replaced.com",
+        "GET",
+        HttpHeaders{},
+        201,
+        HttpHeaders{},
+        std::vector<std::byte>()));
+
+    std::optional<CacheItem> cacheItem = cache.getEntry("TestKey3");
+    REQUIRE(cacheItem);
+    REQUIRE(cacheItem->cacheRequest.url == "replaced.com");
+    REQUIRE(cacheItem->cacheResponse.statusCode == 201);
+    REQUIRE(cacheItem->cacheResponse.getData().empty());
+  }
+
+  SECTION("Prunes expired and least recently used entries") {
+    MappedFileCache cache(spdlog::default_logger(), TEST_DIRECTORY, 10);
+    storeEntries(cache, 5, 1024, std::time(nullptr) - 1);
+    REQUIRE(cache.prune());
+    REQUIRE(countEntries(cache, 5) == 0);
+
+    storeEntries(cache, 20);
+    REQUIRE(cache.prune());
+    REQUIRE(countEntries(cache, 10) == 0);
+    REQUIRE(countEntries(cache, 20) == 10);
+  }
+
+  SECTION("Prunes entries over the byte quota") {
+    MappedFileCache
+        cache(spdlog::default_logger(), TEST_DIRECTORY, 4096, 10240);
+    storeEntries(cache, 20);
+    REQUIRE(cache.prune());
+    REQUIRE(countEntries(cache, 10) == 0);
+    REQUIRE(countEntries(cache, 20) == 10);
+  }
+
+  SECTION("Keeps entries when it is opened again") {
+    {
+      MappedFileCache cache(spdlog::default_logger(), TEST_DIRECTORY);
+      storeEntries(cache, 10);
+    }
+
+    MappedFileCache cache(spdlog::default_logger(), TEST_DIRECTORY);
+    REQUIRE(countEntries(cache, 10) == 10);
+
+    std::optional<CacheItem> cacheItem = cache.getEntry("TestKey9");
+    REQUIRE(cacheItem);
+    const gsl::span<const std::byte> data = cacheItem->cacheResponse.getData();
+    REQUIRE(
+        std::vector<std::byte>(data.begin(), data.end()) ==
+        createResponseData(1024, 9));
+  }
+
+  SECTION("Compacts segments with deleted entries") {
+    // Each segment holds a few entries.
+    MappedFileCache
+        cache(spdlog::default_logger(), TEST_DIRECTORY, 10, 0, 8 * 1024);
+    storeEntries(cache, 40);
+    const size_t segmentsBefore = countSegments();
+
+    // A response keeps its segment mapped while it is compacted.
+    std::optional<CacheItem> oldItem = cache.getEntry("TestKey0");
+    REQUIRE(oldItem);
+
+    REQUIRE(cache.prune());
+    cache.compact();
+
+    REQUIRE(countSegments() < segmentsBefore);
+    REQUIRE(countEntries(cache, 40) == 10);
+
+    const gsl::span<const std::byte> data = oldItem->cacheResponse.getData();
+    REQUIRE(
+        std::vector<std::byte>(data.begin(), data.end()) ==
+        createResponseData(1024, 0));
+  }
+
+  SECTION("Keeps the entries that are replaced while segments are compacted") {
+    MappedFileCache
+        cache(spdlog::default_logger(), TEST_DIRECTORY, 10, 0, 8 * 1024);
+    storeEntries(cache, 40);
+
+    // Pruning starts compacting segments in the background, which copies the
+    // entries without holding the lock while they are replaced.
+    REQUIRE(cache.prune());
+    for (size_t i = 0; i < 40; ++i) {
+      REQUIRE(cache.storeEntry(
+          "TestKey" + std::to_string(i),
+          std::time(nullptr) + 1000,
+          "test.com/" + std::to_string(i),
+          "GET",
+          HttpHeaders{},
+          200,
+          HttpHeaders{},
+          createResponseData(1024, i + 100)));
+    }
+    cache.compact();
+
+    for (size_t i = 0; i < 40; ++i) {
+      std::optional<CacheItem> item =
+          cache.getEntry("TestKey" + std::to_string(i));
+      REQUIRE(item);
+      const gsl::span<const std::byte> data = item->cacheResponse.getData();
+      REQUIRE(
+          std::vector<std::byte>(data.begin(), data.end()) ==
+          createResponseData(1024, i + 100));
+    }
+  }
+
+  SECTION("Clears all entries") {
+    MappedFileCache cache(spdlog::default_logger(), TEST_DIRECTORY);
+    storeEntries(cache, 10);
+    REQUIRE(cache.clearAll());
+    REQUIRE(countEntries(cache, 10) == 0);
+    REQUIRE(countSegments() == 0);
+
+    storeEntries(cache, 1);
+    REQUIRE(countEntries(cache, 1) == 1);
+  }
+}
+
+// Compares looking up random entries in a memory-mapped file cache and in a
+// SQLite cache that both hold 100,000 entries. Run with
+// `cesium-native-tests "[benchmark]"`.
+TEST_CASE(
+    "Memory-mapped file cache compared to SqliteCache",
+    "[.][benchmark]") {
+  const size_t entryCount = 100000;
+  const size_t lookupCount = 10000;
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<size_t> distribution(0, entryCount - 1);
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < lookupCount; ++i) {
+    keys.emplace_back("TestKey" + std::to_string(distribution(random)));
+  }
+
+  const auto lookUp = [&keys](const ICacheDatabase& cache) {
+    size_t bytes = 0;
+    for (const std::string& key : keys) {
+      std::optional<CacheItem> cacheItem = cache.getEntry(key);
+      if (cacheItem) {
+        bytes += cacheItem->cacheResponse.getData().size();
+      }
+    }
+    return bytes;
+  };
+
+  std::filesystem::remove_all(TEST_DIRECTORY);
+  MappedFileCache mappedFileCache(
+      spdlog::default_logger(),
+      TEST_DIRECTORY,
+      entryCount);
+  SqliteCache sqliteCache(spdlog::default_logger(), "benchmark.db", entryCount);
+  REQUIRE(sqliteCache.clearAll());
+
+  storeEntries(mappedFileCache, entryCount);
+  storeEntries(sqliteCache, entryCount);
+
+  BENCHMARK("MappedFileCache, 10000 random lookups") {
+    return lookUp(mappedFileCache);
+  };
+
+  BENCHMARK("SqliteCache, 10000 random lookups") {
+    return lookUp(sqliteCache);
+  };
+}
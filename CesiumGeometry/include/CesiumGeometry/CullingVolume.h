@@ -2,10 +2,13 @@
 
 #include "Plane.h"
 
+#include <optional>
+
 namespace Cesium3DTilesSelection {
 
 /**
- * @brief A culling volume, defined by four planes.
+ * @brief A culling volume, defined by four side planes and optional near and
+ * far planes.
  *
  * The planes describe the culling volume that may be created for
  * the view frustum of a camera. The normals of these planes will
@@ -40,6 +43,22 @@ struct CullingVolume final {
    * Defaults to (0,0,1), with a distance of 0.
    */
   CesiumGeometry::Plane bottomPlane{glm::dvec3(0.0, 0.0, 1.0), 0.0};
+
+  /**
+   * @brief The near plane of the culling volume, if any.
+   *
+   * When this does not have a value, the culling volume is not bounded
+   * towards the eye position, other than by the side planes.
+   */
+  std::optional<CesiumGeometry::Plane> nearPlane;
+
+  /**
+   * @brief The far plane of the culling volume, if any.
+   *
+   * When this does not have a value, the culling volume extends infinitely
+   * far in the viewing direction.
+   */
+  std::optional<CesiumGeometry::Plane> farPlane;
 };
 
 /**
@@ -50,6 +69,10 @@ struct CullingVolume final {
  * @param up The up-vector of the frustum
  * @param fovx The horizontal Field-Of-View angle, in radians
  * @param fovy The vertical Field-Of-View angle, in radians
+ * @param nearDistance The distance from the eye position to the near plane,
+ * or `std::nullopt` to create a culling volume without a near plane.
+ * @param farDistance The distance from the eye position to the far plane,
+ * or `std::nullopt` to create a culling volume without a far plane.
  * @return The {@link CullingVolume}
  */
 CullingVolume createCullingVolume(
@@ -57,5 +80,7 @@ CullingVolume createCullingVolume(
     const glm::dvec3& direction,
     const glm::dvec3& up,
     double fovx,
-    double fovy) noexcept;
+    double fovy,
+    const std::optional<double>& nearDistance = std::nullopt,
+    const std::optional<double>& farDistance = std::nullopt) noexcept;
 } // namespace Cesium3DTilesSelection
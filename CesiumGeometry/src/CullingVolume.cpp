@@ -11,7 +11,9 @@ CullingVolume createCullingVolume(
     const glm::dvec3& direction,
     const glm::dvec3& up,
     const double fovx,
-    const double fovy) noexcept {
+    const double fovy,
+    const std::optional<double>& nearDistance,
+    const std::optional<double>& farDistance) noexcept {
   const double t = glm::tan(0.5 * fovy);
   const double b = -t;
   const double r = glm::tan(0.5 * fovx);
@@ -64,6 +66,26 @@ CullingVolume createCullingVolume(
 
   const CesiumGeometry::Plane topPlane(normal, -glm::dot(normal, position));
 
-  return {leftPlane, rightPlane, topPlane, bottomPlane};
+  CullingVolume result{
+      leftPlane,
+      rightPlane,
+      topPlane,
+      bottomPlane,
+      std::nullopt,
+      std::nullopt};
+
+  const glm::dvec3 forward = glm::normalize(direction);
+
+  if (nearDistance) {
+    const glm::dvec3 nearPoint = position + forward * nearDistance.value();
+    result.nearPlane.emplace(forward, -glm::dot(forward, nearPoint));
+  }
+
+  if (farDistance) {
+    const glm::dvec3 farPoint = position + forward * farDistance.value();
+    result.farPlane.emplace(-forward, glm::dot(forward, farPoint));
+  }
+
+  return result;
 }
 } // namespace Cesium3DTilesSelection
@@ -215,7 +215,7 @@ private:
       return;
     }
 
-    const std::vector<std::byte>& data = pBuffer->cesium.data;
+    const gsl::span<const std::byte> data = pBuffer->cesium.getData();
     const int64_t bufferBytes = int64_t(data.size());
     if (pBufferView->byteOffset + pBufferView->byteLength > bufferBytes) {
       this->_status = AccessorViewStatus::BufferTooSmall;
@@ -246,7 +246,7 @@ private:
       return;
     }
 
-    this->_pData = pBuffer->cesium.data.data();
+    this->_pData = data.data();
     this->_stride = accessorByteStride;
     this->_offset = accessor.byteOffset + pBufferView->byteOffset;
     this->_size = accessor.count;
@@ -2,7 +2,10 @@
 
 #include "Library.h"
 
+#include <gsl/span>
+
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace CesiumGltf {
@@ -12,8 +15,46 @@ namespace CesiumGltf {
  */
 struct CESIUMGLTF_API BufferCesium final {
   /**
-   * @brief The buffer's data.
+   * @brief Gets the buffer's data, whether it is owned by the buffer or not.
+   */
+  gsl::span<const std::byte> getData() const noexcept {
+    if (this->pExternalDataOwner) {
+      return this->externalData;
+    }
+    return gsl::span<const std::byte>(this->data.data(), this->data.size());
+  }
+
+  /**
+   * @brief Gets the buffer's data to modify it.
+   *
+   * If the data is not owned by the buffer, it is first copied into
+   * {@link data}, and the {@link pExternalDataOwner} is released.
+   */
+  std::vector<std::byte>& getMutableData() {
+    if (this->pExternalDataOwner) {
+      this->data.assign(this->externalData.begin(), this->externalData.end());
+      this->externalData = gsl::span<const std::byte>();
+      this->pExternalDataOwner.reset();
+    }
+    return this->data;
+  }
+
+  /**
+   * @brief The buffer's data, if it is owned by the buffer.
    */
   std::vector<std::byte> data;
+
+  /**
+   * @brief The buffer's data, if it is not owned by the buffer, such as the
+   * binary chunk of a GLB that is still held by the response it was read
+   * from. It remains valid while {@link pExternalDataOwner} is alive.
+   */
+  gsl::span<const std::byte> externalData;
+
+  /**
+   * @brief The object that keeps {@link externalData} alive, or `nullptr` if
+   * the data is in {@link data}.
+   */
+  std::shared_ptr<const void> pExternalDataOwner;
 };
 } // namespace CesiumGltf
@@ -7,6 +7,84 @@
 #include <vector>
 
 namespace CesiumGltf {
+
+/**
+ * @brief The GPU compressed pixel formats in which an {@link ImageCesium} may
+ * be kept, so that it is uploaded to the GPU without being decoded.
+ *
+ * The blocks of each format are stored in the order of the corresponding
+ * Vulkan, Direct3D or OpenGL format, without padding between rows of blocks.
+ */
+enum class GpuCompressedPixelFormat : int32_t {
+  /**
+   * @brief The image is not compressed; it is described by
+   * {@link ImageCesium::channels} and {@link ImageCesium::bytesPerChannel}.
+   */
+  NONE,
+
+  /**
+   * @brief ETC2 with red, green and blue, in 8 bytes per 4x4 block.
+   */
+  ETC2_RGB,
+
+  /**
+   * @brief ETC2 with red, green, blue and alpha, in 16 bytes per 4x4 block.
+   */
+  ETC2_RGBA,
+
+  /**
+   * @brief BC1 (DXT1) with red, green and blue, in 8 bytes per 4x4 block.
+   */
+  BC1_RGB,
+
+  /**
+   * @brief BC1 (DXT1) with red, green, blue and a 1-bit alpha, in 8 bytes per
+   * 4x4 block.
+   */
+  BC1_RGBA,
+
+  /**
+   * @brief BC3 (DXT5) with red, green, blue and alpha, in 16 bytes per 4x4
+   * block.
+   */
+  BC3_RGBA,
+
+  /**
+   * @brief BC4 with red, in 8 bytes per 4x4 block.
+   */
+  BC4_R,
+
+  /**
+   * @brief BC5 with red and green, in 16 bytes per 4x4 block.
+   */
+  BC5_RG,
+
+  /**
+   * @brief BC7 with red, green, blue and alpha, in 16 bytes per 4x4 block.
+   */
+  BC7_RGBA,
+
+  /**
+   * @brief ASTC with red, green, blue and alpha, in 16 bytes per 4x4 block.
+   */
+  ASTC_4x4_RGBA
+};
+
+/**
+ * @brief The position of a mip level in the {@link ImageCesium::pixelData}.
+ */
+struct CESIUMGLTF_API ImageCesiumMipPosition final {
+  /**
+   * @brief The offset of the first byte of the level.
+   */
+  size_t byteOffset = 0;
+
+  /**
+   * @brief The number of bytes in the level.
+   */
+  size_t byteSize = 0;
+};
+
 /**
  * @brief Holds {@link Image} properties that are specific to the glTF loader
  * rather than part of the glTF spec.
@@ -32,15 +110,51 @@ struct CESIUMGLTF_API ImageCesium final {
    */
   int32_t bytesPerChannel = 1;
 
+  /**
+   * @brief The GPU compressed format of the {@link pixelData}, or
+   * {@link GpuCompressedPixelFormat::NONE} if it is not compressed.
+   *
+   * A compressed image is only produced by an image decoder that is
+   * registered with the {@link ImageDecoderRegistry}, and it must be uploaded
+   * to the GPU as it is. Its {@link channels} and {@link bytesPerChannel}
+   * have no meaning, and it cannot be manipulated on the CPU.
+   */
+  GpuCompressedPixelFormat compressedPixelFormat =
+      GpuCompressedPixelFormat::NONE;
+
+  /**
+   * @brief Whether the image file declares the color channels of the
+   * {@link pixelData} to be sRGB encoded.
+   *
+   * This is only set by the image decoders of formats that declare a transfer
+   * function, such as the sRGB formats of KTX2 and DDS images, which must be
+   * uploaded to the GPU with the matching sRGB format. It is `false` for
+   * images whose files do not say, such as PNG and JPEG images.
+   */
+  bool isSrgb = false;
+
+  /**
+   * @brief The positions of the mip levels in the {@link pixelData}, starting
+   * with the full-size level 0.
+   *
+   * Level `i` has a width of `max(1, width >> i)` and a height of
+   * `max(1, height >> i)`. If this is empty, the image has a single level
+   * that spans the whole {@link pixelData}.
+   */
+  std::vector<ImageCesiumMipPosition> mipPositions;
+
   /**
    * @brief The raw pixel data.
    *
    * The pixel data is consistent with the
    * [stb](https://github.com/nothings/stb) image library.
    *
-   * For a correctly-formed image, the size of the array will be
-   * `width * height * channels * bytesPerChannel` bytes. There is no
-   * padding between rows or columns of the image, regardless of format.
+   * For a correctly-formed uncompressed image with a single level, the size
+   * of the array will be `width * height * channels * bytesPerChannel` bytes.
+   * There is no padding between rows or columns of the image, regardless of
+   * format. A compressed image holds the blocks of the
+   * {@link compressedPixelFormat} instead, and an image with
+   * {@link mipPositions} holds all of its levels.
    *
    * The channels and their meaning are as follows:
    *
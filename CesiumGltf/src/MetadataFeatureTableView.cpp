@@ -127,13 +127,14 @@ MetadataPropertyViewStatus MetadataFeatureTableView::getBufferSafe(
     return MetadataPropertyViewStatus::InvalidBufferViewNotAligned8Bytes;
   }
 
+  const gsl::span<const std::byte> data = pBuffer->cesium.getData();
   if (pBufferView->byteOffset + pBufferView->byteLength >
-      static_cast<int64_t>(pBuffer->cesium.data.size())) {
+      static_cast<int64_t>(data.size())) {
     return MetadataPropertyViewStatus::InvalidBufferViewOutOfBound;
   }
 
-  buffer = gsl::span<const std::byte>(
-      pBuffer->cesium.data.data() + pBufferView->byteOffset,
+  buffer = data.subspan(
+      static_cast<size_t>(pBufferView->byteOffset),
       static_cast<size_t>(pBufferView->byteLength));
   return MetadataPropertyViewStatus::Valid;
 }
@@ -205,6 +205,137 @@ CesiumJsonReader::IJsonHandler* MeshPrimitiveEXT_feature_metadataJsonHandler::
 }
 // This file was generated by generate-classes.
 // DO NOT EDIT THIS FILE!
+#include "BufferViewEXT_meshopt_compressionJsonHandler.h"
+
+#include <CesiumGltf/BufferViewEXT_meshopt_compression.h>
+
+#include <cassert>
+#include <string>
+
+using namespace CesiumGltf;
+
+BufferViewEXT_meshopt_compressionJsonHandler::BufferViewEXT_meshopt_compressionJsonHandler(
+    const CesiumJsonReader::ExtensionReaderContext& context) noexcept
+    : CesiumJsonReader::ExtensibleObjectJsonHandler(context),
+      _buffer(),
+      _byteOffset(),
+      _byteLength(),
+      _byteStride(),
+      _count(),
+      _mode(),
+      _filter() {}
+
+void BufferViewEXT_meshopt_compressionJsonHandler::reset(
+    CesiumJsonReader::IJsonHandler* pParentHandler,
+    BufferViewEXT_meshopt_compression* pObject) {
+  CesiumJsonReader::ExtensibleObjectJsonHandler::reset(pParentHandler, pObject);
+  this->_pObject = pObject;
+}
+
+CesiumJsonReader::IJsonHandler*
+BufferViewEXT_meshopt_compressionJsonHandler::readObjectKey(
+    const std::string_view& str) {
+  assert(this->_pObject);
+  return this->readObjectKeyBufferViewEXT_meshopt_compression(
+      BufferViewEXT_meshopt_compression::TypeName,
+      str,
+      *this->_pObject);
+}
+
+void BufferViewEXT_meshopt_compressionJsonHandler::reset(
+    CesiumJsonReader::IJsonHandler* pParentHandler,
+    CesiumUtility::ExtensibleObject& o,
+    const std::string_view& extensionName) {
+  std::any& value =
+      o.extensions.emplace(extensionName, BufferViewEXT_meshopt_compression())
+          .first->second;
+  this->reset(
+      pParentHandler,
+      &std::any_cast<BufferViewEXT_meshopt_compression&>(value));
+}
+
+CesiumJsonReader::IJsonHandler*
+BufferViewEXT_meshopt_compressionJsonHandler::readObjectKeyBufferViewEXT_meshopt_compression(
+    const std::string& objectType,
+    const std::string_view& str,
+    BufferViewEXT_meshopt_compression& o) {
+  using namespace std::string_literals;
+
+  if ("buffer"s == str)
+    return property("buffer", this->_buffer, o.buffer);
+  if ("byteOffset"s == str)
+    return property("byteOffset", this->_byteOffset, o.byteOffset);
+  if ("byteLength"s == str)
+    return property("byteLength", this->_byteLength, o.byteLength);
+  if ("byteStride"s == str)
+    return property("byteStride", this->_byteStride, o.byteStride);
+  if ("count"s == str)
+    return property("count", this->_count, o.count);
+  if ("mode"s == str)
+    return property("mode", this->_mode, o.mode);
+  if ("filter"s == str)
+    return property("filter", this->_filter, o.filter);
+
+  return this->readObjectKeyExtensibleObject(objectType, str, *this->_pObject);
+}
+// This file was generated by generate-classes.
+// DO NOT EDIT THIS FILE!
+#include "BufferEXT_meshopt_compressionJsonHandler.h"
+
+#include <CesiumGltf/BufferEXT_meshopt_compression.h>
+
+#include <cassert>
+#include <string>
+
+using namespace CesiumGltf;
+
+BufferEXT_meshopt_compressionJsonHandler::BufferEXT_meshopt_compressionJsonHandler(
+    const CesiumJsonReader::ExtensionReaderContext& context) noexcept
+    : CesiumJsonReader::ExtensibleObjectJsonHandler(context), _fallback() {}
+
+void BufferEXT_meshopt_compressionJsonHandler::reset(
+    CesiumJsonReader::IJsonHandler* pParentHandler,
+    BufferEXT_meshopt_compression* pObject) {
+  CesiumJsonReader::ExtensibleObjectJsonHandler::reset(pParentHandler, pObject);
+  this->_pObject = pObject;
+}
+
+CesiumJsonReader::IJsonHandler*
+BufferEXT_meshopt_compressionJsonHandler::readObjectKey(
+    const std::string_view& str) {
+  assert(this->_pObject);
+  return this->readObjectKeyBufferEXT_meshopt_compression(
+      BufferEXT_meshopt_compression::TypeName,
+      str,
+      *this->_pObject);
+}
+
+void BufferEXT_meshopt_compressionJsonHandler::reset(
+    CesiumJsonReader::IJsonHandler* pParentHandler,
+    CesiumUtility::ExtensibleObject& o,
+    const std::string_view& extensionName) {
+  std::any& value =
+      o.extensions.emplace(extensionName, BufferEXT_meshopt_compression())
+          .first->second;
+  this->reset(
+      pParentHandler,
+      &std::any_cast<BufferEXT_meshopt_compression&>(value));
+}
+
+CesiumJsonReader::IJsonHandler*
+BufferEXT_meshopt_compressionJsonHandler::readObjectKeyBufferEXT_meshopt_compression(
+    const std::string& objectType,
+    const std::string_view& str,
+    BufferEXT_meshopt_compression& o) {
+  using namespace std::string_literals;
+
+  if ("fallback"s == str)
+    return property("fallback", this->_fallback, o.fallback);
+
+  return this->readObjectKeyExtensibleObject(objectType, str, *this->_pObject);
+}
+// This file was generated by generate-classes.
+// DO NOT EDIT THIS FILE!
 #include "FeatureIDTextureJsonHandler.h"
 
 #include <CesiumGltf/FeatureIDTexture.h>
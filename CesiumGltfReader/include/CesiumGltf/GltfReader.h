@@ -1,7 +1,12 @@
 #pragma once
 
+#include "ImageDecoderRegistry.h"
+#include "ImageReaderResult.h"
+#include "ReadImageOptions.h"
 #include "ReaderLibrary.h"
 
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/Future.h>
 #include <CesiumGltf/Model.h>
 #include <CesiumJsonReader/ExtensionReaderContext.h>
 #include <CesiumJsonReader/IExtensionJsonHandler.h>
@@ -39,30 +44,6 @@ struct CESIUMGLTFREADER_API ModelReaderResult {
   std::vector<std::string> warnings;
 };
 
-/**
- * @brief The result of reading an image with
- * {@link GltfReader::readImage}.
- */
-struct CESIUMGLTFREADER_API ImageReaderResult {
-
-  /**
-   * @brief The {@link ImageCesium} that was read.
-   *
-   * This will be `std::nullopt` if the image could not be read.
-   */
-  std::optional<ImageCesium> image;
-
-  /**
-   * @brief Error messages that occurred while trying to read the image.
-   */
-  std::vector<std::string> errors;
-
-  /**
-   * @brief Warning messages that occurred while reading the image.
-   */
-  std::vector<std::string> warnings;
-};
-
 /**
  * @brief Options for how to read a glTF.
  */
@@ -91,11 +72,36 @@ struct CESIUMGLTFREADER_API ReadModelOptions {
    */
   bool decodeEmbeddedImages = true;
 
+  /**
+   * @brief Options for how the images that are decoded as part of the load
+   * process are read.
+   */
+  ReadImageOptions imageOptions;
+
   /**
    * @brief Whether geometry compressed using the `KHR_draco_mesh_compression`
    * extension should be automatically decoded as part of the load process.
    */
   bool decodeDraco = true;
+
+  /**
+   * @brief Whether buffer views compressed using the `EXT_meshopt_compression`
+   * extension should be automatically decoded as part of the load process.
+   *
+   * The decoded data is stored in the fallback buffer of each buffer view.
+   */
+  bool decodeMeshopt = true;
+
+  /**
+   * @brief Whether the first buffer of a GLB may refer to the binary chunk of
+   * the input instead of copying it.
+   *
+   * This only applies when the input is read with an owner that keeps it
+   * alive, see {@link GltfReader::readModel}. The data of such a buffer is in
+   * {@link BufferCesium::externalData} rather than {@link BufferCesium::data},
+   * so it must be read with {@link BufferCesium::getData}.
+   */
+  bool referenceBinaryChunk = false;
 };
 
 /**
@@ -120,6 +126,18 @@ public:
    */
   const CesiumJsonReader::ExtensionReaderContext& getExtensions() const;
 
+  /**
+   * @brief Gets the image decoders that {@link readImage} uses instead of
+   * stb_image, such as the decoders of GPU compressed images.
+   */
+  ImageDecoderRegistry& getImageDecoders();
+
+  /**
+   * @brief Gets the image decoders that {@link readImage} uses instead of
+   * stb_image, such as the decoders of GPU compressed images.
+   */
+  const ImageDecoderRegistry& getImageDecoders() const;
+
   /**
    * @brief Reads a glTF or binary glTF (GLB) from a buffer.
    *
@@ -131,19 +149,79 @@ public:
       const gsl::span<const std::byte>& data,
       const ReadModelOptions& options = ReadModelOptions()) const;
 
+  /**
+   * @brief Reads a glTF or binary glTF (GLB) from a buffer that is kept alive
+   * by the given owner.
+   *
+   * If {@link ReadModelOptions::referenceBinaryChunk} is set, the binary chunk
+   * of a GLB is not copied. Instead, the first buffer of the model refers to
+   * it with {@link BufferCesium::externalData} and keeps the owner alive,
+   * until the buffer is modified through {@link BufferCesium::getMutableData}.
+   * The binary chunk is only copied if it is not aligned to 8 bytes.
+   *
+   * @param data The buffer from which to read the glTF.
+   * @param pDataOwner The object that keeps the `data` alive, such as the
+   * request that holds it. If `nullptr`, the binary chunk is copied.
+   * @param options Options for how to read the glTF.
+   * @return The result of reading the glTF.
+   */
+  ModelReaderResult readModel(
+      const gsl::span<const std::byte>& data,
+      const std::shared_ptr<const void>& pDataOwner,
+      const ReadModelOptions& options = ReadModelOptions()) const;
+
+  /**
+   * @brief Reads a glTF or binary glTF (GLB) from a buffer, and decodes its
+   * embedded images and its Draco meshes in worker threads.
+   *
+   * The glTF is parsed, and its data URLs are decoded, in the calling thread.
+   * Then each embedded image and each primitive compressed with
+   * `KHR_draco_mesh_compression` is decoded in a separate worker thread, so
+   * that a model with many images is not decoded by a single thread. The
+   * result is the same as the result of {@link readModel}.
+   *
+   * The `data` is only used before this method returns, unless the model
+   * refers to the binary chunk of a GLB because a `pDataOwner` is given and
+   * {@link ReadModelOptions::referenceBinaryChunk} is set. This reader must
+   * remain valid until the returned future resolves.
+   *
+   * @param asyncSystem The async system whose worker threads decode the images
+   * and meshes.
+   * @param data The buffer from which to read the glTF.
+   * @param pDataOwner The object that keeps the `data` alive, or `nullptr` to
+   * copy the binary chunk of a GLB.
+   * @param options Options for how to read the glTF.
+   * @return A future that resolves to the result of reading the glTF.
+   */
+  CesiumAsync::Future<ModelReaderResult> readModelAsync(
+      const CesiumAsync::AsyncSystem& asyncSystem,
+      const gsl::span<const std::byte>& data,
+      const std::shared_ptr<const void>& pDataOwner = nullptr,
+      const ReadModelOptions& options = ReadModelOptions()) const;
+
   /**
    * @brief Reads an image from a buffer.
    *
-   * The [stb_image](https://github.com/nothings/stb) library is used to decode
+   * If an {@link ImageDecoder} is registered with the
+   * {@link getImageDecoders} of this reader for the magic header or the MIME
+   * type of the image, it is used. Otherwise, the
+   * [stb_image](https://github.com/nothings/stb) library is used to decode
    * images in `JPG`, `PNG`, `TGA`, `BMP`, `PSD`, `GIF`, `HDR`, or `PIC` format.
    *
    * @param data The buffer from which to read the image.
+   * @param options Options for how to read the image.
+   * @param mimeType The MIME type of the image, or an empty string if it is
+   * not known.
    * @return The result of reading the image.
    */
-  ImageReaderResult readImage(const gsl::span<const std::byte>& data) const;
+  ImageReaderResult readImage(
+      const gsl::span<const std::byte>& data,
+      const ReadImageOptions& options = ReadImageOptions(),
+      const std::string& mimeType = std::string()) const;
 
 private:
   CesiumJsonReader::ExtensionReaderContext _context;
+  ImageDecoderRegistry _imageDecoders;
 };
 
 } // namespace CesiumGltf
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ImageReaderResult.h"
+#include "ReadImageOptions.h"
+#include "ReaderLibrary.h"
+
+#include <gsl/span>
+
+#include <cstddef>
+#include <string>
+#include <typeinfo>
+
+namespace CesiumGltf {
+
+/**
+ * @brief Decodes an image in a particular format, such as a faster decoder of
+ * JPEG images, or a reader of a GPU compressed format that keeps the image
+ * compressed.
+ *
+ * A decoder is used by {@link GltfReader::readImage} after it is registered
+ * with the {@link ImageDecoderRegistry} of the reader. It may be called from
+ * any thread, and from several threads at once.
+ */
+class CESIUMGLTFREADER_API ImageDecoder {
+public:
+  virtual ~ImageDecoder() noexcept = default;
+
+  /**
+   * @brief Decodes an image.
+   *
+   * @param data The buffer from which to read the image.
+   * @param options Options for how to read the image. A decoder of a GPU
+   * compressed format may ignore them.
+   * @return The result of reading the image.
+   */
+  virtual ImageReaderResult decode(
+      const gsl::span<const std::byte>& data,
+      const ReadImageOptions& options) const = 0;
+
+  /**
+   * @brief Gets a name that identifies the images that this decoder creates.
+   *
+   * It is part of {@link ImageDecoderRegistry::getFingerprint}. The default is
+   * the name of the class of the decoder. A decoder whose images depend on how
+   * it was constructed should include these settings in its name.
+   */
+  virtual std::string getName() const { return typeid(*this).name(); }
+};
+
+} // namespace CesiumGltf
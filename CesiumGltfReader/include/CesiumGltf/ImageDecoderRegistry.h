@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ImageDecoder.h"
+#include "ReaderLibrary.h"
+
+#include <gsl/span>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace CesiumGltf {
+
+/**
+ * @brief The {@link ImageDecoder} instances that a {@link GltfReader} uses in
+ * {@link GltfReader::readImage} instead of the built-in
+ * [stb_image](https://github.com/nothings/stb) decoder.
+ *
+ * Each reader has its own registry, see {@link GltfReader::getImageDecoders}.
+ * The decoders are registered based on the magic header or the MIME type of
+ * the image. The MIME type is the one declared by the glTF image or its data
+ * URL, or the content type of the network response of a raster overlay image.
+ *
+ * Like the extensions of the reader, the decoders are meant to be registered
+ * before the reader is used; registering a decoder while the reader reads
+ * images in other threads is not safe.
+ */
+class CESIUMGLTFREADER_API ImageDecoderRegistry final {
+public:
+  /**
+   * @brief Creates a registry without any decoders.
+   */
+  ImageDecoderRegistry();
+
+  /**
+   * @brief Registers the given decoder for the given magic header.
+   *
+   * The magic header is compared to the first bytes of the image. It may have
+   * any length; if several magic headers match, the longest one is used.
+   *
+   * @param magic The magic header.
+   * @param pDecoder The decoder of the images with the magic header.
+   */
+  void registerMagic(
+      const std::string& magic,
+      const std::shared_ptr<ImageDecoder>& pDecoder);
+
+  /**
+   * @brief Registers the given decoder for the given MIME type.
+   *
+   * The MIME type is compared without letter case and without any parameters
+   * after a `;`.
+   *
+   * @param mimeType The MIME type, such as `image/jpeg`.
+   * @param pDecoder The decoder of the images with the MIME type.
+   */
+  void registerMimeType(
+      const std::string& mimeType,
+      const std::shared_ptr<ImageDecoder>& pDecoder);
+
+  /**
+   * @brief Registers the decoders of the KTX2 and DDS containers, which keep
+   * the images in their GPU compressed form.
+   *
+   * The images read by them have a {@link ImageCesium::compressedPixelFormat}
+   * and {@link ImageCesium::mipPositions}, so they should only be registered
+   * when the `IPrepareRendererResources` of the renderer can upload
+   * such images. A KTX2 image with Basis Universal or another supercompression
+   * is not supported. The tiles of a raster overlay that are combined from
+   * several images, such as those of a tile map service, cannot be
+   * compressed; such images are left out of them.
+   */
+  void registerGpuCompressedDecoders();
+
+  /**
+   * @brief Gets the decoder of the given image.
+   *
+   * It first tries to find a decoder based on the magic header of the image,
+   * and then based on its MIME type.
+   *
+   * @param data The image.
+   * @param mimeType The MIME type of the image, or an empty string if it is
+   * not known.
+   * @return The decoder, or `nullptr` if no decoder is registered for the
+   * image.
+   */
+  std::shared_ptr<ImageDecoder> getDecoder(
+      const gsl::span<const std::byte>& data,
+      const std::string& mimeType) const;
+
+  /**
+   * @brief Gets a description of the registered decoders, which changes when
+   * decoders are registered for other images or replaced.
+   *
+   * It lists the magic headers and MIME types together with the
+   * {@link ImageDecoder::getName} of their decoders, so registries with the
+   * same kinds of decoders have the same fingerprint. It can be part of the
+   * key of cached data that was created from decoded images.
+   */
+  std::string getFingerprint() const;
+
+private:
+  std::map<std::string, std::shared_ptr<ImageDecoder>> _decodersByMagic;
+  std::unordered_map<std::string, std::shared_ptr<ImageDecoder>>
+      _decodersByMimeType;
+};
+
+} // namespace CesiumGltf
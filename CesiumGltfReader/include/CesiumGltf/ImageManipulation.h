@@ -72,8 +72,10 @@ public:
    *
    * The source and target images must have the same number of channels and same
    * bytes per channel. If scaling is required, they must also use exactly 1
-   * byte per channel. If any of these requirements are violated, this function
-   * will return false and will not change any target pixels.
+   * byte per channel. Neither image may have a
+   * {@link ImageCesium::compressedPixelFormat}. If any of these requirements
+   * are violated, this function will return false and will not change any
+   * target pixels.
    *
    * The provided rectangles are validated to ensure that they fall within the
    * range of the images. If they do not, this function will return false and
@@ -92,6 +94,26 @@ public:
       const PixelRectangle& targetPixels,
       const ImageCesium& source,
       const PixelRectangle& sourcePixels);
+
+  /**
+   * @brief Generates the mip levels of an image, down to 1x1 pixels.
+   *
+   * Each level is computed from the previous one with a 2x2 box filter. The
+   * levels are appended to the {@link ImageCesium::pixelData}, and their
+   * positions, starting with the full-size level, are stored in
+   * {@link ImageCesium::mipPositions}, so a renderer can upload them as they
+   * are instead of generating them.
+   *
+   * The image must have 1 byte per channel, must not be GPU compressed, and
+   * must not already have mip levels. If any of these requirements are
+   * violated, or if the image has fewer pixels than its size requires, this
+   * function will return false and will not change the image.
+   *
+   * @param image The image for which to generate mip levels.
+   * @returns True if the mip levels were generated, or false if the image is
+   * not supported.
+   */
+  static bool generateMipmaps(ImageCesium& image);
 };
 
 } // namespace CesiumGltf
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ReaderLibrary.h"
+
+#include <CesiumGltf/ImageCesium.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace CesiumGltf {
+
+/**
+ * @brief The result of reading an image with
+ * {@link GltfReader::readImage}.
+ */
+struct CESIUMGLTFREADER_API ImageReaderResult {
+
+  /**
+   * @brief The {@link ImageCesium} that was read.
+   *
+   * This will be `std::nullopt` if the image could not be read.
+   */
+  std::optional<ImageCesium> image;
+
+  /**
+   * @brief Error messages that occurred while trying to read the image.
+   */
+  std::vector<std::string> errors;
+
+  /**
+   * @brief Warning messages that occurred while reading the image.
+   */
+  std::vector<std::string> warnings;
+};
+
+} // namespace CesiumGltf
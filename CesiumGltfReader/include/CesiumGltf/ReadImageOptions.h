@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ReaderLibrary.h"
+
+namespace CesiumGltf {
+
+/**
+ * @brief Options for how to read an image with {@link GltfReader::readImage}.
+ */
+struct CESIUMGLTFREADER_API ReadImageOptions {
+  /**
+   * @brief Whether the image keeps the number of channels in the file.
+   *
+   * By default, every image is expanded to four channels: red, green, blue,
+   * and alpha. If this is `true`, an RGB image such as a JPEG keeps three
+   * channels, and a greyscale image keeps one or two, as described in
+   * {@link ImageCesium::pixelData}. This reduces the memory used by such
+   * images, but the renderer must support the resulting
+   * {@link ImageCesium::channels}.
+   */
+  bool preserveChannels = false;
+
+  /**
+   * @brief Whether an image with 16 bits per channel, such as a 16-bit PNG,
+   * keeps them.
+   *
+   * If this is `true`, such an image has an
+   * {@link ImageCesium::bytesPerChannel} of 2, and each channel is an
+   * unsigned 16-bit integer in the byte order of this machine. Otherwise, it
+   * is reduced to 8 bits per channel.
+   */
+  bool preserve16Bit = false;
+};
+
+} // namespace CesiumGltf
@@ -1,12 +1,18 @@
 #include "CesiumGltf/GltfReader.h"
 
+#include "BufferEXT_meshopt_compressionJsonHandler.h"
+#include "BufferViewEXT_meshopt_compressionJsonHandler.h"
+#include "CesiumGltf/ImageDecoderRegistry.h"
 #include "KHR_draco_mesh_compressionJsonHandler.h"
 #include "MeshPrimitiveEXT_feature_metadataJsonHandler.h"
 #include "ModelEXT_feature_metadataJsonHandler.h"
 #include "ModelJsonHandler.h"
 #include "decodeDataUrls.h"
 #include "decodeDraco.h"
+#include "decodeMeshopt.h"
 
+#include <CesiumGltf/BufferViewEXT_meshopt_compression.h>
+#include <CesiumGltf/KHR_draco_mesh_compression.h>
 #include <CesiumJsonReader/JsonHandler.h>
 #include <CesiumJsonReader/JsonReader.h>
 #include <CesiumUtility/Tracing.h>
@@ -15,9 +21,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_FAILURE_USERMSG
@@ -89,7 +100,8 @@ std::string toMagicString(uint32_t i) {
 
 ModelReaderResult readBinaryModel(
     const CesiumJsonReader::ExtensionReaderContext& context,
-    const gsl::span<const std::byte>& data) {
+    const gsl::span<const std::byte>& data,
+    const std::shared_ptr<const void>& pDataOwner) {
   CESIUM_TRACE("CesiumGltf::ModelReader::readBinaryModel");
 
   if (data.size() < sizeof(GlbHeader) + sizeof(ChunkHeader)) {
@@ -203,66 +215,116 @@ ModelReaderResult readBinaryModel(
       return result;
     }
 
-    buffer.cesium.data = std::vector<std::byte>(
-        binaryChunk.begin(),
-        binaryChunk.begin() + buffer.byteLength);
+    const gsl::span<const std::byte> bufferData =
+        binaryChunk.subspan(0, static_cast<size_t>(buffer.byteLength));
+
+    // The binary chunk is only referenced if it is aligned to 8 bytes, like
+    // an allocated copy, so that metadata of 8-byte types can be read in
+    // place.
+    if (pDataOwner &&
+        reinterpret_cast<std::uintptr_t>(bufferData.data()) % 8 == 0) {
+      buffer.cesium.externalData = bufferData;
+      buffer.cesium.pExternalDataOwner = pDataOwner;
+    } else {
+      buffer.cesium.data =
+          std::vector<std::byte>(bufferData.begin(), bufferData.end());
+    }
   }
 
   return result;
 }
 
+/**
+ * Decodes an embedded image of a model, and returns a function that stores
+ * the decoded image in the model. Like {@link decodeDracoPrimitive}, the
+ * decoding only reads the model.
+ */
+std::function<void(ModelReaderResult&)> decodeEmbeddedImage(
+    const GltfReader& reader,
+    const Model& model,
+    size_t imageIndex,
+    const ReadImageOptions& options) {
+  const Image& sourceImage = model.images[imageIndex];
+  const BufferView& bufferView =
+      Model::getSafe(model.bufferViews, sourceImage.bufferView);
+  const Buffer& buffer = Model::getSafe(model.buffers, bufferView.buffer);
+
+  const gsl::span<const std::byte> bufferSpan = buffer.cesium.getData();
+  if (bufferView.byteOffset + bufferView.byteLength >
+      static_cast<int64_t>(bufferSpan.size())) {
+    std::string message =
+        "Image bufferView's byte offset is " +
+        std::to_string(bufferView.byteOffset) + " and the byteLength is " +
+        std::to_string(bufferView.byteLength) + ", the result is " +
+        std::to_string(bufferView.byteOffset + bufferView.byteLength) +
+        ", which is more than the available " +
+        std::to_string(bufferSpan.size()) + " bytes.";
+    return [warning = std::move(message)](ModelReaderResult& readModel) {
+      readModel.warnings.emplace_back(warning);
+    };
+  }
+
+  const gsl::span<const std::byte> bufferViewSpan = bufferSpan.subspan(
+      static_cast<size_t>(bufferView.byteOffset),
+      static_cast<size_t>(bufferView.byteLength));
+
+  // The result is shared because std::function must be copyable, but it is
+  // only moved.
+  return [imageIndex,
+          pImageResult = std::make_shared<ImageReaderResult>(
+              reader.readImage(
+                  bufferViewSpan,
+                  options,
+                  sourceImage.mimeType.value_or(std::string())))](
+             ModelReaderResult& readModel) {
+    ImageReaderResult& imageResult = *pImageResult;
+    readModel.warnings.insert(
+        readModel.warnings.end(),
+        imageResult.warnings.begin(),
+        imageResult.warnings.end());
+    readModel.errors.insert(
+        readModel.errors.end(),
+        imageResult.errors.begin(),
+        imageResult.errors.end());
+
+    Image& image = readModel.model->images[imageIndex];
+    if (imageResult.image) {
+      image.cesium = std::move(imageResult.image.value());
+    } else {
+      if (image.mimeType) {
+        readModel.errors.emplace_back(
+            "Declared image MIME Type: " + image.mimeType.value());
+      } else {
+        readModel.errors.emplace_back("Image does not declare a MIME Type");
+      }
+    }
+  };
+}
+
 void postprocess(
     const GltfReader& reader,
     ModelReaderResult& readModel,
     const ReadModelOptions& options) {
-  Model& model = readModel.model.value();
+  const Model& model = readModel.model.value();
 
   if (options.decodeDataUrls) {
-    decodeDataUrls(reader, readModel, options.clearDecodedDataUrls);
+    decodeDataUrls(
+        reader,
+        readModel,
+        options.clearDecodedDataUrls,
+        options.imageOptions);
+  }
+
+  // The buffer views are decoded first, because the embedded images and the
+  // Draco primitives may be stored in them.
+  if (options.decodeMeshopt) {
+    decodeMeshopt(readModel);
   }
 
   if (options.decodeEmbeddedImages) {
     CESIUM_TRACE("CesiumGltf::decodeEmbeddedImages");
-    for (Image& image : model.images) {
-      const BufferView& bufferView =
-          Model::getSafe(model.bufferViews, image.bufferView);
-      const Buffer& buffer = Model::getSafe(model.buffers, bufferView.buffer);
-
-      if (bufferView.byteOffset + bufferView.byteLength >
-          static_cast<int64_t>(buffer.cesium.data.size())) {
-        readModel.warnings.emplace_back(
-            "Image bufferView's byte offset is " +
-            std::to_string(bufferView.byteOffset) + " and the byteLength is " +
-            std::to_string(bufferView.byteLength) + ", the result is " +
-            std::to_string(bufferView.byteOffset + bufferView.byteLength) +
-            ", which is more than the available " +
-            std::to_string(buffer.cesium.data.size()) + " bytes.");
-        continue;
-      }
-
-      const gsl::span<const std::byte> bufferSpan(buffer.cesium.data);
-      const gsl::span<const std::byte> bufferViewSpan = bufferSpan.subspan(
-          static_cast<size_t>(bufferView.byteOffset),
-          static_cast<size_t>(bufferView.byteLength));
-      ImageReaderResult imageResult = reader.readImage(bufferViewSpan);
-      readModel.warnings.insert(
-          readModel.warnings.end(),
-          imageResult.warnings.begin(),
-          imageResult.warnings.end());
-      readModel.errors.insert(
-          readModel.errors.end(),
-          imageResult.errors.begin(),
-          imageResult.errors.end());
-      if (imageResult.image) {
-        image.cesium = std::move(imageResult.image.value());
-      } else {
-        if (image.mimeType) {
-          readModel.errors.emplace_back(
-              "Declared image MIME Type: " + image.mimeType.value());
-        } else {
-          readModel.errors.emplace_back("Image does not declare a MIME Type");
-        }
-      }
+    for (size_t i = 0; i < model.images.size(); ++i) {
+      decodeEmbeddedImage(reader, model, i, options.imageOptions)(readModel);
     }
   }
 
@@ -271,9 +333,31 @@ void postprocess(
   }
 }
 
+using DecodeResult = std::function<void(ModelReaderResult&)>;
+
+/**
+ * Waits for decodes that run in worker threads, and then stores their results
+ * in the model, in the order of the decodes.
+ */
+CesiumAsync::Future<void> storeDecodeResults(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const std::shared_ptr<ModelReaderResult>& pResult,
+    std::vector<CesiumAsync::Future<DecodeResult>>&& decodes) {
+  if (decodes.empty()) {
+    return asyncSystem.createResolvedFuture();
+  }
+
+  return asyncSystem.all(std::move(decodes))
+      .thenImmediately([pResult](std::vector<DecodeResult>&& decoded) {
+        for (const DecodeResult& store : decoded) {
+          store(*pResult);
+        }
+      });
+}
+
 } // namespace
 
-GltfReader::GltfReader() : _context() {
+GltfReader::GltfReader() : _context(), _imageDecoders() {
   this->_context.registerExtension<
       MeshPrimitive,
       KHR_draco_mesh_compressionJsonHandler>();
@@ -283,6 +367,12 @@ GltfReader::GltfReader() : _context() {
   this->_context.registerExtension<
       MeshPrimitive,
       MeshPrimitiveEXT_feature_metadataJsonHandler>();
+
+  this->_context.registerExtension<
+      BufferView,
+      BufferViewEXT_meshopt_compressionJsonHandler>();
+  this->_context
+      .registerExtension<Buffer, BufferEXT_meshopt_compressionJsonHandler>();
 }
 
 CesiumJsonReader::ExtensionReaderContext& GltfReader::getExtensions() {
@@ -294,14 +384,34 @@ GltfReader::getExtensions() const {
   return this->_context;
 }
 
+ImageDecoderRegistry& GltfReader::getImageDecoders() {
+  return this->_imageDecoders;
+}
+
+const ImageDecoderRegistry& GltfReader::getImageDecoders() const {
+  return this->_imageDecoders;
+}
+
 ModelReaderResult GltfReader::readModel(
     const gsl::span<const std::byte>& data,
     const ReadModelOptions& options) const {
+  return this->readModel(data, nullptr, options);
+}
+
+ModelReaderResult GltfReader::readModel(
+    const gsl::span<const std::byte>& data,
+    const std::shared_ptr<const void>& pDataOwner,
+    const ReadModelOptions& options) const {
 
   const CesiumJsonReader::ExtensionReaderContext& context =
       this->getExtensions();
-  ModelReaderResult result = isBinaryGltf(data) ? readBinaryModel(context, data)
-                                                : readJsonModel(context, data);
+  ModelReaderResult result =
+      isBinaryGltf(data)
+          ? readBinaryModel(
+                context,
+                data,
+                options.referenceBinaryChunk ? pDataOwner : nullptr)
+          : readJsonModel(context, data);
 
   if (result.model) {
     postprocess(*this, result, options);
@@ -310,39 +420,138 @@ ModelReaderResult GltfReader::readModel(
   return result;
 }
 
-ImageReaderResult
-GltfReader::readImage(const gsl::span<const std::byte>& data) const {
+CesiumAsync::Future<ModelReaderResult> GltfReader::readModelAsync(
+    const CesiumAsync::AsyncSystem& asyncSystem,
+    const gsl::span<const std::byte>& data,
+    const std::shared_ptr<const void>& pDataOwner,
+    const ReadModelOptions& options) const {
+  ReadModelOptions parseOptions = options;
+  parseOptions.decodeEmbeddedImages = false;
+  parseOptions.decodeDraco = false;
+  parseOptions.decodeMeshopt = false;
+
+  ModelReaderResult result = this->readModel(data, pDataOwner, parseOptions);
+  if (!result.model) {
+    return asyncSystem.createResolvedFuture(std::move(result));
+  }
+
+  // The model is not modified while the workers decode it, so they can read
+  // it without synchronization.
+  const std::shared_ptr<ModelReaderResult> pResult =
+      std::make_shared<ModelReaderResult>(std::move(result));
+
+  // Like in readModel, the buffer views are decoded first, because the
+  // embedded images and the Draco primitives may be stored in them.
+  std::vector<CesiumAsync::Future<DecodeResult>> meshoptDecodes;
+  if (options.decodeMeshopt) {
+    const std::vector<BufferView>& bufferViews = pResult->model->bufferViews;
+    for (size_t i = 0; i < bufferViews.size(); ++i) {
+      if (bufferViews[i].getExtension<BufferViewEXT_meshopt_compression>()) {
+        meshoptDecodes.emplace_back(
+            asyncSystem.runInWorkerThread([pResult, i]() {
+              return decodeMeshoptBufferView(pResult->model.value(), i);
+            }));
+      }
+    }
+  }
+
+  return storeDecodeResults(asyncSystem, pResult, std::move(meshoptDecodes))
+      .thenImmediately([this, asyncSystem, pResult, options]() {
+        const Model& model = pResult->model.value();
+        std::vector<CesiumAsync::Future<DecodeResult>> decodes;
+
+        if (options.decodeEmbeddedImages) {
+          for (size_t i = 0; i < model.images.size(); ++i) {
+            decodes.emplace_back(asyncSystem.runInWorkerThread(
+                [this, pResult, i, imageOptions = options.imageOptions]() {
+                  return decodeEmbeddedImage(
+                      *this,
+                      pResult->model.value(),
+                      i,
+                      imageOptions);
+                }));
+          }
+        }
+
+        if (options.decodeDraco) {
+          for (size_t i = 0; i < model.meshes.size(); ++i) {
+            const std::vector<MeshPrimitive>& primitives =
+                model.meshes[i].primitives;
+            for (size_t j = 0; j < primitives.size(); ++j) {
+              if (primitives[j].getExtension<KHR_draco_mesh_compression>()) {
+                decodes.emplace_back(
+                    asyncSystem.runInWorkerThread([pResult, i, j]() {
+                      return decodeDracoPrimitive(pResult->model.value(), i, j);
+                    }));
+              }
+            }
+          }
+        }
+
+        // The decoded images and primitives are stored in the order in which
+        // readModel decodes them, so the result is the same.
+        return storeDecodeResults(asyncSystem, pResult, std::move(decodes));
+      })
+      .thenImmediately([pResult]() { return std::move(*pResult); });
+}
+
+ImageReaderResult GltfReader::readImage(
+    const gsl::span<const std::byte>& data,
+    const ReadImageOptions& options,
+    const std::string& mimeType) const {
   CESIUM_TRACE("CesiumGltf::readImage");
 
+  const std::shared_ptr<ImageDecoder> pDecoder =
+      this->_imageDecoders.getDecoder(data, mimeType);
+  if (pDecoder) {
+    return pDecoder->decode(data, options);
+  }
+
   ImageReaderResult result;
 
   result.image.emplace();
   ImageCesium& image = result.image.value();
 
-  image.bytesPerChannel = 1;
-  image.channels = 4;
+  const stbi_uc* pData = reinterpret_cast<const stbi_uc*>(data.data());
+  const int dataSize = static_cast<int>(data.size());
+
+  // stb_image keeps the number of channels in the file when zero channels are
+  // requested.
+  const int requestedChannels = options.preserveChannels ? 0 : 4;
+  const bool is16Bit =
+      options.preserve16Bit && stbi_is_16_bit_from_memory(pData, dataSize);
 
   int channelsInFile;
-  stbi_uc* pImage = stbi_load_from_memory(
-      reinterpret_cast<const stbi_uc*>(data.data()),
-      static_cast<int>(data.size()),
-      &image.width,
-      &image.height,
-      &channelsInFile,
-      image.channels);
+  void* pImage = nullptr;
+  if (is16Bit) {
+    pImage = stbi_load_16_from_memory(
+        pData,
+        dataSize,
+        &image.width,
+        &image.height,
+        &channelsInFile,
+        requestedChannels);
+  } else {
+    pImage = stbi_load_from_memory(
+        pData,
+        dataSize,
+        &image.width,
+        &image.height,
+        &channelsInFile,
+        requestedChannels);
+  }
+
   if (pImage) {
+    image.channels = options.preserveChannels ? channelsInFile : 4;
+    image.bytesPerChannel = is16Bit ? 2 : 1;
     CESIUM_TRACE(
         "copy image " + std::to_string(image.width) + "x" +
         std::to_string(image.height) + "x" + std::to_string(image.channels) +
         "x" + std::to_string(image.bytesPerChannel));
-    // std::uint8_t is not implicitly convertible to std::byte, so we must use
-    // reinterpret_cast to (safely) force the conversion.
-    const auto lastByte =
-        image.width * image.height * image.channels * image.bytesPerChannel;
-    image.pixelData.resize(static_cast<std::size_t>(lastByte));
-    std::uint8_t* u8Pointer =
-        reinterpret_cast<std::uint8_t*>(image.pixelData.data());
-    std::copy(pImage, pImage + lastByte, u8Pointer);
+    const size_t byteSize = static_cast<size_t>(
+        image.width * image.height * image.channels * image.bytesPerChannel);
+    image.pixelData.resize(byteSize);
+    std::memcpy(image.pixelData.data(), pImage, byteSize);
     stbi_image_free(pImage);
   } else {
     result.image.reset();
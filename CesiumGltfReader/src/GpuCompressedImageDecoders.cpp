@@ -0,0 +1,361 @@
+#include "GpuCompressedImageDecoders.h"
+
+#include <CesiumUtility/Tracing.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace CesiumGltf;
+
+namespace {
+
+template <typename T>
+T readValue(const gsl::span<const std::byte>& data, size_t offset) {
+  T value;
+  std::memcpy(&value, data.data() + offset, sizeof(T));
+  return value;
+}
+
+ImageReaderResult failure(const std::string& message) {
+  ImageReaderResult result;
+  result.errors.emplace_back(message);
+  return result;
+}
+
+/**
+ * Gets the number of bytes in a mip level of the given size, or 0 if the
+ * format is not compressed.
+ */
+size_t computeCompressedLevelSize(
+    GpuCompressedPixelFormat format,
+    uint32_t width,
+    uint32_t height) {
+  size_t bytesPerBlock = 0;
+  switch (format) {
+  case GpuCompressedPixelFormat::ETC2_RGB:
+  case GpuCompressedPixelFormat::BC1_RGB:
+  case GpuCompressedPixelFormat::BC1_RGBA:
+  case GpuCompressedPixelFormat::BC4_R:
+    bytesPerBlock = 8;
+    break;
+  case GpuCompressedPixelFormat::ETC2_RGBA:
+  case GpuCompressedPixelFormat::BC3_RGBA:
+  case GpuCompressedPixelFormat::BC5_RG:
+  case GpuCompressedPixelFormat::BC7_RGBA:
+  case GpuCompressedPixelFormat::ASTC_4x4_RGBA:
+    bytesPerBlock = 16;
+    break;
+  case GpuCompressedPixelFormat::NONE:
+    return 0;
+  }
+
+  const size_t blocksX = (size_t(width) + 3) / 4;
+  const size_t blocksY = (size_t(height) + 3) / 4;
+  return blocksX * blocksY * bytesPerBlock;
+}
+
+struct Level {
+  size_t byteOffset;
+  size_t byteSize;
+};
+
+struct ImageFormat {
+  GpuCompressedPixelFormat compressedPixelFormat;
+
+  // Whether the format declares the color channels to be sRGB encoded.
+  bool isSrgb;
+};
+
+/**
+ * Creates the image from the levels of the file, which must be in the order
+ * of the mip levels, after checking that every level has the expected size.
+ */
+ImageReaderResult createImage(
+    const gsl::span<const std::byte>& data,
+    uint32_t width,
+    uint32_t height,
+    const ImageFormat& imageFormat,
+    const std::vector<Level>& levels) {
+  const GpuCompressedPixelFormat format = imageFormat.compressedPixelFormat;
+
+  ImageReaderResult result;
+  ImageCesium& image = result.image.emplace();
+  image.width = static_cast<int32_t>(width);
+  image.height = static_cast<int32_t>(height);
+  image.channels = 4;
+  image.bytesPerChannel = 1;
+  image.compressedPixelFormat = format;
+  image.isSrgb = imageFormat.isSrgb;
+
+  size_t totalSize = 0;
+  for (size_t i = 0; i < levels.size(); ++i) {
+    const uint32_t levelWidth = std::max(width >> i, 1U);
+    const uint32_t levelHeight = std::max(height >> i, 1U);
+    const size_t expectedSize =
+        format == GpuCompressedPixelFormat::NONE
+            ? size_t(levelWidth) * size_t(levelHeight) * 4
+            : computeCompressedLevelSize(format, levelWidth, levelHeight);
+
+    const Level& level = levels[i];
+    if (level.byteSize < expectedSize ||
+        level.byteOffset > data.size() ||
+        data.size() - level.byteOffset < expectedSize) {
+      return failure(
+          "Mip level " + std::to_string(i) + " of the image has " +
+          std::to_string(level.byteSize) + " bytes, but it needs " +
+          std::to_string(expectedSize) + " bytes.");
+    }
+
+    image.mipPositions.push_back({totalSize, expectedSize});
+    totalSize += expectedSize;
+  }
+
+  CESIUM_TRACE("copy compressed image " + std::to_string(totalSize));
+  image.pixelData.resize(totalSize);
+  for (size_t i = 0; i < levels.size(); ++i) {
+    std::memcpy(
+        image.pixelData.data() + image.mipPositions[i].byteOffset,
+        data.data() + levels[i].byteOffset,
+        image.mipPositions[i].byteSize);
+  }
+
+  // A single level spans the whole pixel data.
+  if (image.mipPositions.size() == 1) {
+    image.mipPositions.clear();
+  }
+
+  return result;
+}
+
+std::optional<ImageFormat> getKtx2Format(uint32_t vkFormat) {
+  switch (vkFormat) {
+  case 37: // VK_FORMAT_R8G8B8A8_UNORM
+    return ImageFormat{GpuCompressedPixelFormat::NONE, false};
+  case 43: // VK_FORMAT_R8G8B8A8_SRGB
+    return ImageFormat{GpuCompressedPixelFormat::NONE, true};
+  case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC1_RGB, false};
+  case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC1_RGB, true};
+  case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC1_RGBA, false};
+  case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC1_RGBA, true};
+  case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC3_RGBA, false};
+  case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC3_RGBA, true};
+  case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC4_R, false};
+  case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC5_RG, false};
+  case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC7_RGBA, false};
+  case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::BC7_RGBA, true};
+  case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::ETC2_RGB, false};
+  case 148: // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::ETC2_RGB, true};
+  case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::ETC2_RGBA, false};
+  case 152: // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::ETC2_RGBA, true};
+  case 157: // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::ASTC_4x4_RGBA, false};
+  case 158: // VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+    return ImageFormat{GpuCompressedPixelFormat::ASTC_4x4_RGBA, true};
+  default:
+    return std::nullopt;
+  }
+}
+
+std::optional<ImageFormat> getDxgiFormat(uint32_t dxgiFormat) {
+  switch (dxgiFormat) {
+  case 71: // DXGI_FORMAT_BC1_UNORM
+    return ImageFormat{GpuCompressedPixelFormat::BC1_RGBA, false};
+  case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+    return ImageFormat{GpuCompressedPixelFormat::BC1_RGBA, true};
+  case 77: // DXGI_FORMAT_BC3_UNORM
+    return ImageFormat{GpuCompressedPixelFormat::BC3_RGBA, false};
+  case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+    return ImageFormat{GpuCompressedPixelFormat::BC3_RGBA, true};
+  case 80: // DXGI_FORMAT_BC4_UNORM
+    return ImageFormat{GpuCompressedPixelFormat::BC4_R, false};
+  case 83: // DXGI_FORMAT_BC5_UNORM
+    return ImageFormat{GpuCompressedPixelFormat::BC5_RG, false};
+  case 98: // DXGI_FORMAT_BC7_UNORM
+    return ImageFormat{GpuCompressedPixelFormat::BC7_RGBA, false};
+  case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+    return ImageFormat{GpuCompressedPixelFormat::BC7_RGBA, true};
+  default:
+    return std::nullopt;
+  }
+}
+
+// The FourCC codes do not declare a transfer function, so they are read as
+// linear, like the UNORM formats.
+std::optional<ImageFormat>
+getFourCCFormat(const gsl::span<const std::byte>& fourCC) {
+  const std::string code(reinterpret_cast<const char*>(fourCC.data()), 4);
+  if (code == "DXT1") {
+    return ImageFormat{GpuCompressedPixelFormat::BC1_RGBA, false};
+  }
+  if (code == "DXT5") {
+    return ImageFormat{GpuCompressedPixelFormat::BC3_RGBA, false};
+  }
+  if (code == "ATI1" || code == "BC4U") {
+    return ImageFormat{GpuCompressedPixelFormat::BC4_R, false};
+  }
+  if (code == "ATI2" || code == "BC5U") {
+    return ImageFormat{GpuCompressedPixelFormat::BC5_RG, false};
+  }
+  return std::nullopt;
+}
+
+constexpr size_t KTX2_HEADER_SIZE = 80;
+constexpr size_t KTX2_LEVEL_INDEX_ENTRY_SIZE = 24;
+constexpr size_t DDS_HEADER_SIZE = 128;
+constexpr size_t DDS_DX10_HEADER_SIZE = 20;
+constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+} // namespace
+
+namespace CesiumGltf {
+
+ImageReaderResult Ktx2ImageDecoder::decode(
+    const gsl::span<const std::byte>& data,
+    const ReadImageOptions& /*options*/) const {
+  CESIUM_TRACE("CesiumGltf::Ktx2ImageDecoder::decode");
+
+  if (data.size() < KTX2_HEADER_SIZE) {
+    return failure("The KTX2 image is too short for its header.");
+  }
+
+  const uint32_t vkFormat = readValue<uint32_t>(data, 12);
+  const uint32_t width = readValue<uint32_t>(data, 20);
+  const uint32_t height = readValue<uint32_t>(data, 24);
+  const uint32_t depth = readValue<uint32_t>(data, 28);
+  const uint32_t layerCount = readValue<uint32_t>(data, 32);
+  const uint32_t faceCount = readValue<uint32_t>(data, 36);
+  const uint32_t levelCount = std::max(readValue<uint32_t>(data, 40), 1U);
+  const uint32_t supercompressionScheme = readValue<uint32_t>(data, 44);
+
+  if (supercompressionScheme != 0) {
+    return failure(
+        "The KTX2 image uses supercompression scheme " +
+        std::to_string(supercompressionScheme) + ", which is not supported.");
+  }
+  if (depth > 1 || layerCount > 1 || faceCount > 1) {
+    return failure(
+        "The KTX2 image is a 3D, array or cubemap texture, which is not "
+        "supported.");
+  }
+  if (width == 0 || height == 0 || levelCount > 32) {
+    return failure("The KTX2 image has an invalid size.");
+  }
+
+  const std::optional<ImageFormat> format = getKtx2Format(vkFormat);
+  if (!format) {
+    return failure(
+        "The KTX2 image has the Vulkan format " + std::to_string(vkFormat) +
+        ", which is not supported.");
+  }
+
+  if (data.size() - KTX2_HEADER_SIZE <
+      size_t(levelCount) * KTX2_LEVEL_INDEX_ENTRY_SIZE) {
+    return failure("The KTX2 image is too short for its level index.");
+  }
+
+  std::vector<Level> levels(levelCount);
+  for (size_t i = 0; i < levels.size(); ++i) {
+    const size_t entryOffset =
+        KTX2_HEADER_SIZE + i * KTX2_LEVEL_INDEX_ENTRY_SIZE;
+    levels[i].byteOffset =
+        static_cast<size_t>(readValue<uint64_t>(data, entryOffset));
+    levels[i].byteSize =
+        static_cast<size_t>(readValue<uint64_t>(data, entryOffset + 8));
+  }
+
+  return createImage(data, width, height, *format, levels);
+}
+
+ImageReaderResult DdsImageDecoder::decode(
+    const gsl::span<const std::byte>& data,
+    const ReadImageOptions& /*options*/) const {
+  CESIUM_TRACE("CesiumGltf::DdsImageDecoder::decode");
+
+  if (data.size() < DDS_HEADER_SIZE) {
+    return failure("The DDS image is too short for its header.");
+  }
+
+  const uint32_t flags = readValue<uint32_t>(data, 8);
+  const uint32_t height = readValue<uint32_t>(data, 12);
+  const uint32_t width = readValue<uint32_t>(data, 16);
+  const uint32_t mipMapCount = readValue<uint32_t>(data, 28);
+  const gsl::span<const std::byte> fourCC = data.subspan(84, 4);
+  const uint32_t caps2 = readValue<uint32_t>(data, 112);
+
+  if ((caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) != 0) {
+    return failure(
+        "The DDS image is a cubemap or volume texture, which is not "
+        "supported.");
+  }
+
+  const uint32_t levelCount =
+      (flags & DDSD_MIPMAPCOUNT) != 0 ? std::max(mipMapCount, 1U) : 1U;
+  if (width == 0 || height == 0 || levelCount > 32) {
+    return failure("The DDS image has an invalid size.");
+  }
+
+  std::optional<ImageFormat> format;
+  size_t dataOffset = DDS_HEADER_SIZE;
+  if (std::memcmp(fourCC.data(), "DX10", 4) == 0) {
+    if (data.size() < DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE) {
+      return failure("The DDS image is too short for its DX10 header.");
+    }
+    const uint32_t dxgiFormat = readValue<uint32_t>(data, DDS_HEADER_SIZE);
+    const uint32_t arraySize = readValue<uint32_t>(data, DDS_HEADER_SIZE + 12);
+    if (arraySize > 1) {
+      return failure(
+          "The DDS image is an array texture, which is not supported.");
+    }
+    format = getDxgiFormat(dxgiFormat);
+    if (!format) {
+      return failure(
+          "The DDS image has the DXGI format " + std::to_string(dxgiFormat) +
+          ", which is not supported.");
+    }
+    dataOffset += DDS_DX10_HEADER_SIZE;
+  } else {
+    format = getFourCCFormat(fourCC);
+    if (!format) {
+      return failure(
+          "The DDS image has the FourCC code '" +
+          std::string(reinterpret_cast<const char*>(fourCC.data()), 4) +
+          "', which is not supported.");
+    }
+  }
+
+  // The levels follow each other, starting with the full-size level.
+  std::vector<Level> levels(levelCount);
+  size_t offset = dataOffset;
+  for (size_t i = 0; i < levels.size(); ++i) {
+    levels[i].byteOffset = offset;
+    levels[i].byteSize = computeCompressedLevelSize(
+        format->compressedPixelFormat,
+        std::max(width >> i, 1U),
+        std::max(height >> i, 1U));
+    offset += levels[i].byteSize;
+  }
+
+  return createImage(data, width, height, *format, levels);
+}
+
+} // namespace CesiumGltf
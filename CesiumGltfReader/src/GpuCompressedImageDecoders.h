@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CesiumGltf/ImageDecoder.h"
+
+#include <gsl/span>
+
+#include <cstddef>
+
+namespace CesiumGltf {
+
+/**
+ * Reads a KTX2 image with a BCn, ETC2 or ASTC 4x4 format without decoding it,
+ * or an uncompressed RGBA8 image, with all of its mip levels.
+ */
+class Ktx2ImageDecoder final : public ImageDecoder {
+public:
+  ImageReaderResult decode(
+      const gsl::span<const std::byte>& data,
+      const ReadImageOptions& options) const override;
+};
+
+/**
+ * Reads a DDS image with a BC1, BC3, BC4, BC5 or BC7 format without decoding
+ * it, with all of its mip levels.
+ */
+class DdsImageDecoder final : public ImageDecoder {
+public:
+  ImageReaderResult decode(
+      const gsl::span<const std::byte>& data,
+      const ReadImageOptions& options) const override;
+};
+
+} // namespace CesiumGltf
@@ -0,0 +1,115 @@
+#include "CesiumGltf/ImageDecoderRegistry.h"
+
+#include "GpuCompressedImageDecoders.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+namespace CesiumGltf {
+
+namespace {
+std::string getBaseMimeType(const std::string& mimeType) {
+  std::string baseMimeType = mimeType.substr(0, mimeType.find(';'));
+  std::transform(
+      baseMimeType.begin(),
+      baseMimeType.end(),
+      baseMimeType.begin(),
+      [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return baseMimeType;
+}
+} // namespace
+
+ImageDecoderRegistry::ImageDecoderRegistry()
+    : _decodersByMagic(), _decodersByMimeType() {}
+
+void ImageDecoderRegistry::registerMagic(
+    const std::string& magic,
+    const std::shared_ptr<ImageDecoder>& pDecoder) {
+  this->_decodersByMagic[magic] = pDecoder;
+}
+
+void ImageDecoderRegistry::registerMimeType(
+    const std::string& mimeType,
+    const std::shared_ptr<ImageDecoder>& pDecoder) {
+  this->_decodersByMimeType[getBaseMimeType(mimeType)] = pDecoder;
+}
+
+void ImageDecoderRegistry::registerGpuCompressedDecoders() {
+  std::shared_ptr<ImageDecoder> pKtx2Decoder =
+      std::make_shared<Ktx2ImageDecoder>();
+  this->registerMagic("\xABKTX 20\xBB\r\n\x1A\n", pKtx2Decoder);
+  this->registerMimeType("image/ktx2", pKtx2Decoder);
+
+  std::shared_ptr<ImageDecoder> pDdsDecoder =
+      std::make_shared<DdsImageDecoder>();
+  this->registerMagic("DDS ", pDdsDecoder);
+  this->registerMimeType("image/vnd-ms.dds", pDdsDecoder);
+}
+
+std::shared_ptr<ImageDecoder> ImageDecoderRegistry::getDecoder(
+    const gsl::span<const std::byte>& data,
+    const std::string& mimeType) const {
+  // Use the longest magic header that matches.
+  const std::shared_ptr<ImageDecoder>* ppMagicDecoder = nullptr;
+  size_t magicLength = 0;
+  for (const auto& pair : this->_decodersByMagic) {
+    const std::string& magic = pair.first;
+    if (magic.size() > magicLength && magic.size() <= data.size() &&
+        std::memcmp(data.data(), magic.data(), magic.size()) == 0) {
+      ppMagicDecoder = &pair.second;
+      magicLength = magic.size();
+    }
+  }
+  if (ppMagicDecoder) {
+    return *ppMagicDecoder;
+  }
+
+  if (mimeType.empty()) {
+    return nullptr;
+  }
+
+  auto itMimeType =
+      this->_decodersByMimeType.find(getBaseMimeType(mimeType));
+  if (itMimeType != this->_decodersByMimeType.end()) {
+    return itMimeType->second;
+  }
+
+  return nullptr;
+}
+
+std::string ImageDecoderRegistry::getFingerprint() const {
+  std::string fingerprint;
+  const auto append = [&fingerprint](
+                          const char* kind,
+                          const std::string& key,
+                          const std::shared_ptr<ImageDecoder>& pDecoder) {
+    fingerprint += kind;
+    fingerprint += key;
+    fingerprint += '=';
+    if (pDecoder) {
+      fingerprint += pDecoder->getName();
+    }
+    fingerprint += '\0';
+  };
+
+  for (const auto& pair : this->_decodersByMagic) {
+    append("magic:", pair.first, pair.second);
+  }
+
+  // Sort the MIME types, so that the order of registration does not matter.
+  std::vector<std::string> mimeTypes;
+  mimeTypes.reserve(this->_decodersByMimeType.size());
+  for (const auto& pair : this->_decodersByMimeType) {
+    mimeTypes.push_back(pair.first);
+  }
+  std::sort(mimeTypes.begin(), mimeTypes.end());
+  for (const std::string& mimeType : mimeTypes) {
+    append("mime:", mimeType, this->_decodersByMimeType.at(mimeType));
+  }
+
+  return fingerprint;
+}
+
+} // namespace CesiumGltf
@@ -2,14 +2,79 @@
 
 #include <CesiumGltf/ImageCesium.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <utility>
+#include <vector>
 
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include <stb_image_resize.h>
 
 using namespace CesiumGltf;
 
+namespace {
+
+/**
+ * Averages each 2x2 block of pixels in two source rows into one target pixel.
+ * The channel count is a template parameter so that the compiler unrolls the
+ * inner loop and vectorizes the outer one.
+ */
+template <size_t Channels>
+void downsampleRows(
+    const uint8_t* pRow0,
+    const uint8_t* pRow1,
+    uint8_t* pTarget,
+    size_t sourceWidth,
+    size_t targetWidth) {
+  // A source that is one pixel wide has a single column to average.
+  const size_t columnStep = sourceWidth > 1 ? Channels : 0;
+  for (size_t x = 0; x < targetWidth; ++x) {
+    const size_t i = 2 * x * Channels;
+    for (size_t c = 0; c < Channels; ++c) {
+      const uint32_t sum = uint32_t(pRow0[i + c]) +
+                           uint32_t(pRow0[i + columnStep + c]) +
+                           uint32_t(pRow1[i + c]) +
+                           uint32_t(pRow1[i + columnStep + c]);
+      pTarget[x * Channels + c] = uint8_t((sum + 2) >> 2);
+    }
+  }
+}
+
+void downsampleImage(
+    const uint8_t* pSource,
+    size_t sourceWidth,
+    size_t sourceHeight,
+    uint8_t* pTarget,
+    size_t targetWidth,
+    size_t targetHeight,
+    size_t channels) {
+  const size_t sourceRowStride = sourceWidth * channels;
+  const size_t targetRowStride = targetWidth * channels;
+  for (size_t y = 0; y < targetHeight; ++y) {
+    const uint8_t* pRow0 = pSource + 2 * y * sourceRowStride;
+    const uint8_t* pRow1 =
+        sourceHeight > 1 ? pRow0 + sourceRowStride : pRow0;
+    uint8_t* pTargetRow = pTarget + y * targetRowStride;
+    switch (channels) {
+    case 1:
+      downsampleRows<1>(pRow0, pRow1, pTargetRow, sourceWidth, targetWidth);
+      break;
+    case 2:
+      downsampleRows<2>(pRow0, pRow1, pTargetRow, sourceWidth, targetWidth);
+      break;
+    case 3:
+      downsampleRows<3>(pRow0, pRow1, pTargetRow, sourceWidth, targetWidth);
+      break;
+    default:
+      downsampleRows<4>(pRow0, pRow1, pTargetRow, sourceWidth, targetWidth);
+      break;
+    }
+  }
+}
+
+} // namespace
+
 void ImageManipulation::unsafeBlitImage(
     std::byte* pTarget,
     size_t targetRowStride,
@@ -40,6 +105,12 @@ bool ImageManipulation::blitImage(
     const ImageCesium& source,
     const PixelRectangle& sourcePixels) {
 
+  if (target.compressedPixelFormat != GpuCompressedPixelFormat::NONE ||
+      source.compressedPixelFormat != GpuCompressedPixelFormat::NONE) {
+    // The blocks of GPU compressed images cannot be copied as pixels.
+    return false;
+  }
+
   if (sourcePixels.x < 0 || sourcePixels.y < 0 || sourcePixels.width < 0 ||
       sourcePixels.height < 0 ||
       (sourcePixels.x + sourcePixels.width) > source.width ||
@@ -114,3 +185,59 @@ bool ImageManipulation::blitImage(
 
   return true;
 }
+
+bool ImageManipulation::generateMipmaps(ImageCesium& image) {
+  if (image.compressedPixelFormat != GpuCompressedPixelFormat::NONE ||
+      image.bytesPerChannel != 1 || image.channels < 1 ||
+      image.channels > 4 || image.width <= 0 || image.height <= 0 ||
+      !image.mipPositions.empty()) {
+    return false;
+  }
+
+  const size_t channels = size_t(image.channels);
+  const size_t width = size_t(image.width);
+  const size_t height = size_t(image.height);
+  if (image.pixelData.size() < width * height * channels) {
+    return false;
+  }
+
+  // Find the positions of all levels, so the pixel data is only resized once.
+  std::vector<ImageCesiumMipPosition> mipPositions;
+  size_t levelWidth = width;
+  size_t levelHeight = height;
+  size_t byteOffset = 0;
+  while (true) {
+    const size_t byteSize = levelWidth * levelHeight * channels;
+    mipPositions.push_back({byteOffset, byteSize});
+    byteOffset += byteSize;
+    if (levelWidth == 1 && levelHeight == 1) {
+      break;
+    }
+    levelWidth = std::max<size_t>(levelWidth / 2, 1);
+    levelHeight = std::max<size_t>(levelHeight / 2, 1);
+  }
+
+  // Any bytes after the full-size level are replaced.
+  image.pixelData.resize(byteOffset);
+  uint8_t* pPixels = reinterpret_cast<uint8_t*>(image.pixelData.data());
+
+  levelWidth = width;
+  levelHeight = height;
+  for (size_t i = 1; i < mipPositions.size(); ++i) {
+    const size_t targetWidth = std::max<size_t>(levelWidth / 2, 1);
+    const size_t targetHeight = std::max<size_t>(levelHeight / 2, 1);
+    downsampleImage(
+        pPixels + mipPositions[i - 1].byteOffset,
+        levelWidth,
+        levelHeight,
+        pPixels + mipPositions[i].byteOffset,
+        targetWidth,
+        targetHeight,
+        channels);
+    levelWidth = targetWidth;
+    levelHeight = targetHeight;
+  }
+
+  image.mipPositions = std::move(mipPositions);
+  return true;
+}
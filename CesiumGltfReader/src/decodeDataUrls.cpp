@@ -89,7 +89,8 @@ namespace CesiumGltf {
 void decodeDataUrls(
     const GltfReader& reader,
     ModelReaderResult& readModel,
-    bool clearDecodedDataUrls) {
+    bool clearDecodedDataUrls,
+    const ReadImageOptions& imageOptions) {
   CESIUM_TRACE("CesiumGltf::decodeDataUrls");
   if (!readModel.model) {
     return;
@@ -124,7 +125,11 @@ void decodeDataUrls(
       continue;
     }
 
-    ImageReaderResult imageResult = reader.readImage(decoded.value().data);
+    ImageReaderResult imageResult =
+        reader.readImage(
+            decoded.value().data,
+            imageOptions,
+            decoded.value().mimeType);
     if (imageResult.image) {
       image.cesium = std::move(imageResult.image.value());
     }
@@ -3,10 +3,12 @@
 namespace CesiumGltf {
 
 struct ModelReaderResult;
+struct ReadImageOptions;
 class GltfReader;
 
 void decodeDataUrls(
     const GltfReader& reader,
     ModelReaderResult& readModel,
-    bool clearDecodedDataUrls);
+    bool clearDecodedDataUrls,
+    const ReadImageOptions& imageOptions);
 } // namespace CesiumGltf
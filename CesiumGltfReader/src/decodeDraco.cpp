@@ -7,7 +7,10 @@
 #include <CesiumUtility/Tracing.h>
 
 #include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -25,41 +28,38 @@ namespace {
 using namespace CesiumGltf;
 
 std::unique_ptr<draco::Mesh> decodeBufferViewToDracoMesh(
-    ModelReaderResult& readModel,
-    MeshPrimitive& /* primitive */,
-    const KHR_draco_mesh_compression& draco) {
+    const Model& model,
+    const KHR_draco_mesh_compression& draco,
+    std::vector<std::string>& warnings) {
   CESIUM_TRACE("CesiumGltf::decodeBufferViewToDracoMesh");
-  Model& model = readModel.model.value();
 
-  BufferView* pBufferView =
+  const BufferView* pBufferView =
       Model::getSafe(&model.bufferViews, draco.bufferView);
   if (!pBufferView) {
-    readModel.warnings.emplace_back("Draco bufferView index is invalid.");
+    warnings.emplace_back("Draco bufferView index is invalid.");
     return nullptr;
   }
 
   const BufferView& bufferView = *pBufferView;
 
-  Buffer* pBuffer = Model::getSafe(&model.buffers, bufferView.buffer);
+  const Buffer* pBuffer = Model::getSafe(&model.buffers, bufferView.buffer);
   if (!pBuffer) {
-    readModel.warnings.emplace_back(
-        "Draco bufferView has an invalid buffer index.");
+    warnings.emplace_back("Draco bufferView has an invalid buffer index.");
     return nullptr;
   }
 
-  Buffer& buffer = *pBuffer;
+  const gsl::span<const std::byte> bufferData = pBuffer->cesium.getData();
 
   if (bufferView.byteOffset < 0 || bufferView.byteLength < 0 ||
       bufferView.byteOffset + bufferView.byteLength >
-          static_cast<int64_t>(buffer.cesium.data.size())) {
-    readModel.warnings.emplace_back(
-        "Draco bufferView extends beyond its buffer.");
+          static_cast<int64_t>(bufferData.size())) {
+    warnings.emplace_back("Draco bufferView extends beyond its buffer.");
     return nullptr;
   }
 
-  const gsl::span<const std::byte> data(
-      buffer.cesium.data.data() + bufferView.byteOffset,
-      static_cast<uint64_t>(bufferView.byteLength));
+  const gsl::span<const std::byte> data = bufferData.subspan(
+      static_cast<size_t>(bufferView.byteOffset),
+      static_cast<size_t>(bufferView.byteLength));
 
   draco::DecoderBuffer decodeBuffer;
   decodeBuffer.Init(reinterpret_cast<const char*>(data.data()), data.size());
@@ -69,7 +69,7 @@ std::unique_ptr<draco::Mesh> decodeBufferViewToDracoMesh(
   draco::StatusOr<std::unique_ptr<draco::Mesh>> result =
       decoder.DecodeMeshFromBuffer(&decodeBuffer);
   if (!result.ok()) {
-    readModel.warnings.emplace_back(
+    warnings.emplace_back(
         std::string("Draco decoding failed: ") +
         result.status().error_msg_string());
     return nullptr;
@@ -266,20 +266,15 @@ void copyDecodedAttribute(
   }
 }
 
-void decodePrimitive(
+void copyDecodedPrimitive(
     ModelReaderResult& readModel,
     MeshPrimitive& primitive,
-    KHR_draco_mesh_compression& draco) {
-  CESIUM_TRACE("CesiumGltf::decodePrimitive");
+    const KHR_draco_mesh_compression& draco,
+    draco::Mesh* pMesh) {
+  CESIUM_TRACE("CesiumGltf::copyDecodedPrimitive");
   Model& model = readModel.model.value();
 
-  std::unique_ptr<draco::Mesh> pMesh =
-      decodeBufferViewToDracoMesh(readModel, primitive, draco);
-  if (!pMesh) {
-    return;
-  }
-
-  copyDecodedIndices(readModel, primitive, pMesh.get());
+  copyDecodedIndices(readModel, primitive, pMesh);
 
   for (const std::pair<const std::string, int32_t>& attribute :
        draco.attributes) {
@@ -311,12 +306,7 @@ void decodePrimitive(
       continue;
     }
 
-    copyDecodedAttribute(
-        readModel,
-        primitive,
-        pAccessor,
-        pMesh.get(),
-        pAttribute);
+    copyDecodedAttribute(readModel, primitive, pAccessor, pMesh, pAttribute);
   }
 }
 } // namespace
@@ -329,19 +319,55 @@ void decodeDraco(CesiumGltf::ModelReaderResult& readModel) {
     return;
   }
 
-  Model& model = readModel.model.value();
+  const Model& model = readModel.model.value();
 
-  for (Mesh& mesh : model.meshes) {
-    for (MeshPrimitive& primitive : mesh.primitives) {
-      KHR_draco_mesh_compression* pDraco =
-          primitive.getExtension<KHR_draco_mesh_compression>();
-      if (!pDraco) {
-        continue;
+  for (size_t i = 0; i < model.meshes.size(); ++i) {
+    const std::vector<MeshPrimitive>& primitives = model.meshes[i].primitives;
+    for (size_t j = 0; j < primitives.size(); ++j) {
+      if (primitives[j].getExtension<KHR_draco_mesh_compression>()) {
+        decodeDracoPrimitive(model, i, j)(readModel);
       }
-
-      decodePrimitive(readModel, primitive, *pDraco);
     }
   }
 }
 
+std::function<void(ModelReaderResult&)> decodeDracoPrimitive(
+    const Model& model,
+    size_t meshIndex,
+    size_t primitiveIndex) {
+  CESIUM_TRACE("CesiumGltf::decodeDracoPrimitive");
+  const MeshPrimitive& primitive =
+      model.meshes[meshIndex].primitives[primitiveIndex];
+  const KHR_draco_mesh_compression* pDraco =
+      primitive.getExtension<KHR_draco_mesh_compression>();
+
+  std::vector<std::string> decodeWarnings;
+  std::shared_ptr<draco::Mesh> pMesh;
+  if (pDraco) {
+    pMesh = decodeBufferViewToDracoMesh(model, *pDraco, decodeWarnings);
+  }
+
+  return [meshIndex,
+          primitiveIndex,
+          warnings = std::move(decodeWarnings),
+          pMesh](
+             ModelReaderResult& readModel) {
+    readModel.warnings.insert(
+        readModel.warnings.end(),
+        warnings.begin(),
+        warnings.end());
+    if (!pMesh) {
+      return;
+    }
+
+    MeshPrimitive& primitive =
+        readModel.model->meshes[meshIndex].primitives[primitiveIndex];
+    copyDecodedPrimitive(
+        readModel,
+        primitive,
+        *primitive.getExtension<KHR_draco_mesh_compression>(),
+        pMesh.get());
+  };
+}
+
 } // namespace CesiumGltf
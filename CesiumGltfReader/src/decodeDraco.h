@@ -1,7 +1,24 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+
 namespace CesiumGltf {
+struct Model;
 struct ModelReaderResult;
 
 void decodeDraco(ModelReaderResult& readModel);
+
+/**
+ * Decodes the `KHR_draco_mesh_compression` mesh of a primitive, and returns a
+ * function that copies the decoded indices and attributes into the model.
+ *
+ * The decoding only reads the model, so the primitives of a model can be
+ * decoded in parallel, as long as the returned functions are called one after
+ * another once all of them are decoded.
+ */
+std::function<void(ModelReaderResult&)> decodeDracoPrimitive(
+    const Model& model,
+    size_t meshIndex,
+    size_t primitiveIndex);
 } // namespace CesiumGltf
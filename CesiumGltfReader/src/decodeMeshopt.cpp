@@ -0,0 +1,683 @@
+#include "decodeMeshopt.h"
+
+#include "CesiumGltf/GltfReader.h"
+
+#include <CesiumGltf/BufferViewEXT_meshopt_compression.h>
+#include <CesiumGltf/Model.h>
+#include <CesiumUtility/Tracing.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// The codecs follow the bitstream specification of the
+// EXT_meshopt_compression extension. They are plain loops over fixed-size
+// groups and blocks, which the compiler can unroll and vectorize.
+
+namespace {
+using namespace CesiumGltf;
+
+const uint8_t VERTEX_HEADER = 0xa0;
+const uint8_t INDEX_HEADER = 0xe0;
+const uint8_t SEQUENCE_HEADER = 0xd0;
+
+const size_t VERTEX_BLOCK_SIZE_BYTES = 8192;
+const size_t VERTEX_BLOCK_MAX_SIZE = 256;
+const size_t BYTE_GROUP_SIZE = 16;
+const size_t BYTE_GROUP_DECODE_LIMIT = 24;
+const size_t TAIL_MAX_SIZE = 32;
+
+uint8_t unzigzag(uint8_t v) noexcept {
+  return static_cast<uint8_t>(-(v & 1) ^ (v >> 1));
+}
+
+uint32_t unzigzag(uint32_t v) noexcept {
+  return (v >> 1) ^ (0u - (v & 1));
+}
+
+/**
+ * Decodes a group of 16 values that are packed into `Bits` bits each, where
+ * the largest packed value means that the value follows the packed values
+ * as a full byte.
+ */
+template <int Bits>
+const uint8_t* decodeBytesGroupPacked(const uint8_t* pData, uint8_t* pBuffer) {
+  constexpr size_t valuesPerByte = 8 / Bits;
+  constexpr size_t packedSize = BYTE_GROUP_SIZE / valuesPerByte;
+  constexpr uint8_t escape = (1 << Bits) - 1;
+
+  const uint8_t* pVariable = pData + packedSize;
+  for (size_t i = 0; i < packedSize; ++i) {
+    uint8_t byte = pData[i];
+    for (size_t j = 0; j < valuesPerByte; ++j) {
+      const uint8_t encoded = static_cast<uint8_t>(byte >> (8 - Bits));
+      byte = static_cast<uint8_t>(byte << Bits);
+      if (encoded == escape) {
+        *pBuffer++ = *pVariable++;
+      } else {
+        *pBuffer++ = encoded;
+      }
+    }
+  }
+
+  return pVariable;
+}
+
+const uint8_t* decodeBytesGroup(
+    const uint8_t* pData,
+    uint8_t* pBuffer,
+    uint8_t bitsLog2) {
+  switch (bitsLog2) {
+  case 0:
+    std::fill_n(pBuffer, BYTE_GROUP_SIZE, uint8_t(0));
+    return pData;
+  case 1:
+    return decodeBytesGroupPacked<2>(pData, pBuffer);
+  case 2:
+    return decodeBytesGroupPacked<4>(pData, pBuffer);
+  default:
+    std::copy(pData, pData + BYTE_GROUP_SIZE, pBuffer);
+    return pData + BYTE_GROUP_SIZE;
+  }
+}
+
+/**
+ * Decodes `bufferSize` bytes, a multiple of the group size, into `pBuffer`.
+ * Returns the end of the decoded data, or `nullptr` if it is truncated.
+ */
+const uint8_t* decodeBytes(
+    const uint8_t* pData,
+    const uint8_t* pDataEnd,
+    uint8_t* pBuffer,
+    size_t bufferSize) {
+  const size_t headerSize = (bufferSize / BYTE_GROUP_SIZE + 3) / 4;
+  if (size_t(pDataEnd - pData) < headerSize) {
+    return nullptr;
+  }
+
+  const uint8_t* pHeader = pData;
+  pData += headerSize;
+
+  for (size_t i = 0; i < bufferSize; i += BYTE_GROUP_SIZE) {
+    // A group reads at most 24 bytes, so it can be read without further
+    // checks.
+    if (size_t(pDataEnd - pData) < BYTE_GROUP_DECODE_LIMIT) {
+      return nullptr;
+    }
+
+    const size_t headerOffset = i / BYTE_GROUP_SIZE;
+    const uint8_t bitsLog2 = static_cast<uint8_t>(
+        (pHeader[headerOffset / 4] >> ((headerOffset % 4) * 2)) & 3);
+    pData = decodeBytesGroup(pData, pBuffer + i, bitsLog2);
+  }
+
+  return pData;
+}
+
+const uint8_t* decodeVertexBlock(
+    const uint8_t* pData,
+    const uint8_t* pDataEnd,
+    uint8_t* pVertexData,
+    size_t vertexCount,
+    size_t vertexSize,
+    std::array<uint8_t, 256>& lastVertex) {
+  std::array<uint8_t, VERTEX_BLOCK_MAX_SIZE> buffer;
+  std::array<uint8_t, VERTEX_BLOCK_SIZE_BYTES> transposed;
+
+  const size_t vertexCountAligned =
+      (vertexCount + BYTE_GROUP_SIZE - 1) & ~(BYTE_GROUP_SIZE - 1);
+
+  // Each byte of a vertex is stored as a separate stream of deltas.
+  for (size_t k = 0; k < vertexSize; ++k) {
+    pData = decodeBytes(pData, pDataEnd, buffer.data(), vertexCountAligned);
+    if (!pData) {
+      return nullptr;
+    }
+
+    uint8_t previous = lastVertex[k];
+    for (size_t i = 0; i < vertexCount; ++i) {
+      previous = static_cast<uint8_t>(unzigzag(buffer[i]) + previous);
+      transposed[i * vertexSize + k] = previous;
+    }
+    lastVertex[k] = previous;
+  }
+
+  std::copy(
+      transposed.begin(),
+      transposed.begin() + int64_t(vertexCount * vertexSize),
+      pVertexData);
+  return pData;
+}
+
+bool decodeVertexBuffer(
+    const uint8_t* pData,
+    size_t dataSize,
+    uint8_t* pDestination,
+    size_t vertexCount,
+    size_t vertexSize) {
+  if (vertexSize == 0 || vertexSize > 256 || vertexSize % 4 != 0 ||
+      dataSize < 1 + vertexSize) {
+    return false;
+  }
+
+  const uint8_t* pDataEnd = pData + dataSize;
+  const uint8_t header = *pData++;
+  if ((header & 0xf0) != VERTEX_HEADER || (header & 0x0f) > 0) {
+    return false;
+  }
+
+  // The tail holds the vertex that the deltas of the first block are
+  // relative to.
+  std::array<uint8_t, 256> lastVertex;
+  std::copy(pDataEnd - vertexSize, pDataEnd, lastVertex.begin());
+
+  const size_t blockSize = std::min(
+      (VERTEX_BLOCK_SIZE_BYTES / vertexSize) & ~(BYTE_GROUP_SIZE - 1),
+      VERTEX_BLOCK_MAX_SIZE);
+
+  for (size_t offset = 0; offset < vertexCount; offset += blockSize) {
+    const size_t count = std::min(blockSize, vertexCount - offset);
+    pData = decodeVertexBlock(
+        pData,
+        pDataEnd,
+        pDestination + offset * vertexSize,
+        count,
+        vertexSize,
+        lastVertex);
+    if (!pData) {
+      return false;
+    }
+  }
+
+  const size_t tailSize = std::max(vertexSize, TAIL_MAX_SIZE);
+  return size_t(pDataEnd - pData) == tailSize;
+}
+
+uint32_t decodeVByte(const uint8_t*& pData) noexcept {
+  const uint8_t lead = *pData++;
+  if (lead < 128) {
+    return lead;
+  }
+
+  // The values take at most 5 bytes.
+  uint32_t result = lead & 127u;
+  uint32_t shift = 7;
+  for (int i = 0; i < 4; ++i) {
+    const uint8_t group = *pData++;
+    result |= uint32_t(group & 127u) << shift;
+    shift += 7;
+    if (group < 128) {
+      break;
+    }
+  }
+
+  return result;
+}
+
+uint32_t decodeIndex(const uint8_t*& pData, uint32_t last) noexcept {
+  return last + unzigzag(decodeVByte(pData));
+}
+
+void writeIndex(
+    uint8_t* pDestination,
+    size_t index,
+    size_t indexSize,
+    uint32_t value) noexcept {
+  if (indexSize == 2) {
+    const uint16_t shortValue = static_cast<uint16_t>(value);
+    std::memcpy(pDestination + index * 2, &shortValue, sizeof(uint16_t));
+  } else {
+    std::memcpy(pDestination + index * 4, &value, sizeof(uint32_t));
+  }
+}
+
+/**
+ * Decodes the indices of triangles, which are encoded as references to
+ * recently seen edges and vertices, or as deltas to the last free index.
+ */
+bool decodeIndexBuffer(
+    const uint8_t* pData,
+    size_t dataSize,
+    uint8_t* pDestination,
+    size_t indexCount,
+    size_t indexSize) {
+  if (indexCount % 3 != 0 || dataSize < 1 + indexCount / 3 + 16) {
+    return false;
+  }
+
+  const uint8_t version = static_cast<uint8_t>(pData[0] & 0x0f);
+  if ((pData[0] & 0xf0) != INDEX_HEADER || version > 1) {
+    return false;
+  }
+
+  std::array<std::array<uint32_t, 2>, 16> edgeFifo;
+  std::array<uint32_t, 16> vertexFifo;
+  for (std::array<uint32_t, 2>& edge : edgeFifo) {
+    edge.fill(~0u);
+  }
+  vertexFifo.fill(~0u);
+
+  size_t edgeFifoOffset = 0;
+  size_t vertexFifoOffset = 0;
+  const auto pushEdge = [&edgeFifo, &edgeFifoOffset](uint32_t a, uint32_t b) {
+    edgeFifo[edgeFifoOffset] = {a, b};
+    edgeFifoOffset = (edgeFifoOffset + 1) & 15;
+  };
+  const auto pushVertex =
+      [&vertexFifo, &vertexFifoOffset](uint32_t v, bool advance = true) {
+        vertexFifo[vertexFifoOffset] = v;
+        vertexFifoOffset = (vertexFifoOffset + (advance ? 1 : 0)) & 15;
+      };
+
+  uint32_t next = 0;
+  uint32_t last = 0;
+  const uint32_t maxFifoCode = version >= 1 ? 13 : 15;
+
+  const uint8_t* pCode = pData + 1;
+  const uint8_t* pIndexData = pCode + indexCount / 3;
+  // The 16 bytes of the auxiliary code table let a triangle read up to 16
+  // bytes without checking every read.
+  const uint8_t* pSafeEnd = pData + dataSize - 16;
+  const uint8_t* pCodeAuxTable = pSafeEnd;
+
+  for (size_t i = 0; i < indexCount; i += 3) {
+    if (pIndexData > pSafeEnd) {
+      return false;
+    }
+
+    const uint8_t codeTriangle = *pCode++;
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t c = 0;
+
+    if (codeTriangle < 0xf0) {
+      // The triangle shares an edge with a recent triangle.
+      const uint32_t edgeCode = uint32_t(codeTriangle >> 4);
+      const std::array<uint32_t, 2>& edge =
+          edgeFifo[(edgeFifoOffset - 1 - edgeCode) & 15];
+      a = edge[0];
+      b = edge[1];
+
+      const uint32_t vertexCode = uint32_t(codeTriangle & 15);
+      if (vertexCode < maxFifoCode) {
+        const bool isNext = vertexCode == 0;
+        c = isNext ? next
+                   : vertexFifo[(vertexFifoOffset - 1 - vertexCode) & 15];
+        next += isNext ? 1 : 0;
+        pushVertex(c, isNext);
+      } else {
+        // In version 1, codes 13 and 14 are the last free index minus and
+        // plus one.
+        if (vertexCode == 15) {
+          c = decodeIndex(pIndexData, last);
+        } else {
+          c = vertexCode == 13 ? last - 1 : last + 1;
+        }
+        last = c;
+        pushVertex(c);
+      }
+
+      pushEdge(c, b);
+      pushEdge(a, c);
+    } else {
+      // The triangle shares no edge, and the references to its vertices are
+      // in a code from the table or in the data.
+      const bool isTableCode = codeTriangle < 0xfe;
+      const uint8_t codeAux =
+          isTableCode ? pCodeAuxTable[codeTriangle & 15] : *pIndexData++;
+      const uint32_t aCode = isTableCode || codeTriangle == 0xfe ? 0 : 15;
+      const uint32_t bCode = uint32_t(codeAux >> 4);
+      const uint32_t cCode = uint32_t(codeAux & 15);
+
+      if (!isTableCode && codeAux == 0) {
+        next = 0;
+      }
+
+      // Encoders only write a code of 15, for a free index, in a full byte.
+      // The table is part of the data though, so a code of 15 from it also
+      // reads a free index. Either way, a triangle reads at most 16 bytes:
+      // one code and three free indices of up to 5 bytes, which the check at
+      // the start of the loop allows for.
+
+      a = aCode == 0 ? next++ : 0;
+      b = bCode == 0 ? next++ : vertexFifo[(vertexFifoOffset - bCode) & 15];
+      c = cCode == 0 ? next++ : vertexFifo[(vertexFifoOffset - cCode) & 15];
+
+      if (aCode == 15) {
+        last = a = decodeIndex(pIndexData, last);
+      }
+      if (bCode == 15) {
+        last = b = decodeIndex(pIndexData, last);
+      }
+      if (cCode == 15) {
+        last = c = decodeIndex(pIndexData, last);
+      }
+
+      pushVertex(a);
+      pushVertex(b, bCode == 0 || bCode == 15);
+      pushVertex(c, cCode == 0 || cCode == 15);
+
+      pushEdge(b, a);
+      pushEdge(c, b);
+      pushEdge(a, c);
+    }
+
+    writeIndex(pDestination, i, indexSize, a);
+    writeIndex(pDestination, i + 1, indexSize, b);
+    writeIndex(pDestination, i + 2, indexSize, c);
+  }
+
+  return pIndexData == pSafeEnd;
+}
+
+/**
+ * Decodes indices that are encoded as deltas to one of the two previous
+ * indices.
+ */
+bool decodeIndexSequence(
+    const uint8_t* pData,
+    size_t dataSize,
+    uint8_t* pDestination,
+    size_t indexCount,
+    size_t indexSize) {
+  // Every index takes at least one byte, and the data ends with 4 bytes of
+  // padding.
+  if (dataSize < 1 + indexCount + 4) {
+    return false;
+  }
+
+  if ((pData[0] & 0xf0) != SEQUENCE_HEADER || (pData[0] & 0x0f) > 1) {
+    return false;
+  }
+
+  const uint8_t* pIndexData = pData + 1;
+  const uint8_t* pSafeEnd = pData + dataSize - 4;
+  std::array<uint32_t, 2> last{0, 0};
+
+  for (size_t i = 0; i < indexCount; ++i) {
+    if (pIndexData >= pSafeEnd) {
+      return false;
+    }
+
+    const uint32_t v = decodeVByte(pIndexData);
+    uint32_t& previous = last[v & 1];
+    previous += unzigzag(v >> 1);
+    writeIndex(pDestination, i, indexSize, previous);
+  }
+
+  return pIndexData == pSafeEnd;
+}
+
+int32_t roundToInt(float value) noexcept {
+  return static_cast<int32_t>(value + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+/**
+ * Reconstructs unit vectors from the octahedral encoding of their x and y
+ * components, where z holds the encoding of 1.0.
+ */
+template <typename T>
+void decodeFilterOctahedral(uint8_t* pData, size_t count) {
+  const float max = float((1 << (sizeof(T) * 8 - 1)) - 1);
+
+  for (size_t i = 0; i < count; ++i) {
+    std::array<T, 4> v;
+    std::memcpy(v.data(), pData + i * sizeof(v), sizeof(v));
+
+    float x = float(v[0]);
+    float y = float(v[1]);
+    const float z = float(v[2]) - std::fabs(x) - std::fabs(y);
+
+    // Folds the coordinates of the lower hemisphere.
+    const float t = z >= 0.0f ? 0.0f : z;
+    x += x >= 0.0f ? t : -t;
+    y += y >= 0.0f ? t : -t;
+
+    const float scale = max / std::sqrt(x * x + y * y + z * z);
+    v[0] = static_cast<T>(roundToInt(x * scale));
+    v[1] = static_cast<T>(roundToInt(y * scale));
+    v[2] = static_cast<T>(roundToInt(z * scale));
+
+    std::memcpy(pData + i * sizeof(v), v.data(), sizeof(v));
+  }
+}
+
+/**
+ * Reconstructs unit quaternions from three of their components. The two low
+ * bits of the fourth one are the index of the omitted, largest component, and
+ * the other bits are the scale of the three others.
+ */
+void decodeFilterQuaternion(uint8_t* pData, size_t count) {
+  const float scale = 1.0f / std::sqrt(2.0f);
+
+  for (size_t i = 0; i < count; ++i) {
+    std::array<int16_t, 4> v;
+    std::memcpy(v.data(), pData + i * sizeof(v), sizeof(v));
+
+    const float componentScale = scale / float(v[3] | 3);
+    const float x = float(v[0]) * componentScale;
+    const float y = float(v[1]) * componentScale;
+    const float z = float(v[2]) * componentScale;
+
+    // Precision errors may make the square negative.
+    const float ww = 1.0f - x * x - y * y - z * z;
+    const float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+    const size_t largest = size_t(v[3] & 3);
+    std::array<int16_t, 4> result;
+    result[(largest + 1) & 3] = static_cast<int16_t>(roundToInt(x * 32767.0f));
+    result[(largest + 2) & 3] = static_cast<int16_t>(roundToInt(y * 32767.0f));
+    result[(largest + 3) & 3] = static_cast<int16_t>(roundToInt(z * 32767.0f));
+    result[largest] = static_cast<int16_t>(roundToInt(w * 32767.0f));
+
+    std::memcpy(pData + i * sizeof(result), result.data(), sizeof(result));
+  }
+}
+
+/**
+ * Converts values with a 24-bit mantissa and an 8-bit exponent to floats.
+ */
+void decodeFilterExponential(uint8_t* pData, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t v;
+    std::memcpy(&v, pData + i * sizeof(v), sizeof(v));
+
+    const int32_t mantissa = static_cast<int32_t>(v << 8) >> 8;
+    const int32_t exponent = static_cast<int32_t>(v) >> 24;
+    const float value = std::ldexp(float(mantissa), exponent);
+
+    std::memcpy(pData + i * sizeof(value), &value, sizeof(value));
+  }
+}
+
+std::optional<std::vector<std::byte>> decodeBufferView(
+    const Model& model,
+    const BufferView& bufferView,
+    const BufferViewEXT_meshopt_compression& meshopt,
+    std::vector<std::string>& warnings) {
+  CESIUM_TRACE("CesiumGltf::decodeMeshoptBufferView");
+
+  const Buffer* pBuffer = Model::getSafe(&model.buffers, meshopt.buffer);
+  if (!pBuffer) {
+    warnings.emplace_back("Meshopt buffer index is invalid.");
+    return std::nullopt;
+  }
+
+  const gsl::span<const std::byte> bufferData = pBuffer->cesium.getData();
+  if (meshopt.byteOffset < 0 || meshopt.byteLength < 0 ||
+      meshopt.byteOffset + meshopt.byteLength >
+          static_cast<int64_t>(bufferData.size())) {
+    warnings.emplace_back("Meshopt compressed data extends beyond its buffer.");
+    return std::nullopt;
+  }
+
+  if (meshopt.count < 0 || meshopt.byteStride <= 0 ||
+      meshopt.byteStride > 256) {
+    warnings.emplace_back("Meshopt count or byteStride is invalid.");
+    return std::nullopt;
+  }
+
+  const Buffer* pFallbackBuffer =
+      Model::getSafe(&model.buffers, bufferView.buffer);
+  if (!pFallbackBuffer) {
+    warnings.emplace_back("Meshopt bufferView has an invalid buffer index.");
+    return std::nullopt;
+  }
+
+  if (bufferView.byteOffset < 0 || bufferView.byteLength < 0 ||
+      bufferView.byteOffset + bufferView.byteLength >
+          pFallbackBuffer->byteLength ||
+      meshopt.count > bufferView.byteLength / meshopt.byteStride) {
+    warnings.emplace_back(
+        "Meshopt bufferView is too small for the decoded data.");
+    return std::nullopt;
+  }
+
+  const size_t count = static_cast<size_t>(meshopt.count);
+  const size_t byteStride = static_cast<size_t>(meshopt.byteStride);
+
+  const uint8_t* pData =
+      reinterpret_cast<const uint8_t*>(bufferData.data()) +
+      meshopt.byteOffset;
+  const size_t dataSize = static_cast<size_t>(meshopt.byteLength);
+
+  std::vector<std::byte> decoded(count * byteStride);
+  uint8_t* pDecoded = reinterpret_cast<uint8_t*>(decoded.data());
+
+  bool success = false;
+  if (meshopt.mode == BufferViewEXT_meshopt_compression::Mode::ATTRIBUTES) {
+    success = decodeVertexBuffer(pData, dataSize, pDecoded, count, byteStride);
+  } else if (
+      meshopt.mode == BufferViewEXT_meshopt_compression::Mode::TRIANGLES) {
+    success = (byteStride == 2 || byteStride == 4) &&
+              decodeIndexBuffer(pData, dataSize, pDecoded, count, byteStride);
+  } else if (meshopt.mode == BufferViewEXT_meshopt_compression::Mode::INDICES) {
+    success =
+        (byteStride == 2 || byteStride == 4) &&
+        decodeIndexSequence(pData, dataSize, pDecoded, count, byteStride);
+  } else {
+    warnings.emplace_back("Meshopt mode " + meshopt.mode + " is unknown.");
+    return std::nullopt;
+  }
+
+  if (!success) {
+    warnings.emplace_back(
+        "Meshopt decoding failed for a bufferView in " + meshopt.mode +
+        " mode.");
+    return std::nullopt;
+  }
+
+  if (meshopt.filter == BufferViewEXT_meshopt_compression::Filter::NONE) {
+    return decoded;
+  }
+
+  if (meshopt.mode != BufferViewEXT_meshopt_compression::Mode::ATTRIBUTES) {
+    warnings.emplace_back("Meshopt filters only apply to ATTRIBUTES mode.");
+    return std::nullopt;
+  }
+
+  if (meshopt.filter ==
+          BufferViewEXT_meshopt_compression::Filter::OCTAHEDRAL &&
+      byteStride == 4) {
+    decodeFilterOctahedral<int8_t>(pDecoded, count);
+  } else if (
+      meshopt.filter ==
+          BufferViewEXT_meshopt_compression::Filter::OCTAHEDRAL &&
+      byteStride == 8) {
+    decodeFilterOctahedral<int16_t>(pDecoded, count);
+  } else if (
+      meshopt.filter ==
+          BufferViewEXT_meshopt_compression::Filter::QUATERNION &&
+      byteStride == 8) {
+    decodeFilterQuaternion(pDecoded, count);
+  } else if (
+      meshopt.filter ==
+      BufferViewEXT_meshopt_compression::Filter::EXPONENTIAL) {
+    decodeFilterExponential(pDecoded, count * byteStride / 4);
+  } else {
+    warnings.emplace_back(
+        "Meshopt filter " + meshopt.filter + " cannot be applied to a " +
+        std::to_string(byteStride) + "-byte stride.");
+    return std::nullopt;
+  }
+
+  return decoded;
+}
+
+} // namespace
+
+namespace CesiumGltf {
+
+void decodeMeshopt(ModelReaderResult& readModel) {
+  CESIUM_TRACE("CesiumGltf::decodeMeshopt");
+  if (!readModel.model) {
+    return;
+  }
+
+  const Model& model = readModel.model.value();
+
+  for (size_t i = 0; i < model.bufferViews.size(); ++i) {
+    const BufferView& bufferView = model.bufferViews[i];
+    if (bufferView.getExtension<BufferViewEXT_meshopt_compression>()) {
+      decodeMeshoptBufferView(model, i)(readModel);
+    }
+  }
+}
+
+std::function<void(ModelReaderResult&)>
+decodeMeshoptBufferView(const Model& model, size_t bufferViewIndex) {
+  const BufferView& bufferView = model.bufferViews[bufferViewIndex];
+  const BufferViewEXT_meshopt_compression* pMeshopt =
+      bufferView.getExtension<BufferViewEXT_meshopt_compression>();
+
+  std::vector<std::string> decodeWarnings;
+  std::shared_ptr<std::vector<std::byte>> pDecoded;
+  if (pMeshopt) {
+    std::optional<std::vector<std::byte>> decoded =
+        decodeBufferView(model, bufferView, *pMeshopt, decodeWarnings);
+    if (decoded) {
+      pDecoded =
+          std::make_shared<std::vector<std::byte>>(std::move(decoded.value()));
+    }
+  }
+
+  return [bufferViewIndex, warnings = std::move(decodeWarnings), pDecoded](
+             ModelReaderResult& readModel) {
+    readModel.warnings.insert(
+        readModel.warnings.end(),
+        warnings.begin(),
+        warnings.end());
+    if (!pDecoded) {
+      return;
+    }
+
+    Model& decodedModel = readModel.model.value();
+    const BufferView& decodedBufferView =
+        decodedModel.bufferViews[bufferViewIndex];
+    Buffer& buffer =
+        decodedModel.buffers[static_cast<size_t>(decodedBufferView.buffer)];
+
+    // The fallback buffer usually has no data of its own, so it is allocated
+    // when the first of its buffer views is decoded.
+    const size_t start = static_cast<size_t>(decodedBufferView.byteOffset);
+    std::vector<std::byte>& data = buffer.cesium.getMutableData();
+    if (data.size() < start + pDecoded->size()) {
+      data.resize(static_cast<size_t>(buffer.byteLength));
+    }
+
+    std::copy(
+        pDecoded->begin(),
+        pDecoded->end(),
+        data.begin() + static_cast<int64_t>(start));
+  };
+}
+
+} // namespace CesiumGltf
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace CesiumGltf {
+struct Model;
+struct ModelReaderResult;
+
+void decodeMeshopt(ModelReaderResult& readModel);
+
+/**
+ * Decodes the `EXT_meshopt_compression` data of a buffer view, and returns a
+ * function that copies the decoded data into the fallback buffer of the buffer
+ * view.
+ *
+ * Like {@link decodeDracoPrimitive}, the decoding only reads the model, so the
+ * buffer views of a model can be decoded in parallel.
+ */
+std::function<void(ModelReaderResult&)>
+decodeMeshoptBufferView(const Model& model, size_t bufferViewIndex);
+} // namespace CesiumGltf
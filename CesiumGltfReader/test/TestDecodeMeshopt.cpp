@@ -0,0 +1,865 @@
+#include "CesiumGltf/GltfReader.h"
+
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/ITaskProcessor.h>
+#include <CesiumGltf/BufferEXT_meshopt_compression.h>
+#include <CesiumGltf/BufferViewEXT_meshopt_compression.h>
+
+#include <catch2/catch.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <gsl/span>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4127 4018 4804)
+#endif
+
+#include <draco/compression/encode.h>
+#include <draco/mesh/mesh.h>
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+using namespace CesiumAsync;
+using namespace CesiumGltf;
+
+namespace {
+class ThreadTaskProcessor : public ITaskProcessor {
+public:
+  virtual void startTask(std::function<void()> f) override {
+    std::thread(f).detach();
+  }
+};
+
+// The compressed buffer holds, in this order:
+// - 4 triangles encoded as TRIANGLES.
+// - 4 vertices of 4 bytes encoded as ATTRIBUTES, using all the kinds of
+//   byte groups.
+// - 6 indices encoded as INDICES.
+// - 2 normals, 2 rotations and 2 floats encoded as ATTRIBUTES with the
+//   OCTAHEDRAL, QUATERNION and EXPONENTIAL filters.
+const std::string compressedBuffer = R"(
+        {
+          "byteLength": 485,
+          "uri": "data:application/octet-stream;base64,4PAQ/v/wDP8CAgIAdodWZ3iphmWJaJgBaQAAAKADAgEABAAAAAAAAAAAAAAAAAFwAAAABwACLwAAAAAAAAAoAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAoAAAAA0AAEBJEDDAYAAAAAoP8A/gAAAAAAAAAAAAAAAAAA/wAAAAAAAAAAAAAAAAAAAAD//gAAAAAAAAAAAAAAAAAAAP8KCwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACg/wAAAAAAAAAAAAAAAAAAAAD/AAAAAAAAAAAAAAAAAAAAAP8AAAAAAAAAAAAAAAAAAAAA/wAAAAAAAAAAAAAAAAAAAAD/AAEAAAAAAAAAAAAAAAAAAP8AfgAAAAAAAAAAAAAAAAAA/wEAAAAAAAAAAAAAAAAAAAD/fgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAoP8GCQAAAAAAAAAAAAAAAAAA/wABAAAAAAAAAAAAAAAAAAD/AAEAAAAAAAAAAAAAAAAAAP8BBgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA="
+        }
+)";
+
+const std::string fallbackBuffer = R"(
+        {
+          "byteLength": 96,
+          "extensions": {
+            "EXT_meshopt_compression": { "fallback": true }
+          }
+        }
+)";
+
+std::string createMeshoptGltf(const std::string& bufferViews) {
+  return R"({ "asset": { "version": "2.0" }, "buffers": [)" +
+         compressedBuffer + "," + fallbackBuffer +
+         R"(], "bufferViews": [)" + bufferViews + "] }";
+}
+
+// Creates a buffer view in the fallback buffer with the given compressed data.
+std::string createBufferView(
+    int64_t byteOffset,
+    int64_t byteLength,
+    int64_t compressedByteOffset,
+    int64_t compressedByteLength,
+    int64_t count,
+    int64_t byteStride,
+    const std::string& mode,
+    const std::string& filter) {
+  return R"({ "buffer": 1, "byteOffset": )" + std::to_string(byteOffset) +
+         R"(, "byteLength": )" + std::to_string(byteLength) +
+         R"(, "extensions": { "EXT_meshopt_compression": { "buffer": 0)" +
+         R"(, "byteOffset": )" + std::to_string(compressedByteOffset) +
+         R"(, "byteLength": )" + std::to_string(compressedByteLength) +
+         R"(, "count": )" + std::to_string(count) +
+         R"(, "byteStride": )" + std::to_string(byteStride) +
+         R"(, "mode": ")" + mode + R"(", "filter": ")" + filter + R"(" } } })";
+}
+
+const std::string allBufferViews =
+    createBufferView(0, 24, 0, 27, 12, 2, "TRIANGLES", "NONE") + "," +
+    createBufferView(24, 16, 28, 67, 4, 4, "ATTRIBUTES", "NONE") + "," +
+    createBufferView(40, 24, 96, 12, 6, 4, "INDICES", "NONE") + "," +
+    createBufferView(64, 8, 108, 101, 2, 4, "ATTRIBUTES", "OCTAHEDRAL") + "," +
+    createBufferView(72, 16, 212, 169, 2, 8, "ATTRIBUTES", "QUATERNION") +
+    "," + createBufferView(88, 8, 384, 101, 2, 4, "ATTRIBUTES", "EXPONENTIAL");
+
+template <typename T>
+std::vector<T>
+readValues(const Model& model, size_t bufferViewIndex, size_t count) {
+  const BufferView& bufferView = model.bufferViews[bufferViewIndex];
+  const gsl::span<const std::byte> data =
+      model.buffers[size_t(bufferView.buffer)].cesium.getData();
+  REQUIRE(
+      size_t(bufferView.byteOffset) + count * sizeof(T) <= size_t(data.size()));
+
+  std::vector<T> values(count);
+  std::memcpy(
+      values.data(),
+      data.data() + bufferView.byteOffset,
+      count * sizeof(T));
+  return values;
+}
+
+ModelReaderResult
+readModel(const std::string& gltf, const ReadModelOptions& options) {
+  GltfReader reader;
+  return reader.readModel(
+      gsl::span(reinterpret_cast<const std::byte*>(gltf.c_str()), gltf.size()),
+      options);
+}
+
+// Encodes data the way meshoptimizer does, for the round trip test and the
+// benchmark, since meshoptimizer is not a dependency.
+void encodeVByte(std::vector<uint8_t>& data, uint32_t value) {
+  while (value >= 128) {
+    data.push_back(static_cast<uint8_t>((value & 127) | 128));
+    value >>= 7;
+  }
+  data.push_back(static_cast<uint8_t>(value));
+}
+
+void encodeIndex(std::vector<uint8_t>& data, uint32_t index, uint32_t last) {
+  const uint32_t delta = index - last;
+  encodeVByte(data, (delta << 1) ^ (0u - (delta >> 31)));
+}
+
+// Encodes each group of 16 deltas with the fewest bits per value.
+void encodeBytes(
+    std::vector<uint8_t>& data,
+    const std::vector<uint8_t>& bytes) {
+  const size_t groupCount = bytes.size() / 16;
+  const size_t headerOffset = data.size();
+  data.resize(data.size() + (groupCount + 3) / 4);
+
+  for (size_t group = 0; group < groupCount; ++group) {
+    const uint8_t* pGroup = bytes.data() + group * 16;
+    const size_t nonZero =
+        size_t(std::count_if(pGroup, pGroup + 16, [](uint8_t v) {
+          return v != 0;
+        }));
+    const size_t escaped2 =
+        size_t(std::count_if(pGroup, pGroup + 16, [](uint8_t v) {
+          return v >= 3;
+        }));
+    const size_t escaped4 =
+        size_t(std::count_if(pGroup, pGroup + 16, [](uint8_t v) {
+          return v >= 15;
+        }));
+
+    uint8_t mode = 3;
+    if (nonZero == 0) {
+      mode = 0;
+    } else if (4 + escaped2 <= 8 + escaped4 && 4 + escaped2 < 16) {
+      mode = 1;
+    } else if (8 + escaped4 < 16) {
+      mode = 2;
+    }
+    data[headerOffset + group / 4] |=
+        static_cast<uint8_t>(mode << ((group % 4) * 2));
+
+    if (mode == 3) {
+      data.insert(data.end(), pGroup, pGroup + 16);
+    } else if (mode != 0) {
+      const int bits = mode == 1 ? 2 : 4;
+      const uint8_t escape = static_cast<uint8_t>((1 << bits) - 1);
+      uint8_t packed = 0;
+      std::vector<uint8_t> literals;
+      for (size_t i = 0; i < 16; ++i) {
+        const uint8_t value = std::min(pGroup[i], escape);
+        packed = static_cast<uint8_t>((packed << bits) | value);
+        if (value == escape) {
+          literals.push_back(pGroup[i]);
+        }
+        if ((i + 1) % size_t(8 / bits) == 0) {
+          data.push_back(packed);
+          packed = 0;
+        }
+      }
+      data.insert(data.end(), literals.begin(), literals.end());
+    }
+  }
+}
+
+std::vector<uint8_t>
+encodeVertexBuffer(const std::vector<uint8_t>& vertices, size_t vertexSize) {
+  const size_t vertexCount = vertices.size() / vertexSize;
+  const size_t blockSize =
+      std::min((8192 / vertexSize) & ~size_t(15), size_t(256));
+
+  std::vector<uint8_t> data{0xa0};
+  std::vector<uint8_t> lastVertex(
+      vertices.begin(),
+      vertices.begin() + int64_t(vertexSize));
+  std::vector<uint8_t> deltas;
+
+  for (size_t offset = 0; offset < vertexCount; offset += blockSize) {
+    const size_t count = std::min(blockSize, vertexCount - offset);
+    for (size_t k = 0; k < vertexSize; ++k) {
+      deltas.assign((count + 15) & ~size_t(15), 0);
+      for (size_t i = 0; i < count; ++i) {
+        const uint8_t value = vertices[(offset + i) * vertexSize + k];
+        const uint8_t delta = static_cast<uint8_t>(value - lastVertex[k]);
+        deltas[i] = static_cast<uint8_t>(
+            (delta << 1) ^ ((delta & 0x80) != 0 ? 0xff : 0));
+        lastVertex[k] = value;
+      }
+      encodeBytes(data, deltas);
+    }
+  }
+
+  // The tail ends with the first vertex, which the first deltas are relative
+  // to.
+  data.insert(data.end(), std::max(vertexSize, size_t(32)) - vertexSize, 0);
+  data.insert(
+      data.end(),
+      vertices.begin(),
+      vertices.begin() + int64_t(vertexSize));
+  return data;
+}
+
+std::vector<uint8_t> encodeIndexBuffer(const std::vector<uint32_t>& indices) {
+  const std::array<uint8_t, 16> codeAuxTable = {
+      0x00,
+      0x76,
+      0x87,
+      0x56,
+      0x67,
+      0x78,
+      0xa9,
+      0x86,
+      0x65,
+      0x89,
+      0x68,
+      0x98,
+      0x01,
+      0x69,
+      0x00,
+      0x00};
+
+  std::array<std::array<uint32_t, 2>, 16> edgeFifo;
+  std::array<uint32_t, 16> vertexFifo;
+  for (std::array<uint32_t, 2>& edge : edgeFifo) {
+    edge.fill(~0u);
+  }
+  vertexFifo.fill(~0u);
+  size_t edgeFifoOffset = 0;
+  size_t vertexFifoOffset = 0;
+
+  const auto pushEdge = [&edgeFifo, &edgeFifoOffset](uint32_t a, uint32_t b) {
+    edgeFifo[edgeFifoOffset] = {a, b};
+    edgeFifoOffset = (edgeFifoOffset + 1) & 15;
+  };
+  const auto pushVertex = [&vertexFifo, &vertexFifoOffset](uint32_t v) {
+    vertexFifo[vertexFifoOffset] = v;
+    vertexFifoOffset = (vertexFifoOffset + 1) & 15;
+  };
+  const auto findVertex = [&vertexFifo, &vertexFifoOffset](uint32_t v) {
+    for (uint32_t i = 0; i < 16; ++i) {
+      if (vertexFifo[(vertexFifoOffset - 1 - i) & 15] == v) {
+        return int32_t(i);
+      }
+    }
+    return -1;
+  };
+  // Returns the age of an edge of the triangle in the FIFO, times four, plus
+  // the rotation that makes it the first edge.
+  const auto findEdge =
+      [&edgeFifo, &edgeFifoOffset](uint32_t a, uint32_t b, uint32_t c) {
+        for (uint32_t i = 0; i < 16; ++i) {
+          const std::array<uint32_t, 2>& edge =
+              edgeFifo[(edgeFifoOffset - 1 - i) & 15];
+          if (edge[0] == a && edge[1] == b) {
+            return int32_t(i << 2);
+          }
+          if (edge[0] == b && edge[1] == c) {
+            return int32_t((i << 2) | 1);
+          }
+          if (edge[0] == c && edge[1] == a) {
+            return int32_t((i << 2) | 2);
+          }
+        }
+        return -1;
+      };
+
+  std::vector<uint8_t> codes;
+  std::vector<uint8_t> data;
+  uint32_t next = 0;
+  uint32_t last = 0;
+
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    const int32_t edge =
+        findEdge(indices[i], indices[i + 1], indices[i + 2]);
+
+    if (edge >= 0 && (edge >> 2) < 15) {
+      const size_t rotation = size_t(edge & 3);
+      const uint32_t a = indices[i + rotation];
+      const uint32_t b = indices[i + (rotation + 1) % 3];
+      const uint32_t c = indices[i + (rotation + 2) % 3];
+
+      const int32_t fifoIndex = findVertex(c);
+      uint32_t code = 15;
+      if (fifoIndex >= 1 && fifoIndex < 13) {
+        code = uint32_t(fifoIndex);
+      } else if (c == next) {
+        code = 0;
+        ++next;
+      } else if (c + 1 == last) {
+        code = 13;
+      } else if (c == last + 1) {
+        code = 14;
+      }
+
+      codes.push_back(static_cast<uint8_t>(((edge >> 2) << 4) | int32_t(code)));
+      if (code == 15) {
+        encodeIndex(data, c, last);
+      }
+      if (code >= 13) {
+        last = c;
+      }
+      if (code == 0 || code >= 13) {
+        pushVertex(c);
+      }
+
+      pushEdge(c, b);
+      pushEdge(a, c);
+    } else {
+      // The vertex that is next, if any, becomes the first one.
+      const size_t rotation =
+          indices[i + 1] == next ? 1 : (indices[i + 2] == next ? 2 : 0);
+      const uint32_t a = indices[i + rotation];
+      const uint32_t b = indices[i + (rotation + 1) % 3];
+      const uint32_t c = indices[i + (rotation + 2) % 3];
+
+      const int32_t fifoIndexB = findVertex(b);
+      const int32_t fifoIndexC = findVertex(c);
+      const auto getCode = [&next](uint32_t v, int32_t fifoIndex) {
+        if (fifoIndex >= 0 && fifoIndex < 14) {
+          return uint32_t(fifoIndex + 1);
+        }
+        if (v == next) {
+          ++next;
+          return 0u;
+        }
+        return 15u;
+      };
+      const uint32_t codeA = getCode(a, -1);
+      const uint32_t codeB = getCode(b, fifoIndexB);
+      const uint32_t codeC = getCode(c, fifoIndexC);
+
+      const uint8_t codeAux = static_cast<uint8_t>((codeB << 4) | codeC);
+      const auto tableIt = std::find(
+          codeAuxTable.begin(),
+          codeAuxTable.begin() + 14,
+          codeAux);
+      if (codeA == 0 && tableIt != codeAuxTable.begin() + 14) {
+        codes.push_back(
+            static_cast<uint8_t>(0xf0 | (tableIt - codeAuxTable.begin())));
+      } else {
+        codes.push_back(codeA == 15 ? 0xff : 0xfe);
+        data.push_back(codeAux);
+      }
+
+      for (const auto& [v, code] :
+           {std::make_pair(a, codeA),
+            std::make_pair(b, codeB),
+            std::make_pair(c, codeC)}) {
+        if (code == 15) {
+          encodeIndex(data, v, last);
+          last = v;
+        }
+      }
+
+      pushVertex(a);
+      if (codeB == 0 || codeB == 15) {
+        pushVertex(b);
+      }
+      if (codeC == 0 || codeC == 15) {
+        pushVertex(c);
+      }
+
+      pushEdge(b, a);
+      pushEdge(c, b);
+      pushEdge(a, c);
+    }
+  }
+
+  std::vector<uint8_t> result{0xe1};
+  result.insert(result.end(), codes.begin(), codes.end());
+  result.insert(result.end(), data.begin(), data.end());
+  result.insert(result.end(), codeAuxTable.begin(), codeAuxTable.end());
+  return result;
+}
+
+int8_t quantizeSnorm8(float value) {
+  return static_cast<int8_t>(
+      std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+}
+
+// A grid with a wavy surface, so that the normals vary.
+struct TestMesh {
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec3> normals;
+  std::vector<uint32_t> indices;
+};
+
+TestMesh createGrid(uint32_t size) {
+  TestMesh mesh;
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      const float fx = float(x) * 0.1f;
+      const float fy = float(y) * 0.1f;
+      mesh.positions.emplace_back(
+          float(x),
+          float(y),
+          4.0f * std::sin(fx) * std::cos(fy));
+      mesh.normals.push_back(glm::normalize(glm::vec3(
+          -0.4f * std::cos(fx) * std::cos(fy),
+          0.4f * std::sin(fx) * std::sin(fy),
+          1.0f)));
+    }
+  }
+
+  for (uint32_t y = 0; y + 1 < size; ++y) {
+    for (uint32_t x = 0; x + 1 < size; ++x) {
+      const uint32_t v0 = y * size + x;
+      const uint32_t v2 = v0 + size;
+      mesh.indices.insert(mesh.indices.end(), {v0, v2, v0 + 1});
+      mesh.indices.insert(mesh.indices.end(), {v0 + 1, v2, v2 + 1});
+    }
+  }
+
+  return mesh;
+}
+
+// The positions are quantized to 14 bits and the normals to 8 bits, like
+// they are for Draco in encodeDraco.
+std::vector<uint16_t> quantizePositions(const TestMesh& mesh, float range) {
+  std::vector<uint16_t> quantized;
+  for (const glm::vec3& position : mesh.positions) {
+    for (glm::length_t i = 0; i < 3; ++i) {
+      quantized.push_back(static_cast<uint16_t>(
+          std::lround((position[i] + range) / (2.0f * range) * 16383.0f)));
+    }
+    quantized.push_back(0);
+  }
+  return quantized;
+}
+
+std::vector<int8_t> encodeOctahedralNormals(const TestMesh& mesh) {
+  std::vector<int8_t> encoded;
+  for (const glm::vec3& normal : mesh.normals) {
+    const float length =
+        std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    const float x = normal.x / length;
+    const float y = normal.y / length;
+    // The lower hemisphere is folded over the upper one.
+    const float u = normal.z >= 0.0f
+                        ? x
+                        : (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    const float v = normal.z >= 0.0f
+                        ? y
+                        : (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+    encoded.insert(
+        encoded.end(),
+        {quantizeSnorm8(u), quantizeSnorm8(v), 127, 0});
+  }
+  return encoded;
+}
+
+template <typename T> std::vector<uint8_t> toBytes(const std::vector<T>& v) {
+  std::vector<uint8_t> bytes(v.size() * sizeof(T));
+  std::memcpy(bytes.data(), v.data(), bytes.size());
+  return bytes;
+}
+
+std::vector<std::byte>
+createGlb(const std::string& json, const std::vector<uint8_t>& binary) {
+  std::string paddedJson = json;
+  paddedJson.resize((json.size() + 3) & ~size_t(3), ' ');
+  std::vector<uint8_t> paddedBinary = binary;
+  paddedBinary.resize((binary.size() + 3) & ~size_t(3), 0);
+
+  std::vector<std::byte> glb;
+  const auto append = [&glb](const void* pData, size_t size) {
+    const std::byte* pBytes = static_cast<const std::byte*>(pData);
+    glb.insert(glb.end(), pBytes, pBytes + size);
+  };
+  const uint32_t length = static_cast<uint32_t>(
+      12 + 8 + paddedJson.size() + 8 + paddedBinary.size());
+  const uint32_t header[] = {
+      0x46546C67,
+      2,
+      length,
+      static_cast<uint32_t>(paddedJson.size()),
+      0x4E4F534A};
+  append(header, sizeof(header));
+  append(paddedJson.data(), paddedJson.size());
+  const uint32_t binaryHeader[] = {
+      static_cast<uint32_t>(paddedBinary.size()),
+      0x004E4942};
+  append(binaryHeader, sizeof(binaryHeader));
+  append(paddedBinary.data(), paddedBinary.size());
+  return glb;
+}
+
+std::string createAccessors(
+    size_t vertexCount,
+    size_t indexCount,
+    const std::string& positionType,
+    const std::string& normalType,
+    bool hasBufferViews) {
+  const auto bufferView = [hasBufferViews](int32_t index) {
+    return hasBufferViews
+               ? R"("bufferView": )" + std::to_string(index) + ", "
+               : std::string();
+  };
+  return R"("accessors": [ { )" + bufferView(0) + R"("componentType": )" +
+         positionType + R"(, "count": )" + std::to_string(vertexCount) +
+         R"(, "type": "VEC3" }, { )" + bufferView(1) +
+         R"("componentType": )" + normalType +
+         R"(, "normalized": true, "count": )" + std::to_string(vertexCount) +
+         R"(, "type": "VEC3" }, { )" + bufferView(2) +
+         R"("componentType": 5125, "count": )" + std::to_string(indexCount) +
+         R"(, "type": "SCALAR" } ])";
+}
+
+// Creates a GLB with the mesh compressed with EXT_meshopt_compression. The
+// positions are quantized with KHR_mesh_quantization, and the normals use the
+// octahedral filter.
+std::vector<std::byte> createMeshoptGlb(const TestMesh& mesh, float range) {
+  const std::vector<uint8_t> positions =
+      encodeVertexBuffer(toBytes(quantizePositions(mesh, range)), 8);
+  const std::vector<uint8_t> normals =
+      encodeVertexBuffer(toBytes(encodeOctahedralNormals(mesh)), 4);
+  const std::vector<uint8_t> indices = encodeIndexBuffer(mesh.indices);
+
+  std::vector<uint8_t> binary;
+  std::string bufferViews;
+  int64_t fallbackOffset = 0;
+  const auto addBufferView = [&](const std::vector<uint8_t>& data,
+                                 int64_t count,
+                                 int64_t byteStride,
+                                 const std::string& mode,
+                                 const std::string& filter) {
+    binary.resize((binary.size() + 3) & ~size_t(3), 0);
+    if (!bufferViews.empty()) {
+      bufferViews += ",";
+    }
+    bufferViews += createBufferView(
+        fallbackOffset,
+        count * byteStride,
+        int64_t(binary.size()),
+        int64_t(data.size()),
+        count,
+        byteStride,
+        mode,
+        filter);
+    binary.insert(binary.end(), data.begin(), data.end());
+    fallbackOffset += count * byteStride;
+  };
+
+  const int64_t vertexCount = int64_t(mesh.positions.size());
+  const int64_t indexCount = int64_t(mesh.indices.size());
+  addBufferView(positions, vertexCount, 8, "ATTRIBUTES", "NONE");
+  addBufferView(normals, vertexCount, 4, "ATTRIBUTES", "OCTAHEDRAL");
+  addBufferView(indices, indexCount, 4, "TRIANGLES", "NONE");
+
+  const std::string json =
+      R"({ "asset": { "version": "2.0" }, "extensionsUsed": )"
+      R"([ "EXT_meshopt_compression", "KHR_mesh_quantization" ], )"
+      R"("buffers": [ { "byteLength": )" +
+      std::to_string(binary.size()) + R"( }, { "byteLength": )" +
+      std::to_string(fallbackOffset) +
+      R"(, "extensions": { "EXT_meshopt_compression": )"
+      R"({ "fallback": true } } } ], "bufferViews": [ )" +
+      bufferViews + " ], " +
+      createAccessors(
+          mesh.positions.size(),
+          mesh.indices.size(),
+          "5123",
+          "5120",
+          true) +
+      R"(, "meshes": [ { "primitives": [ { "attributes": )"
+      R"({ "POSITION": 0, "NORMAL": 1 }, "indices": 2 } ] } ] })";
+  return createGlb(json, binary);
+}
+
+// Creates a GLB with the mesh compressed with KHR_draco_mesh_compression.
+std::vector<std::byte> createDracoGlb(const TestMesh& mesh) {
+  draco::Mesh dracoMesh;
+  const uint32_t vertexCount = uint32_t(mesh.positions.size());
+  dracoMesh.set_num_points(vertexCount);
+
+  const auto addAttribute = [&dracoMesh, vertexCount](
+                                draco::GeometryAttribute::Type type,
+                                const std::vector<glm::vec3>& values) {
+    draco::GeometryAttribute attribute;
+    attribute.Init(
+        type,
+        nullptr,
+        3,
+        draco::DT_FLOAT32,
+        false,
+        sizeof(glm::vec3),
+        0);
+    const int id = dracoMesh.AddAttribute(attribute, true, vertexCount);
+    draco::PointAttribute* pAttribute = dracoMesh.attribute(id);
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+      pAttribute->SetAttributeValue(draco::AttributeValueIndex(i), &values[i]);
+    }
+    return pAttribute->unique_id();
+  };
+  const uint32_t positionId =
+      addAttribute(draco::GeometryAttribute::POSITION, mesh.positions);
+  const uint32_t normalId =
+      addAttribute(draco::GeometryAttribute::NORMAL, mesh.normals);
+
+  for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+    dracoMesh.AddFace(
+        {draco::PointIndex(mesh.indices[i]),
+         draco::PointIndex(mesh.indices[i + 1]),
+         draco::PointIndex(mesh.indices[i + 2])});
+  }
+
+  draco::Encoder encoder;
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, 14);
+  encoder.SetAttributeQuantization(draco::GeometryAttribute::NORMAL, 8);
+  draco::EncoderBuffer buffer;
+  REQUIRE(encoder.EncodeMeshToBuffer(dracoMesh, &buffer).ok());
+
+  const std::vector<uint8_t> binary(
+      reinterpret_cast<const uint8_t*>(buffer.data()),
+      reinterpret_cast<const uint8_t*>(buffer.data()) + buffer.size());
+  const std::string json =
+      R"({ "asset": { "version": "2.0" }, "extensionsUsed": )"
+      R"([ "KHR_draco_mesh_compression" ], "buffers": [ { "byteLength": )" +
+      std::to_string(binary.size()) +
+      R"( } ], "bufferViews": [ { "buffer": 0, "byteLength": )" +
+      std::to_string(binary.size()) + " } ], " +
+      createAccessors(
+          mesh.positions.size(),
+          mesh.indices.size(),
+          "5126",
+          "5126",
+          false) +
+      R"(, "meshes": [ { "primitives": [ { "attributes": )"
+      R"({ "POSITION": 0, "NORMAL": 1 }, "indices": 2, "extensions": )"
+      R"({ "KHR_draco_mesh_compression": { "bufferView": 0, )"
+      R"("attributes": { "POSITION": )" +
+      std::to_string(positionId) + R"(, "NORMAL": )" +
+      std::to_string(normalId) + " } } } } ] } ] }";
+  return createGlb(json, binary);
+}
+
+// Rotates each triangle so that it starts with its smallest index, because
+// the triangle codec may rotate triangles.
+std::vector<uint32_t> normalizeTriangles(std::vector<uint32_t> indices) {
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    const auto begin = indices.begin() + int64_t(i);
+    std::rotate(begin, std::min_element(begin, begin + 3), begin + 3);
+  }
+  return indices;
+}
+} // namespace
+
+TEST_CASE("Decodes EXT_meshopt_compression buffer views") {
+  const std::string gltf = createMeshoptGltf(allBufferViews);
+  ModelReaderResult result = readModel(gltf, ReadModelOptions());
+  REQUIRE(result.model);
+  CHECK(result.errors.empty());
+  CHECK(result.warnings.empty());
+
+  const Model& model = *result.model;
+  const BufferEXT_meshopt_compression* pBufferMeshopt =
+      model.buffers[1].getExtension<BufferEXT_meshopt_compression>();
+  REQUIRE(pBufferMeshopt);
+  CHECK(pBufferMeshopt->fallback);
+
+  const BufferViewEXT_meshopt_compression* pMeshopt =
+      model.bufferViews[3].getExtension<BufferViewEXT_meshopt_compression>();
+  REQUIRE(pMeshopt);
+  CHECK(pMeshopt->buffer == 0);
+  CHECK(pMeshopt->byteOffset == 108);
+  CHECK(pMeshopt->byteLength == 101);
+  CHECK(pMeshopt->count == 2);
+  CHECK(pMeshopt->byteStride == 4);
+  CHECK(pMeshopt->mode == BufferViewEXT_meshopt_compression::Mode::ATTRIBUTES);
+  CHECK(
+      pMeshopt->filter ==
+      BufferViewEXT_meshopt_compression::Filter::OCTAHEDRAL);
+
+  REQUIRE(model.buffers[1].cesium.getData().size() == 96);
+
+  CHECK(
+      readValues<uint16_t>(model, 0, 12) ==
+      std::vector<uint16_t>{0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9});
+  CHECK(
+      readValues<uint8_t>(model, 1, 16) ==
+      std::vector<uint8_t>{
+          11,
+          255,
+          0,
+          1,
+          10,
+          251,
+          0,
+          21,
+          10,
+          251,
+          0,
+          21,
+          12,
+          251,
+          0,
+          21});
+  CHECK(
+      readValues<uint32_t>(model, 2, 6) ==
+      std::vector<uint32_t>{0, 1, 2, 100, 5, 3});
+
+  // The fourth components of the normals are left unchanged.
+  CHECK(
+      readValues<int8_t>(model, 3, 8) ==
+      std::vector<int8_t>{0, 0, 127, 5, 127, 0, 0, -1});
+  CHECK(
+      readValues<int16_t>(model, 4, 8) ==
+      std::vector<int16_t>{0, 0, 0, 32767, 0, 0, 23170, 23170});
+  CHECK(readValues<float>(model, 5, 2) == std::vector<float>{1.5f, -8.0f});
+}
+
+TEST_CASE("Decodes EXT_meshopt_compression buffer views in worker threads") {
+  const std::string gltf = createMeshoptGltf(allBufferViews);
+  const gsl::span<const std::byte> data(
+      reinterpret_cast<const std::byte*>(gltf.c_str()),
+      gltf.size());
+
+  GltfReader reader;
+  AsyncSystem asyncSystem(std::make_shared<ThreadTaskProcessor>());
+  ModelReaderResult result = reader.readModelAsync(asyncSystem, data).wait();
+  REQUIRE(result.model);
+  CHECK(result.warnings.empty());
+
+  ModelReaderResult expected = reader.readModel(data);
+  REQUIRE(expected.model);
+  CHECK(
+      result.model->buffers[1].cesium.data ==
+      expected.model->buffers[1].cesium.data);
+}
+
+TEST_CASE("Reports EXT_meshopt_compression buffer views that cannot be "
+          "decoded") {
+  SECTION("Truncated data") {
+    const std::string gltf = createMeshoptGltf(
+        createBufferView(0, 24, 0, 26, 12, 2, "TRIANGLES", "NONE"));
+    ModelReaderResult result = readModel(gltf, ReadModelOptions());
+    REQUIRE(result.model);
+    CHECK(result.warnings.size() == 1);
+    CHECK(result.model->buffers[1].cesium.getData().empty());
+  }
+
+  SECTION("Filter that does not match the stride") {
+    const std::string gltf = createMeshoptGltf(
+        createBufferView(64, 8, 108, 101, 2, 4, "ATTRIBUTES", "QUATERNION"));
+    ModelReaderResult result = readModel(gltf, ReadModelOptions());
+    REQUIRE(result.model);
+    CHECK(result.warnings.size() == 1);
+  }
+
+  SECTION("Buffer view that is too small") {
+    const std::string gltf = createMeshoptGltf(
+        createBufferView(0, 20, 0, 27, 12, 2, "TRIANGLES", "NONE"));
+    ModelReaderResult result = readModel(gltf, ReadModelOptions());
+    REQUIRE(result.model);
+    CHECK(result.warnings.size() == 1);
+  }
+
+  SECTION("Decoding is disabled") {
+    ReadModelOptions options;
+    options.decodeMeshopt = false;
+    ModelReaderResult result =
+        readModel(createMeshoptGltf(allBufferViews), options);
+    REQUIRE(result.model);
+    CHECK(result.warnings.empty());
+    CHECK(result.model->buffers[1].cesium.getData().empty());
+  }
+}
+
+TEST_CASE("Decodes a mesh compressed with EXT_meshopt_compression") {
+  const TestMesh mesh = createGrid(64);
+  const std::vector<std::byte> glb = createMeshoptGlb(mesh, 64.0f);
+
+  GltfReader reader;
+  ModelReaderResult result = reader.readModel(glb);
+  REQUIRE(result.model);
+  CHECK(result.errors.empty());
+  CHECK(result.warnings.empty());
+
+  const Model& model = *result.model;
+  const size_t vertexCount = mesh.positions.size();
+  CHECK(
+      readValues<uint16_t>(model, 0, vertexCount * 4) ==
+      quantizePositions(mesh, 64.0f));
+  CHECK(
+      normalizeTriangles(
+          readValues<uint32_t>(model, 2, mesh.indices.size())) ==
+      normalizeTriangles(mesh.indices));
+
+  const std::vector<int8_t> normals =
+      readValues<int8_t>(model, 1, vertexCount * 4);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    const glm::vec3 normal(
+        float(normals[i * 4]) / 127.0f,
+        float(normals[i * 4 + 1]) / 127.0f,
+        float(normals[i * 4 + 2]) / 127.0f);
+    REQUIRE(glm::dot(normal, mesh.normals[i]) > 0.99f);
+  }
+}
+
+// Compares reading a mesh compressed with EXT_meshopt_compression and the
+// same mesh compressed with KHR_draco_mesh_compression, with the same
+// quantization. Run with `cesium-native-tests "[benchmark]"`.
+TEST_CASE(
+    "EXT_meshopt_compression compared to KHR_draco_mesh_compression",
+    "[.][benchmark]") {
+  const TestMesh mesh = createGrid(256);
+  const std::vector<std::byte> meshoptGlb = createMeshoptGlb(mesh, 256.0f);
+  const std::vector<std::byte> dracoGlb = createDracoGlb(mesh);
+
+  GltfReader reader;
+  const ModelReaderResult meshoptResult = reader.readModel(meshoptGlb);
+  REQUIRE(meshoptResult.model);
+  REQUIRE(meshoptResult.warnings.empty());
+  const ModelReaderResult dracoResult = reader.readModel(dracoGlb);
+  REQUIRE(dracoResult.model);
+  REQUIRE(dracoResult.warnings.empty());
+
+  BENCHMARK(
+      "EXT_meshopt_compression, " + std::to_string(mesh.positions.size()) +
+      " vertices, " + std::to_string(meshoptGlb.size()) + " bytes") {
+    return reader.readModel(meshoptGlb);
+  };
+
+  BENCHMARK(
+      "KHR_draco_mesh_compression, " + std::to_string(mesh.positions.size()) +
+      " vertices, " + std::to_string(dracoGlb.size()) + " bytes") {
+    return reader.readModel(dracoGlb);
+  };
+}
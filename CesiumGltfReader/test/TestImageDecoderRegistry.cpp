@@ -0,0 +1,361 @@
+#include "CesiumGltf/ImageDecoderRegistry.h"
+
+#include <CesiumGltf/GltfReader.h>
+#include <CesiumGltf/ImageCesium.h>
+#include <CesiumGltf/ImageManipulation.h>
+
+#include <catch2/catch.hpp>
+#include <gsl/span>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace CesiumGltf;
+
+namespace {
+
+class TestImageDecoder final : public ImageDecoder {
+public:
+  explicit TestImageDecoder(int32_t width) : _width(width) {}
+
+  ImageReaderResult decode(
+      const gsl::span<const std::byte>& /*data*/,
+      const ReadImageOptions& /*options*/) const override {
+    ImageReaderResult result;
+    result.image.emplace().width = this->_width;
+    return result;
+  }
+
+private:
+  int32_t _width;
+};
+
+std::vector<std::byte> toBytes(const std::string& text) {
+  std::vector<std::byte> bytes(text.size());
+  std::memcpy(bytes.data(), text.data(), text.size());
+  return bytes;
+}
+
+template <typename T>
+void writeValue(std::vector<std::byte>& data, size_t offset, T value) {
+  std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+struct TestLevel {
+  size_t byteSize;
+  std::byte value;
+};
+
+// Creates a KTX2 image whose levels are stored from the smallest to the
+// largest, as required by the specification.
+std::vector<std::byte> createKtx2(
+    uint32_t vkFormat,
+    uint32_t width,
+    uint32_t height,
+    const std::vector<TestLevel>& levels) {
+  const std::string identifier = "\xABKTX 20\xBB\r\n\x1A\n";
+  const size_t headerSize = 80 + levels.size() * 24;
+
+  size_t totalSize = headerSize;
+  for (const TestLevel& level : levels) {
+    totalSize += level.byteSize;
+  }
+
+  std::vector<std::byte> data(totalSize);
+  std::memcpy(data.data(), identifier.data(), identifier.size());
+  writeValue<uint32_t>(data, 12, vkFormat);
+  writeValue<uint32_t>(data, 16, 1);
+  writeValue<uint32_t>(data, 20, width);
+  writeValue<uint32_t>(data, 24, height);
+  writeValue<uint32_t>(data, 36, 1);
+  writeValue<uint32_t>(data, 40, static_cast<uint32_t>(levels.size()));
+
+  size_t offset = headerSize;
+  for (size_t i = levels.size(); i > 0; --i) {
+    const TestLevel& level = levels[i - 1];
+    const size_t entryOffset = 80 + (i - 1) * 24;
+    writeValue<uint64_t>(data, entryOffset, offset);
+    writeValue<uint64_t>(data, entryOffset + 8, level.byteSize);
+    writeValue<uint64_t>(data, entryOffset + 16, level.byteSize);
+    std::fill_n(data.begin() + int64_t(offset), level.byteSize, level.value);
+    offset += level.byteSize;
+  }
+
+  return data;
+}
+
+// Creates a DDS image with the given FourCC code, and the given DXGI format
+// if the code is DX10.
+std::vector<std::byte> createDds(
+    const std::string& fourCC,
+    uint32_t dxgiFormat,
+    uint32_t width,
+    uint32_t height,
+    const std::vector<TestLevel>& levels) {
+  const size_t headerSize = fourCC == "DX10" ? 148 : 128;
+
+  size_t totalSize = headerSize;
+  for (const TestLevel& level : levels) {
+    totalSize += level.byteSize;
+  }
+
+  std::vector<std::byte> data(totalSize);
+  std::memcpy(data.data(), "DDS ", 4);
+  writeValue<uint32_t>(data, 4, 124);
+  writeValue<uint32_t>(data, 8, 0x1007 | 0x20000);
+  writeValue<uint32_t>(data, 12, height);
+  writeValue<uint32_t>(data, 16, width);
+  writeValue<uint32_t>(data, 28, static_cast<uint32_t>(levels.size()));
+  writeValue<uint32_t>(data, 76, 32);
+  writeValue<uint32_t>(data, 80, 0x4);
+  std::memcpy(data.data() + 84, fourCC.data(), 4);
+  if (fourCC == "DX10") {
+    writeValue<uint32_t>(data, 128, dxgiFormat);
+    writeValue<uint32_t>(data, 132, 3);
+    writeValue<uint32_t>(data, 140, 1);
+  }
+
+  size_t offset = headerSize;
+  for (const TestLevel& level : levels) {
+    std::fill_n(data.begin() + int64_t(offset), level.byteSize, level.value);
+    offset += level.byteSize;
+  }
+
+  return data;
+}
+
+} // namespace
+
+TEST_CASE("ImageDecoderRegistry finds decoders by magic and MIME type") {
+  std::shared_ptr<ImageDecoder> pShortMagicDecoder =
+      std::make_shared<TestImageDecoder>(1);
+  std::shared_ptr<ImageDecoder> pLongMagicDecoder =
+      std::make_shared<TestImageDecoder>(2);
+  std::shared_ptr<ImageDecoder> pMimeTypeDecoder =
+      std::make_shared<TestImageDecoder>(3);
+  GltfReader reader;
+  ImageDecoderRegistry& registry = reader.getImageDecoders();
+  registry.registerMagic("CTST", pShortMagicDecoder);
+  registry.registerMagic("CTSTLONG", pLongMagicDecoder);
+  registry.registerMimeType("image/x-cesium-test", pMimeTypeDecoder);
+
+  const std::vector<std::byte> shortMagic = toBytes("CTST1234");
+  const std::vector<std::byte> longMagic = toBytes("CTSTLONG1234");
+  const std::vector<std::byte> noMagic = toBytes("1234");
+
+  CHECK(registry.getDecoder(shortMagic, "") == pShortMagicDecoder);
+  CHECK(registry.getDecoder(longMagic, "") == pLongMagicDecoder);
+  CHECK(
+      registry.getDecoder(longMagic, "image/x-cesium-test") ==
+      pLongMagicDecoder);
+  CHECK(
+      registry.getDecoder(
+          noMagic,
+          "Image/X-Cesium-Test; charset=binary") == pMimeTypeDecoder);
+  CHECK(registry.getDecoder(noMagic, "") == nullptr);
+  CHECK(registry.getDecoder(noMagic, "image/png") == nullptr);
+
+  // The reader uses the registered decoder instead of stb_image.
+  ImageReaderResult result = reader.readImage(
+      noMagic,
+      ReadImageOptions(),
+      "image/x-cesium-test");
+  REQUIRE(result.image);
+  CHECK(result.image->width == 3);
+
+  // Decoders registered with one reader do not leak into another.
+  GltfReader otherReader;
+  CHECK(
+      otherReader.getImageDecoders().getDecoder(
+          noMagic,
+          "image/x-cesium-test") == nullptr);
+}
+
+TEST_CASE("ImageDecoderRegistry has a fingerprint of its decoders") {
+  GltfReader reader;
+  ImageDecoderRegistry& registry = reader.getImageDecoders();
+  const std::string empty = registry.getFingerprint();
+  CHECK(GltfReader().getImageDecoders().getFingerprint() == empty);
+
+  registry.registerGpuCompressedDecoders();
+  const std::string gpuCompressed = registry.getFingerprint();
+  CHECK(gpuCompressed != empty);
+
+  // Registries with the same kinds of decoders have the same fingerprint.
+  GltfReader otherReader;
+  otherReader.getImageDecoders().registerGpuCompressedDecoders();
+  CHECK(otherReader.getImageDecoders().getFingerprint() == gpuCompressed);
+
+  registry.registerMimeType(
+      "image/x-cesium-test",
+      std::make_shared<TestImageDecoder>(1));
+  CHECK(registry.getFingerprint() != gpuCompressed);
+}
+
+TEST_CASE("Reads GPU compressed KTX2 images without decoding them") {
+  GltfReader reader;
+  reader.getImageDecoders().registerGpuCompressedDecoders();
+
+  SECTION("BC1 with mip levels") {
+    // 8x4, 4x2, 2x1 and 1x1 pixels take 2, 1, 1 and 1 blocks of 8 bytes.
+    const std::vector<std::byte> data = createKtx2(
+        133,
+        8,
+        4,
+        {{16, std::byte(1)},
+         {8, std::byte(2)},
+         {8, std::byte(3)},
+         {8, std::byte(4)}});
+    ImageReaderResult result = reader.readImage(data);
+    REQUIRE(result.image);
+    CHECK(result.errors.empty());
+
+    const ImageCesium& image = *result.image;
+    CHECK(image.width == 8);
+    CHECK(image.height == 4);
+    CHECK(image.compressedPixelFormat == GpuCompressedPixelFormat::BC1_RGBA);
+    CHECK(!image.isSrgb);
+    REQUIRE(image.pixelData.size() == 40);
+    REQUIRE(image.mipPositions.size() == 4);
+
+    // The levels start with the full-size one.
+    CHECK(image.mipPositions[0].byteOffset == 0);
+    CHECK(image.mipPositions[0].byteSize == 16);
+    CHECK(image.mipPositions[1].byteOffset == 16);
+    CHECK(image.mipPositions[3].byteOffset == 32);
+    CHECK(image.pixelData[0] == std::byte(1));
+    CHECK(image.pixelData[15] == std::byte(1));
+    CHECK(image.pixelData[16] == std::byte(2));
+    CHECK(image.pixelData[39] == std::byte(4));
+  }
+
+  SECTION("UNORM and sRGB variants of a format") {
+    // VK_FORMAT_BC7_UNORM_BLOCK and VK_FORMAT_BC7_SRGB_BLOCK.
+    ImageReaderResult unorm =
+        reader.readImage(createKtx2(145, 4, 4, {{16, std::byte(1)}}));
+    ImageReaderResult srgb =
+        reader.readImage(createKtx2(146, 4, 4, {{16, std::byte(1)}}));
+    REQUIRE(unorm.image);
+    REQUIRE(srgb.image);
+    CHECK(
+        unorm.image->compressedPixelFormat ==
+        GpuCompressedPixelFormat::BC7_RGBA);
+    CHECK(
+        srgb.image->compressedPixelFormat ==
+        GpuCompressedPixelFormat::BC7_RGBA);
+    CHECK(!unorm.image->isSrgb);
+    CHECK(srgb.image->isSrgb);
+
+    // VK_FORMAT_R8G8B8A8_SRGB.
+    ImageReaderResult uncompressed =
+        reader.readImage(createKtx2(43, 2, 2, {{16, std::byte(7)}}));
+    REQUIRE(uncompressed.image);
+    CHECK(
+        uncompressed.image->compressedPixelFormat ==
+        GpuCompressedPixelFormat::NONE);
+    CHECK(uncompressed.image->isSrgb);
+  }
+
+  SECTION("Uncompressed RGBA8 with a single level") {
+    const std::vector<std::byte> data =
+        createKtx2(37, 2, 2, {{16, std::byte(7)}});
+    ImageReaderResult result = reader.readImage(data);
+    REQUIRE(result.image);
+    CHECK(
+        result.image->compressedPixelFormat == GpuCompressedPixelFormat::NONE);
+    CHECK(result.image->channels == 4);
+    CHECK(result.image->mipPositions.empty());
+    CHECK(result.image->pixelData.size() == 16);
+  }
+
+  SECTION("Fails on unsupported or truncated images") {
+    std::vector<std::byte> data = createKtx2(133, 8, 4, {{16, std::byte(1)}});
+
+    // Basis Universal supercompression.
+    std::vector<std::byte> supercompressed = data;
+    writeValue<uint32_t>(supercompressed, 44, 1);
+    CHECK(!reader.readImage(supercompressed).image);
+
+    // VK_FORMAT_BC6H_UFLOAT_BLOCK.
+    std::vector<std::byte> unsupported = data;
+    writeValue<uint32_t>(unsupported, 12, 143);
+    CHECK(!reader.readImage(unsupported).image);
+
+    data.resize(data.size() - 1);
+    ImageReaderResult result = reader.readImage(data);
+    CHECK(!result.image);
+    CHECK(!result.errors.empty());
+  }
+}
+
+TEST_CASE("Reads GPU compressed DDS images without decoding them") {
+  GltfReader reader;
+  reader.getImageDecoders().registerGpuCompressedDecoders();
+
+  SECTION("DXT5 with mip levels") {
+    const std::vector<std::byte> data = createDds(
+        "DXT5",
+        0,
+        4,
+        4,
+        {{16, std::byte(1)}, {16, std::byte(2)}, {16, std::byte(3)}});
+    ImageReaderResult result = reader.readImage(data);
+    REQUIRE(result.image);
+
+    const ImageCesium& image = *result.image;
+    CHECK(image.compressedPixelFormat == GpuCompressedPixelFormat::BC3_RGBA);
+    REQUIRE(image.mipPositions.size() == 3);
+    CHECK(image.mipPositions[2].byteOffset == 32);
+    CHECK(image.pixelData.size() == 48);
+    CHECK(image.pixelData[47] == std::byte(3));
+  }
+
+  SECTION("BC7 with a DX10 header") {
+    const std::vector<std::byte> data =
+        createDds("DX10", 98, 8, 8, {{64, std::byte(1)}});
+    ImageReaderResult result = reader.readImage(data);
+    REQUIRE(result.image);
+    CHECK(
+        result.image->compressedPixelFormat ==
+        GpuCompressedPixelFormat::BC7_RGBA);
+    CHECK(result.image->mipPositions.empty());
+    CHECK(result.image->pixelData.size() == 64);
+  }
+
+  SECTION("UNORM and sRGB variants of a DXGI format") {
+    // DXGI_FORMAT_BC1_UNORM and DXGI_FORMAT_BC1_UNORM_SRGB.
+    ImageReaderResult unorm =
+        reader.readImage(createDds("DX10", 71, 4, 4, {{8, std::byte(1)}}));
+    ImageReaderResult srgb =
+        reader.readImage(createDds("DX10", 72, 4, 4, {{8, std::byte(1)}}));
+    REQUIRE(unorm.image);
+    REQUIRE(srgb.image);
+    CHECK(
+        unorm.image->compressedPixelFormat ==
+        GpuCompressedPixelFormat::BC1_RGBA);
+    CHECK(
+        srgb.image->compressedPixelFormat ==
+        GpuCompressedPixelFormat::BC1_RGBA);
+    CHECK(!unorm.image->isSrgb);
+    CHECK(srgb.image->isSrgb);
+  }
+
+  SECTION("Compressed images cannot be blitted") {
+    const std::vector<std::byte> data =
+        createDds("DXT1", 0, 4, 4, {{8, std::byte(1)}});
+    ImageReaderResult result = reader.readImage(data);
+    REQUIRE(result.image);
+
+    ImageCesium target;
+    target.width = 4;
+    target.height = 4;
+    target.pixelData.resize(64);
+    const PixelRectangle pixels{0, 0, 4, 4};
+    CHECK(
+        !ImageManipulation::blitImage(target, pixels, *result.image, pixels));
+  }
+}
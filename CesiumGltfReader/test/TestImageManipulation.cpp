@@ -332,3 +332,71 @@ TEST_CASE("ImageManipulation::blitImage") {
     verifyTargetUnchanged();
   }
 }
+
+TEST_CASE("ImageManipulation::generateMipmaps") {
+  SECTION("averages 2x2 blocks down to a single pixel") {
+    ImageCesium image;
+    image.width = 4;
+    image.height = 2;
+    image.channels = 4;
+    image.pixelData.resize(32);
+    for (size_t i = 0; i < image.pixelData.size(); ++i) {
+      image.pixelData[i] = std::byte(i * 4);
+    }
+    const std::vector<std::byte> fullSize = image.pixelData;
+
+    REQUIRE(ImageManipulation::generateMipmaps(image));
+
+    // 4x2, 2x1 and 1x1 pixels.
+    REQUIRE(image.mipPositions.size() == 3);
+    CHECK(image.mipPositions[0].byteOffset == 0);
+    CHECK(image.mipPositions[0].byteSize == 32);
+    CHECK(image.mipPositions[1].byteOffset == 32);
+    CHECK(image.mipPositions[1].byteSize == 8);
+    CHECK(image.mipPositions[2].byteOffset == 40);
+    CHECK(image.mipPositions[2].byteSize == 4);
+    REQUIRE(image.pixelData.size() == 44);
+    CHECK(
+        std::equal(fullSize.begin(), fullSize.end(), image.pixelData.begin()));
+
+    // The first channel of the first pixel of level 1 averages the bytes at
+    // 0, 4, 16 and 20 of level 0.
+    CHECK(image.pixelData[32] == std::byte((0 + 16 + 64 + 80) / 4));
+    CHECK(image.pixelData[36] == std::byte((32 + 48 + 96 + 112) / 4));
+
+    // Level 2 averages the two pixels of level 1, rounding up.
+    CHECK(image.pixelData[40] == std::byte((40 + 72 + 1) / 2));
+  }
+
+  SECTION("handles images that are one pixel high or wide") {
+    ImageCesium image;
+    image.width = 3;
+    image.height = 1;
+    image.channels = 1;
+    image.pixelData = {std::byte(10), std::byte(20), std::byte(255)};
+
+    REQUIRE(ImageManipulation::generateMipmaps(image));
+    REQUIRE(image.mipPositions.size() == 2);
+    REQUIRE(image.pixelData.size() == 4);
+    CHECK(image.pixelData[3] == std::byte(15));
+  }
+
+  SECTION("rejects unsupported images") {
+    ImageCesium image;
+    image.width = 2;
+    image.height = 2;
+    image.channels = 1;
+    image.bytesPerChannel = 2;
+    image.pixelData.resize(8);
+    CHECK(!ImageManipulation::generateMipmaps(image));
+
+    image.bytesPerChannel = 1;
+    image.compressedPixelFormat = GpuCompressedPixelFormat::BC4_R;
+    CHECK(!ImageManipulation::generateMipmaps(image));
+
+    image.compressedPixelFormat = GpuCompressedPixelFormat::NONE;
+    image.pixelData.resize(3);
+    CHECK(!ImageManipulation::generateMipmaps(image));
+    CHECK(image.mipPositions.empty());
+  }
+}
@@ -1,5 +1,7 @@
 #include "CesiumGltf/GltfReader.h"
 
+#include <CesiumAsync/AsyncSystem.h>
+#include <CesiumAsync/ITaskProcessor.h>
 #include <CesiumGltf/AccessorView.h>
 #include <CesiumGltf/KHR_draco_mesh_compression.h>
 
@@ -8,14 +10,28 @@
 #include <gsl/span>
 #include <rapidjson/reader.h>
 
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
+using namespace CesiumAsync;
 using namespace CesiumGltf;
 using namespace CesiumUtility;
 
 namespace {
+class ThreadTaskProcessor : public ITaskProcessor {
+public:
+  virtual void startTask(std::function<void()> f) override {
+    std::thread(f).detach();
+  }
+};
+
 std::vector<std::byte> readFile(const std::filesystem::path& fileName) {
   std::ifstream file(fileName, std::ios::binary | std::ios::ate);
   REQUIRE(file);
@@ -372,3 +388,229 @@ TEST_CASE("Unknown MIME types are handled") {
   // because no images could be read.
   REQUIRE(modelResult.model.has_value());
 }
+
+TEST_CASE("Reads the GLB binary chunk without copying it") {
+  // The JSON chunk is padded so that the binary chunk starts at an offset
+  // that is a multiple of 8.
+  const std::string json =
+      R"({"asset":{"version":"2.0"},"buffers":[{"byteLength":16}]}   )";
+  REQUIRE(json.size() % 8 == 4);
+
+  const uint32_t binaryLength = 16;
+  const uint32_t length = static_cast<uint32_t>(12 + 8 + json.size() + 8) +
+                          binaryLength;
+  std::vector<std::byte> glb;
+  const auto append = [&glb](const void* pData, size_t size) {
+    const std::byte* pBytes = static_cast<const std::byte*>(pData);
+    glb.insert(glb.end(), pBytes, pBytes + size);
+  };
+  const uint32_t jsonLength = static_cast<uint32_t>(json.size());
+  const uint32_t header[] = {0x46546C67, 2, length, jsonLength, 0x4E4F534A};
+  append(header, sizeof(header));
+  append(json.data(), json.size());
+  const uint32_t binaryHeader[] = {binaryLength, 0x004E4942};
+  append(binaryHeader, sizeof(binaryHeader));
+  for (uint32_t i = 0; i < binaryLength; ++i) {
+    glb.push_back(std::byte(i));
+  }
+
+  const std::shared_ptr<std::vector<std::byte>> pData =
+      std::make_shared<std::vector<std::byte>>(std::move(glb));
+  const gsl::span<const std::byte> binaryChunk(
+      pData->data() + pData->size() - binaryLength,
+      binaryLength);
+
+  GltfReader reader;
+
+  SECTION("Refers to the binary chunk when it has an owner") {
+    ReadModelOptions options;
+    options.referenceBinaryChunk = true;
+    ModelReaderResult result = reader.readModel(*pData, pData, options);
+    REQUIRE(result.errors.empty());
+    REQUIRE(result.model);
+
+    BufferCesium& buffer = result.model->buffers[0].cesium;
+    REQUIRE(buffer.data.empty());
+    REQUIRE(buffer.getData().data() == binaryChunk.data());
+    REQUIRE(buffer.getData().size() == binaryLength);
+    REQUIRE(pData.use_count() == 2);
+
+    // Modifying the data copies it and releases the owner.
+    std::vector<std::byte>& data = buffer.getMutableData();
+    REQUIRE(data.size() == binaryLength);
+    REQUIRE(data[15] == std::byte(15));
+    REQUIRE(buffer.getData().data() == data.data());
+    REQUIRE(!buffer.pExternalDataOwner);
+    REQUIRE(pData.use_count() == 1);
+  }
+
+  SECTION("Copies the binary chunk unless referencing it is enabled") {
+    ModelReaderResult result = reader.readModel(*pData, pData);
+    REQUIRE(result.errors.empty());
+    REQUIRE(result.model);
+
+    const BufferCesium& buffer = result.model->buffers[0].cesium;
+    REQUIRE(buffer.data.size() == binaryLength);
+    REQUIRE(buffer.getData().data() == buffer.data.data());
+    REQUIRE(!buffer.pExternalDataOwner);
+    REQUIRE(pData.use_count() == 1);
+  }
+
+  SECTION("Copies the binary chunk without an owner") {
+    ModelReaderResult result = reader.readModel(*pData);
+    REQUIRE(result.errors.empty());
+    REQUIRE(result.model);
+
+    const BufferCesium& buffer = result.model->buffers[0].cesium;
+    REQUIRE(buffer.data.size() == binaryLength);
+    REQUIRE(buffer.getData().data() == buffer.data.data());
+    REQUIRE(!buffer.pExternalDataOwner);
+  }
+}
+
+TEST_CASE("Reads a model and decodes its images in worker threads") {
+  // The buffer holds a 1x1 red PNG and a 2x1 green and blue PNG. The third
+  // image has a bufferView that extends beyond the buffer.
+  const std::string s = R"(
+    {
+      "asset": { "version": "2.0" },
+      "buffers": [
+        {
+          "byteLength": 141,
+          "uri": "data:application/octet-stream;base64,iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAIAAACQd1PeAAAADElEQVR4nGP4z8AAAAMBAQDJ/pLvAAAAAElFTkSuQmCCiVBORw0KGgoAAAANSUhEUgAAAAIAAAABCAIAAAB7QOjdAAAAD0lEQVR4nGNg+M/AwPAfAAYBAf9d/01yAAAAAElFTkSuQmCC"
+        }
+      ],
+      "bufferViews": [
+        { "buffer": 0, "byteOffset": 0, "byteLength": 69 },
+        { "buffer": 0, "byteOffset": 69, "byteLength": 72 },
+        { "buffer": 0, "byteOffset": 100, "byteLength": 100 }
+      ],
+      "images": [
+        { "bufferView": 0, "mimeType": "image/png" },
+        { "bufferView": 1, "mimeType": "image/png" },
+        { "bufferView": 2, "mimeType": "image/png" }
+      ]
+    }
+  )";
+  const gsl::span<const std::byte> data(
+      reinterpret_cast<const std::byte*>(s.c_str()),
+      s.size());
+
+  GltfReader reader;
+  AsyncSystem asyncSystem(std::make_shared<ThreadTaskProcessor>());
+  ModelReaderResult result = reader.readModelAsync(asyncSystem, data).wait();
+  REQUIRE(result.model);
+  REQUIRE(result.errors.empty());
+  REQUIRE(result.warnings.size() == 1);
+
+  const std::vector<Image>& images = result.model->images;
+  REQUIRE(images.size() == 3);
+  CHECK(images[0].cesium.width == 1);
+  CHECK(images[0].cesium.height == 1);
+  CHECK(
+      images[0].cesium.pixelData ==
+      std::vector<std::byte>{
+          std::byte(255),
+          std::byte(0),
+          std::byte(0),
+          std::byte(255)});
+  CHECK(images[1].cesium.width == 2);
+  CHECK(images[1].cesium.height == 1);
+  CHECK(images[1].cesium.pixelData.size() == 8);
+  CHECK(images[1].cesium.pixelData[6] == std::byte(255));
+  CHECK(images[2].cesium.pixelData.empty());
+
+  // The result is the same as the result of reading it synchronously.
+  ModelReaderResult expected = reader.readModel(data);
+  REQUIRE(expected.model);
+  CHECK(result.warnings == expected.warnings);
+  for (size_t i = 0; i < images.size(); ++i) {
+    const Image& expectedImage = expected.model->images[i];
+    CHECK(images[i].cesium.pixelData == expectedImage.cesium.pixelData);
+  }
+}
+
+TEST_CASE("Reads images with the channels and bits in the file") {
+  // A 1x1 red RGB PNG and a 1x1 greyscale PNG with the 16-bit value 0x1234.
+  const std::vector<uint8_t> rgb{
+      0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+      0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+      0x08, 0x02, 0x00, 0x00, 0x00, 0x90, 0x77, 0x53, 0xde, 0x00, 0x00, 0x00,
+      0x0c, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0xf8, 0xcf, 0xc0, 0x00,
+      0x00, 0x03, 0x01, 0x01, 0x00, 0xc9, 0xfe, 0x92, 0xef, 0x00, 0x00, 0x00,
+      0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82};
+  const std::vector<uint8_t> grey16{
+      0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+      0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+      0x10, 0x00, 0x00, 0x00, 0x00, 0x6a, 0xee, 0x47, 0x16, 0x00, 0x00, 0x00,
+      0x0b, 0x49, 0x44, 0x41, 0x54, 0x78, 0x9c, 0x63, 0x10, 0x32, 0x01, 0x00,
+      0x00, 0x5b, 0x00, 0x47, 0x96, 0xfb, 0x1b, 0x65, 0x00, 0x00, 0x00, 0x00,
+      0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82};
+  const gsl::span<const std::byte> rgbData(
+      reinterpret_cast<const std::byte*>(rgb.data()),
+      rgb.size());
+  const gsl::span<const std::byte> grey16Data(
+      reinterpret_cast<const std::byte*>(grey16.data()),
+      grey16.size());
+
+  GltfReader reader;
+
+  SECTION("Expands images to four 8-bit channels by default") {
+    ImageReaderResult result = reader.readImage(rgbData);
+    REQUIRE(result.image);
+    CHECK(result.image->channels == 4);
+    CHECK(result.image->bytesPerChannel == 1);
+    CHECK(
+        result.image->pixelData ==
+        std::vector<std::byte>{
+            std::byte(255),
+            std::byte(0),
+            std::byte(0),
+            std::byte(255)});
+
+    result = reader.readImage(grey16Data);
+    REQUIRE(result.image);
+    CHECK(result.image->channels == 4);
+    CHECK(result.image->bytesPerChannel == 1);
+    CHECK(result.image->pixelData[0] == std::byte(0x12));
+  }
+
+  SECTION("Keeps the channels of the file") {
+    ReadImageOptions options;
+    options.preserveChannels = true;
+
+    ImageReaderResult result = reader.readImage(rgbData, options);
+    REQUIRE(result.image);
+    CHECK(result.image->channels == 3);
+    CHECK(result.image->bytesPerChannel == 1);
+    CHECK(
+        result.image->pixelData ==
+        std::vector<std::byte>{std::byte(255), std::byte(0), std::byte(0)});
+
+    result = reader.readImage(grey16Data, options);
+    REQUIRE(result.image);
+    CHECK(result.image->channels == 1);
+    CHECK(result.image->bytesPerChannel == 1);
+    CHECK(result.image->pixelData.size() == 1);
+  }
+
+  SECTION("Keeps 16 bits per channel") {
+    ReadImageOptions options;
+    options.preserveChannels = true;
+    options.preserve16Bit = true;
+
+    ImageReaderResult result = reader.readImage(grey16Data, options);
+    REQUIRE(result.image);
+    CHECK(result.image->channels == 1);
+    CHECK(result.image->bytesPerChannel == 2);
+    REQUIRE(result.image->pixelData.size() == 2);
+    uint16_t value;
+    std::memcpy(&value, result.image->pixelData.data(), sizeof(value));
+    CHECK(value == 0x1234);
+
+    // 8-bit images are not affected.
+    result = reader.readImage(rgbData, options);
+    REQUIRE(result.image);
+    CHECK(result.image->bytesPerChannel == 1);
+  }
+}
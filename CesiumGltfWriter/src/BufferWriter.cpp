@@ -9,6 +9,22 @@
 
 #include <string_view>
 
+namespace {
+// The callback takes a vector, so data that the buffer does not own is copied
+// into one.
+void writeBufferData(
+    CesiumGltf::WriteGLTFCallback& writeGLTFCallback,
+    std::string_view name,
+    const CesiumGltf::BufferCesium& cesium) {
+  if (cesium.pExternalDataOwner) {
+    const gsl::span<const std::byte> data = cesium.getData();
+    writeGLTFCallback(name, std::vector<std::byte>(data.begin(), data.end()));
+  } else {
+    writeGLTFCallback(name, cesium.data);
+  }
+}
+} // namespace
+
 void CesiumGltf::writeBuffer(
     WriteModelResult& result,
     const std::vector<Buffer>& buffers,
@@ -29,7 +45,8 @@ void CesiumGltf::writeBuffer(
     const auto isBufferReservedForGLBBinaryChunk =
         i == 0 && options.exportType == GltfExportType::GLB;
     const auto isUriSet = buffer.uri.has_value();
-    const auto isDataBufferEmpty = buffer.cesium.data.empty();
+    const gsl::span<const std::byte> data = buffer.cesium.getData();
+    const auto isDataBufferEmpty = data.empty();
     const auto isBase64URI = isUriSet && isURIBase64DataURI(*buffer.uri);
     const auto isExternalFileURI = isUriSet && !isBase64URI;
 
@@ -48,7 +65,7 @@ void CesiumGltf::writeBuffer(
         return;
       }
 
-      byteLength = static_cast<std::int64_t>(buffer.cesium.data.size());
+      byteLength = static_cast<std::int64_t>(data.size());
     }
 
     else if (isBase64URI) {
@@ -91,22 +108,25 @@ void CesiumGltf::writeBuffer(
         j.EndArray();
         return;
       }
-      byteLength = static_cast<std::int64_t>(buffer.cesium.data.size());
+      byteLength = static_cast<std::int64_t>(data.size());
       j.KeyPrimitive("uri", *buffer.uri);
-      writeGLTFCallback(*buffer.uri, buffer.cesium.data);
+      writeBufferData(writeGLTFCallback, *buffer.uri, buffer.cesium);
     }
 
     else if (!isDataBufferEmpty) {
       if (options.autoConvertDataToBase64) {
-        byteLength = static_cast<std::int64_t>(buffer.cesium.data.size());
+        byteLength = static_cast<std::int64_t>(data.size());
         j.KeyPrimitive(
             "uri",
-            BASE64_PREFIX + encodeAsBase64String(buffer.cesium.data));
+            BASE64_PREFIX + encodeAsBase64String(data));
       }
 
       // Auto generate a filename and invoke the user provided lambda.
       else {
-        writeGLTFCallback(std::to_string(i) + ".bin", buffer.cesium.data);
+        writeBufferData(
+            writeGLTFCallback,
+            std::to_string(i) + ".bin",
+            buffer.cesium);
       }
     }
 
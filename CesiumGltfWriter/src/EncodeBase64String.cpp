@@ -3,7 +3,8 @@
 #include <modp_b64.h>
 
 std::string
-CesiumGltf::encodeAsBase64String(const std::vector<std::byte>& data) noexcept {
+CesiumGltf::encodeAsBase64String(
+    const gsl::span<const std::byte>& data) noexcept {
   const std::size_t paddedLength = modp_b64_encode_len(data.size());
   std::string result(paddedLength, '\0');
   const char* asCharPointer = reinterpret_cast<const char*>(data.data());
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <gsl/span>
+
 #include <cstdint>
 #include <string>
 #include <vector>
 
 namespace CesiumGltf {
 [[nodiscard]] std::string
-encodeAsBase64String(const std::vector<std::byte>& data) noexcept;
+encodeAsBase64String(const gsl::span<const std::byte>& data) noexcept;
 }
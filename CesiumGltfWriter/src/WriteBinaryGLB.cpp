@@ -57,7 +57,7 @@ void writeGLBJsonChunk(
 
 void writeGLBBinaryChunk(
     std::vector<std::byte>& glbBuffer,
-    const std::vector<std::byte>& binaryChunk,
+    const gsl::span<const std::byte>& binaryChunk,
     std::size_t byteOffset) {
 
   const auto bufferLength = binaryChunk.size();
@@ -81,7 +81,7 @@ void writeGLBBinaryChunk(
 }
 
 [[nodiscard]] std::vector<std::byte> CesiumGltf::writeBinaryGLB(
-    const std::vector<std::byte>& binaryChunk,
+    const gsl::span<const std::byte>& binaryChunk,
     const std::string_view& gltfJson) {
 
   std::vector<std::byte> glbBuffer(
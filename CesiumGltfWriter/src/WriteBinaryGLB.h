@@ -2,6 +2,8 @@
 
 #include <CesiumGltf/Model.h>
 
+#include <gsl/span>
+
 #include <cstdint>
 #include <string_view>
 #include <vector>
@@ -10,6 +12,6 @@ enum GLBChunkType { JSON = 0x4E4F534A, BIN = 0x004E4942 };
 
 namespace CesiumGltf {
 std::vector<std::byte> writeBinaryGLB(
-    const std::vector<std::byte>& binaryChunk,
+    const gsl::span<const std::byte>& binaryChunk,
     const std::string_view& gltfJson);
 }
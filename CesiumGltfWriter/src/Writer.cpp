@@ -123,12 +123,12 @@ WriteModelResult writeModel(
   if (options.exportType == GltfExportType::GLB) {
     if (model.buffers.empty()) {
       result.gltfAssetBytes =
-          writeBinaryGLB(std::vector<std::byte>{}, writer->toStringView());
+          writeBinaryGLB({}, writer->toStringView());
     }
 
     else {
       result.gltfAssetBytes = writeBinaryGLB(
-          model.buffers.at(0).cesium.data,
+          model.buffers.at(0).cesium.getData(),
           writer->toStringView());
     }
   } else {
@@ -0,0 +1,327 @@
+// Loads the tiles of a tileset that overlap a region into a SQLite cache, so
+// that they can later be served from the cache. Run without arguments for the
+// usage.
+
+#include <Cesium3DTilesSelection/IonRasterOverlay.h>
+#include <Cesium3DTilesSelection/TileMapServiceRasterOverlay.h>
+#include <Cesium3DTilesSelection/Tileset.h>
+#include <Cesium3DTilesSelection/TilesetCacheSeeder.h>
+#include <Cesium3DTilesSelection/registerAllTileContentTypes.h>
+#include <CesiumAsync/CachingAssetAccessor.h>
+#include <CesiumAsync/HttpAssetAccessor.h>
+#include <CesiumAsync/ITaskProcessor.h>
+#include <CesiumAsync/SqliteCache.h>
+#include <CesiumGeospatial/CartographicPolygon.h>
+#include <CesiumGeospatial/GlobeRectangle.h>
+#include <CesiumUtility/Math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Cesium3DTilesSelection;
+using namespace CesiumAsync;
+using namespace CesiumGeospatial;
+using namespace CesiumUtility;
+
+namespace {
+const char* USAGE =
+    R"(Usage: cesium-native-seed-cache [options]
+
+Tileset, one of:
+  --url <url>                The URL of the tileset.json or layer.json.
+  --ion-asset <id>           The ID of a Cesium ion asset.
+  --ion-token <token>        The Cesium ion access token.
+
+Region, at least one of:
+  --rectangle <w,s,e,n>      A rectangle, in degrees.
+  --polygon <lon,lat,...>    A polygon, in degrees.
+
+Options:
+  --sse <pixels>             The target screen-space error. Default: 16.
+  --view-distance <meters>   The closest viewing distance. Default: 1000.
+  --max-depth <levels>       The deepest level of tiles to load.
+  --max-loads <count>        The maximum tiles loading at once. Default: 64.
+  --ion-overlay <id>         Loads a Cesium ion imagery asset for the tiles.
+  --tms-overlay <url>        Loads a Tile Map Service imagery for the tiles.
+  --cache <path>             The SQLite cache. Default: cesium-cache.sqlite.
+  --cache-items <count>      The maximum cached responses. Default: 1000000.
+  --resume-file <path>       Records the progress, to resume an interrupted
+                             run.
+)";
+
+// Runs the tasks in a fixed number of threads.
+class ThreadPoolTaskProcessor : public ITaskProcessor {
+public:
+  explicit ThreadPoolTaskProcessor(uint32_t numberOfThreads) {
+    for (uint32_t i = 0; i < numberOfThreads; ++i) {
+      this->_threads.emplace_back([this]() { this->run(); });
+    }
+  }
+
+  virtual ~ThreadPoolTaskProcessor() override {
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      this->_stopping = true;
+    }
+    this->_condition.notify_all();
+    for (std::thread& thread : this->_threads) {
+      thread.join();
+    }
+  }
+
+  virtual void startTask(std::function<void()> f) override {
+    {
+      std::lock_guard<std::mutex> lock(this->_mutex);
+      this->_tasks.emplace_back(std::move(f));
+    }
+    this->_condition.notify_one();
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> lock(this->_mutex);
+    while (true) {
+      this->_condition.wait(lock, [this]() {
+        return this->_stopping || !this->_tasks.empty();
+      });
+      if (this->_tasks.empty()) {
+        return;
+      }
+
+      std::function<void()> task = std::move(this->_tasks.front());
+      this->_tasks.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  std::deque<std::function<void()>> _tasks;
+  bool _stopping = false;
+  std::vector<std::thread> _threads;
+};
+
+std::vector<double> parseNumbers(const std::string& value) {
+  std::vector<double> numbers;
+  std::istringstream stream(value);
+  std::string number;
+  while (std::getline(stream, number, ',')) {
+    numbers.push_back(std::stod(number));
+  }
+  return numbers;
+}
+
+CartographicPolygon parseRectangle(const std::string& value) {
+  const std::vector<double> numbers = parseNumbers(value);
+  if (numbers.size() != 4) {
+    throw std::invalid_argument("A rectangle needs four numbers: " + value);
+  }
+  return TilesetCacheSeeder::createPolygon(GlobeRectangle::fromDegrees(
+      numbers[0],
+      numbers[1],
+      numbers[2],
+      numbers[3]));
+}
+
+CartographicPolygon parsePolygon(const std::string& value) {
+  const std::vector<double> numbers = parseNumbers(value);
+  if (numbers.size() < 6 || numbers.size() % 2 != 0) {
+    throw std::invalid_argument(
+        "A polygon needs at least three longitude and latitude pairs: " +
+        value);
+  }
+
+  std::vector<glm::dvec2> vertices;
+  for (size_t i = 0; i < numbers.size(); i += 2) {
+    vertices.emplace_back(
+        Math::degreesToRadians(numbers[i]),
+        Math::degreesToRadians(numbers[i + 1]));
+  }
+  return CartographicPolygon(vertices);
+}
+
+struct Arguments {
+  std::string url;
+  std::optional<uint32_t> ionAssetID;
+  std::string ionAccessToken;
+  std::vector<CartographicPolygon> region;
+  TilesetCacheSeederOptions options;
+  std::vector<uint32_t> ionOverlays;
+  std::vector<std::string> tmsOverlays;
+  std::string cachePath = "cesium-cache.sqlite";
+  uint64_t cacheItems = 1000000;
+};
+
+Arguments parseArguments(int argc, char** argv) {
+  Arguments arguments;
+  for (int i = 1; i < argc; ++i) {
+    const std::string name = argv[i];
+    if (i + 1 == argc) {
+      throw std::invalid_argument("Missing value for " + name);
+    }
+    const std::string value = argv[++i];
+
+    if (name == "--url") {
+      arguments.url = value;
+    } else if (name == "--ion-asset") {
+      arguments.ionAssetID = uint32_t(std::stoul(value));
+    } else if (name == "--ion-token") {
+      arguments.ionAccessToken = value;
+    } else if (name == "--rectangle") {
+      arguments.region.emplace_back(parseRectangle(value));
+    } else if (name == "--polygon") {
+      arguments.region.emplace_back(parsePolygon(value));
+    } else if (name == "--sse") {
+      arguments.options.maximumScreenSpaceError = std::stod(value);
+    } else if (name == "--view-distance") {
+      arguments.options.viewDistance = std::stod(value);
+    } else if (name == "--max-depth") {
+      arguments.options.maximumDepth = int32_t(std::stoi(value));
+    } else if (name == "--max-loads") {
+      arguments.options.maximumSimultaneousTileLoads =
+          uint32_t(std::stoul(value));
+    } else if (name == "--ion-overlay") {
+      arguments.ionOverlays.push_back(uint32_t(std::stoul(value)));
+    } else if (name == "--tms-overlay") {
+      arguments.tmsOverlays.push_back(value);
+    } else if (name == "--cache") {
+      arguments.cachePath = value;
+    } else if (name == "--cache-items") {
+      arguments.cacheItems = uint64_t(std::stoull(value));
+    } else if (name == "--resume-file") {
+      arguments.options.resumeFile = value;
+    } else {
+      throw std::invalid_argument("Unknown option " + name);
+    }
+  }
+
+  if (arguments.url.empty() == !arguments.ionAssetID) {
+    throw std::invalid_argument("Specify either --url or --ion-asset.");
+  }
+  if (arguments.region.empty()) {
+    throw std::invalid_argument("Specify a --rectangle or a --polygon.");
+  }
+
+  return arguments;
+}
+
+void printProgress(const TilesetCacheSeederProgress& progress) {
+  std::printf(
+      "\rTiles loaded: %lld, failed: %lld, loading: %lld, queued: %lld, "
+      "subtrees skipped: %lld, requests: %lld, received: %.1f MB   ",
+      static_cast<long long>(progress.tilesLoaded),
+      static_cast<long long>(progress.tilesFailed),
+      static_cast<long long>(progress.tilesLoading),
+      static_cast<long long>(progress.tilesQueued),
+      static_cast<long long>(progress.subtreesSkipped),
+      static_cast<long long>(progress.requests),
+      double(progress.bytesReceived) / (1024.0 * 1024.0));
+  std::fflush(stdout);
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc == 1) {
+    std::fputs(USAGE, stdout);
+    return 0;
+  }
+
+  Arguments arguments;
+  try {
+    arguments = parseArguments(argc, argv);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n\n%s", e.what(), USAGE);
+    return 2;
+  }
+
+  registerAllTileContentTypes();
+
+  const std::shared_ptr<spdlog::logger> pLogger = spdlog::default_logger();
+  const uint32_t numberOfThreads =
+      std::max(std::thread::hardware_concurrency(), 2u);
+
+  HttpAssetAccessorOptions accessorOptions;
+  accessorOptions.numberOfThreads =
+      std::max(arguments.options.maximumSimultaneousTileLoads, 8u);
+
+  TilesetExternals externals{
+      std::make_shared<CachingAssetAccessor>(
+          pLogger,
+          std::make_shared<HttpAssetAccessor>(accessorOptions),
+          std::make_shared<SqliteCache>(
+              pLogger,
+              arguments.cachePath,
+              arguments.cacheItems)),
+      nullptr,
+      AsyncSystem(std::make_shared<ThreadPoolTaskProcessor>(numberOfThreads)),
+      nullptr,
+      pLogger};
+
+  try {
+    std::unique_ptr<TilesetCacheSeeder> pSeeder =
+        arguments.ionAssetID
+            ? std::make_unique<TilesetCacheSeeder>(
+                  externals,
+                  *arguments.ionAssetID,
+                  arguments.ionAccessToken,
+                  arguments.region,
+                  arguments.options)
+            : std::make_unique<TilesetCacheSeeder>(
+                  externals,
+                  arguments.url,
+                  arguments.region,
+                  arguments.options);
+
+    for (uint32_t ionAssetID : arguments.ionOverlays) {
+      pSeeder->getTileset().getOverlays().add(
+          std::make_unique<IonRasterOverlay>(
+              "ion",
+              ionAssetID,
+              arguments.ionAccessToken));
+    }
+    for (const std::string& url : arguments.tmsOverlays) {
+      pSeeder->getTileset().getOverlays().add(
+          std::make_unique<TileMapServiceRasterOverlay>("tms", url));
+    }
+
+    auto lastPrint = std::chrono::steady_clock::now();
+    while (!pSeeder->update()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+      const auto now = std::chrono::steady_clock::now();
+      if (now - lastPrint >= std::chrono::seconds(1)) {
+        printProgress(pSeeder->getProgress());
+        lastPrint = now;
+      }
+    }
+
+    printProgress(pSeeder->getProgress());
+    std::printf("\n");
+
+    if (pSeeder->getProgress().tilesetFailed) {
+      std::fprintf(stderr, "The tileset failed to load.\n");
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 namespace CesiumUtility {
 class Uri final {
@@ -15,6 +16,19 @@ public:
       const std::string& key,
       const std::string& value);
 
+  /**
+   * @brief Removes the query parameters with the given names from a URI.
+   *
+   * The remaining query parameters and the fragment are kept in their order.
+   *
+   * @param uri The URI.
+   * @param names The names of the query parameters to remove.
+   * @return The URI without the query parameters.
+   */
+  static std::string removeQueryParameters(
+      const std::string& uri,
+      const std::vector<std::string>& names);
+
   typedef std::string
   SubstitutionCallbackSignature(const std::string& placeholder);
   static std::string substituteTemplateParameters(
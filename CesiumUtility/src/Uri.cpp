@@ -2,6 +2,7 @@
 
 #include <uriparser/Uri.h>
 
+#include <algorithm>
 #include <stdexcept>
 
 using namespace CesiumUtility;
@@ -101,6 +102,41 @@ std::string Uri::addQuery(
   // uriFreeUriMembersA(&baseUri);
 }
 
+std::string Uri::removeQueryParameters(
+    const std::string& uri,
+    const std::vector<std::string>& names) {
+  const size_t queryStart = uri.find('?');
+  if (queryStart == std::string::npos) {
+    return uri;
+  }
+
+  const size_t queryEnd = std::min(uri.find('#', queryStart), uri.size());
+
+  std::string result = uri.substr(0, queryStart);
+  char separator = '?';
+  size_t parameterStart = queryStart + 1;
+  while (parameterStart <= queryEnd) {
+    const size_t parameterEnd =
+        std::min(uri.find('&', parameterStart), queryEnd);
+    const size_t nameEnd =
+        std::min(uri.find('=', parameterStart), parameterEnd);
+    const std::string name =
+        uri.substr(parameterStart, nameEnd - parameterStart);
+
+    if (parameterEnd > parameterStart &&
+        std::find(names.begin(), names.end(), name) == names.end()) {
+      result += separator;
+      result.append(uri, parameterStart, parameterEnd - parameterStart);
+      separator = '&';
+    }
+
+    parameterStart = parameterEnd + 1;
+  }
+
+  result.append(uri, queryEnd, std::string::npos);
+  return result;
+}
+
 std::string Uri::substituteTemplateParameters(
     const std::string& templateUri,
     const std::function<SubstitutionCallbackSignature>& substitutionCallback) {